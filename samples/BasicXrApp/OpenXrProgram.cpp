@@ -97,6 +97,9 @@ namespace {
             m_optionalExtensions.SpatialAnchorSupported = EnableExtensionIfSupported(XR_MSFT_SPATIAL_ANCHOR_EXTENSION_NAME);
             m_optionalExtensions.MsftHandInteractionSupported = EnableExtensionIfSupported(XR_MSFT_HAND_INTERACTION_EXTENSION_NAME);
             m_optionalExtensions.HPMRControllerSupported = EnableExtensionIfSupported(XR_EXT_HP_MIXED_REALITY_CONTROLLER_EXTENSION_NAME);
+#ifdef XR_KHR_locate_spaces
+            m_optionalExtensions.LocateSpacesSupported = EnableExtensionIfSupported(XR_KHR_LOCATE_SPACES_EXTENSION_NAME);
+#endif
 
             return enabledExtensions;
         }
@@ -289,6 +292,7 @@ namespace {
             createInfo.next = &graphicsBinding;
             createInfo.systemId = m_systemId;
             CHECK_XRCMD(xrCreateSession(m_instance.Get(), &createInfo, m_session.Put(xrDestroySession)));
+            m_spaceLocator.emplace(m_session.Get(), m_optionalExtensions.LocateSpacesSupported);
 
             XrSessionActionSetsAttachInfo attachInfo{XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
             std::vector<XrActionSet> actionSets = {m_actionSet.Get()};
@@ -765,30 +769,42 @@ namespace {
 
             std::vector<const sample::Cube*> visibleCubes;
 
-            auto UpdateVisibleCube = [&](sample::Cube& cube) {
+            UpdateSpinningCube(predictedDisplayTime);
+
+            // Locate the spaces of all cubes with one call to the runtime.
+            std::vector<sample::Cube*> cubes;
+            std::vector<XrSpace> cubeSpaces;
+            auto AddCube = [&](sample::Cube& cube) {
                 if (cube.Space.Get() != XR_NULL_HANDLE) {
-                    XrSpaceLocation cubeSpaceInAppSpace{XR_TYPE_SPACE_LOCATION};
-                    CHECK_XRCMD(xrLocateSpace(cube.Space.Get(), m_appSpace.Get(), predictedDisplayTime, &cubeSpaceInAppSpace));
-
-                    // Update cube's location with latest space location
-                    if (xr::math::Pose::IsPoseValid(cubeSpaceInAppSpace)) {
-                        if (cube.PoseInSpace.has_value()) {
-                            cube.PoseInAppSpace = xr::math::Pose::Multiply(cube.PoseInSpace.value(), cubeSpaceInAppSpace.pose);
-                        } else {
-                            cube.PoseInAppSpace = cubeSpaceInAppSpace.pose;
-                        }
-                        visibleCubes.push_back(&cube);
-                    }
+                    cubes.push_back(&cube);
+                    cubeSpaces.push_back(cube.Space.Get());
                 }
             };
 
-            UpdateSpinningCube(predictedDisplayTime);
-
-            UpdateVisibleCube(m_cubesInHand[LeftSide]);
-            UpdateVisibleCube(m_cubesInHand[RightSide]);
+            AddCube(m_cubesInHand[LeftSide]);
+            AddCube(m_cubesInHand[RightSide]);
 
             for (auto& hologram : m_holograms) {
-                UpdateVisibleCube(hologram.Cube);
+                AddCube(hologram.Cube);
+            }
+
+            std::vector<xr::SpaceLocation> cubeSpacesInAppSpace(cubeSpaces.size());
+            m_spaceLocator->LocateSpaces(
+                m_appSpace.Get(), predictedDisplayTime, (uint32_t)cubeSpaces.size(), cubeSpaces.data(), cubeSpacesInAppSpace.data());
+
+            for (size_t i = 0; i < cubes.size(); i++) {
+                sample::Cube& cube = *cubes[i];
+                const xr::SpaceLocation& cubeSpaceInAppSpace = cubeSpacesInAppSpace[i];
+
+                // Update cube's location with latest space location
+                if (xr::math::Pose::IsPoseValid(cubeSpaceInAppSpace.LocationFlags)) {
+                    if (cube.PoseInSpace.has_value()) {
+                        cube.PoseInAppSpace = xr::math::Pose::Multiply(cube.PoseInSpace.value(), cubeSpaceInAppSpace.Pose);
+                    } else {
+                        cube.PoseInAppSpace = cubeSpaceInAppSpace.Pose;
+                    }
+                    visibleCubes.push_back(&cube);
+                }
             }
 
             m_renderResources->ProjectionLayerViews.resize(viewCount);
@@ -864,6 +880,7 @@ namespace {
             m_mainCubeIndex = m_spinningCubeIndex = {};
             m_holograms.clear();
             m_renderResources.reset();
+            m_spaceLocator.reset();
             m_session.Reset();
             m_systemId = XR_NULL_SYSTEM_ID;
         }
@@ -894,10 +911,12 @@ namespace {
             bool SpatialAnchorSupported{false};
             bool MsftHandInteractionSupported{false};
             bool HPMRControllerSupported{false};
+            bool LocateSpacesSupported{false};
         } m_optionalExtensions;
 
         xr::SpaceHandle m_appSpace;
         XrReferenceSpaceType m_appSpaceType{};
+        std::optional<xr::SpaceLocator> m_spaceLocator;
 
         struct Hologram {
             sample::Cube Cube;
@@ -33,6 +33,7 @@
 #include <XrUtility/XrError.h>
 #include <XrUtility/XrHandle.h>
 #include <XrUtility/XrMath.h>
+#include <XrUtility/XrSpaceLocator.h>
 #include <XrUtility/XrString.h>
 
 #include <winrt/base.h> // winrt::com_ptr
@@ -5,7 +5,7 @@
 #include <XrSceneLib/XrApp.h>
 
 std::unique_ptr<engine::Scene> TryCreateTitleScene(engine::Context& context);
-std::unique_ptr<engine::Scene> TryCreateEyeGazeInteractionScene(engine::Context& context);
+std::unique_ptr<engine::Scene> TryCreateEyeGazeInteractionScene(engine::Context& context, XrSpace* gazeSpace);
 
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ int nCmdShow) {
     try {
@@ -17,7 +17,16 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
 
         auto app = CreateXrApp(appConfig);
         app->AddScene(TryCreateTitleScene(app->Context()));
-        app->AddScene(TryCreateEyeGazeInteractionScene(app->Context()));
+
+        // The gaze space is owned by the scene, which outlives the rendering of the projection layer.
+        XrSpace gazeSpace = XR_NULL_HANDLE;
+        app->AddScene(TryCreateEyeGazeInteractionScene(app->Context(), &gazeSpace));
+
+        // Render the primary projection layer at full resolution only around the eye gaze.
+        engine::FoveationConfig foveation;
+        foveation.GazeSpace = gazeSpace;
+        app->ProjectionLayers().At(0).Config().Foveation = foveation;
+
         app->Run();
     } catch (const std::exception& ex) {
         sample::Trace("Unhandled Exception: {}", ex.what());
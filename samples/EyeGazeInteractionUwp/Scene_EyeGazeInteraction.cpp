@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include <XrSceneLib/PbrModelObject.h>
+#include <XrSceneLib/PickingService.h>
 #include <XrSceneLib/Scene.h>
 
 using namespace DirectX;
@@ -19,15 +20,6 @@ namespace {
     constexpr float layoutRadius = 1.5f;   // In meters
     constexpr int numberOfObjects = 36;    // Number of objects for a full circle.
 
-    bool IsLookingAtObject(const XrPosef& gazeInAppSpace, const XrPosef& objectInAppSpace, float objectRadius) {
-        const XrPosef appSpaceInGaze = Pose::Invert(gazeInAppSpace);
-        const XrPosef objectInGaze = objectInAppSpace * appSpaceInGaze;
-        const float projectionOnZ = Normalize(objectInGaze.position).z;
-        const float distance = Length(objectInGaze.position);
-        const float angleTolerance = std::atan2(objectRadius, distance);
-        return projectionOnZ < -std::cos(angleTolerance);
-    }
-
     struct EyeGazeInteractionScene : public engine::Scene {
         EyeGazeInteractionScene(engine::Context& context)
             : Scene(context)
@@ -75,6 +67,7 @@ namespace {
                 object->Pose().position.x = layoutRadius * std::sin(i * angleDistance);
                 object->Pose().position.z = layoutRadius * std::cos(i * angleDistance);
                 object->Motion.SetRotation({0, 0, 1}, XM_2PI); // Rotate around per second
+                m_picking.Add(object, objectDiameter / 2);
                 m_lookAtObjects.emplace_back(std::move(object));
             }
         }
@@ -83,31 +76,42 @@ namespace {
             XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
             CHECK_XRCMD(xrLocateSpace(m_gazeSpace.Get(), m_context.AppSpace, frameTime.PredictedDisplayTime, &location));
 
+            for (auto& object : m_lookAtObjects) {
+                object->Motion.SetEnabled(false);
+            }
+
             if (Pose::IsPoseValid(location)) {
                 m_gazeObject->SetVisible(true);
                 m_gazeObject->Pose() = location.pose;
-                for (auto& object : m_lookAtObjects) {
-                    XrPosef objectInAppSpace;
-                    StoreXrPose(&objectInAppSpace, object->WorldTransform());
-                    object->Motion.Enabled = IsLookingAtObject(location.pose, objectInAppSpace, objectDiameter / 2);
+
+                // Every object within the gaze cone rotates.
+                m_picking.Update();
+                m_picking.Pick(engine::PickQuery::Cone(location.pose), m_gazeHits);
+                for (const engine::PickHit& hit : m_gazeHits) {
+                    hit.Object->Motion.SetEnabled(true);
                 }
             } else {
                 m_gazeObject->SetVisible(false);
-                for (auto& object : m_lookAtObjects) {
-                    object->Motion.Enabled = false;
-                }
             }
         }
 
+        XrSpace GazeSpace() const {
+            return m_gazeSpace.Get();
+        }
+
     private:
         const bool m_supportsEyeGazeAction{false};
         xr::SpaceHandle m_gazeSpace;
         std::shared_ptr<engine::Object> m_gazeObject;
         std::shared_ptr<engine::Object> m_gazeLookAtAxis;
         std::vector<std::shared_ptr<engine::Object>> m_lookAtObjects;
+        engine::PickingService m_picking;
+        std::vector<engine::PickHit> m_gazeHits;
     };
 } // namespace
 
-std::unique_ptr<engine::Scene> TryCreateEyeGazeInteractionScene(engine::Context& context) {
-    return std::make_unique<EyeGazeInteractionScene>(context);
+std::unique_ptr<engine::Scene> TryCreateEyeGazeInteractionScene(engine::Context& context, XrSpace* gazeSpace) {
+    auto scene = std::make_unique<EyeGazeInteractionScene>(context);
+    *gazeSpace = scene->GazeSpace();
+    return scene;
 }
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "pch.h"
+#include <XrUtility/XrSide.h>
+#include <SampleShared/HandGestureRecognizer.h>
+#include <SampleShared/HandJointFilter.h>
 #include <XrSceneLib/PbrModelObject.h>
 #include <XrSceneLib/Scene.h>
 
@@ -23,6 +26,11 @@ namespace {
 
             m_motionRangeModeChangeAction = actionSet.CreateAction(
                 "motion_range_mode_change_action", "Motion Range Mode Change Action", XR_ACTION_TYPE_BOOLEAN_INPUT, {});
+            ActionContext().Subscribe(m_motionRangeModeChangeAction, [this](const sample::ActionEvent& event) {
+                if (event.type == sample::ActionEventType::Pressed) {
+                    m_motionRangeMode = (MotionRangeMode)(((uint32_t)m_motionRangeMode + 1) % (uint32_t)MotionRangeMode::Count);
+                }
+            });
 
             ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/microsoft/motion_controller",
                                                               {
@@ -121,39 +129,20 @@ namespace {
                 }
             }
 
-            // Set a clap detector that will toggle the display mode.
-            m_clapDetector = std::make_unique<StateChangeDetector>(
-                [this](XrTime time) {
-                    const XrHandJointLocationEXT& leftPalmLocation = m_leftHandData.JointLocations[XR_HAND_JOINT_PALM_EXT];
-                    const XrHandJointLocationEXT& rightPalmLocation = m_rightHandData.JointLocations[XR_HAND_JOINT_PALM_EXT];
-
-                    if (xr::math::Pose::IsPoseValid(leftPalmLocation) && xr::math::Pose::IsPoseValid(rightPalmLocation)) {
-                        const XMVECTOR leftPalmPosition = xr::math::LoadXrVector3(leftPalmLocation.pose.position);
-                        const XMVECTOR rightPalmPosition = xr::math::LoadXrVector3(rightPalmLocation.pose.position);
-                        const float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(leftPalmPosition, rightPalmPosition)));
-                        return distance - leftPalmLocation.radius - rightPalmLocation.radius < 0.02f /*meter*/;
-                    }
-
-                    return false;
-                },
-                [this]() {
-                    // We can only change mode if Mesh is supported
-                    if (m_enableHandMesh) {
-                        m_mode = (HandDisplayMode)(((uint32_t)m_mode + 1) % (uint32_t)HandDisplayMode::Count);
-                    }
-                });
+            // Clapping the palms together toggles the display mode.
+            // The hysteresis keeps a clap held near the threshold from toggling the mode repeatedly.
+            sample::GestureStep clapStep;
+            clapStep.Predicates.push_back(sample::GesturePredicate::Distance({xr::Side::Left, XR_HAND_JOINT_PALM_EXT},
+                                                                             {xr::Side::Right, XR_HAND_JOINT_PALM_EXT},
+                                                                             -std::numeric_limits<float>::infinity(),
+                                                                             0.02f /*meter*/,
+                                                                             0.01f /*meter*/));
+            m_clapGesture = m_gestureRecognizer.AddGesture({"Clap", {std::move(clapStep)}});
         }
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
-            XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
-            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-            getInfo.action = m_motionRangeModeChangeAction;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &state));
-            const bool isMotionRangeModeChangeButtonPressed = state.isActive && state.changedSinceLastSync && state.currentState;
-            if (isMotionRangeModeChangeButtonPressed) {
-                m_motionRangeMode = (MotionRangeMode)(((uint32_t)m_motionRangeMode + 1) % (uint32_t)MotionRangeMode::Count);
-            }
-            for (HandData& handData : {std::ref(m_leftHandData), std::ref(m_rightHandData)}) {
+            const std::tuple<uint32_t, HandData&> hands[] = {{xr::Side::Left, m_leftHandData}, {xr::Side::Right, m_rightHandData}};
+            for (const auto& [hand, handData] : hands) {
                 XrHandJointsMotionRangeInfoEXT motionRangeInfo{XR_TYPE_HAND_JOINTS_MOTION_RANGE_INFO_EXT};
                 motionRangeInfo.handJointsMotionRange = m_motionRangeMode == MotionRangeMode::Unobstructed
                                                             ? XR_HAND_JOINTS_MOTION_RANGE_UNOBSTRUCTED_EXT
@@ -162,10 +151,25 @@ namespace {
                 locateInfo.baseSpace = m_context.AppSpace;
                 locateInfo.time = frameTime.PredictedDisplayTime;
 
-                XrHandJointLocationsEXT locations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT};
+                XrHandJointVelocitiesEXT velocities{XR_TYPE_HAND_JOINT_VELOCITIES_EXT};
+                velocities.jointCount = (uint32_t)handData.JointVelocities.size();
+                velocities.jointVelocities = handData.JointVelocities.data();
+
+                XrHandJointLocationsEXT locations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT, &velocities};
                 locations.jointCount = (uint32_t)handData.JointLocations.size();
                 locations.jointLocations = handData.JointLocations.data();
                 CHECK_XRCMD(xrLocateHandJointsEXT(handData.TrackerHandle.Get(), &locateInfo, &locations));
+                m_jointFilter.SetJoints(hand, frameTime.PredictedDisplayTime, locations);
+            }
+
+            // Smooth the joints of both hands together. They are located at the display time, so the filter only extrapolates them
+            // over its own lag.
+            m_jointFilter.Update();
+
+            for (const auto& [hand, handData] : hands) {
+                const bool isTracked =
+                    m_jointFilter.GetJoints(hand, frameTime.PredictedDisplayTime, handData.FilteredJointLocations.data());
+                m_gestureRecognizer.SetJoints(hand, isTracked, handData.FilteredJointLocations.data());
 
                 bool jointsVisible = m_mode == HandDisplayMode::Joints;
                 bool meshVisible = m_mode == HandDisplayMode::Mesh;
@@ -184,8 +188,12 @@ namespace {
                 }
             }
 
-            // Detect hand clap to toggle hand display mode.
-            m_clapDetector->Update(frameTime.PredictedDisplayTime);
+            for (const sample::GestureEvent& event : m_gestureRecognizer.Update(frameTime.PredictedDisplayTime)) {
+                // We can only change mode if Mesh is supported
+                if (event.GestureId == m_clapGesture && event.Type == sample::GestureEventType::Started && m_enableHandMesh) {
+                    m_mode = (HandDisplayMode)(((uint32_t)m_mode + 1) % (uint32_t)HandDisplayMode::Count);
+                }
+            }
         }
 
         struct HandData {
@@ -195,6 +203,8 @@ namespace {
             std::shared_ptr<engine::PbrModelObject> JointModel;
             std::array<Pbr::NodeIndex_t, XR_HAND_JOINT_COUNT_EXT> PbrNodeIndices{};
             std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> JointLocations{};
+            std::array<XrHandJointVelocityEXT, XR_HAND_JOINT_COUNT_EXT> JointVelocities{};
+            std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> FilteredJointLocations{};
 
             // Data to display hand mesh tracking
             xr::SpaceHandle MeshSpace;
@@ -216,11 +226,12 @@ namespace {
             bool jointsVisible = false;
 
             for (uint32_t k = 0; k < XR_HAND_JOINT_COUNT_EXT; k++) {
-                if (xr::math::Pose::IsPoseValid(handData.JointLocations[k])) {
+                const XrHandJointLocationEXT& jointLocation = handData.FilteredJointLocations[k];
+                if (xr::math::Pose::IsPoseValid(jointLocation)) {
                     Pbr::Node& jointNode = handData.JointModel->GetModel()->GetNode(handData.PbrNodeIndices[k]);
 
-                    const float radius = handData.JointLocations[k].radius;
-                    jointNode.SetTransform(XMMatrixScaling(radius, radius, radius) * xr::math::LoadXrPose(handData.JointLocations[k].pose));
+                    const float radius = jointLocation.radius;
+                    jointNode.SetTransform(XMMatrixScaling(radius, radius, radius) * xr::math::LoadXrPose(jointLocation.pose));
 
                     jointsVisible = true;
                 }
@@ -239,33 +250,43 @@ namespace {
                 return false;
             }
 
-            bool indicesChanged = handData.meshState.indexBufferChanged;
-            bool verticesChanged = handData.meshState.vertexBufferChanged;
+            const XrHandMeshIndexBufferMSFT& indexBuffer = handData.meshState.indexBuffer;
+            const XrHandMeshVertexBufferMSFT& vertexBuffer = handData.meshState.vertexBuffer;
+            const bool indicesChanged = handData.meshState.indexBufferChanged;
+            const bool verticesChanged = handData.meshState.vertexBufferChanged;
 
             if (indicesChanged) {
                 // Index buffer is changed, recalculate vertices color based on neutral hand pose.
                 ComputeHandMeshColor(handData, time);
             }
 
-            if (verticesChanged) {
-                Pbr::PrimitiveBuilder meshBuilder = CreateHandMeshPrimitiveBuilder(handData.meshState.indexBuffer.indices,
-                                                                                   handData.meshState.indexBuffer.indexCountOutput,
-                                                                                   handData.meshState.vertexBuffer.vertices,
-                                                                                   handData.meshState.vertexBuffer.vertexCountOutput,
-                                                                                   handData.VertexColors);
-
-                if (!handData.MeshObject) {
-                    // The hand mesh scene object doesn't exist yet and must be created.
-                    Pbr::Primitive surfacePrimitive(m_context.PbrResources, meshBuilder, m_meshMaterial, false /* updatableBuffers */);
-
-                    auto surfaceModel = std::make_shared<Pbr::Model>();
-                    surfaceModel->AddPrimitive(std::move(surfacePrimitive));
-
-                    handData.MeshObject = AddObject(std::make_shared<engine::PbrModelObject>(surfaceModel));
-                } else {
-                    // Update vertices and indices of the existing hand mesh scene object's primitive.
-                    handData.MeshObject->GetModel()->GetPrimitive(0).UpdateBuffers(
-                        m_context.Device.get(), m_context.DeviceContext.get(), meshBuilder);
+            if (!handData.MeshObject) {
+                // The hand mesh scene object doesn't exist yet and must be created.
+                Pbr::PrimitiveBuilder meshBuilder;
+                meshBuilder.Indices.assign(indexBuffer.indices, indexBuffer.indices + indexBuffer.indexCountOutput);
+                meshBuilder.Vertices.resize(vertexBuffer.vertexCountOutput);
+                WriteHandMeshVertices(
+                    vertexBuffer.vertices, vertexBuffer.vertexCountOutput, handData.VertexColors, meshBuilder.Vertices.data());
+
+                Pbr::Primitive surfacePrimitive(m_context.PbrResources, meshBuilder, m_meshMaterial, true /* updatableBuffers */);
+
+                auto surfaceModel = std::make_shared<Pbr::Model>();
+                surfaceModel->AddPrimitive(std::move(surfacePrimitive));
+
+                handData.MeshObject = AddObject(std::make_shared<engine::PbrModelObject>(surfaceModel));
+            } else {
+                // Stream the changed buffers of the existing hand mesh scene object's primitive.
+                // The indices only change when the hand mesh topology changes, which is rare.
+                Pbr::Primitive& primitive = handData.MeshObject->GetModel()->GetPrimitive(0);
+                if (indicesChanged) {
+                    primitive.UpdateIndices(
+                        m_context.Device.get(), m_context.DeviceContext.get(), indexBuffer.indices, indexBuffer.indexCountOutput);
+                }
+                if (verticesChanged) {
+                    primitive.UpdateVertices(
+                        m_context.Device.get(), m_context.DeviceContext.get(), vertexBuffer.vertexCountOutput, [&](Pbr::Vertex* vertices) {
+                            WriteHandMeshVertices(vertexBuffer.vertices, vertexBuffer.vertexCountOutput, handData.VertexColors, vertices);
+                        });
                 }
             }
 
@@ -300,87 +321,58 @@ namespace {
             CHECK_XRCMD(xrLocateHandJointsEXT(handData.TrackerHandle.Get(), &locateInfo, &locations));
             assert(locations.isActive);
 
-            const XrVector3f& vZero = handData.JointLocations[XR_HAND_JOINT_MIDDLE_TIP_EXT].pose.position;
-            const XrVector3f& vOne = handData.JointLocations[XR_HAND_JOINT_WRIST_EXT].pose.position;
-            const XrVector3f& hZero = handData.JointLocations[XR_HAND_JOINT_LITTLE_TIP_EXT].pose.position;
-            const XrVector3f& hOne = handData.JointLocations[XR_HAND_JOINT_THUMB_TIP_EXT].pose.position;
+            const XMVECTOR vZero = xr::math::LoadXrVector3(handData.JointLocations[XR_HAND_JOINT_MIDDLE_TIP_EXT].pose.position);
+            const XMVECTOR vOne = xr::math::LoadXrVector3(handData.JointLocations[XR_HAND_JOINT_WRIST_EXT].pose.position);
+            const XMVECTOR hZero = xr::math::LoadXrVector3(handData.JointLocations[XR_HAND_JOINT_LITTLE_TIP_EXT].pose.position);
+            const XMVECTOR hOne = xr::math::LoadXrVector3(handData.JointLocations[XR_HAND_JOINT_THUMB_TIP_EXT].pose.position);
 
             const XrHandMeshVertexBufferMSFT& vertexBuffer = handData.meshState.vertexBuffer;
             handData.VertexColors.resize(vertexBuffer.vertexCountOutput);
 
-            // Calculate the normalized length of a vertex to a line segment defined by two point [zero, one].
-            auto weight = [](const XrVector3f& v, const XrVector3f& zero, const XrVector3f& one) -> float {
-                const XrVector3f dm = {one.x - zero.x, one.y - zero.y, one.z - zero.z};
-                const XrVector3f dv = {v.x - zero.x, v.y - zero.y, v.z - zero.z};
-                const float lm = dm.x * dm.x + dm.y * dm.y + dm.z * dm.z;
-                const float vm = dv.x * dm.x + dv.y * dm.y + dv.z * dm.z;
-
-                return std::min(1.f, std::max(0.f, vm / lm));
-            };
+            // The normalized length of a vertex to a line segment defined by two points [zero, one] is
+            // dot(v - zero, one - zero) / |one - zero|^2, which is affine in v. Both weights are computed at once by
+            // transforming the vertex with a matrix whose first two columns hold the two scaled segment directions.
+            const XMVECTOR vAxis = XMVectorDivide(vOne - vZero, XMVector3LengthSq(vOne - vZero));
+            const XMVECTOR hAxis = XMVectorDivide(hOne - hZero, XMVector3LengthSq(hOne - hZero));
+            const XMMATRIX weightTransform = XMMatrixTranspose(XMMATRIX(XMVectorSetW(vAxis, -XMVectorGetX(XMVector3Dot(vAxis, vZero))),
+                                                                        XMVectorSetW(hAxis, -XMVectorGetX(XMVector3Dot(hAxis, hZero))),
+                                                                        g_XMZero,
+                                                                        g_XMZero));
 
             for (uint32_t i = 0; i < vertexBuffer.vertexCountOutput; i++) {
-                const XrVector3f& vertexPosition = vertexBuffer.vertices[i].position;
-                const float v = weight(vertexPosition, vZero, vOne);
-                const float h = weight(vertexPosition, hZero, hOne);
-                // Pick a simple psuedo color map to visualize figers in colors.
-                handData.VertexColors[i] = {v, (1 - h), h, 1};
+                // weights = (v, h, 0, 0)
+                const XMVECTOR weights =
+                    XMVectorSaturate(XMVector3Transform(xr::math::LoadXrVector3(vertexBuffer.vertices[i].position), weightTransform));
+                // Pick a simple psuedo color map to visualize figers in colors: (v, 1 - h, h, 1)
+                const XMVECTOR inverseWeights = XMVectorSubtract(g_XMOne, weights);
+                const XMVECTOR color = XMVectorPermute<XM_PERMUTE_0X, XM_PERMUTE_1Y, XM_PERMUTE_0Y, XM_PERMUTE_1W>(weights, inverseWeights);
+                XMStoreFloat4(&handData.VertexColors[i], color);
             }
         }
 
-        Pbr::PrimitiveBuilder CreateHandMeshPrimitiveBuilder(uint32_t* indices,
-                                                             uint32_t indexCount,
-                                                             XrHandMeshVertexMSFT* vertices,
-                                                             uint32_t vertexCount,
-                                                             const std::vector<XMFLOAT4>& vertexColors) {
-            Pbr::PrimitiveBuilder builder;
-            builder.Vertices.resize(vertexCount);
-
-            builder.Indices = std::vector<uint32_t>(indices, indices + indexCount);
-
-            for (uint32_t i = 0; i < vertexCount; i++, vertices++) {
-                Pbr::Vertex& vertex = builder.Vertices[i];
-
-                vertex.Position = xr::math::cast(vertices->position);
-                vertex.Normal = xr::math::cast(vertices->normal);
+        // Convert the runtime's hand mesh vertices to the PBR vertex layout. The destination can be mapped GPU memory,
+        // so each vertex is assembled on the stack and written once.
+        static void WriteHandMeshVertices(const XrHandMeshVertexMSFT* handVertices,
+                                          uint32_t vertexCount,
+                                          const std::vector<XMFLOAT4>& vertexColors,
+                                          Pbr::Vertex* vertices) {
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                Pbr::Vertex vertex;
+                vertex.Position = xr::math::cast(handVertices[i].position);
+                vertex.Normal = xr::math::cast(handVertices[i].normal);
                 vertex.Color0 = vertexColors[i];
 
-                bool xDominant = std::abs(vertex.Normal.x) > std::abs(vertex.Normal.y);
-                XMVECTOR basis = xDominant ? g_XMIdentityR1 : g_XMIdentityR0;
-                XMVECTOR normal = XMLoadFloat3(&vertex.Normal);
-                XMVECTOR tangent = XMVector3Cross(normal, basis);
-                XMStoreFloat4(&vertex.Tangent, tangent);
+                const bool xDominant = std::abs(vertex.Normal.x) > std::abs(vertex.Normal.y);
+                const XMVECTOR basis = xDominant ? g_XMIdentityR1 : g_XMIdentityR0;
+                const XMVECTOR normal = XMLoadFloat3(&vertex.Normal);
+                XMStoreFloat4(&vertex.Tangent, XMVector3Cross(normal, basis));
 
-                XMStoreFloat2(&vertex.TexCoord0, g_XMZero);
+                vertex.TexCoord0 = {0, 0};
                 vertex.ModelTransformIndex = Pbr::RootNodeIndex; // Index into the node transforms
+                vertices[i] = vertex;
             }
-
-            return builder;
         }
 
-        // Detects two spaces collide to each other
-        class StateChangeDetector {
-        public:
-            StateChangeDetector(std::function<bool(XrTime)> getState, std::function<void()> callback)
-                : m_getState(std::move(getState))
-                , m_callback(std::move(callback)) {
-            }
-
-            void Update(XrTime time) {
-                bool state = m_getState(time);
-                if (m_lastState != state) {
-                    m_lastState = state;
-                    if (state) { // trigger on rising edge
-                        m_callback();
-                    }
-                }
-            }
-
-        private:
-            const std::function<bool(XrTime)> m_getState;
-            const std::function<void()> m_callback;
-            std::optional<bool> m_lastState{};
-        };
-
         bool m_enableHandMesh{false};
         enum class HandDisplayMode { Mesh, Joints, Count };
         HandDisplayMode m_mode{HandDisplayMode::Joints};
@@ -393,7 +385,9 @@ namespace {
 
         HandData m_leftHandData;
         HandData m_rightHandData;
-        std::unique_ptr<StateChangeDetector> m_clapDetector;
+        sample::HandJointFilter m_jointFilter{xr::Side::Count};
+        sample::HandGestureRecognizer m_gestureRecognizer{xr::Side::Count};
+        uint32_t m_clapGesture{0};
     };
 } // namespace
 
@@ -61,6 +61,9 @@ namespace {
             createInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
             createInfo.poseInReferenceSpace = Pose::Identity();
             CHECK_XRCMD(xrCreateReferenceSpace(m_context.Session.Handle, &createInfo, m_viewSpace.Put(xrDestroySpace)));
+
+            // The update only locates spaces and moves the objects of this scene.
+            SetConcurrentUpdate(true);
         }
 
         void OnEvent(const XrEventDataBuffer& eventData [[maybe_unused]]) override {
@@ -82,10 +85,7 @@ namespace {
         }
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
-            XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
-            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-            getInfo.action = m_selectAction;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &state));
+            const XrActionStateBoolean state = ActionContext().GetBooleanState(m_selectAction);
             const bool isSelectPressed = state.isActive && state.changedSinceLastSync && state.currentState;
             const bool firstUpdate = !m_sun->IsVisible();
 
@@ -58,7 +58,7 @@ namespace {
                 {
                     XrAction aimAction = FindAction(m_actions, aimPoseActionName[side]).action;
                     xr::SpaceHandle aimSpace = CreateActionSpace(context.Session.Handle, aimAction);
-                    controllerData.aimRoot = AddObject(engine::CreateSpaceObject(std::move(aimSpace)));
+                    controllerData.aimRoot = AddObject(engine::CreateSpaceObject(m_context, std::move(aimSpace)));
                     controllerData.aimRoot->SetVisible(false);
 
                     auto aimRay = AddObject(engine::CreateCube(m_context.PbrResources, {0.001f, 0.001f, 2.f}, Pbr::RGBA::White));
@@ -73,7 +73,7 @@ namespace {
                 {
                     XrAction gripAction = FindAction(m_actions, gripPoseActionName[side]).action;
                     xr::SpaceHandle gripSpace = CreateActionSpace(context.Session.Handle, gripAction);
-                    controllerData.gripRoot = AddObject(engine::CreateSpaceObject(std::move(gripSpace)));
+                    controllerData.gripRoot = AddObject(engine::CreateSpaceObject(m_context, std::move(gripSpace)));
 
                     auto axis = AddObject(engine::CreateAxis(m_context.PbrResources, 0.05f, 0.001f));
                     axis->SetParent(controllerData.gripRoot);
@@ -84,15 +84,18 @@ namespace {
                     {
                         XrAction pinchAction = FindAction(m_actions, pinchPoseActionName[side]).action;
                         xr::SpaceHandle pinchSpace = CreateActionSpace(context.Session.Handle, pinchAction);
-                        controllerData.pinchRoot = AddObject(engine::CreateSpaceObject(std::move(pinchSpace)));
+                        controllerData.pinchRoot = AddObject(engine::CreateSpaceObject(m_context, std::move(pinchSpace)));
 
                         auto axis = AddObject(engine::CreateAxis(m_context.PbrResources, 0.05f, 0.001f, 0.001f));
                         axis->SetParent(controllerData.pinchRoot);
 
                         // Load Key object to vizualise pinch pose and plane
-                        auto glbData = sample::ReadFileBytes(sample::FindFileInAppFolder(L"Key.glb"));
-                        controllerData.pinchPlaneObject =
-                            std::make_shared<engine::PbrModelObject>(Gltf::FromGltfBinary(m_context.PbrResources, glbData));
+                        const auto loadKeyModel = [&pbrResources = m_context.PbrResources] {
+                            const std::vector<uint8_t> glbData = sample::ReadFileBytes(sample::FindFileInAppFolder(L"Key.glb"));
+                            return Gltf::FromGltfBinary(pbrResources, glbData);
+                        };
+                        controllerData.pinchPlaneObject = std::make_shared<engine::PbrModelObject>(loadKeyModel());
+                        controllerData.pinchPlaneObject->EnableResidencyTracking(m_context.AssetResidency, loadKeyModel);
                         controllerData.pinchPlane = AddObject(controllerData.pinchPlaneObject);
                         controllerData.pinchPlane->SetParent(controllerData.pinchRoot);
                         controllerData.pinchPlaneObject->SetFillMode(Pbr::FillMode::Wireframe);
@@ -102,7 +105,7 @@ namespace {
                     {
                         XrAction pokeAction = FindAction(m_actions, pokePoseActionName[side]).action;
                         xr::SpaceHandle pokeSpace = CreateActionSpace(context.Session.Handle, pokeAction);
-                        controllerData.pokeRoot = AddObject(engine::CreateSpaceObject(std::move(pokeSpace)));
+                        controllerData.pokeRoot = AddObject(engine::CreateSpaceObject(m_context, std::move(pokeSpace)));
 
                         auto axis = AddObject(engine::CreateAxis(m_context.PbrResources, 0.05f, 0.001f, 0.0f));
                         axis->SetParent(controllerData.pokeRoot);
@@ -119,6 +122,24 @@ namespace {
 
                 m_interactionProfilesDirty = true;
             }
+
+            // Show the pinch plane as solid while the hand is fully pinched.
+            if (m_context.Extensions.XR_EXT_hand_interaction_enabled) {
+                if (XrAction pinchAction = FindAction(m_actions, "pinch").action) {
+                    ActionContext().Subscribe(
+                        pinchAction,
+                        [this](const sample::ActionEvent& event) {
+                            for (ControllerData& controllerData : m_controllerData) {
+                                if (controllerData.userPath == event.subactionPath) {
+                                    const bool isPinched = event.type == sample::ActionEventType::Pressed;
+                                    controllerData.pinchPlaneObject->SetFillMode(isPinched ? Pbr::FillMode::Solid
+                                                                                           : Pbr::FillMode::Wireframe);
+                                }
+                            }
+                        },
+                        1.0f /*threshold*/);
+                }
+            }
         }
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
@@ -137,24 +158,7 @@ namespace {
             for (auto side : {xr::Side::Left, xr::Side::Right}) {
                 // Update the value and visual for each controller component
                 for (auto& component : m_controllerData[side].components) {
-                    UpdateComponentValueVisuals(m_context, xr::StringToPath(m_context.Instance.Handle, UserHandPath[side]), component);
-                }
-
-                // Find the pinch action
-                if (m_context.Extensions.XR_EXT_hand_interaction_enabled) {
-                    XrAction pinchAction = FindAction(m_actions, "pinch").action;
-                    if (pinchAction) {
-                        XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-                        getInfo.action = pinchAction;
-                        getInfo.subactionPath = xr::StringToPath(m_context.Instance.Handle, UserHandPath[side]);
-                        XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
-                        CHECK_XRCMD(xrGetActionStateFloat(m_context.Session.Handle, &getInfo, &state));
-                        if (state.isActive && state.changedSinceLastSync) {
-                            const bool isPinched = (state.currentState == 1.0f);
-                            m_controllerData[side].pinchPlaneObject->SetFillMode(isPinched ? Pbr::FillMode::Solid
-                                                                                           : Pbr::FillMode::Wireframe);
-                        }
-                    }
+                    UpdateComponentValueVisuals(ActionContext(), m_controllerData[side].userPath, component);
                 }
             }
         }
@@ -633,23 +637,18 @@ namespace {
             return engine::CreateQuad(context.PbrResources, {1, quadHeight}, material);
         }
 
-        static void UpdateComponentValueVisuals(engine::Context& context, XrPath subactionPath, ComponentData& component) {
-            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-            getInfo.action = component.actionInfo.action;
-            getInfo.subactionPath = subactionPath;
+        static void UpdateComponentValueVisuals(sample::ActionContext& actionContext, XrPath subactionPath, ComponentData& component) {
+            const XrAction action = component.actionInfo.action;
             if (component.actionInfo.actionType == XR_ACTION_TYPE_BOOLEAN_INPUT) {
-                XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
-                CHECK_XRCMD(xrGetActionStateBoolean(context.Session.Handle, &getInfo, &state));
+                const XrActionStateBoolean state = actionContext.GetBooleanState(action, subactionPath);
                 component.actionValue = (float)state.currentState;
                 component.isActive = state.isActive;
             } else if (component.actionInfo.actionType == XR_ACTION_TYPE_FLOAT_INPUT) {
-                XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
-                CHECK_XRCMD(xrGetActionStateFloat(context.Session.Handle, &getInfo, &state));
+                const XrActionStateFloat state = actionContext.GetFloatState(action, subactionPath);
                 component.actionValue = state.currentState;
                 component.isActive = state.isActive;
             } else if (component.actionInfo.actionType == XR_ACTION_TYPE_POSE_INPUT) {
-                XrActionStatePose state{XR_TYPE_ACTION_STATE_POSE};
-                CHECK_XRCMD(xrGetActionStatePose(context.Session.Handle, &getInfo, &state));
+                const XrActionStatePose state = actionContext.GetPoseState(action, subactionPath);
                 component.actionValue = state.isActive ? 1.f : 0.f;
                 component.isActive = state.isActive;
             } else {
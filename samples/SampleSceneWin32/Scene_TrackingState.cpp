@@ -4,9 +4,9 @@
 #include "pch.h"
 #include <XrUtility/XrToString.h>
 #include <XrUtility/XrSide.h>
-#include <XrSceneLib/PbrModelObject.h>
-#include <XrSceneLib/TextTexture.h>
+#include <XrSceneLib/TextObject.h>
 #include <XrSceneLib/Scene.h>
+#include <SampleShared/BindingManifest.h>
 
 using namespace xr::math;
 using namespace std::chrono;
@@ -14,6 +14,15 @@ using namespace std::chrono_literals;
 
 namespace {
 
+    constexpr std::string_view BindingManifest = R"(
+        [/interaction_profiles/khr/simple_controller]
+        [/interaction_profiles/microsoft/motion_controller]
+        [/interaction_profiles/microsoft/hand_interaction] XR_MSFT_hand_interaction
+        [/interaction_profiles/ext/hand_interaction_ext] XR_EXT_hand_interaction
+        [/interaction_profiles/hp/mixed_reality_controller] XR_EXT_hp_mixed_reality_controller
+        grip_pose = /user/hand/{left,right}/input/grip/pose
+    )";
+
     //
     // This sample displays the state of head tracking and controller/hand tracking into HMD view in front of user.
     // The head tracking state is done by observing the VIEW reference space and
@@ -23,45 +32,15 @@ namespace {
     struct TrackingStateScene : public engine::Scene {
         TrackingStateScene(engine::Context& context)
             : Scene(context) {
+            engine::GlyphAtlasInfo atlasInfo;
+            atlasInfo.FontSize = 16.0f;
+            m_glyphAtlas = std::make_shared<engine::GlyphAtlas>(m_context, atlasInfo);
+
             sample::ActionSet& actionSet = ActionContext().CreateActionSet("tracking_state_action_set", "Tracking state action set");
             const std::vector<std::string> subactionPathBothHands = {"/user/hand/right", "/user/hand/left"};
             m_gripSpaceAction = actionSet.CreateAction("grip_pose", "Grip Pose", XR_ACTION_TYPE_POSE_INPUT, subactionPathBothHands);
 
-            ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/khr/simple_controller",
-                                                              {
-                                                                  {m_gripSpaceAction, "/user/hand/left/input/grip/pose"},
-                                                                  {m_gripSpaceAction, "/user/hand/right/input/grip/pose"},
-                                                              });
-
-            ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/microsoft/motion_controller",
-                                                              {
-                                                                  {m_gripSpaceAction, "/user/hand/left/input/grip/pose"},
-                                                                  {m_gripSpaceAction, "/user/hand/right/input/grip/pose"},
-                                                              });
-
-            if (context.Extensions.XR_MSFT_hand_interaction_enabled) {
-                ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/microsoft/hand_interaction",
-                                                                  {
-                                                                      {m_gripSpaceAction, "/user/hand/left/input/grip/pose"},
-                                                                      {m_gripSpaceAction, "/user/hand/right/input/grip/pose"},
-                                                                  });
-            }
-
-            if (context.Extensions.XR_EXT_hand_interaction_enabled) {
-                ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/ext/hand_interaction_ext",
-                                                                  {
-                                                                      {m_gripSpaceAction, "/user/hand/left/input/grip/pose"},
-                                                                      {m_gripSpaceAction, "/user/hand/right/input/grip/pose"},
-                                                                  });
-            }
-
-            if (context.Extensions.XR_EXT_hp_mixed_reality_controller_enabled) {
-                ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/hp/mixed_reality_controller",
-                                                                  {
-                                                                      {m_gripSpaceAction, "/user/hand/left/input/grip/pose"},
-                                                                      {m_gripSpaceAction, "/user/hand/right/input/grip/pose"},
-                                                                  });
-            }
+            sample::SuggestManifestBindings(ActionContext(), sample::ParseBindingManifest(BindingManifest), context.Extensions);
 
             XrActionSpaceCreateInfo spaceCreateInfo{XR_TYPE_ACTION_SPACE_CREATE_INFO};
             spaceCreateInfo.poseInActionSpace = Pose::Identity();
@@ -72,12 +51,12 @@ namespace {
                 CHECK_XRCMD(xrCreateActionSpace(m_context.Session.Handle, &spaceCreateInfo, m_gripSpace[side].Put(xrDestroySpace)));
 
                 const float offset = side == xr::Side::Left ? -0.5f : 0.5f;
-                AddTextBlock(m_handTextBlock[side], Pose::Translation({offset, 0, -1.0f}), {0.4f, 0.3f}, {256, 256});
+                AddTextBlock(m_handTextBlock[side], Pose::Translation({offset, 0, -1.0f}), {0.4f, 0.3f});
             }
 
             // Add text block for head/view reference space
             {
-                AddTextBlock(m_headTextBlock, Pose::Translation({0, 0, -1.2f}), {0.4f, 0.3f}, {256, 256});
+                AddTextBlock(m_headTextBlock, Pose::Translation({0, 0, -1.2f}), {0.4f, 0.3f});
 
                 XrReferenceSpaceCreateInfo createInfo{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
                 createInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
@@ -102,11 +81,8 @@ namespace {
                                side == xr::Side::Left ? "/user/hand/left" : "/user/hand/right");
                 FormatTrackingState(buffer, location.locationFlags, velocity.velocityFlags);
 
-                XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-                getInfo.action = m_gripSpaceAction;
-                getInfo.subactionPath = side == xr::Side::Left ? m_context.Instance.LeftHandPath : m_context.Instance.RightHandPath;
-                XrActionStatePose poseState{XR_TYPE_ACTION_STATE_POSE};
-                CHECK_XRCMD(xrGetActionStatePose(m_context.Session.Handle, &getInfo, &poseState));
+                const XrPath subactionPath = side == xr::Side::Left ? m_context.Instance.LeftHandPath : m_context.Instance.RightHandPath;
+                const XrActionStatePose poseState = ActionContext().GetPoseState(m_gripSpaceAction, subactionPath);
 
                 fmt::format_to(fmt::appender(buffer), "poseState.IsActive={}\n", poseState.isActive);
                 UpdateTextBlock(m_handTextBlock[side], fmt::to_string(buffer).c_str());
@@ -147,39 +123,31 @@ namespace {
     private:
         struct TextBlock {
             std::string Text;
-            std::unique_ptr<engine::TextTexture> TextTexture;
-            std::shared_ptr<engine::PbrModelObject> Object;
+            std::shared_ptr<engine::TextObject> Object;
         };
 
-        void AddTextBlock(TextBlock& textBlock, const XrPosef& center, const XrExtent2Df& size, const XrExtent2Di& pixelSize) {
-            uint32_t pixelWidth = pixelSize.width;
-            uint32_t pixelHeight = (uint32_t)std::floor(size.height * pixelWidth / size.width); // Keep texture aspect ratio
-
-            textBlock.TextTexture = std::make_unique<engine::TextTexture>(m_context, GetTextInfo(pixelWidth, pixelHeight));
-            textBlock.TextTexture->Draw(textBlock.Text);
-
-            const auto material = textBlock.TextTexture->CreatePbrMaterial(m_context.PbrResources);
-            textBlock.Object = AddObject(engine::CreateQuad(m_context.PbrResources, {size.width, size.height}, material));
+        void AddTextBlock(TextBlock& textBlock, const XrPosef& center, const XrExtent2Df& size) {
+            textBlock.Object = AddObject(std::make_shared<engine::TextObject>(m_context, m_glyphAtlas, GetTextInfo(size)));
+            textBlock.Object->SetText(textBlock.Text);
             textBlock.Object->Pose() = center;
         }
 
         void UpdateTextBlock(TextBlock& textBlock, const char* text) {
             if (strcmp(textBlock.Text.c_str(), text) != 0) {
                 textBlock.Text = text;
-                textBlock.TextTexture->Draw(textBlock.Text);
-                const auto material = textBlock.TextTexture->CreatePbrMaterial(m_context.PbrResources);
-                textBlock.Object->GetModel()->GetPrimitive(0).SetMaterial(material);
+                textBlock.Object->SetText(textBlock.Text);
             }
         }
 
-        static engine::TextTextureInfo GetTextInfo(uint32_t pixelWidth, uint32_t pixelHeight) {
-            engine::TextTextureInfo textInfo(pixelWidth, pixelHeight); // pixels
-            textInfo.Margin = 5;                                       // pixels
-            textInfo.FontSize = 16.0f;                                 // DPI
+        static engine::TextObjectInfo GetTextInfo(const XrExtent2Df& size) {
+            engine::TextObjectInfo textInfo;
+            textInfo.Size = {size.width, size.height}; // meters
+            textInfo.PixelWidth = 256;                 // pixels
+            textInfo.Margin = 5;                       // pixels
             textInfo.Foreground = Pbr::RGBA::White;
             textInfo.Background = Pbr::FromSRGB(DirectX::Colors::DarkSlateBlue);
-            textInfo.TextAlignment = DWRITE_TEXT_ALIGNMENT_LEADING;
-            textInfo.ParagraphAlignment = DWRITE_PARAGRAPH_ALIGNMENT_NEAR;
+            textInfo.Alignment = engine::TextAlignment::Leading;
+            textInfo.VerticalAlignment = engine::TextVerticalAlignment::Top;
             return textInfo;
         }
 
@@ -188,6 +156,8 @@ namespace {
         xr::SpaceHandle m_gripSpace[xr::Side::Count];
         XrAction m_gripSpaceAction{};
 
+        std::shared_ptr<engine::GlyphAtlas> m_glyphAtlas;
+
         TextBlock m_headTextBlock;
         TextBlock m_handTextBlock[xr::Side::Count];
     };
@@ -6,8 +6,15 @@
 #include <winrt/Windows.Security.Cryptography.h>
 #include <XrUtility/XrString.h>
 #include <XrUtility/XrSceneUnderstanding.hpp>
+#include <XrUtility/XrSceneUnderstandingDiff.hpp>
+#include <XrUtility/XrSceneUnderstandingSerialization.hpp>
+#include <XrUtility/XrSceneUnderstandingSpatialIndex.hpp>
 #include <pbr/GltfLoader.h>
 #include <SampleShared/FileUtility.h>
+#include <SampleShared/InputCapture.h>
+#include <SampleShared/MeshSimplification.h>
+#include <SampleShared/SceneFragmentCache.h>
+#include <SampleShared/SpatialAnchorManager.h>
 #include <SampleShared/TextureUtility.h>
 #include <XrSceneLib/PbrModelObject.h>
 #include <XrSceneLib/Scene.h>
@@ -28,21 +35,29 @@ namespace {
     constexpr auto UpdateInterval = 5s; // Time to wait between SU requests
     constexpr float ScanRadius = 4.8f;  // meters
     constexpr size_t TextureSideLength = 32;
+    constexpr float PlaneTextureScale = 5.0f; // Texture repeats per meter on the plane visuals.
     constexpr float CubeSideLength = 0.1f;
+    constexpr XrSceneComputeConsistencyMSFT SceneComputeConsistency = XR_SCENE_COMPUTE_CONSISTENCY_SNAPSHOT_COMPLETE_MSFT;
+    constexpr size_t MeshSimplificationThreadCount = 2;
+    constexpr uint16_t SceneProcessingInputStream = sample::InputCapture::FirstBackgroundStream;
     constexpr int LeftHand = 0;
     constexpr int RightHand = 1;
     constexpr int HandCount = 2;
 
     enum class RaycastAction { Activate, Searching };
 
-    struct DistanceSortableIndices {
+    struct PlaneHit {
         float distance;
         XrPosef hitPose;
         size_t planeIndex;
+    };
 
-        bool operator<(const DistanceSortableIndices& other) const noexcept {
-            return distance < other.distance;
-        }
+    // The mesh of a plane being simplified on a thread pool. It replaces the quad of the plane's visual once simplified.
+    struct PendingPlaneMesh {
+        std::shared_ptr<engine::PbrModelObject> visual;
+        Pbr::RGBAColor color;
+        XrExtent2Df planeSize;
+        std::future<sample::SimplifiedMesh> mesh;
     };
 
     struct SceneVisuals {
@@ -50,28 +65,35 @@ namespace {
         SceneVisuals(std::unique_ptr<xr::su::Scene> scene,
                      std::vector<XrUuidMSFT> componentIds,
                      std::vector<xr::su::ScenePlane> planes,
-                     std::vector<std::shared_ptr<engine::Object>> visuals)
+                     std::vector<XrSceneObjectTypeMSFT> planeTypes,
+                     std::vector<std::shared_ptr<engine::Object>> visuals,
+                     std::vector<PendingPlaneMesh> pendingMeshes)
             : scene(std::move(scene))
             , componentIds(std::move(componentIds))
             , planes(std::move(planes))
-            , visuals(std::move(visuals)) {
+            , planeTypes(std::move(planeTypes))
+            , visuals(std::move(visuals))
+            , pendingMeshes(std::move(pendingMeshes)) {
         }
 
         std::unique_ptr<xr::su::Scene> scene;
         std::vector<XrUuidMSFT> componentIds;
         std::vector<xr::su::ScenePlane> planes;
-        std::vector<std::shared_ptr<engine::Object>> visuals;
+        std::vector<XrSceneObjectTypeMSFT> planeTypes; // The type of the scene object of each plane.
+        std::vector<std::shared_ptr<engine::Object>> visuals; // Null for planes whose visual is reused from the previous scene.
+        std::vector<PendingPlaneMesh> pendingMeshes;          // The meshes of the new visuals.
 
         void ForEachEngineObject(const std::function<void(const std::shared_ptr<engine::Object>&)>& func) {
             for (const auto& visual : visuals) {
-                func(visual);
+                if (visual) {
+                    func(visual);
+                }
             }
         }
     };
 
     struct PlacedObject {
-        xr::SpatialAnchorHandle anchor;
-        xr::SpaceHandle space;
+        sample::PlacementId placement;
         std::shared_ptr<engine::Object> visual;
     };
 
@@ -90,13 +112,37 @@ namespace {
                                       float& distance);
     Pbr::RGBAColor GetColor(XrSceneObjectTypeMSFT type);
     std::shared_ptr<Pbr::Material> CreateTextureMaterial(Pbr::Resources& pbr);
+    std::shared_ptr<engine::PbrModelObject> CreatePlaneVisual(const Pbr::Resources& pbrResources,
+                                                              const std::shared_ptr<Pbr::Material>& material,
+                                                              const xr::su::ScenePlane& scenePlane,
+                                                              const Pbr::RGBAColor& color);
+    std::shared_ptr<Pbr::Model> CreateMeshModel(const Pbr::Resources& pbrResources,
+                                                const std::shared_ptr<Pbr::Material>& material,
+                                                const sample::SimplifiedMesh& mesh,
+                                                const Pbr::RGBAColor& color,
+                                                const XrExtent2Df& planeSize,
+                                                Pbr::PrimitiveBuilder& builder);
+    // State kept across scene updates by the background thread processing them.
+    struct SceneProcessingState {
+        xr::su::SceneComponentTracker<xr::su::ScenePlane> planeTracker;
+        std::unordered_map<xr::su::ScenePlane::Id, XrSceneObjectTypeMSFT> planeTypes; // The plane types of the previous scene.
+        xr::su::SceneComponentReader componentReader;
+        std::vector<xr::su::SceneObject> sceneObjects;
+        std::unique_ptr<sample::SceneFragmentCache> fragmentCache; // Null if scene serialization is not supported.
+        bool cacheSceneFragments{false}; // True if the scene being processed was computed with serialization.
+        XrSceneComputeConsistencyMSFT consistency{SceneComputeConsistency}; // The consistency the scene was computed with.
+        sample::ThreadPool meshThreadPool{MeshSimplificationThreadCount};
+    };
+
     SceneVisuals CreateSceneVisuals(const Pbr::Resources& pbrResources,
                                     const std::shared_ptr<Pbr::Material>& material,
+                                    SceneProcessingState& processingState,
                                     std::unique_ptr<xr::su::Scene> scene);
 
     struct HandRays {
         HandRays(engine::Context& context, sample::ActionContext& actionContext, IHandRayListener& rayListener)
             : m_context{context}
+            , m_actionContext(actionContext)
             , m_rayListener(rayListener) {
             const std::vector<std::string> subactionPaths = {"/user/hand/right", "/user/hand/left"};
             m_placementActionSet = &actionContext.CreateActionSet("placement_actions", "Placement Actions");
@@ -168,11 +214,7 @@ namespace {
             SetPointerVisibilityAndLocation(*m_rightPointerObject, m_rightPointerSpace.Get());
 
             const auto checkHandActivation = [&](int hand, XrPath handPath, XrSpace space) {
-                XrActionStateBoolean actionState{XR_TYPE_ACTION_STATE_BOOLEAN};
-                XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-                getInfo.action = m_placeObjectAction;
-                getInfo.subactionPath = handPath;
-                CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &actionState));
+                const XrActionStateBoolean actionState = m_actionContext.GetBooleanState(m_placeObjectAction, handPath);
                 const RaycastAction raycastAction =
                     actionState.changedSinceLastSync && actionState.currentState ? RaycastAction::Activate : RaycastAction::Searching;
 
@@ -195,6 +237,7 @@ namespace {
 
     private:
         engine::Context& m_context;
+        const sample::ActionContext& m_actionContext;
         IHandRayListener& m_rayListener;
 
         sample::ActionSet* m_placementActionSet{nullptr};
@@ -211,6 +254,7 @@ namespace {
         explicit PlacementScene(engine::Context& context)
             : Scene(context)
             , m_planeMaterial(CreateTextureMaterial(context.PbrResources))
+            , m_anchorManager(context.Session.Handle, context.Extensions)
             , m_nextUpdate{engine::FrameTime::clock::now() + UpdateInterval}
             , m_handRays{context, ActionContext(), *this} {
             XrReferenceSpaceCreateInfo spaceCreateInfo{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
@@ -221,6 +265,20 @@ namespace {
             constexpr float AxisLength = 0.2f;
             m_previewCubes[LeftHand] = engine::CreateAxis(m_context.PbrResources, AxisLength);
             m_previewCubes[RightHand] = engine::CreateAxis(m_context.PbrResources, AxisLength);
+
+            // The cached fragments of a previous run would change which scene calls are made, so an input capture would not replay.
+            if (context.Extensions.XR_MSFT_scene_understanding_serialization_enabled && !sample::InputCapture::IsActive()) {
+                try {
+                    const winrt::hstring localFolder = winrt::Windows::Storage::ApplicationData::Current().LocalFolder().Path();
+                    m_sceneProcessingState.fragmentCache = std::make_unique<sample::SceneFragmentCache>(
+                        std::filesystem::path(localFolder.c_str()) / L"SceneFragments");
+                } catch (const winrt::hresult_error& ex) {
+                    sample::Trace("Scene fragment cache is not available: {}", winrt::to_string(ex.message()));
+                } catch (const std::exception& ex) {
+                    sample::Trace("Scene fragment cache is not available: {}", ex.what());
+                }
+            }
+
             for (const auto& object : m_previewCubes) {
                 object->SetVisible(false);
                 AddObject(object);
@@ -243,12 +301,11 @@ namespace {
 
             // Check if the background thread finished creating a new group of visuals.
             if (m_scanState == ScanState::Processing && m_future.valid() && m_future.wait_for(0s) == std::future_status::ready) {
-                m_sceneVisuals.ForEachEngineObject([this](const std::shared_ptr<engine::Object>& object) { RemoveObject(object); });
-                m_sceneVisuals = m_future.get();
-                m_sceneVisuals.ForEachEngineObject([this](const std::shared_ptr<engine::Object>& object) { AddObject(object); });
+                ApplySceneVisuals(m_future.get());
                 m_scanState = ScanState::Idle;
                 m_nextUpdate = frameTime.Now + UpdateInterval;
             }
+            InstallSimplifiedPlaneMeshes();
 
             // Update the location of all scene objects
             if (m_sceneVisuals.scene) {
@@ -265,12 +322,18 @@ namespace {
                         scenePlane.id == m_highlightedPlanes[RightHand]) {
                         object->SetVisible(true);
                     }
-                    if (xr::math::Pose::IsPoseValid(location.flags)) {
+                    const bool poseValid = xr::math::Pose::IsPoseValid(location.flags);
+                    if (poseValid) {
                         object->Pose() = location.pose;
+                        m_planeSpatialIndex.SetPose(static_cast<XrUuidMSFT>(scenePlane.id), location.pose);
                     } else {
                         object->SetVisible(false);
                     }
+                    m_planeSpatialIndex.SetEnabled(static_cast<XrUuidMSFT>(scenePlane.id), poseValid);
                 }
+
+                // Only refits the bounds unless the set of planes changed.
+                m_planeSpatialIndex.Update();
             }
 
             XrSpaceLocation viewInLocal{XR_TYPE_SPACE_LOCATION};
@@ -279,7 +342,12 @@ namespace {
                 m_sceneBounds.sphereBounds[0].center = viewInLocal.pose.position;
             }
 
-            UpdatePlacedObjects(frameTime.PredictedDisplayTime);
+            // Anchors far from the viewer or at rest are located less often than every frame.
+            for (const sample::AnchorTrackingEvent& event :
+                 m_anchorManager.Update(m_context.AppSpace, frameTime.PredictedDisplayTime, m_sceneBounds.sphereBounds[0].center)) {
+                sample::Trace("Anchor {} tracking state changed from {} to {}", event.Anchor, (int)event.Previous, (int)event.Current);
+            }
+            UpdatePlacedObjects();
             m_handRays.OnUpdate(frameTime);
 
             if (m_scanState == ScanState::Waiting) {
@@ -287,10 +355,12 @@ namespace {
                 const XrSceneComputeStateMSFT state = m_sceneObserver->GetSceneComputeState();
                 if (state == XR_SCENE_COMPUTE_STATE_COMPLETED_MSFT) {
                     // Send the scene compute result to the background thread for processing
+                    // The processing state is only accessed by the background thread while processing.
                     m_future = std::async(std::launch::async,
                                           &CreateSceneVisuals,
                                           std::cref(m_context.PbrResources),
                                           m_planeMaterial,
+                                          std::ref(m_sceneProcessingState),
                                           m_sceneObserver->CreateScene());
                     m_scanState = ScanState::Processing;
                 } else if (state == XR_SCENE_COMPUTE_STATE_COMPLETED_WITH_ERROR_MSFT) {
@@ -305,7 +375,14 @@ namespace {
                     m_sceneBounds.time = m_lastTimeOfUpdate;
                     static const std::vector<XrSceneComputeFeatureMSFT> Features{XR_SCENE_COMPUTE_FEATURE_PLANE_MSFT,
                                                                                  XR_SCENE_COMPUTE_FEATURE_PLANE_MESH_MSFT};
-                    m_sceneObserver->ComputeNewScene(Features, m_sceneBounds);
+                    static const std::vector<XrSceneComputeFeatureMSFT> SerializedFeatures{XR_SCENE_COMPUTE_FEATURE_PLANE_MSFT,
+                                                                                           XR_SCENE_COMPUTE_FEATURE_PLANE_MESH_MSFT,
+                                                                                           XR_SCENE_COMPUTE_FEATURE_SERIALIZE_SCENE_MSFT};
+                    m_sceneProcessingState.cacheSceneFragments = m_sceneProcessingState.fragmentCache != nullptr;
+                    m_sceneProcessingState.consistency = SceneComputeConsistency;
+                    m_sceneObserver->ComputeNewScene(m_sceneProcessingState.cacheSceneFragments ? SerializedFeatures : Features,
+                                                     m_sceneBounds,
+                                                     m_sceneProcessingState.consistency);
 
                     m_nextUpdate = frameTime.Now + UpdateInterval;
                     m_scanState = ScanState::Waiting;
@@ -326,40 +403,36 @@ namespace {
                 return;
             }
 
-            std::vector<DistanceSortableIndices> objectsHit;
-            for (size_t i = 0; i < m_sceneVisuals.planes.size(); i++) {
-                const auto& plane = m_sceneVisuals.planes[i];
-                if (!xr::math::Pose::IsPoseValid(m_componentLocations[i].flags)) {
-                    continue;
-                }
+            const XMVECTOR rayPosition = xr::math::LoadXrVector3(handPose.position);
+            const XMVECTOR rayDirection = XMVector3Rotate(XMVectorSet(0, 0, -1, 0), xr::math::LoadXrQuaternion(handPose.orientation));
+
+            xr::su::SpatialRay ray{handPose.position};
+            xr::math::StoreXrVector3(&ray.direction, rayDirection);
+            const std::optional<xr::su::SpatialHit> closestHit = m_planeSpatialIndex.RaycastClosest(ray);
+
+            // Compute the placement pose on the closest plane only.
+            std::optional<PlaneHit> planeHit;
+            if (closestHit.has_value()) {
+                const size_t planeIndex = m_planeIndices.at(xr::su::ScenePlane::Id{closestHit->componentId});
+                const auto& plane = m_sceneVisuals.planes[planeIndex];
+
                 // Clockwise order
                 const float halfWidth = plane.size.width / 2.0f;
                 const float halfHeight = plane.size.height / 2.0f;
-                auto v0 = XMVectorSet(-halfWidth, -halfHeight, 0, 1);
-                auto v1 = XMVectorSet(-halfWidth, halfHeight, 0, 1);
-                auto v2 = XMVectorSet(halfWidth, halfHeight, 0, 1);
-                auto v3 = XMVectorSet(halfWidth, -halfHeight, 0, 1);
-                const auto matrix = xr::math::LoadXrPose(m_componentLocations[i].pose);
-                v0 = XMVector4Transform(v0, matrix);
-                v1 = XMVector4Transform(v1, matrix);
-                v2 = XMVector4Transform(v2, matrix);
-                v3 = XMVector4Transform(v3, matrix);
-
-                XMVECTOR rayPosition = xr::math::LoadXrVector3(handPose.position);
-
-                const auto forward = XMVectorSet(0, 0, -1, 0);
-                const auto rotation = xr::math::LoadXrQuaternion(handPose.orientation);
-                XMVECTOR rayDirection = XMVector3Rotate(forward, rotation);
+                const auto matrix = xr::math::LoadXrPose(m_componentLocations[planeIndex].pose);
+                const auto v0 = XMVector4Transform(XMVectorSet(-halfWidth, -halfHeight, 0, 1), matrix);
+                const auto v1 = XMVector4Transform(XMVectorSet(-halfWidth, halfHeight, 0, 1), matrix);
+                const auto v2 = XMVector4Transform(XMVectorSet(halfWidth, halfHeight, 0, 1), matrix);
+                const auto v3 = XMVector4Transform(XMVectorSet(halfWidth, -halfHeight, 0, 1), matrix);
 
                 XrPosef hitPose{};
                 float distance = 0.0f;
                 if (RayIntersectQuad(rayPosition, rayDirection, v0, v1, v2, v3, &hitPose, distance)) {
-                    objectsHit.push_back({distance, hitPose, i});
+                    planeHit = PlaneHit{distance, hitPose, planeIndex};
                 }
             }
-            if (!objectsHit.empty()) {
-                std::sort(objectsHit.begin(), objectsHit.end());
-                const DistanceSortableIndices& objectHit = objectsHit[0];
+            if (planeHit.has_value()) {
+                const PlaneHit& objectHit = planeHit.value();
                 const xr::su::ScenePlane& plane = m_sceneVisuals.planes[objectHit.planeIndex];
 
                 m_previewCubes[hand]->Pose() = objectHit.hitPose;
@@ -372,34 +445,19 @@ namespace {
                 }
 
                 if (raycastAction == RaycastAction::Activate) {
-                    PlacedObject placedObject;
-                    XrSpatialAnchorCreateInfoMSFT anchorCreateInfo{XR_TYPE_SPATIAL_ANCHOR_CREATE_INFO_MSFT};
-                    anchorCreateInfo.space = m_context.AppSpace;
-                    anchorCreateInfo.pose = objectHit.hitPose;
-                    anchorCreateInfo.time = time;
-                    XrResult result = xrCreateSpatialAnchorMSFT(
-                        m_context.Session.Handle, &anchorCreateInfo, placedObject.anchor.Put(xrDestroySpatialAnchorMSFT));
-                    if (XR_FAILED(result)) {
-                        if (result == XR_ERROR_CREATE_SPATIAL_ANCHOR_FAILED_MSFT) {
-                            sample::Trace("Anchor cannot be created, likely due to lost tracking. User should try again later");
-                            return;
-                        } else {
-                            CHECK_XRRESULT(result, "xrCreateSpatialAnchorMSFT");
-                        }
+                    // Placements close to an earlier one share its anchor.
+                    const std::optional<sample::PlacementId> placement = m_anchorManager.Place(m_context.AppSpace, objectHit.hitPose, time);
+                    if (!placement) {
+                        sample::Trace("Anchor cannot be created, likely due to lost tracking. User should try again later");
+                        return;
                     }
-                    XrSpatialAnchorSpaceCreateInfoMSFT anchorSpaceCreateInfo{XR_TYPE_SPATIAL_ANCHOR_SPACE_CREATE_INFO_MSFT};
-                    anchorSpaceCreateInfo.anchor = placedObject.anchor.Get();
-                    anchorSpaceCreateInfo.poseInAnchorSpace = xr::math::Pose::Identity();
-                    CHECK_XRCMD(xrCreateSpatialAnchorSpaceMSFT(
-                        m_context.Session.Handle, &anchorSpaceCreateInfo, placedObject.space.Put(xrDestroySpace)));
 
                     auto cube = CreatePlacementCube();
                     cube->Pose() = objectHit.hitPose;
                     AddObject(cube);
-                    placedObject.visual = cube;
 
                     m_visiblePlanes.insert(plane.id);
-                    m_placedObjects.emplace_back(std::move(placedObject));
+                    m_placedObjects.push_back(PlacedObject{placement.value(), std::move(cube)});
                 }
             }
         }
@@ -418,6 +476,7 @@ namespace {
         void Enable() {
             m_sceneObserver = std::make_unique<xr::su::SceneObserver>(m_context.Session.Handle);
             m_scanState = ScanState::Idle;
+            LoadCachedScene();
 
             const auto createPointerRay = [this](const std::shared_ptr<engine::PbrModelObject>& parent, const Pbr::RGBAColor& color) {
                 auto aimRay = AddObject(engine::CreateCube(m_context.PbrResources, {1.0f, 1.0f, 1.0f}, color));
@@ -432,29 +491,129 @@ namespace {
             m_handRays.SetPointerObjects(std::move(leftPointerObject), std::move(rightPointerObject));
         }
 
+        // Deserialize the environment saved by a previous session, so that placement works before the first scene compute completes.
+        // The deserialized scene is processed like a computed scene.
+        void LoadCachedScene() {
+            sample::SceneFragmentCache* const cache = m_sceneProcessingState.fragmentCache.get();
+            if (cache == nullptr || cache->Empty()) {
+                return;
+            }
+
+            try {
+                const std::vector<std::vector<uint8_t>> fragments = cache->LoadFragments();
+                if (!fragments.empty()) {
+                    xr::su::DeserializeScene(m_sceneObserver->Handle(), fragments);
+                    m_sceneProcessingState.cacheSceneFragments = false;
+                    m_scanState = ScanState::Waiting;
+                }
+            } catch (const std::exception& ex) {
+                sample::Trace("Failed to load the cached scene: {}", ex.what());
+                cache->Clear();
+            }
+        }
+
         void Disable() {
             m_sceneVisuals.ForEachEngineObject([this](const auto& object) { RemoveObject(object); });
             m_sceneVisuals = {};
+            m_pendingPlaneMeshes.clear();
+            m_planeSpatialIndex.Clear();
+            m_planeIndices.clear();
 
             // Stop the worker thread before clearing sceneObserver because the thread has access to it.
             if (m_future.valid()) {
                 m_future.get();
             }
+            m_sceneProcessingState.planeTracker.Reset();
+            m_sceneProcessingState.planeTypes.clear();
             m_sceneObserver = nullptr;
         }
 
+        // Replace the current scene visuals with the new ones, keeping the visuals of planes whose geometry and type did not change.
+        void ApplySceneVisuals(SceneVisuals newVisuals) {
+            std::unordered_map<xr::su::ScenePlane::Id, std::shared_ptr<engine::Object>> previousVisuals;
+            for (size_t i = 0; i < m_sceneVisuals.planes.size(); i++) {
+                previousVisuals.emplace(m_sceneVisuals.planes[i].id, std::move(m_sceneVisuals.visuals[i]));
+            }
+
+            for (size_t i = 0; i < newVisuals.planes.size(); i++) {
+                std::shared_ptr<engine::Object>& visual = newVisuals.visuals[i];
+                if (!visual) {
+                    // The plane tracker and the current visuals describe the same previous scene, so the visual should exist.
+                    // Create a new one rather than relying on that in release builds.
+                    auto it = previousVisuals.find(newVisuals.planes[i].id);
+                    if (it != previousVisuals.end()) {
+                        visual = std::move(it->second);
+                        previousVisuals.erase(it);
+                        continue;
+                    }
+
+                    const xr::su::ScenePlane& plane = newVisuals.planes[i];
+                    visual = CreatePlaneVisual(m_context.PbrResources, m_planeMaterial, plane, GetColor(newVisuals.planeTypes[i]));
+                    visual->SetVisible(false);
+                }
+                AddObject(visual);
+            }
+
+            // Remaining visuals belong to removed planes or to planes whose geometry or type was updated.
+            for (const auto& [id, visual] : previousVisuals) {
+                RemoveObject(visual);
+            }
+
+            for (PendingPlaneMesh& pendingMesh : newVisuals.pendingMeshes) {
+                m_pendingPlaneMeshes.push_back(std::move(pendingMesh));
+            }
+            newVisuals.pendingMeshes.clear();
+            m_sceneVisuals = std::move(newVisuals);
+
+            // Planes stay disabled in the spatial index until they are located in the app space by the next update.
+            m_planeSpatialIndex.Clear();
+            m_planeIndices.clear();
+            for (size_t i = 0; i < m_sceneVisuals.planes.size(); i++) {
+                const xr::su::ScenePlane& plane = m_sceneVisuals.planes[i];
+                m_planeSpatialIndex.AddOrUpdatePlane(static_cast<XrUuidMSFT>(plane.id), xr::math::Pose::Identity(), plane.size);
+                m_planeSpatialIndex.SetEnabled(static_cast<XrUuidMSFT>(plane.id), false);
+                m_planeIndices.emplace(plane.id, i);
+            }
+        }
+
+        // Replace the quads of plane visuals by the meshes of the planes once these were simplified.
+        void InstallSimplifiedPlaneMeshes() {
+            for (auto it = m_pendingPlaneMeshes.begin(); it != m_pendingPlaneMeshes.end();) {
+                if (it->mesh.wait_for(0s) != std::future_status::ready) {
+                    ++it;
+                    continue;
+                }
+
+                try {
+                    const sample::SimplifiedMesh mesh = it->mesh.get();
+                    if (!mesh.Indices.empty()) {
+                        it->visual->SetModel(
+                            CreateMeshModel(m_context.PbrResources, m_planeMaterial, mesh, it->color, it->planeSize, m_meshBuilder));
+                    }
+                } catch (const std::exception& ex) {
+                    sample::Trace("Failed to simplify a plane mesh: {}", ex.what());
+                }
+                it = m_pendingPlaneMeshes.erase(it);
+            }
+        }
+
         std::shared_ptr<engine::PbrModelObject> CreatePlacementCube() {
-            return engine::CreateCube(
-                m_context.PbrResources, {CubeSideLength, CubeSideLength, CubeSideLength}, Pbr::FromSRGB(Colors::Yellow));
+            const auto createCube = [&pbrResources = m_context.PbrResources] {
+                return engine::CreateCube(pbrResources, {CubeSideLength, CubeSideLength, CubeSideLength}, Pbr::FromSRGB(Colors::Yellow));
+            };
+
+            // Placed cubes accumulate over the session, so they may be evicted when out of sight and are recreated when seen again.
+            std::shared_ptr<engine::PbrModelObject> cube = createCube();
+            cube->EnableResidencyTracking(m_context.AssetResidency, [createCube] { return createCube()->GetModel(); });
+            return cube;
         }
 
-        void UpdatePlacedObjects(XrTime predictedDisplayTime) {
+        void UpdatePlacedObjects() {
             for (PlacedObject& placedObject : m_placedObjects) {
-                XrSpaceLocation spaceLocation{XR_TYPE_SPACE_LOCATION};
-                CHECK_XRCMD(xrLocateSpace(placedObject.space.Get(), m_context.AppSpace, predictedDisplayTime, &spaceLocation));
-                if (xr::math::Pose::IsPoseValid(spaceLocation)) {
+                const std::optional<XrPosef> pose = m_anchorManager.GetPlacementPose(placedObject.placement);
+                if (pose) {
                     placedObject.visual->SetVisible(true);
-                    placedObject.visual->Pose() = spaceLocation.pose;
+                    placedObject.visual->Pose() = pose.value();
                 } else {
                     placedObject.visual->SetVisible(false);
                 }
@@ -474,7 +633,13 @@ namespace {
         std::unique_ptr<xr::su::SceneObserver> m_sceneObserver;
         std::shared_ptr<Pbr::Material> m_planeMaterial;
         SceneVisuals m_sceneVisuals;
+        std::vector<PendingPlaneMesh> m_pendingPlaneMeshes;
+        Pbr::PrimitiveBuilder m_meshBuilder;
         std::future<SceneVisuals> m_future;
+        SceneProcessingState m_sceneProcessingState;
+        xr::su::SceneSpatialIndex m_planeSpatialIndex;
+        std::unordered_map<xr::su::ScenePlane::Id, size_t> m_planeIndices; // Index into m_sceneVisuals.planes
+        sample::SpatialAnchorManager m_anchorManager;
         std::vector<PlacedObject> m_placedObjects;
         std::array<std::shared_ptr<engine::Object>, HandCount> m_previewCubes;
         std::array<std::optional<xr::su::ScenePlane::Id>, HandCount> m_highlightedPlanes;
@@ -544,9 +709,12 @@ namespace {
         }
     }
 
+    // The mesh of a plane is in the space of the plane. Its texture coordinates continue those of the quad of the plane, see
+    // CreatePlaneVisual, so that both show the same tiles.
     void FillMeshPrimitiveBuilder(const std::vector<XrVector3f>& positions,
                                   const std::vector<uint32_t>& indices,
                                   const Pbr::RGBAColor& color,
+                                  const XrExtent2Df& planeSize,
                                   Pbr::PrimitiveBuilder& builder) {
         const size_t indexCount = indices.size();
         builder.Vertices.clear();
@@ -554,8 +722,10 @@ namespace {
         builder.Vertices.reserve(indexCount);
         builder.Indices.reserve(indexCount);
 
-        auto appendVertex = [&builder](const XMVECTOR& pos, Pbr::Vertex& vertex) {
+        auto appendVertex = [&builder, &planeSize](const XMVECTOR& pos, Pbr::Vertex& vertex) {
             XMStoreFloat3(&vertex.Position, pos);
+            vertex.TexCoord0 = {(vertex.Position.x + planeSize.width / 2) * PlaneTextureScale,
+                                (planeSize.height / 2 - vertex.Position.y) * PlaneTextureScale};
             builder.Indices.push_back(static_cast<uint32_t>(builder.Vertices.size()));
             builder.Vertices.push_back(vertex);
         };
@@ -578,31 +748,44 @@ namespace {
         }
     }
 
-    std::shared_ptr<engine::PbrModelObject> CreateMeshVisual(const Pbr::Resources& pbrResources,
-                                                             const std::shared_ptr<Pbr::Material>& material,
-                                                             XrSceneMSFT scene,
-                                                             uint64_t meshBufferId,
-                                                             Pbr::PrimitiveBuilder& builder,
-                                                             const Pbr::RGBAColor& color) {
+    // Read a mesh of the scene and simplify it on the thread pool. Returns an invalid future if the mesh is empty.
+    // The mesh is read on the calling thread, so the tasks of the thread pool make no OpenXR calls and need no input stream.
+    std::future<sample::SimplifiedMesh> SimplifyMeshBufferAsync(sample::ThreadPool& threadPool,
+                                                                XrSceneMSFT scene,
+                                                                uint64_t meshBufferId,
+                                                                XrSceneComputeConsistencyMSFT consistency) {
         std::vector<XrVector3f> vertexBuffer;
         std::vector<uint32_t> indexBuffer;
         xr::ReadMeshBuffers(scene, meshBufferId, vertexBuffer, indexBuffer);
         if (indexBuffer.empty() || vertexBuffer.empty()) {
-            return nullptr;
+            return {};
         }
-        FillMeshPrimitiveBuilder(vertexBuffer, indexBuffer, color, builder);
+
+        // Raw scene meshes are dense and contain duplicated vertices, so simplify them before creating GPU buffers.
+        // Normals are not generated because the mesh is drawn with flat per-triangle normals.
+        sample::MeshSimplificationOptions options = sample::GetMeshSimplificationOptions(consistency);
+        options.GenerateNormals = false;
+        return sample::SimplifyMeshAsync(threadPool, std::move(vertexBuffer), std::move(indexBuffer), options);
+    }
+
+    std::shared_ptr<Pbr::Model> CreateMeshModel(const Pbr::Resources& pbrResources,
+                                                const std::shared_ptr<Pbr::Material>& material,
+                                                const sample::SimplifiedMesh& mesh,
+                                                const Pbr::RGBAColor& color,
+                                                const XrExtent2Df& planeSize,
+                                                Pbr::PrimitiveBuilder& builder) {
+        FillMeshPrimitiveBuilder(mesh.Positions, mesh.Indices, color, planeSize, builder);
         auto model = std::make_shared<Pbr::Model>();
         model->AddPrimitive(Pbr::Primitive(pbrResources, builder, material));
-        return std::make_shared<engine::PbrModelObject>(std::move(model));
+        return model;
     }
 
     std::shared_ptr<engine::PbrModelObject> CreatePlaneVisual(const Pbr::Resources& pbrResources,
                                                               const std::shared_ptr<Pbr::Material>& material,
                                                               const xr::su::ScenePlane& scenePlane,
                                                               const Pbr::RGBAColor& color) {
-        constexpr float TextureScale = 5.0f;
         const DirectX::XMFLOAT2 sideLengths{scenePlane.size.width, scenePlane.size.height};
-        const DirectX::XMFLOAT2 textureCoord{sideLengths.x * TextureScale, sideLengths.y * TextureScale};
+        const DirectX::XMFLOAT2 textureCoord{sideLengths.x * PlaneTextureScale, sideLengths.y * PlaneTextureScale};
         auto model = std::make_shared<Pbr::Model>();
         model->AddPrimitive(
             Pbr::Primitive(pbrResources, Pbr::PrimitiveBuilder().AddQuad(sideLengths, textureCoord, Pbr::RootNodeIndex, color), material));
@@ -620,6 +803,7 @@ namespace {
 
     SceneVisuals CreateSceneVisuals(const Pbr::Resources& pbrResources,
                                     const std::shared_ptr<Pbr::Material>& material,
+                                    SceneProcessingState& processingState,
                                     std::unique_ptr<xr::su::Scene> scene) {
         static const std::vector<xr::su::SceneObject::Type> typeFilter{XR_SCENE_OBJECT_TYPE_BACKGROUND_MSFT,
                                                                        XR_SCENE_OBJECT_TYPE_WALL_MSFT,
@@ -627,24 +811,85 @@ namespace {
                                                                        XR_SCENE_OBJECT_TYPE_CEILING_MSFT,
                                                                        XR_SCENE_OBJECT_TYPE_PLATFORM_MSFT,
                                                                        XR_SCENE_OBJECT_TYPE_INFERRED_MSFT};
+        // Runs on the scene processing thread, whose calls are recorded and replayed apart from the update thread.
+        // std::async may reuse the thread for other tasks, so its default stream is restored afterwards.
+        sample::InputCapture::SetThreadStream(SceneProcessingInputStream);
+        auto restoreInputStream = MakeScopeGuard([] { sample::InputCapture::SetThreadStream(0); });
+
         std::vector<std::shared_ptr<engine::Object>> visuals;
         std::vector<XrUuidMSFT> componentIds;
-        Pbr::PrimitiveBuilder builder;
+        std::vector<XrSceneObjectTypeMSFT> planeTypes;
+        std::vector<PendingPlaneMesh> pendingMeshes;
 
+        processingState.componentReader.GetObjects(scene->Handle(), processingState.sceneObjects, typeFilter);
         const std::unordered_map<xr::su::SceneObject::Id, XrSceneObjectTypeMSFT> sceneObjectIdToType =
-            CreateTypeMap(scene->GetObjects(typeFilter));
+            CreateTypeMap(processingState.sceneObjects);
+
+        // The planes are kept by the returned SceneVisuals, so they are read into a new vector.
+        std::vector<xr::su::ScenePlane> planes;
+        processingState.componentReader.GetPlanes(scene->Handle(), planes, {}, typeFilter);
+        const xr::su::SceneComponentDiff<xr::su::ScenePlane> diff = processingState.planeTracker.Update(planes);
+
+        // Only create visuals for new planes and planes whose geometry changed. The others are reused by the caller, unless the
+        // type of their scene object changed, since the color of a visual depends on it.
+        std::unordered_set<xr::su::ScenePlane::Id> reusableVisuals;
+        for (const xr::su::ScenePlane& scenePlane : diff.poseUpdated) {
+            reusableVisuals.insert(scenePlane.id);
+        }
+        for (const xr::su::ScenePlane& scenePlane : diff.unchanged) {
+            reusableVisuals.insert(scenePlane.id);
+        }
 
-        auto planes = scene->GetPlanes(typeFilter);
+        visuals.reserve(planes.size());
+        componentIds.reserve(planes.size());
+        planeTypes.reserve(planes.size());
         for (const xr::su::ScenePlane& scenePlane : planes) {
             const XrSceneObjectTypeMSFT type = sceneObjectIdToType.at(scenePlane.parentId);
-            std::shared_ptr<engine::PbrModelObject> obj = CreatePlaneVisual(pbrResources, material, scenePlane, GetColor(type));
-            if (obj != nullptr) {
+            planeTypes.push_back(type);
+            const auto previousType = processingState.planeTypes.find(scenePlane.id);
+            const bool typeChanged = previousType == processingState.planeTypes.end() || previousType->second != type;
+            if (reusableVisuals.count(scenePlane.id) != 0 && !typeChanged) {
+                visuals.push_back(nullptr);
+            } else {
+                std::shared_ptr<engine::PbrModelObject> obj = CreatePlaneVisual(pbrResources, material, scenePlane, GetColor(type));
                 obj->SetVisible(false);
+
+                // The plane is drawn as a quad until its mesh was simplified.
+                if (scenePlane.meshBufferId != 0) {
+                    std::future<sample::SimplifiedMesh> mesh = SimplifyMeshBufferAsync(
+                        processingState.meshThreadPool, scene->Handle(), scenePlane.meshBufferId, processingState.consistency);
+                    if (mesh.valid()) {
+                        pendingMeshes.push_back(PendingPlaneMesh{obj, GetColor(type), scenePlane.size, std::move(mesh)});
+                    }
+                }
                 visuals.push_back(std::move(obj));
-                componentIds.push_back(static_cast<XrUuidMSFT>(scenePlane.id));
+            }
+            componentIds.push_back(static_cast<XrUuidMSFT>(scenePlane.id));
+        }
+
+        processingState.planeTypes.clear();
+        for (size_t i = 0; i < planes.size(); i++) {
+            processingState.planeTypes.emplace(planes[i].id, planeTypes[i]);
+        }
+
+        if (processingState.fragmentCache && processingState.cacheSceneFragments) {
+            try {
+                const sample::SceneFragmentCacheStats stats = processingState.fragmentCache->Update(scene->Handle());
+                sample::Trace("Scene fragment cache: {} fragments, {} written, {} unchanged, {} removed",
+                              stats.FragmentCount,
+                              stats.WrittenCount,
+                              stats.UnchangedCount,
+                              stats.RemovedCount);
+            } catch (const std::exception& ex) {
+                sample::Trace("Failed to update the scene fragment cache: {}", ex.what());
             }
         }
-        return SceneVisuals(std::move(scene), std::move(componentIds), std::move(planes), std::move(visuals));
+        return SceneVisuals(std::move(scene),
+                            std::move(componentIds),
+                            std::move(planes),
+                            std::move(planeTypes),
+                            std::move(visuals),
+                            std::move(pendingMeshes));
     }
 
     std::shared_ptr<Pbr::Material> CreateTextureMaterial(Pbr::Resources& pbr) {
@@ -5,6 +5,7 @@
 #include <winrt/Windows.Storage.h>
 #include <winrt/Windows.Security.Cryptography.h>
 #include <XrUtility/XrString.h>
+#include <XrUtility/XrSceneUnderstanding.hpp>
 #include <pbr/GltfLoader.h>
 #include <SampleShared/FileUtility.h>
 #include <SampleShared/TextureUtility.h>
@@ -122,18 +123,13 @@ namespace {
         }
 
         bool ShouldSwitchFilter() {
-            XrActionStateBoolean switchFilterState{XR_TYPE_ACTION_STATE_BOOLEAN};
-            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-            getInfo.action = m_switchFilterAction;
-
-            getInfo.subactionPath = m_context.Instance.RightHandPath;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &switchFilterState));
+            XrActionStateBoolean switchFilterState =
+                ActionContext().GetBooleanState(m_switchFilterAction, m_context.Instance.RightHandPath);
             if (switchFilterState.isActive && switchFilterState.changedSinceLastSync && switchFilterState.currentState) {
                 return true;
             }
 
-            getInfo.subactionPath = m_context.Instance.LeftHandPath;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &switchFilterState));
+            switchFilterState = ActionContext().GetBooleanState(m_switchFilterAction, m_context.Instance.LeftHandPath);
             if (switchFilterState.isActive && switchFilterState.changedSinceLastSync && switchFilterState.currentState) {
                 return true;
             }
@@ -344,56 +340,23 @@ namespace {
             XrSceneCreateInfoMSFT createInfo{XR_TYPE_SCENE_CREATE_INFO_MSFT};
             CHECK_XRCMD(xrCreateSceneMSFT(m_sceneObserver.Get(), &createInfo, m_scene.Put(xrDestroySceneMSFT)));
 
-            XrSceneComponentsGetInfoMSFT getInfo{XR_TYPE_SCENE_COMPONENTS_GET_INFO_MSFT};
-            getInfo.componentType = XR_SCENE_COMPONENT_TYPE_MARKER_MSFT;
-
-            std::vector<XrSceneMarkerTypeMSFT> markerTypes{XrSceneMarkerTypeMSFT::XR_SCENE_MARKER_TYPE_QR_CODE_MSFT};
-            XrSceneMarkerTypeFilterMSFT typesFilter{XR_TYPE_SCENE_MARKER_TYPE_FILTER_MSFT};
-            typesFilter.markerTypeCount = static_cast<uint32_t>(markerTypes.size());
-            typesFilter.markerTypes = markerTypes.data();
-            xr::InsertExtensionStruct(getInfo, typesFilter);
-            XrSceneComponentsMSFT sceneComponents{XR_TYPE_SCENE_COMPONENTS_MSFT};
-
-
-            // Get the number of markers
-            CHECK_XRCMD(xrGetSceneComponentsMSFT(m_scene.Get(), &getInfo, &sceneComponents));
-            const uint32_t count = sceneComponents.componentCountOutput;
-
-            std::vector<XrSceneComponentMSFT> components(count);
-            sceneComponents.componentCapacityInput = count;
-            sceneComponents.components = components.data();
-
-            std::vector<XrSceneMarkerMSFT> markers(count);
-            XrSceneMarkersMSFT sceneMarkers{XR_TYPE_SCENE_MARKERS_MSFT};
-            sceneMarkers.sceneMarkerCapacityInput = count;
-            sceneMarkers.sceneMarkers = markers.data();
-            xr::InsertExtensionStruct(sceneComponents, sceneMarkers);
-
-            std::vector<XrSceneMarkerQRCodeMSFT> qrcodes(count);
-            XrSceneMarkerQRCodesMSFT sceneQRCodes{XR_TYPE_SCENE_MARKER_QR_CODES_MSFT};
-            sceneQRCodes.qrCodeCapacityInput = count;
-            sceneQRCodes.qrCodes = qrcodes.data();
-            xr::InsertExtensionStruct(sceneComponents, sceneQRCodes);
-
-
-            CHECK_XRCMD(xrGetSceneComponentsMSFT(m_scene.Get(), &getInfo, &sceneComponents));
+            // 6. Call xrGetSceneComponentsMSFT with XrSceneMarkersMSFT and XrSceneMarkerQRCodesMSFT chained to read the markers.
+            // The reader reuses its buffers across updates, so the count query is usually skipped.
+            m_componentReader.GetQRCodes(m_scene.Get(), m_qrCodes);
 
             // Get or create visuals for all QR Codes not too obsolete
             decltype(m_markerVisuals) markerVisuals;
-            for (uint32_t i = 0; i < count; ++i) {
-                const XrDuration markerAgeNanos = predictedDisplayTime - markers[i].lastSeenTime;
+            for (const xr::su::SceneQRCode& qrCode : m_qrCodes) {
+                const XrDuration markerAgeNanos = predictedDisplayTime - qrCode.lastSeenTime;
                 std::chrono::nanoseconds markerAge = duration<XrDuration, std::nano>(markerAgeNanos);
                 std::chrono::duration<float> markerAgeSeconds = markerAge;
                 if (markerAge < MaxMarkerAge) {
-                    auto& markerId = components[i].id;
+                    const XrUuidMSFT markerId = static_cast<XrUuidMSFT>(qrCode.id);
 
                     // Always re-create to enable color change and dimension change
-                    auto visual = CreateMarkerVisual(markerId,
-                                                     markers[i],
-                                                     qrcodes[i],
-                                                     markerAgeSeconds.count());
+                    auto visual = CreateMarkerVisual(markerId, qrCode, markerAgeSeconds.count());
                     XrQuaternionf rotation = xr::math::Quaternion::RotationAxisAngle(XrVector3f{1.0f, 0.0f, 0.0f}, XM_PI);
-                    XrVector3f centerOffset{markers[i].center.x, markers[i].center.y, 0.0f};
+                    XrVector3f centerOffset{qrCode.center.x, qrCode.center.y, 0.0f};
                     auto centerToPose = xr::math::Pose::MakePose(rotation, centerOffset);
                     markerVisuals[markerId] = std::make_pair(centerToPose, visual);
                     AddObject(visual);
@@ -415,15 +378,14 @@ namespace {
 
         // Create a Quad which covers the marker and displays the marker's string as text
         std::shared_ptr<engine::PbrModelObject> CreateMarkerVisual(const XrUuidMSFT& markerId,
-                                                                   const XrSceneMarkerMSFT& marker,
-                                                                   const XrSceneMarkerQRCodeMSFT& qrcode,
+                                                                   const xr::su::SceneQRCode& qrcode,
                                                                    float ageSeconds) {
             uint32_t stringLength{0};
             std::vector<char> markerString;
             CHECK_XRCMD(xrGetSceneMarkerDecodedStringMSFT(m_scene.Get(), &markerId, 0, &stringLength, nullptr));
             markerString.resize(stringLength);
             CHECK_XRCMD(xrGetSceneMarkerDecodedStringMSFT(m_scene.Get(), &markerId, stringLength, &stringLength, markerString.data()));
-            const DirectX::XMFLOAT2 size{marker.size.width, marker.size.height};
+            const DirectX::XMFLOAT2 size{qrcode.size.width, qrcode.size.height};
             const bool isMicroQR =
                 (qrcode.symbolType == XrSceneMarkerQRCodeSymbolTypeMSFT::XR_SCENE_MARKER_QR_CODE_SYMBOL_TYPE_MICRO_QR_CODE_MSFT);
             const auto& pbrResources = m_context.PbrResources;
@@ -447,6 +409,8 @@ namespace {
         // The XrSceneObserver needs to be destroyed after the XrScene.
         xr::UniqueXrHandle<XrSceneObserverMSFT> m_sceneObserver;
         xr::UniqueXrHandle<XrSceneMSFT> m_scene;
+        xr::su::SceneComponentReader m_componentReader;
+        std::vector<xr::su::SceneQRCode> m_qrCodes;
         std::vector<XrUuidMSFT> m_markerIds;
         std::vector<XrSceneComponentLocationMSFT> m_componentLocations;
         std::unordered_map<XrUuidMSFT, std::pair<XrPosef, std::shared_ptr<engine::PbrModelObject>>> m_markerVisuals;
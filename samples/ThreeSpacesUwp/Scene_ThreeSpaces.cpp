@@ -100,18 +100,12 @@ namespace {
         }
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
-            XrActionStateBoolean selectState{XR_TYPE_ACTION_STATE_BOOLEAN};
-            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-            getInfo.action = m_selectAction;
-
-            getInfo.subactionPath = m_context.Instance.RightHandPath;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &selectState));
+            XrActionStateBoolean selectState = ActionContext().GetBooleanState(m_selectAction, m_context.Instance.RightHandPath);
             if (selectState.isActive && selectState.changedSinceLastSync && selectState.currentState) {
                 PlaceThreeSpaces(m_rightAimSpace.Get(), selectState.lastChangeTime);
             }
 
-            getInfo.subactionPath = m_context.Instance.LeftHandPath;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &selectState));
+            selectState = ActionContext().GetBooleanState(m_selectAction, m_context.Instance.LeftHandPath);
             if (selectState.isActive && selectState.changedSinceLastSync && selectState.currentState) {
                 PlaceThreeSpaces(m_leftAimSpace.Get(), selectState.lastChangeTime);
             }
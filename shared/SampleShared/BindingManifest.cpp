@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include "XrActionContext.h"
+#include "BindingManifest.h"
+
+namespace {
+    std::string_view Trim(std::string_view text) {
+        const size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        const size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool StartsWith(std::string_view text, std::string_view prefix) {
+        return text.substr(0, prefix.size()) == prefix;
+    }
+
+    bool HasWhitespace(std::string_view text) {
+        return text.find_first_of(" \t") != std::string_view::npos;
+    }
+
+    // Expand every {a,b,...} group of the path into one path for each alternative.
+    void ExpandAlternatives(std::string_view path, std::vector<std::string>& expanded) {
+        const size_t open = path.find('{');
+        if (open == std::string_view::npos) {
+            expanded.emplace_back(path);
+            return;
+        }
+        const size_t close = path.find('}', open);
+        if (close == std::string_view::npos) {
+            throw std::invalid_argument("missing '}'");
+        }
+
+        const std::string_view prefix = path.substr(0, open);
+        const std::string_view suffix = path.substr(close + 1);
+        std::string_view alternatives = path.substr(open + 1, close - open - 1);
+        while (true) {
+            const size_t comma = alternatives.find(',');
+            std::string alternative(prefix);
+            alternative += Trim(alternatives.substr(0, comma));
+            alternative += suffix;
+            ExpandAlternatives(alternative, expanded);
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            alternatives.remove_prefix(comma + 1);
+        }
+    }
+
+    // OpenXR action names may only contain lower case letters, digits, '-', '_' and '.'.
+    bool IsValidActionName(std::string_view name) {
+        return !name.empty() && std::all_of(name.begin(), name.end(), [](char c) {
+            return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+        });
+    }
+
+    bool IsKnownExtension(std::string_view extensionName) {
+#define RETURN_TRUE_IF_MATCH(name, _) \
+    if (extensionName == #name) {     \
+        return true;                  \
+    }
+
+        XR_LIST_EXTENSIONS(RETURN_TRUE_IF_MATCH)
+        XR_LIST_EXTENSIONS_MSFT_PREVIEW(RETURN_TRUE_IF_MATCH)
+
+#undef RETURN_TRUE_IF_MATCH
+        return false;
+    }
+
+    [[noreturn]] void ThrowManifestErrors(const std::vector<std::string>& errors) {
+        std::string message = "Invalid binding manifest:";
+        for (const std::string& error : errors) {
+            message += "\n  ";
+            message += error;
+        }
+        throw std::invalid_argument(message);
+    }
+} // namespace
+
+namespace sample {
+    BindingManifest ParseBindingManifest(std::string_view text) {
+        BindingManifest manifest;
+        std::vector<std::string> errors;
+
+        // Profiles of the current group of consecutive headers.
+        size_t groupBegin = 0;
+        bool groupHasBindings = true;
+
+        uint32_t lineNumber = 0;
+        while (!text.empty()) {
+            const size_t lineEnd = text.find('\n');
+            const std::string_view line = Trim(text.substr(0, lineEnd));
+            text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+            lineNumber++;
+
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            if (line[0] == '[') {
+                const size_t close = line.find(']');
+                if (close == std::string_view::npos) {
+                    errors.push_back(fmt::format("line {}: missing ']'", lineNumber));
+                    continue;
+                }
+
+                if (groupHasBindings) {
+                    groupBegin = manifest.profiles.size();
+                    groupHasBindings = false;
+                }
+
+                BindingManifest::Profile& profile = manifest.profiles.emplace_back();
+                profile.interactionProfile = Trim(line.substr(1, close - 1));
+                profile.requiredExtension = Trim(line.substr(close + 1));
+                profile.line = lineNumber;
+                continue;
+            }
+
+            const size_t equal = line.find('=');
+            if (equal == std::string_view::npos) {
+                errors.push_back(fmt::format("line {}: expected '[interaction profile]' or 'action = binding'", lineNumber));
+                continue;
+            }
+            if (groupBegin == manifest.profiles.size()) {
+                errors.push_back(fmt::format("line {}: binding before the first interaction profile", lineNumber));
+                continue;
+            }
+
+            const std::string actionName(Trim(line.substr(0, equal)));
+            std::vector<std::string> paths;
+            try {
+                ExpandAlternatives(Trim(line.substr(equal + 1)), paths);
+            } catch (const std::invalid_argument& ex) {
+                errors.push_back(fmt::format("line {}: {}", lineNumber, ex.what()));
+                continue;
+            }
+
+            groupHasBindings = true;
+            for (size_t i = groupBegin; i < manifest.profiles.size(); i++) {
+                for (const std::string& path : paths) {
+                    manifest.profiles[i].bindings.push_back({actionName, path, lineNumber});
+                }
+            }
+        }
+
+        for (std::string& error : ValidateBindingManifest(manifest)) {
+            errors.push_back(std::move(error));
+        }
+        if (!errors.empty()) {
+            ThrowManifestErrors(errors);
+        }
+        return manifest;
+    }
+
+    std::vector<std::string> ValidateBindingManifest(const BindingManifest& manifest) {
+        std::vector<std::string> errors;
+        std::set<std::string_view> profiles;
+
+        for (const BindingManifest::Profile& profile : manifest.profiles) {
+            const std::string_view profilePath = profile.interactionProfile;
+            if (!StartsWith(profilePath, "/interaction_profiles/") || HasWhitespace(profilePath)) {
+                errors.push_back(fmt::format("line {}: invalid interaction profile '{}'", profile.line, profilePath));
+            }
+            if (!profiles.insert(profilePath).second) {
+                errors.push_back(fmt::format("line {}: interaction profile '{}' is declared more than once", profile.line, profilePath));
+            }
+            if (HasWhitespace(profile.requiredExtension)) {
+                errors.push_back(fmt::format("line {}: expected a single extension name after the profile", profile.line));
+            } else if (!profile.requiredExtension.empty() && !IsKnownExtension(profile.requiredExtension)) {
+                errors.push_back(fmt::format("line {}: unknown extension '{}'", profile.line, profile.requiredExtension));
+            }
+            if (profile.bindings.empty()) {
+                errors.push_back(fmt::format("line {}: interaction profile '{}' has no bindings", profile.line, profilePath));
+            }
+
+            std::set<std::pair<std::string_view, std::string_view>> bindings;
+            for (const BindingManifest::Binding& binding : profile.bindings) {
+                if (!IsValidActionName(binding.actionName)) {
+                    errors.push_back(fmt::format("line {}: invalid action name '{}'", binding.line, binding.actionName));
+                }
+                const std::string_view path = binding.path;
+                if (!StartsWith(path, "/user/") || HasWhitespace(path) ||
+                    (path.find("/input/") == std::string_view::npos && path.find("/output/") == std::string_view::npos)) {
+                    errors.push_back(fmt::format("line {}: invalid binding path '{}'", binding.line, path));
+                }
+                if (!bindings.emplace(binding.actionName, path).second) {
+                    errors.push_back(fmt::format("line {}: duplicate binding '{}' for '{}'", binding.line, path, binding.actionName));
+                }
+            }
+        }
+        return errors;
+    }
+
+    BindingManifestValidation ValidateBindingManifest(const BindingManifest& manifest, const xr::EnabledExtensions& extensions) {
+        BindingManifestValidation validation;
+        validation.errors = ValidateBindingManifest(manifest);
+        for (const BindingManifest::Profile& profile : manifest.profiles) {
+            if (!profile.requiredExtension.empty() && !extensions.IsEnabled(profile.requiredExtension)) {
+                validation.skippedProfiles.push_back(fmt::format("line {}: interaction profile '{}' requires disabled extension '{}'",
+                                                                 profile.line,
+                                                                 profile.interactionProfile,
+                                                                 profile.requiredExtension));
+            }
+        }
+        return validation;
+    }
+
+    void SuggestManifestBindings(ActionContext& actionContext, const BindingManifest& manifest, const xr::EnabledExtensions& extensions) {
+        BindingManifestValidation validation = ValidateBindingManifest(manifest, extensions);
+        if (!validation.errors.empty()) {
+            ThrowManifestErrors(validation.errors);
+        }
+        for (const std::string& skippedProfile : validation.skippedProfiles) {
+            sample::Trace("Binding manifest {}", skippedProfile);
+        }
+
+        std::vector<std::string> errors;
+        for (const BindingManifest::Profile& profile : manifest.profiles) {
+            if (!profile.requiredExtension.empty() && !extensions.IsEnabled(profile.requiredExtension)) {
+                continue;
+            }
+
+            std::vector<ActionContext::ActionBinding> bindings;
+            bindings.reserve(profile.bindings.size());
+            for (const BindingManifest::Binding& binding : profile.bindings) {
+                const XrAction action = actionContext.FindAction(binding.actionName);
+                if (action == XR_NULL_HANDLE) {
+                    errors.push_back(fmt::format("line {}: unknown action '{}'", binding.line, binding.actionName));
+                    continue;
+                }
+                bindings.push_back({action, binding.path});
+            }
+            actionContext.SuggestInteractionProfileBindings(profile.interactionProfile.c_str(), bindings);
+        }
+
+        if (!errors.empty()) {
+            ThrowManifestErrors(errors);
+        }
+    }
+} // namespace sample
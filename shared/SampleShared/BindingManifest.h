@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <XrUtility/XrEnabledExtensions.h>
+
+namespace sample {
+    struct ActionContext;
+
+    //
+    // A binding manifest declares the suggested bindings of the actions of a scene for all interaction profiles in one table.
+    //
+    //     # Comments start with '#'.
+    //     [/interaction_profiles/khr/simple_controller]
+    //     [/interaction_profiles/microsoft/hand_interaction] XR_MSFT_hand_interaction
+    //     grip_pose = /user/hand/{left,right}/input/grip/pose
+    //
+    // Consecutive profile headers share the bindings that follow them. A header may name an extension that must be enabled
+    // for its profile to be suggested. Bindings refer to actions by name, and a {a,b} group in a binding path expands to one
+    // binding for each alternative.
+    //
+    struct BindingManifest {
+        struct Binding {
+            std::string actionName;
+            std::string path;
+            uint32_t line;
+        };
+
+        struct Profile {
+            std::string interactionProfile;
+            std::string requiredExtension; // Empty if the profile does not depend on an extension.
+            std::vector<Binding> bindings;
+            uint32_t line;
+        };
+
+        std::vector<Profile> profiles;
+    };
+
+    // Parse and validate a manifest. Throws std::invalid_argument listing the line of each syntax or validation error.
+    BindingManifest ParseBindingManifest(std::string_view text);
+
+    // Returns a description of each problem found in the manifest, e.g. malformed paths, duplicate bindings or unknown extensions.
+    std::vector<std::string> ValidateBindingManifest(const BindingManifest& manifest);
+
+    struct BindingManifestValidation {
+        std::vector<std::string> errors;          // Problems that make the manifest invalid, as for ValidateBindingManifest.
+        std::vector<std::string> skippedProfiles; // Profiles that are not suggested because their extension is not enabled.
+    };
+
+    // Validate a manifest against the extensions enabled for an instance.
+    BindingManifestValidation ValidateBindingManifest(const BindingManifest& manifest, const xr::EnabledExtensions& extensions);
+
+    // Suggest the bindings of all profiles whose extension is enabled to the action context, and trace the skipped profiles.
+    // Throws std::invalid_argument if the manifest is invalid or refers to an action the context does not have.
+    void SuggestManifestBindings(ActionContext& actionContext, const BindingManifest& manifest, const xr::EnabledExtensions& extensions);
+} // namespace sample
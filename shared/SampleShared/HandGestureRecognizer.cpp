@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <algorithm>
+#include "HandGestureRecognizer.h"
+
+namespace {
+    constexpr uint32_t JointCount = XR_HAND_JOINT_COUNT_EXT;
+    constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+} // namespace
+
+namespace sample {
+    HandGestureRecognizer::HandGestureRecognizer(uint32_t handCount)
+        : m_laneCount(handCount * JointCount) {
+        for (std::vector<float>* lanes : {&m_positionX, &m_positionY, &m_positionZ, &m_radius, &m_previousX, &m_previousY, &m_previousZ}) {
+            lanes->resize(m_laneCount);
+        }
+        m_valid.resize(m_laneCount);
+        m_previousValid.resize(m_laneCount);
+    }
+
+    uint32_t HandGestureRecognizer::AddGesture(GestureDescription description) {
+        if (description.Steps.empty()) {
+            throw std::invalid_argument("A gesture needs at least one step");
+        }
+
+        Gesture gesture;
+        for (const GestureStep& step : description.Steps) {
+            const uint32_t begin = static_cast<uint32_t>(m_predicateMeasurement.size());
+            for (const GesturePredicate& predicate : step.Predicates) {
+                m_predicateMeasurement.push_back(GetMeasurementIndex(predicate));
+                m_predicateMin.push_back(predicate.Min);
+                m_predicateMax.push_back(predicate.Max);
+                m_predicateHysteresis.push_back(predicate.Hysteresis);
+                m_predicateHolds.push_back(false);
+            }
+            gesture.StepPredicates.emplace_back(begin, static_cast<uint32_t>(m_predicateMeasurement.size()));
+        }
+        gesture.Description = std::move(description);
+
+        m_gestures.push_back(std::move(gesture));
+        return static_cast<uint32_t>(m_gestures.size() - 1);
+    }
+
+    // Predicates of different gestures on the same joints share one measurement.
+    uint32_t HandGestureRecognizer::GetMeasurementIndex(const GesturePredicate& predicate) {
+        Measurement measurement{predicate.Measure, {}};
+        for (uint32_t k = 0; k < 3; k++) {
+            const HandJointRef& joint = predicate.Joints[k];
+            if (joint.Joint >= JointCount || (joint.Hand + 1) * JointCount > m_laneCount) {
+                throw std::out_of_range("Gesture predicate joint is out of range");
+            }
+            measurement.Lanes[k] = joint.Hand * JointCount + joint.Joint;
+        }
+
+        // Distances and angles do not depend on the order of the end points.
+        if (measurement.Measure == GestureMeasure::Distance && measurement.Lanes[0] > measurement.Lanes[1]) {
+            std::swap(measurement.Lanes[0], measurement.Lanes[1]);
+        } else if (measurement.Measure == GestureMeasure::Angle && measurement.Lanes[0] > measurement.Lanes[2]) {
+            std::swap(measurement.Lanes[0], measurement.Lanes[2]);
+        }
+
+        const auto it = std::find_if(m_measurements.begin(), m_measurements.end(), [&](const Measurement& existing) {
+            return existing.Measure == measurement.Measure &&
+                   std::equal(std::begin(existing.Lanes), std::end(existing.Lanes), std::begin(measurement.Lanes));
+        });
+        if (it != m_measurements.end()) {
+            return static_cast<uint32_t>(std::distance(m_measurements.begin(), it));
+        }
+
+        m_measurements.push_back(measurement);
+        m_measuredValues.push_back(NaN);
+        return static_cast<uint32_t>(m_measurements.size() - 1);
+    }
+
+    void HandGestureRecognizer::SetJoints(uint32_t hand, bool isActive, const XrHandJointLocationEXT* locations) {
+        constexpr XrSpaceLocationFlags PositionValid = XR_SPACE_LOCATION_POSITION_VALID_BIT;
+        const uint32_t base = hand * JointCount;
+        if (base + JointCount > m_laneCount) {
+            throw std::out_of_range("Hand index is out of range");
+        }
+
+        for (uint32_t k = 0; k < JointCount; k++) {
+            const XrHandJointLocationEXT& location = locations[k];
+            m_positionX[base + k] = location.pose.position.x;
+            m_positionY[base + k] = location.pose.position.y;
+            m_positionZ[base + k] = location.pose.position.z;
+            m_radius[base + k] = location.radius;
+            m_valid[base + k] = isActive && (location.locationFlags & PositionValid) != 0;
+        }
+    }
+
+    const std::vector<GestureEvent>& HandGestureRecognizer::Update(XrTime time) {
+        m_events.clear();
+
+        MeasureJoints(time);
+
+        // Evaluate all predicates, widening the range of the ones that held in the last update.
+        // A NaN measurement fails both comparisons.
+        for (size_t i = 0; i < m_predicateMeasurement.size(); i++) {
+            const float value = m_measuredValues[m_predicateMeasurement[i]];
+            const float margin = m_predicateHolds[i] ? m_predicateHysteresis[i] : 0.0f;
+            m_predicateHolds[i] = value >= m_predicateMin[i] - margin && value <= m_predicateMax[i] + margin;
+        }
+
+        for (uint32_t gestureId = 0; gestureId < m_gestures.size(); gestureId++) {
+            UpdateGesture(gestureId, m_gestures[gestureId], time);
+        }
+        return m_events;
+    }
+
+    void HandGestureRecognizer::MeasureJoints(XrTime time) {
+        const float deltaTime = m_previousTime != 0 && time > m_previousTime ? (time - m_previousTime) * 1e-9f : 0.0f;
+
+        for (size_t m = 0; m < m_measurements.size(); m++) {
+            const Measurement& measurement = m_measurements[m];
+            const uint32_t a = measurement.Lanes[0];
+            const uint32_t b = measurement.Lanes[1];
+            const uint32_t c = measurement.Lanes[2];
+
+            float value = NaN;
+            switch (measurement.Measure) {
+            case GestureMeasure::Distance:
+                if (m_valid[a] && m_valid[b]) {
+                    const float dx = m_positionX[a] - m_positionX[b];
+                    const float dy = m_positionY[a] - m_positionY[b];
+                    const float dz = m_positionZ[a] - m_positionZ[b];
+                    value = std::sqrt(dx * dx + dy * dy + dz * dz) - m_radius[a] - m_radius[b];
+                }
+                break;
+            case GestureMeasure::Angle:
+                if (m_valid[a] && m_valid[b] && m_valid[c]) {
+                    const float ux = m_positionX[a] - m_positionX[b];
+                    const float uy = m_positionY[a] - m_positionY[b];
+                    const float uz = m_positionZ[a] - m_positionZ[b];
+                    const float vx = m_positionX[c] - m_positionX[b];
+                    const float vy = m_positionY[c] - m_positionY[b];
+                    const float vz = m_positionZ[c] - m_positionZ[b];
+                    const float lengths = std::sqrt((ux * ux + uy * uy + uz * uz) * (vx * vx + vy * vy + vz * vz));
+                    if (lengths > 0) {
+                        value = std::acos(std::clamp((ux * vx + uy * vy + uz * vz) / lengths, -1.0f, 1.0f));
+                    }
+                }
+                break;
+            case GestureMeasure::Speed:
+                if (deltaTime > 0 && m_valid[a] && m_previousValid[a]) {
+                    const float dx = m_positionX[a] - m_previousX[a];
+                    const float dy = m_positionY[a] - m_previousY[a];
+                    const float dz = m_positionZ[a] - m_previousZ[a];
+                    value = std::sqrt(dx * dx + dy * dy + dz * dz) / deltaTime;
+                }
+                break;
+            }
+            m_measuredValues[m] = value;
+        }
+
+        m_previousX = m_positionX;
+        m_previousY = m_positionY;
+        m_previousZ = m_positionZ;
+        m_previousValid = m_valid;
+        m_previousTime = time;
+    }
+
+    bool HandGestureRecognizer::IsStepSatisfied(const Gesture& gesture, size_t step) const {
+        const auto [begin, end] = gesture.StepPredicates[step];
+        return std::all_of(m_predicateHolds.begin() + begin, m_predicateHolds.begin() + end, [](uint8_t holds) { return holds != 0; });
+    }
+
+    void HandGestureRecognizer::UpdateGesture(uint32_t gestureId, Gesture& gesture, XrTime time) {
+        const std::vector<GestureStep>& steps = gesture.Description.Steps;
+
+        if (gesture.Active) {
+            if (!IsStepSatisfied(gesture, steps.size() - 1)) {
+                gesture.Active = false;
+                gesture.CurrentStep = 0;
+                gesture.StepHoldStartTime.reset();
+                m_events.push_back({gestureId, GestureEventType::Ended, time});
+            }
+            return;
+        }
+
+        const GestureStep& step = steps[gesture.CurrentStep];
+        if (!IsStepSatisfied(gesture, gesture.CurrentStep)) {
+            gesture.StepHoldStartTime.reset();
+            if (gesture.CurrentStep > 0 && step.MaxDelay > 0 && time - gesture.LastStepCompletedTime > step.MaxDelay) {
+                gesture.CurrentStep = 0; // Too slow, start the sequence over.
+            }
+            return;
+        }
+
+        if (!gesture.StepHoldStartTime) {
+            gesture.StepHoldStartTime = time;
+        }
+        if (time - gesture.StepHoldStartTime.value() < step.MinDuration) {
+            return;
+        }
+
+        gesture.StepHoldStartTime.reset();
+        gesture.LastStepCompletedTime = time;
+        if (gesture.CurrentStep + 1 < steps.size()) {
+            gesture.CurrentStep++;
+        } else {
+            gesture.Active = true;
+            m_events.push_back({gestureId, GestureEventType::Started, time});
+        }
+    }
+} // namespace sample
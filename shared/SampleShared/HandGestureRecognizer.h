@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sample {
+    struct HandJointRef {
+        uint32_t Hand;       // Index of the hand given to HandGestureRecognizer::SetJoints, e.g. xr::Side::Left.
+        XrHandJointEXT Joint;
+    };
+
+    enum class GestureMeasure {
+        Distance, // Distance in meters between the surfaces of two joints, i.e. between their centers minus their radii.
+        Angle,    // Angle in radians at the second joint, between the directions to the first and the third joint.
+        Speed,    // Speed in meters per second of a joint, between the last two updates.
+    };
+
+    // A condition on the joints of one or both hands. The predicate holds while the measured value is within [Min, Max].
+    // Once it holds, the range is widened by Hysteresis on both sides, so that noise around a threshold does not toggle it.
+    // A predicate on joints that are not located does not hold.
+    struct GesturePredicate {
+        GestureMeasure Measure;
+        HandJointRef Joints[3];
+        float Min{-std::numeric_limits<float>::infinity()};
+        float Max{std::numeric_limits<float>::infinity()};
+        float Hysteresis{0};
+
+        static GesturePredicate Distance(HandJointRef a, HandJointRef b, float min, float max, float hysteresis = 0) {
+            return {GestureMeasure::Distance, {a, b, b}, min, max, hysteresis};
+        }
+
+        static GesturePredicate Angle(HandJointRef a, HandJointRef vertex, HandJointRef c, float min, float max, float hysteresis = 0) {
+            return {GestureMeasure::Angle, {a, vertex, c}, min, max, hysteresis};
+        }
+
+        static GesturePredicate Speed(HandJointRef joint, float min, float max, float hysteresis = 0) {
+            return {GestureMeasure::Speed, {joint, joint, joint}, min, max, hysteresis};
+        }
+    };
+
+    // One step of a gesture. The step completes when all predicates hold for MinDuration.
+    struct GestureStep {
+        std::vector<GesturePredicate> Predicates;
+        XrDuration MinDuration{0};
+
+        // The step must complete within this duration after the previous step completed, otherwise the gesture starts over.
+        // Zero means no limit. Ignored for the first step.
+        XrDuration MaxDelay{0};
+    };
+
+    // A gesture is a sequence of steps. It starts when the last step completes and ends when the last step no longer holds.
+    struct GestureDescription {
+        std::string Name;
+        std::vector<GestureStep> Steps;
+    };
+
+    enum class GestureEventType { Started, Ended };
+
+    struct GestureEvent {
+        uint32_t GestureId;
+        GestureEventType Type;
+        XrTime Time;
+    };
+
+    // Recognizes declarative gestures on hand joints.
+    // Each update measures every distinct joint distance, angle and speed used by any gesture once, in one pass over the
+    // joints of all hands, and then evaluates the gestures on the measured values. Gestures sharing measurements cost
+    // little more than a comparison each.
+    class HandGestureRecognizer {
+    public:
+        explicit HandGestureRecognizer(uint32_t handCount = 2);
+
+        // Returns the id used in GestureEvent.
+        uint32_t AddGesture(GestureDescription gesture);
+
+        const GestureDescription& GetGesture(uint32_t gestureId) const {
+            return m_gestures.at(gestureId).Description;
+        }
+
+        bool IsActive(uint32_t gestureId) const {
+            return m_gestures.at(gestureId).Active;
+        }
+
+        // Provide the XR_HAND_JOINT_COUNT_EXT joint locations of a hand for the next update.
+        // Joints without valid positions, or all joints if the hand is not active, make the predicates using them fail.
+        void SetJoints(uint32_t hand, bool isActive, const XrHandJointLocationEXT* locations);
+
+        // Evaluate all gestures at the given time. Returns the gestures that started or ended, in the order they were added.
+        const std::vector<GestureEvent>& Update(XrTime time);
+
+    private:
+        struct Measurement {
+            GestureMeasure Measure;
+            uint32_t Lanes[3]; // Indices into the joint arrays
+        };
+
+        struct Gesture {
+            GestureDescription Description;
+            std::vector<std::pair<uint32_t, uint32_t>> StepPredicates; // Range of m_predicate* entries for each step.
+            size_t CurrentStep{0};
+            std::optional<XrTime> StepHoldStartTime;
+            XrTime LastStepCompletedTime{0};
+            bool Active{false};
+        };
+
+        uint32_t GetMeasurementIndex(const GesturePredicate& predicate);
+        void MeasureJoints(XrTime time);
+        void UpdateGesture(uint32_t gestureId, Gesture& gesture, XrTime time);
+        bool IsStepSatisfied(const Gesture& gesture, size_t step) const;
+
+        const uint32_t m_laneCount;
+
+        // Joints of all hands, one lane per joint.
+        std::vector<float> m_positionX, m_positionY, m_positionZ, m_radius;
+        std::vector<float> m_previousX, m_previousY, m_previousZ;
+        std::vector<uint8_t> m_valid, m_previousValid;
+        XrTime m_previousTime{0};
+
+        std::vector<Measurement> m_measurements;
+        std::vector<float> m_measuredValues; // NaN when a joint of the measurement is not located.
+
+        // Predicates of all steps of all gestures.
+        std::vector<uint32_t> m_predicateMeasurement;
+        std::vector<float> m_predicateMin, m_predicateMax, m_predicateHysteresis;
+        std::vector<uint8_t> m_predicateHolds;
+
+        std::vector<Gesture> m_gestures;
+        std::vector<GestureEvent> m_events;
+    };
+} // namespace sample
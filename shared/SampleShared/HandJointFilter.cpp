@@ -0,0 +1,421 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <algorithm>
+#include <XrUtility/XrMath.h>
+#include "HandJointFilter.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t JointCount = XR_HAND_JOINT_COUNT_EXT;
+    constexpr float TwoPi = 2 * XM_PI;
+    constexpr float MinDeltaTime = 1e-4f;
+    constexpr XrSpaceLocationFlags ValidFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+    constexpr XrSpaceLocationFlags TrackedFlags = XR_SPACE_LOCATION_POSITION_TRACKED_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT;
+
+    constexpr float ToSeconds(XrDuration duration) {
+        return static_cast<float>(duration) * 1e-9f;
+    }
+
+    const XrHandJointVelocitiesEXT* FindJointVelocities(const XrHandJointLocationsEXT& locations) {
+        for (auto* next = reinterpret_cast<const XrBaseInStructure*>(locations.next); next != nullptr; next = next->next) {
+            if (next->type == XR_TYPE_HAND_JOINT_VELOCITIES_EXT) {
+                return reinterpret_cast<const XrHandJointVelocitiesEXT*>(next);
+            }
+        }
+        return nullptr;
+    }
+
+    // Smoothing factor of an exponential filter with the given cutoff frequency, for a sample period dt.
+    inline float Alpha(float cutoff, float dt) {
+        const float tau = 1.0f / (TwoPi * cutoff);
+        return dt / (dt + tau);
+    }
+
+    // How far in seconds an exponential filter with the smoothing factor alpha lags behind a steady motion.
+    inline float Lag(float alpha, float dt) {
+        return dt * (1 - alpha) / std::max(alpha, 1e-6f);
+    }
+
+    // Moves value towards target by amount for lanes with a new sample. Other lanes keep their value as is, rather than moving it
+    // by a zero amount, since their input may not be finite.
+    inline float Step(float value, float target, float amount, bool hasSample) {
+        return hasSample ? value + amount * (target - value) : value;
+    }
+
+    bool IsFinite(const XrPosef& pose) {
+        return std::isfinite(pose.position.x) && std::isfinite(pose.position.y) && std::isfinite(pose.position.z) &&
+               std::isfinite(pose.orientation.x) && std::isfinite(pose.orientation.y) && std::isfinite(pose.orientation.z) &&
+               std::isfinite(pose.orientation.w);
+    }
+} // namespace
+
+namespace sample {
+    HandJointFilter::HandJointFilter(uint32_t handCount, HandJointFilterOptions options)
+        : m_options(options)
+        , m_handTimes(handCount) {
+        const size_t laneCount = size_t{handCount} * JointCount;
+        for (Lanes* lanes : {&m_input.PositionX,          &m_input.PositionY,          &m_input.PositionZ,
+                             &m_input.OrientationX,       &m_input.OrientationY,       &m_input.OrientationZ,
+                             &m_input.OrientationW,       &m_input.LinearVelocityX,    &m_input.LinearVelocityY,
+                             &m_input.LinearVelocityZ,    &m_input.AngularVelocityX,   &m_input.AngularVelocityY,
+                             &m_input.AngularVelocityZ,   &m_input.Radius,             &m_input.Weight,
+                             &m_state.PositionX,          &m_state.PositionY,          &m_state.PositionZ,
+                             &m_state.OrientationX,       &m_state.OrientationY,       &m_state.OrientationZ,
+                             &m_state.OrientationW,       &m_state.VelocityX,          &m_state.VelocityY,
+                             &m_state.VelocityZ,          &m_state.AngularSpeed,       &m_state.SampleX,
+                             &m_state.SampleY,            &m_state.SampleZ,            &m_state.SampleOrientationX,
+                             &m_state.SampleOrientationY, &m_state.SampleOrientationZ, &m_state.SampleOrientationW,
+                             &m_state.Lag,                &m_state.RotationLag,        &m_state.Radius,
+                             &m_state.DeltaTime,          &m_state.Gain}) {
+            lanes->resize(laneCount);
+        }
+        m_input.LocationFlags.resize(laneCount);
+        m_input.VelocityFlags.resize(laneCount);
+        m_state.LocationFlags.resize(laneCount);
+        m_state.Initialized.resize(laneCount);
+        m_state.LastValidTime.resize(laneCount);
+        Reset();
+    }
+
+    void HandJointFilter::SetOptions(const HandJointFilterOptions& options) {
+        const bool typeChanged = options.Type != m_options.Type;
+        m_options = options;
+        if (typeChanged) {
+            Reset(); // The velocity state has a different meaning for each filter.
+        }
+    }
+
+    void HandJointFilter::Reset() {
+        for (uint32_t hand = 0; hand < m_handTimes.size(); hand++) {
+            Reset(hand);
+        }
+    }
+
+    void HandJointFilter::Reset(uint32_t hand) {
+        m_handTimes.at(hand) = {};
+        ResetLanes(size_t{hand} * JointCount, size_t{hand + 1} * JointCount);
+    }
+
+    void HandJointFilter::ResetLanes(size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            m_input.Weight[i] = 0;
+            m_input.LocationFlags[i] = 0;
+            m_input.VelocityFlags[i] = 0;
+            m_state.Initialized[i] = false;
+            m_state.LocationFlags[i] = 0;
+            m_state.Gain[i] = 0;
+            m_state.Lag[i] = 0;
+            m_state.RotationLag[i] = 0;
+        }
+    }
+
+    void HandJointFilter::SetJoints(uint32_t hand, XrTime time, const XrHandJointLocationsEXT& locations) {
+        if (locations.jointCount != JointCount) {
+            throw std::invalid_argument("Hand joint filter requires the default hand joint set");
+        }
+
+        HandTimes& handTimes = m_handTimes.at(hand);
+        if (!handTimes.HasNewSample) {
+            handTimes.PreviousSampleTime = handTimes.SampleTime;
+        }
+        handTimes.SampleTime = time;
+        handTimes.HasNewSample = true;
+
+        const XrHandJointVelocitiesEXT* velocities = FindJointVelocities(locations);
+        const size_t base = size_t{hand} * JointCount;
+        for (uint32_t k = 0; k < JointCount; k++) {
+            const size_t i = base + k;
+            const XrHandJointLocationEXT& location = locations.jointLocations[k];
+            const XrSpaceLocationFlags flags = locations.isActive ? location.locationFlags : 0;
+
+            // Poses which are not finite are ignored like those which are not valid.
+            float weight = 0;
+            if ((flags & ValidFlags) == ValidFlags && IsFinite(location.pose) && std::isfinite(location.radius)) {
+                weight = (flags & TrackedFlags) == TrackedFlags ? 1.0f : m_options.InferredWeight;
+            }
+            m_input.Weight[i] = weight;
+            m_input.LocationFlags[i] = weight > 0 ? flags : 0;
+            m_input.PositionX[i] = location.pose.position.x;
+            m_input.PositionY[i] = location.pose.position.y;
+            m_input.PositionZ[i] = location.pose.position.z;
+            m_input.OrientationX[i] = location.pose.orientation.x;
+            m_input.OrientationY[i] = location.pose.orientation.y;
+            m_input.OrientationZ[i] = location.pose.orientation.z;
+            m_input.OrientationW[i] = location.pose.orientation.w;
+            m_input.Radius[i] = location.radius;
+
+            const XrHandJointVelocityEXT* velocity = velocities != nullptr && weight > 0 ? &velocities->jointVelocities[k] : nullptr;
+            XrSpaceVelocityFlags velocityFlags = velocity != nullptr ? velocity->velocityFlags : 0;
+            if (velocity != nullptr && !(std::isfinite(velocity->linearVelocity.x) && std::isfinite(velocity->linearVelocity.y) &&
+                                         std::isfinite(velocity->linearVelocity.z))) {
+                velocityFlags &= ~XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
+            }
+            if (velocity != nullptr && !(std::isfinite(velocity->angularVelocity.x) && std::isfinite(velocity->angularVelocity.y) &&
+                                         std::isfinite(velocity->angularVelocity.z))) {
+                velocityFlags &= ~XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+            }
+            m_input.VelocityFlags[i] = velocityFlags;
+            m_input.LinearVelocityX[i] = velocity != nullptr ? velocity->linearVelocity.x : 0;
+            m_input.LinearVelocityY[i] = velocity != nullptr ? velocity->linearVelocity.y : 0;
+            m_input.LinearVelocityZ[i] = velocity != nullptr ? velocity->linearVelocity.z : 0;
+            m_input.AngularVelocityX[i] = velocity != nullptr ? velocity->angularVelocity.x : 0;
+            m_input.AngularVelocityY[i] = velocity != nullptr ? velocity->angularVelocity.y : 0;
+            m_input.AngularVelocityZ[i] = velocity != nullptr ? velocity->angularVelocity.z : 0;
+        }
+    }
+
+    void HandJointFilter::Update() {
+        const size_t laneCount = m_input.Weight.size();
+
+        // Confidence gating. Decide per joint whether the new sample is filtered in, used as is, or whether the last pose is held.
+        for (uint32_t hand = 0; hand < m_handTimes.size(); hand++) {
+            HandTimes& handTimes = m_handTimes[hand];
+            const bool hasPreviousSample = handTimes.PreviousSampleTime != 0 && handTimes.SampleTime > handTimes.PreviousSampleTime;
+            const float dt = hasPreviousSample ? ToSeconds(handTimes.SampleTime - handTimes.PreviousSampleTime) : 0;
+
+            for (size_t i = size_t{hand} * JointCount; i < size_t{hand + 1} * JointCount; i++) {
+                m_state.Gain[i] = 0;
+                m_state.DeltaTime[i] = std::max(dt, MinDeltaTime);
+                if (!handTimes.HasNewSample) {
+                    continue;
+                }
+
+                if (m_input.Weight[i] > 0) {
+                    m_state.LastValidTime[i] = handTimes.SampleTime;
+                    m_state.LocationFlags[i] = m_input.LocationFlags[i];
+                    if (m_state.Initialized[i] && hasPreviousSample) {
+                        m_state.Gain[i] = m_input.Weight[i];
+                    } else {
+                        // There is nothing to filter against, so start from the sample.
+                        m_state.Initialized[i] = true;
+                        m_state.PositionX[i] = m_input.PositionX[i];
+                        m_state.PositionY[i] = m_input.PositionY[i];
+                        m_state.PositionZ[i] = m_input.PositionZ[i];
+                        m_state.OrientationX[i] = m_input.OrientationX[i];
+                        m_state.OrientationY[i] = m_input.OrientationY[i];
+                        m_state.OrientationZ[i] = m_input.OrientationZ[i];
+                        m_state.OrientationW[i] = m_input.OrientationW[i];
+                        m_state.SampleX[i] = m_input.PositionX[i];
+                        m_state.SampleY[i] = m_input.PositionY[i];
+                        m_state.SampleZ[i] = m_input.PositionZ[i];
+                        m_state.SampleOrientationX[i] = m_input.OrientationX[i];
+                        m_state.SampleOrientationY[i] = m_input.OrientationY[i];
+                        m_state.SampleOrientationZ[i] = m_input.OrientationZ[i];
+                        m_state.SampleOrientationW[i] = m_input.OrientationW[i];
+                        m_state.VelocityX[i] = m_state.VelocityY[i] = m_state.VelocityZ[i] = 0;
+                        m_state.AngularSpeed[i] = 0;
+                        m_state.Radius[i] = m_input.Radius[i];
+                    }
+                } else if (m_state.Initialized[i]) {
+                    if (handTimes.SampleTime - m_state.LastValidTime[i] > m_options.MaxHoldDuration) {
+                        m_state.Initialized[i] = false;
+                        m_state.LocationFlags[i] = 0;
+                    } else {
+                        m_state.LocationFlags[i] &= ~TrackedFlags; // Held poses are no longer tracked.
+                    }
+                }
+            }
+            handTimes.HasNewSample = false;
+        }
+
+        switch (m_options.Type) {
+        case HandJointFilterType::OneEuro:
+            UpdateOneEuro(laneCount);
+            break;
+        case HandJointFilterType::DoubleExponential:
+            UpdateDoubleExponential(laneCount);
+            break;
+        default:
+            UpdatePassThrough(laneCount);
+            break;
+        }
+    }
+
+    // The filter loops below are branch free over the lanes, so that they can be vectorized. Lanes without a new sample select
+    // their previous state, see Step.
+    void HandJointFilter::UpdateOneEuro(size_t laneCount) {
+        const float minCutoff = m_options.MinCutoff;
+        const float beta = m_options.Beta;
+        const float rotationMinCutoff = m_options.RotationMinCutoff;
+        const float rotationBeta = m_options.RotationBeta;
+        const float derivativeCutoff = m_options.DerivativeCutoff;
+
+        const Input& in = m_input;
+        State& s = m_state;
+        for (size_t i = 0; i < laneCount; i++) {
+            const float gain = s.Gain[i];
+            const bool hasSample = gain > 0;
+            const float dt = s.DeltaTime[i];
+            const float derivativeAlpha = gain * Alpha(derivativeCutoff, dt);
+
+            // Positions: the cutoff frequency increases with the filtered speed of the samples. The speed is derived from the
+            // previous sample rather than from the filtered position, whose lag would otherwise be taken for motion.
+            s.VelocityX[i] = Step(s.VelocityX[i], (in.PositionX[i] - s.SampleX[i]) / dt, derivativeAlpha, hasSample);
+            s.VelocityY[i] = Step(s.VelocityY[i], (in.PositionY[i] - s.SampleY[i]) / dt, derivativeAlpha, hasSample);
+            s.VelocityZ[i] = Step(s.VelocityZ[i], (in.PositionZ[i] - s.SampleZ[i]) / dt, derivativeAlpha, hasSample);
+            const float speed =
+                std::sqrt(s.VelocityX[i] * s.VelocityX[i] + s.VelocityY[i] * s.VelocityY[i] + s.VelocityZ[i] * s.VelocityZ[i]);
+            const float alpha = gain * Alpha(minCutoff + beta * speed, dt);
+            s.PositionX[i] = Step(s.PositionX[i], in.PositionX[i], alpha, hasSample);
+            s.PositionY[i] = Step(s.PositionY[i], in.PositionY[i], alpha, hasSample);
+            s.PositionZ[i] = Step(s.PositionZ[i], in.PositionZ[i], alpha, hasSample);
+            s.Lag[i] = hasSample ? Lag(alpha, dt) : s.Lag[i];
+            s.SampleX[i] = Step(s.SampleX[i], in.PositionX[i], 1, hasSample);
+            s.SampleY[i] = Step(s.SampleY[i], in.PositionY[i], 1, hasSample);
+            s.SampleZ[i] = Step(s.SampleZ[i], in.PositionZ[i], 1, hasSample);
+            s.Radius[i] = Step(s.Radius[i], in.Radius[i], 1, hasSample);
+
+            // Orientations: same filter on the angle between the previous and the new sample, blended with a normalized lerp.
+            const float sampleDot = s.SampleOrientationX[i] * in.OrientationX[i] + s.SampleOrientationY[i] * in.OrientationY[i] +
+                                    s.SampleOrientationZ[i] * in.OrientationZ[i] + s.SampleOrientationW[i] * in.OrientationW[i];
+            const float angle = 2 * std::acos(std::min(std::abs(sampleDot), 1.0f));
+            s.AngularSpeed[i] = Step(s.AngularSpeed[i], angle / dt, derivativeAlpha, hasSample);
+            s.SampleOrientationX[i] = Step(s.SampleOrientationX[i], in.OrientationX[i], 1, hasSample);
+            s.SampleOrientationY[i] = Step(s.SampleOrientationY[i], in.OrientationY[i], 1, hasSample);
+            s.SampleOrientationZ[i] = Step(s.SampleOrientationZ[i], in.OrientationZ[i], 1, hasSample);
+            s.SampleOrientationW[i] = Step(s.SampleOrientationW[i], in.OrientationW[i], 1, hasSample);
+
+            const float dot = s.OrientationX[i] * in.OrientationX[i] + s.OrientationY[i] * in.OrientationY[i] +
+                              s.OrientationZ[i] * in.OrientationZ[i] + s.OrientationW[i] * in.OrientationW[i];
+            const float sign = dot < 0 ? -1.0f : 1.0f;
+            const float rotationAlpha = gain * Alpha(rotationMinCutoff + rotationBeta * s.AngularSpeed[i], dt);
+            const float qx = s.OrientationX[i] + rotationAlpha * (sign * in.OrientationX[i] - s.OrientationX[i]);
+            const float qy = s.OrientationY[i] + rotationAlpha * (sign * in.OrientationY[i] - s.OrientationY[i]);
+            const float qz = s.OrientationZ[i] + rotationAlpha * (sign * in.OrientationZ[i] - s.OrientationZ[i]);
+            const float qw = s.OrientationW[i] + rotationAlpha * (sign * in.OrientationW[i] - s.OrientationW[i]);
+            const float inverseLength = 1.0f / std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+            s.OrientationX[i] = hasSample ? qx * inverseLength : s.OrientationX[i];
+            s.OrientationY[i] = hasSample ? qy * inverseLength : s.OrientationY[i];
+            s.OrientationZ[i] = hasSample ? qz * inverseLength : s.OrientationZ[i];
+            s.OrientationW[i] = hasSample ? qw * inverseLength : s.OrientationW[i];
+            s.RotationLag[i] = hasSample ? Lag(rotationAlpha, dt) : s.RotationLag[i];
+        }
+    }
+
+    void HandJointFilter::UpdateDoubleExponential(size_t laneCount) {
+        const float smoothing = m_options.Smoothing;
+        const float trendSmoothing = m_options.TrendSmoothing;
+
+        const Input& in = m_input;
+        State& s = m_state;
+        for (size_t i = 0; i < laneCount; i++) {
+            const float gain = s.Gain[i];
+            const bool hasSample = gain > 0;
+            const float dt = s.DeltaTime[i];
+            const float alpha = smoothing * gain;
+
+            // Level: blend the sample with the position predicted by the trend. Trend: smooth the change of the level.
+            // Following the trend, the level does not lag behind a steady motion.
+            const float predictedX = s.PositionX[i] + s.VelocityX[i] * dt;
+            const float predictedY = s.PositionY[i] + s.VelocityY[i] * dt;
+            const float predictedZ = s.PositionZ[i] + s.VelocityZ[i] * dt;
+            const float levelX = predictedX + alpha * (in.PositionX[i] - predictedX);
+            const float levelY = predictedY + alpha * (in.PositionY[i] - predictedY);
+            const float levelZ = predictedZ + alpha * (in.PositionZ[i] - predictedZ);
+            s.VelocityX[i] = Step(s.VelocityX[i], (levelX - s.PositionX[i]) / dt, trendSmoothing, hasSample);
+            s.VelocityY[i] = Step(s.VelocityY[i], (levelY - s.PositionY[i]) / dt, trendSmoothing, hasSample);
+            s.VelocityZ[i] = Step(s.VelocityZ[i], (levelZ - s.PositionZ[i]) / dt, trendSmoothing, hasSample);
+            s.PositionX[i] = Step(s.PositionX[i], levelX, 1, hasSample);
+            s.PositionY[i] = Step(s.PositionY[i], levelY, 1, hasSample);
+            s.PositionZ[i] = Step(s.PositionZ[i], levelZ, 1, hasSample);
+            s.Lag[i] = 0;
+            s.Radius[i] = Step(s.Radius[i], in.Radius[i], 1, hasSample);
+
+            // Orientations are smoothed without a trend. Joint velocities, when available, compensate the lag at prediction time.
+            const float dot = s.OrientationX[i] * in.OrientationX[i] + s.OrientationY[i] * in.OrientationY[i] +
+                              s.OrientationZ[i] * in.OrientationZ[i] + s.OrientationW[i] * in.OrientationW[i];
+            const float sign = dot < 0 ? -1.0f : 1.0f;
+            const float qx = s.OrientationX[i] + alpha * (sign * in.OrientationX[i] - s.OrientationX[i]);
+            const float qy = s.OrientationY[i] + alpha * (sign * in.OrientationY[i] - s.OrientationY[i]);
+            const float qz = s.OrientationZ[i] + alpha * (sign * in.OrientationZ[i] - s.OrientationZ[i]);
+            const float qw = s.OrientationW[i] + alpha * (sign * in.OrientationW[i] - s.OrientationW[i]);
+            const float inverseLength = 1.0f / std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+            s.OrientationX[i] = hasSample ? qx * inverseLength : s.OrientationX[i];
+            s.OrientationY[i] = hasSample ? qy * inverseLength : s.OrientationY[i];
+            s.OrientationZ[i] = hasSample ? qz * inverseLength : s.OrientationZ[i];
+            s.OrientationW[i] = hasSample ? qw * inverseLength : s.OrientationW[i];
+            s.RotationLag[i] = hasSample ? Lag(alpha, dt) : s.RotationLag[i];
+        }
+    }
+
+    void HandJointFilter::UpdatePassThrough(size_t laneCount) {
+        const Input& in = m_input;
+        State& s = m_state;
+        for (size_t i = 0; i < laneCount; i++) {
+            const bool hasSample = s.Gain[i] > 0;
+            s.PositionX[i] = Step(s.PositionX[i], in.PositionX[i], 1, hasSample);
+            s.PositionY[i] = Step(s.PositionY[i], in.PositionY[i], 1, hasSample);
+            s.PositionZ[i] = Step(s.PositionZ[i], in.PositionZ[i], 1, hasSample);
+            s.OrientationX[i] = Step(s.OrientationX[i], in.OrientationX[i], 1, hasSample);
+            s.OrientationY[i] = Step(s.OrientationY[i], in.OrientationY[i], 1, hasSample);
+            s.OrientationZ[i] = Step(s.OrientationZ[i], in.OrientationZ[i], 1, hasSample);
+            s.OrientationW[i] = Step(s.OrientationW[i], in.OrientationW[i], 1, hasSample);
+            s.Radius[i] = Step(s.Radius[i], in.Radius[i], 1, hasSample);
+            s.Lag[i] = 0;
+            s.RotationLag[i] = 0;
+        }
+    }
+
+    bool HandJointFilter::GetJoints(uint32_t hand, XrTime time, XrHandJointLocationEXT* locations) const {
+        const HandTimes& handTimes = m_handTimes.at(hand);
+        const float predictionTime = ToSeconds(std::max(time - handTimes.SampleTime, XrDuration{0}));
+        const float maxPredictionTime = ToSeconds(m_options.MaxPredictionDuration);
+        const bool hasFilterVelocity = m_options.Type != HandJointFilterType::None;
+
+        bool anyValid = false;
+        const size_t base = size_t{hand} * JointCount;
+        for (uint32_t k = 0; k < JointCount; k++) {
+            const size_t i = base + k;
+            XrHandJointLocationEXT& location = locations[k];
+            location.locationFlags = m_state.LocationFlags[i];
+            if (!m_state.Initialized[i]) {
+                location.locationFlags = 0;
+                location.pose = xr::math::Pose::Identity();
+                location.radius = 0;
+                continue;
+            }
+
+            XMVECTOR position = XMVectorSet(m_state.PositionX[i], m_state.PositionY[i], m_state.PositionZ[i], 0);
+            XMVECTOR orientation =
+                XMVectorSet(m_state.OrientationX[i], m_state.OrientationY[i], m_state.OrientationZ[i], m_state.OrientationW[i]);
+
+            // Only extrapolate joints that were located in the last sample. Held joints stay where they were last seen.
+            // Joints are extrapolated from the sample time to the requested time, plus the time the filter lags behind the samples.
+            const float positionTime = std::min(predictionTime + m_state.Lag[i], maxPredictionTime);
+            const float orientationTime = std::min(predictionTime + m_state.RotationLag[i], maxPredictionTime);
+            if (m_input.Weight[i] > 0) {
+                const XrSpaceVelocityFlags velocityFlags = m_input.VelocityFlags[i];
+                if (velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) {
+                    const XMVECTOR velocity =
+                        XMVectorSet(m_input.LinearVelocityX[i], m_input.LinearVelocityY[i], m_input.LinearVelocityZ[i], 0);
+                    position = XMVectorMultiplyAdd(velocity, XMVectorReplicate(positionTime), position);
+                } else if (hasFilterVelocity) {
+                    const XMVECTOR velocity = XMVectorSet(m_state.VelocityX[i], m_state.VelocityY[i], m_state.VelocityZ[i], 0);
+                    position = XMVectorMultiplyAdd(velocity, XMVectorReplicate(positionTime), position);
+                }
+
+                // Without joint velocities from the runtime, orientations are not extrapolated and keep the lag of the filter.
+                if (velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) {
+                    const XMVECTOR angularVelocity =
+                        XMVectorSet(m_input.AngularVelocityX[i], m_input.AngularVelocityY[i], m_input.AngularVelocityZ[i], 0);
+                    const float angularSpeed = XMVectorGetX(XMVector3Length(angularVelocity));
+                    if (angularSpeed > 0) {
+                        // The angular velocity is expressed in the base space, so the rotation is applied after the joint orientation.
+                        const XMVECTOR rotation =
+                            XMQuaternionRotationNormal(angularVelocity / angularSpeed, angularSpeed * orientationTime);
+                        orientation = XMQuaternionNormalize(XMQuaternionMultiply(orientation, rotation));
+                    }
+                }
+            }
+
+            xr::math::StoreXrVector3(&location.pose.position, position);
+            xr::math::StoreXrQuaternion(&location.pose.orientation, orientation);
+            location.radius = m_state.Radius[i];
+            anyValid = true;
+        }
+        return anyValid;
+    }
+} // namespace sample
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include <vector>
+
+namespace sample {
+    enum class HandJointFilterType {
+        None,              // Raw joint locations, only confidence gating and prediction are applied.
+        OneEuro,           // Adaptive low-pass filter: smooth when the hand is still, responsive when it moves fast.
+        DoubleExponential, // Holt's linear smoothing, which tracks the trend of the motion to reduce lag.
+    };
+
+    struct HandJointFilterOptions {
+        HandJointFilterType Type{HandJointFilterType::OneEuro};
+
+        // One Euro filter parameters. The cutoff frequency in Hz grows with the speed of the input (m/s or rad/s) times beta.
+        float MinCutoff{1.0f};
+        float Beta{30.0f};
+        float RotationMinCutoff{1.0f};
+        float RotationBeta{2.0f};
+        float DerivativeCutoff{1.0f};
+
+        // Double exponential filter parameters, in (0, 1]. Larger values follow the input more closely.
+        float Smoothing{0.5f};
+        float TrendSmoothing{0.3f};
+
+        // Joints that are located but not actively tracked are inferred by the runtime and are blended in with this weight.
+        float InferredWeight{0.3f};
+
+        // Joints that lose their location keep their last filtered pose, marked as not tracked, for at most this duration.
+        XrDuration MaxHoldDuration{100'000'000};
+
+        // Joints are extrapolated from the time they were located to the requested time, plus the time the filter lags behind
+        // a steady motion, by at most this duration.
+        XrDuration MaxPredictionDuration{20'000'000};
+    };
+
+    // Filters the joint streams of one or more hands. The joints of all hands are stored as one structure of arrays,
+    // so every filter step runs as a single loop over all joints of all hands.
+    // Each frame, call SetJoints for every hand and then Update. Filtered locations are read back with GetJoints.
+    class HandJointFilter {
+    public:
+        explicit HandJointFilter(uint32_t handCount = 2, HandJointFilterOptions options = {});
+
+        const HandJointFilterOptions& Options() const noexcept {
+            return m_options;
+        }
+
+        // Changing the filter type resets the filter state.
+        void SetOptions(const HandJointFilterOptions& options);
+
+        // Forget the filter state, so that the next located joints are used as they are.
+        void Reset();
+        void Reset(uint32_t hand);
+
+        // Provide the joints located by xrLocateHandJointsEXT at the given time. The locations must have XR_HAND_JOINT_COUNT_EXT joints.
+        // If an XrHandJointVelocitiesEXT is chained to the locations, valid joint velocities are used for prediction.
+        void SetJoints(uint32_t hand, XrTime time, const XrHandJointLocationsEXT& locations);
+
+        // Run the filter over all joints that received new locations since the last update.
+        void Update();
+
+        // Write the filtered joints of a hand, extrapolated to the given time and compensated for the lag of the filter, e.g. at the
+        // time the joints were located for. Joints without a valid filtered pose have no location flags.
+        // Returns true if any joint has a valid pose.
+        bool GetJoints(uint32_t hand, XrTime time, XrHandJointLocationEXT* locations) const;
+
+    private:
+        using Lanes = std::vector<float>;
+
+        struct Input {
+            Lanes PositionX, PositionY, PositionZ;
+            Lanes OrientationX, OrientationY, OrientationZ, OrientationW;
+            Lanes LinearVelocityX, LinearVelocityY, LinearVelocityZ;
+            Lanes AngularVelocityX, AngularVelocityY, AngularVelocityZ;
+            Lanes Radius;
+            Lanes Weight; // Confidence of the new sample in [0, 1], zero if there is no new sample.
+            std::vector<XrSpaceLocationFlags> LocationFlags;
+            std::vector<XrSpaceVelocityFlags> VelocityFlags;
+        };
+
+        struct State {
+            Lanes PositionX, PositionY, PositionZ;
+            Lanes OrientationX, OrientationY, OrientationZ, OrientationW;
+            Lanes VelocityX, VelocityY, VelocityZ; // Filtered derivative for One Euro, trend for double exponential, in m/s.
+            Lanes AngularSpeed;                    // Filtered angular speed for One Euro, in rad/s.
+            Lanes SampleX, SampleY, SampleZ;       // The previous sample of the joint, which One Euro differentiates.
+            Lanes SampleOrientationX, SampleOrientationY, SampleOrientationZ, SampleOrientationW;
+            Lanes Lag, RotationLag; // Seconds the filtered position and orientation lag behind a steady motion.
+            Lanes Radius;
+            Lanes DeltaTime; // Seconds since the previous sample of the joint's hand.
+            Lanes Gain;      // Weight of the new sample in this update, zero if the joint is held or was reset to the sample.
+            std::vector<XrSpaceLocationFlags> LocationFlags;
+            std::vector<uint8_t> Initialized;
+            std::vector<XrTime> LastValidTime;
+        };
+
+        struct HandTimes {
+            XrTime PreviousSampleTime{0};
+            XrTime SampleTime{0};
+            bool HasNewSample{false};
+        };
+
+        void ResetLanes(size_t begin, size_t end);
+        void UpdateOneEuro(size_t laneCount);
+        void UpdateDoubleExponential(size_t laneCount);
+        void UpdatePassThrough(size_t laneCount);
+
+        HandJointFilterOptions m_options;
+        std::vector<HandTimes> m_handTimes;
+        Input m_input;
+        State m_state;
+    };
+} // namespace sample
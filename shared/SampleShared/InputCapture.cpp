@@ -0,0 +1,768 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <fstream>
+#include <map>
+#include <mutex>
+#include "FileUtility.h"
+#include "InputCapture.h"
+
+namespace {
+    constexpr uint32_t CaptureMagic = 0x50434E49; // "INCP"
+    constexpr uint32_t CaptureVersion = 1;
+    constexpr size_t FlushThreshold = 1 << 20; // Buffered bytes before records are written to the file.
+    constexpr size_t DisplayTimeHistory = 4;   // Frames in flight between xrWaitFrame and xrEndFrame.
+
+    // Identifies the function of a record in the file. Values must not change, new functions are added at the end.
+    enum class FunctionId : uint16_t {
+        WaitFrame = 1,
+        LocateViews,
+        LocateSpace,
+        LocateSpaces,
+        SyncActions,
+        GetActionStateBoolean,
+        GetActionStateFloat,
+        GetActionStateVector2f,
+        GetActionStatePose,
+        LocateHandJoints,
+        UpdateHandMesh,
+        ComputeNewScene,
+        GetSceneComputeState,
+        CreateScene,
+        DestroyScene,
+        GetSceneComponents,
+        LocateSceneComponents,
+        GetSceneMeshBuffers,
+        GetSceneMarkerRawData,
+        GetSceneMarkerDecodedString,
+        DeserializeScene,
+        GetSerializedSceneFragmentData,
+    };
+
+    struct FileHeader {
+        uint32_t Magic;
+        uint32_t Version;
+    };
+
+    // Each record is followed by the outputs of the call. Outputs are only recorded when the call succeeded.
+    struct RecordHeader {
+        uint16_t Function;
+        uint16_t Stream; // See InputCapture::SetThreadStream
+        int32_t Result;
+        int64_t Timestamp; // Nanoseconds since the capture started.
+        uint32_t PayloadSize;
+        uint32_t Reserved;
+    };
+
+    class PayloadWriter {
+    public:
+        explicit PayloadWriter(std::vector<uint8_t>& data)
+            : m_data(data) {
+        }
+
+        template <typename T>
+        void Value(const T& value) {
+            Append(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void Array(const T* values, uint32_t count) {
+            if (values != nullptr && count > 0) {
+                Append(values, sizeof(T) * count);
+            }
+        }
+
+    private:
+        void Append(const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            m_data.insert(m_data.end(), bytes, bytes + size);
+        }
+
+        std::vector<uint8_t>& m_data;
+    };
+
+    // Reads the outputs in the same order as PayloadWriter wrote them.
+    // Counts are read before the arrays they size, so a replayed call fills the same elements as the recorded one.
+    class PayloadReader {
+    public:
+        PayloadReader(const uint8_t* data, size_t size)
+            : m_data(data)
+            , m_size(size) {
+        }
+
+        template <typename T>
+        void Value(T& value) {
+            Read(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void Array(T* values, uint32_t count) {
+            if (values != nullptr && count > 0) {
+                Read(values, sizeof(T) * count);
+            }
+        }
+
+        // True if the outputs consumed exactly the recorded payload.
+        bool Matches() const {
+            return m_valid && m_offset == m_size;
+        }
+
+    private:
+        void Read(void* data, size_t size) {
+            if (!m_valid || size > m_size - m_offset) {
+                m_valid = false;
+                return;
+            }
+            memcpy(data, m_data + m_offset, size);
+            m_offset += size;
+        }
+
+        const uint8_t* const m_data;
+        const size_t m_size;
+        size_t m_offset{0};
+        bool m_valid{true};
+    };
+
+    template <typename T>
+    T* FindOutStruct(const void* next, XrStructureType type) {
+        for (auto* header = static_cast<const XrBaseOutStructure*>(next); header != nullptr; header = header->next) {
+            if (header->type == type) {
+                return reinterpret_cast<T*>(const_cast<XrBaseOutStructure*>(header));
+            }
+        }
+        return nullptr;
+    }
+
+    constexpr uint32_t FilledCount(uint32_t capacityInput, uint32_t countOutput) {
+        return capacityInput < countOutput ? capacityInput : countOutput;
+    }
+
+    thread_local uint16_t t_stream = 0;
+} // namespace
+
+// The captured functions, and the functions that replace them in the dispatch table.
+// clang-format off
+#define INPUT_CAPTURE_LIST_FUNCTIONS(_)                                     \
+    _(xrWaitFrame, WaitFrame)                                               \
+    _(xrLocateViews, LocateViews)                                           \
+    _(xrLocateSpace, LocateSpace)                                           \
+    INPUT_CAPTURE_LIST_LOCATE_SPACES(_)                                     \
+    _(xrSyncActions, SyncActions)                                           \
+    _(xrGetActionStateBoolean, GetActionStateBoolean)                       \
+    _(xrGetActionStateFloat, GetActionStateFloat)                           \
+    _(xrGetActionStateVector2f, GetActionStateVector2f)                     \
+    _(xrGetActionStatePose, GetActionStatePose)                             \
+    _(xrLocateHandJointsEXT, LocateHandJoints)                              \
+    _(xrUpdateHandMeshMSFT, UpdateHandMesh)                                 \
+    _(xrComputeNewSceneMSFT, ComputeNewScene)                               \
+    _(xrGetSceneComputeStateMSFT, GetSceneComputeState)                     \
+    _(xrCreateSceneMSFT, CreateScene)                                       \
+    _(xrDestroySceneMSFT, DestroyScene)                                     \
+    _(xrGetSceneComponentsMSFT, GetSceneComponents)                         \
+    _(xrLocateSceneComponentsMSFT, LocateSceneComponents)                   \
+    _(xrGetSceneMeshBuffersMSFT, GetSceneMeshBuffers)                       \
+    _(xrGetSceneMarkerRawDataMSFT, GetSceneMarkerRawData)                   \
+    _(xrGetSceneMarkerDecodedStringMSFT, GetSceneMarkerDecodedString)       \
+    _(xrDeserializeSceneMSFT, DeserializeScene)                             \
+    _(xrGetSerializedSceneFragmentDataMSFT, GetSerializedSceneFragmentData)
+
+#ifdef XR_KHR_locate_spaces
+#define INPUT_CAPTURE_LIST_LOCATE_SPACES(_) _(xrLocateSpacesKHR, LocateSpaces)
+#else
+#define INPUT_CAPTURE_LIST_LOCATE_SPACES(_)
+#endif
+// clang-format on
+
+struct sample::InputCapture::Impl {
+    Impl(xr::DispatchTable& dispatchTable, InputCaptureInfo info)
+        : DispatchTable(dispatchTable)
+        , Runtime(dispatchTable)
+        , Info(std::move(info)) {
+        if (Info.Mode == InputCaptureMode::Record) {
+            File.open(Info.Path, std::ios::binary | std::ios::trunc);
+            const FileHeader header{CaptureMagic, CaptureVersion};
+            File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (!File) {
+                throw std::runtime_error(fmt::format("Failed to create input capture: {}", Info.Path.string()));
+            }
+            StartTime = std::chrono::steady_clock::now();
+        } else {
+            LoadRecords();
+        }
+    }
+
+    void Install() {
+        if (s_active != nullptr) {
+            throw std::logic_error("Only one input capture can be active at a time.");
+        }
+        s_active = this;
+
+        // Functions of extensions that are not enabled stay null.
+#define INPUT_CAPTURE_INSTALL(name, thunk) \
+    if (DispatchTable.name != nullptr) {   \
+        DispatchTable.name = &Impl::thunk; \
+    }
+        INPUT_CAPTURE_LIST_FUNCTIONS(INPUT_CAPTURE_INSTALL);
+#undef INPUT_CAPTURE_INSTALL
+
+        if (Info.Mode == InputCaptureMode::Replay) {
+            DispatchTable.xrEndFrame = &Impl::EndFrame;
+        }
+    }
+
+    void Uninstall() {
+#define INPUT_CAPTURE_UNINSTALL(name, thunk) DispatchTable.name = Runtime.name;
+        INPUT_CAPTURE_LIST_FUNCTIONS(INPUT_CAPTURE_UNINSTALL);
+#undef INPUT_CAPTURE_UNINSTALL
+        DispatchTable.xrEndFrame = Runtime.xrEndFrame;
+        s_active = nullptr;
+    }
+
+    // Records the outputs of the runtime call, or replays the recorded outputs into the same structures.
+    // Calls that reach the runtime during replay have their outputs overwritten by the recording.
+    template <typename TCall, typename TVisit>
+    XrResult Capture(FunctionId function, bool callRuntimeOnReplay, TCall&& call, TVisit&& visit) {
+        if (Info.Mode == InputCaptureMode::Record) {
+            const XrResult result = call();
+
+            thread_local std::vector<uint8_t> payload;
+            payload.clear();
+            if (XR_SUCCEEDED(result)) {
+                PayloadWriter writer(payload);
+                visit(writer);
+            }
+            AppendRecord(function, result, payload);
+            return result;
+        }
+
+        if (callRuntimeOnReplay) {
+            (void)call();
+        }
+
+        const Record record = NextRecord(function);
+        if (XR_SUCCEEDED(record.Result)) {
+            PayloadReader reader(FileData.data() + record.Offset, record.Size);
+            visit(reader);
+            if (!reader.Matches()) {
+                throw std::runtime_error(
+                    fmt::format("The outputs of function {} do not match the input capture", static_cast<uint32_t>(function)));
+            }
+        }
+        return record.Result;
+    }
+
+    void AppendRecord(FunctionId function, XrResult result, const std::vector<uint8_t>& payload) {
+        std::lock_guard lock(Mutex);
+        const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StartTime);
+        const RecordHeader header{static_cast<uint16_t>(function),
+                                  t_stream,
+                                  static_cast<int32_t>(result),
+                                  static_cast<int64_t>(timestamp.count()),
+                                  static_cast<uint32_t>(payload.size()),
+                                  0};
+
+        const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+        Buffer.insert(Buffer.end(), headerBytes, headerBytes + sizeof(header));
+        Buffer.insert(Buffer.end(), payload.begin(), payload.end());
+        RecordCount++;
+
+        if (Buffer.size() >= FlushThreshold) {
+            FlushLocked();
+        }
+    }
+
+    void FlushLocked() {
+        if (File.is_open() && !Buffer.empty()) {
+            File.write(reinterpret_cast<const char*>(Buffer.data()), Buffer.size());
+            File.flush();
+            Buffer.clear();
+            if (!File) {
+                throw std::runtime_error(fmt::format("Failed to write input capture: {}", Info.Path.string()));
+            }
+        }
+    }
+
+    struct Record {
+        XrResult Result;
+        size_t Offset;
+        uint32_t Size;
+    };
+
+    // The records of one function called from one stream, in call order.
+    struct RecordStream {
+        std::vector<Record> Records;
+        size_t Next{0};
+    };
+
+    void LoadRecords() {
+        FileData = sample::ReadFileBytes(Info.Path);
+
+        FileHeader fileHeader{};
+        if (FileData.size() < sizeof(fileHeader)) {
+            throw std::runtime_error(fmt::format("Invalid input capture: {}", Info.Path.string()));
+        }
+        memcpy(&fileHeader, FileData.data(), sizeof(fileHeader));
+        if (fileHeader.Magic != CaptureMagic || fileHeader.Version != CaptureVersion) {
+            throw std::runtime_error(fmt::format("Unsupported input capture: {}", Info.Path.string()));
+        }
+
+        // A truncated last record, e.g. from an app that did not exit cleanly, is ignored.
+        size_t offset = sizeof(fileHeader);
+        while (FileData.size() - offset >= sizeof(RecordHeader)) {
+            RecordHeader header;
+            memcpy(&header, FileData.data() + offset, sizeof(header));
+            offset += sizeof(header);
+            if (header.PayloadSize > FileData.size() - offset) {
+                break;
+            }
+
+            Streams[{header.Function, header.Stream}].Records.push_back({static_cast<XrResult>(header.Result), offset, header.PayloadSize});
+            offset += header.PayloadSize;
+            RecordCount++;
+        }
+    }
+
+    Record NextRecord(FunctionId function) {
+        std::lock_guard lock(Mutex);
+        const auto it = Streams.find({static_cast<uint16_t>(function), t_stream});
+        if (it == Streams.end() || it->second.Next == it->second.Records.size()) {
+            throw std::runtime_error(fmt::format(
+                "The input capture has no more records of function {} in stream {}", static_cast<uint32_t>(function), t_stream));
+        }
+        RecordCount--;
+        return it->second.Records[it->second.Next++];
+    }
+
+    // In replay, the application ends frames with the replayed display time. The runtime expects its own predicted time instead.
+    void MapDisplayTime(XrTime replayedTime, XrTime runtimeTime) {
+        std::lock_guard lock(Mutex);
+        DisplayTimes[NextDisplayTime] = {replayedTime, runtimeTime};
+        NextDisplayTime = (NextDisplayTime + 1) % DisplayTimes.size();
+    }
+
+    XrTime GetRuntimeDisplayTime(XrTime replayedTime) {
+        std::lock_guard lock(Mutex);
+        for (const auto& [replayed, runtime] : DisplayTimes) {
+            if (replayed == replayedTime) {
+                return runtime;
+            }
+        }
+        return replayedTime;
+    }
+
+    static Impl& Active() {
+        return *s_active;
+    }
+
+    static XrResult XRAPI_CALL WaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState) {
+        Impl& capture = Active();
+        XrTime runtimeDisplayTime = 0;
+        const XrResult result = capture.Capture(
+            FunctionId::WaitFrame,
+            true, // The runtime must still throttle the frame loop.
+            [&] {
+                const XrResult runtimeResult = capture.Runtime.xrWaitFrame(session, frameWaitInfo, frameState);
+                if (XR_SUCCEEDED(runtimeResult)) {
+                    runtimeDisplayTime = frameState->predictedDisplayTime;
+                }
+                return runtimeResult;
+            },
+            [&](auto& visitor) {
+                visitor.Value(frameState->predictedDisplayTime);
+                visitor.Value(frameState->predictedDisplayPeriod);
+                visitor.Value(frameState->shouldRender);
+            });
+
+        if (capture.Info.Mode == InputCaptureMode::Replay && XR_SUCCEEDED(result)) {
+            capture.MapDisplayTime(frameState->predictedDisplayTime, runtimeDisplayTime);
+        }
+        return result;
+    }
+
+    static XrResult XRAPI_CALL EndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo) {
+        Impl& capture = Active();
+        XrFrameEndInfo endInfo = *frameEndInfo;
+        endInfo.displayTime = capture.GetRuntimeDisplayTime(frameEndInfo->displayTime);
+        return capture.Runtime.xrEndFrame(session, &endInfo);
+    }
+
+    static XrResult XRAPI_CALL LocateViews(XrSession session,
+                                           const XrViewLocateInfo* viewLocateInfo,
+                                           XrViewState* viewState,
+                                           uint32_t viewCapacityInput,
+                                           uint32_t* viewCountOutput,
+                                           XrView* views) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::LocateViews,
+            false,
+            [&] { return capture.Runtime.xrLocateViews(session, viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views); },
+            [&](auto& visitor) {
+                visitor.Value(viewState->viewStateFlags);
+                visitor.Value(*viewCountOutput);
+                if (views != nullptr) {
+                    for (uint32_t i = 0; i < FilledCount(viewCapacityInput, *viewCountOutput); i++) {
+                        visitor.Value(views[i].pose);
+                        visitor.Value(views[i].fov);
+                    }
+                }
+            });
+    }
+
+    static XrResult XRAPI_CALL LocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::LocateSpace,
+            false,
+            [&] { return capture.Runtime.xrLocateSpace(space, baseSpace, time, location); },
+            [&](auto& visitor) {
+                visitor.Value(location->locationFlags);
+                visitor.Value(location->pose);
+                if (auto* velocity = FindOutStruct<XrSpaceVelocity>(location->next, XR_TYPE_SPACE_VELOCITY)) {
+                    visitor.Value(velocity->velocityFlags);
+                    visitor.Value(velocity->linearVelocity);
+                    visitor.Value(velocity->angularVelocity);
+                }
+            });
+    }
+
+#ifdef XR_KHR_locate_spaces
+    static XrResult XRAPI_CALL LocateSpaces(XrSession session,
+                                            const XrSpacesLocateInfoKHR* locateInfo,
+                                            XrSpaceLocationsKHR* spaceLocations) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::LocateSpaces,
+            false,
+            [&] { return capture.Runtime.xrLocateSpacesKHR(session, locateInfo, spaceLocations); },
+            [&](auto& visitor) {
+                visitor.Array(spaceLocations->locations, spaceLocations->locationCount);
+                if (auto* velocities = FindOutStruct<XrSpaceVelocitiesKHR>(spaceLocations->next, XR_TYPE_SPACE_VELOCITIES_KHR)) {
+                    visitor.Array(velocities->velocities, velocities->velocityCount);
+                }
+            });
+    }
+#endif
+
+    static XrResult XRAPI_CALL SyncActions(XrSession session, const XrActionsSyncInfo* syncInfo) {
+        Impl& capture = Active();
+        // The runtime still syncs on replay so that the session keeps its action sets attached and focused.
+        return capture.Capture(
+            FunctionId::SyncActions, true, [&] { return capture.Runtime.xrSyncActions(session, syncInfo); }, [](auto&) {});
+    }
+
+    static XrResult XRAPI_CALL GetActionStateBoolean(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetActionStateBoolean,
+            false,
+            [&] { return capture.Runtime.xrGetActionStateBoolean(session, getInfo, state); },
+            [&](auto& visitor) { VisitActionState(visitor, *state); });
+    }
+
+    static XrResult XRAPI_CALL GetActionStateFloat(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetActionStateFloat,
+            false,
+            [&] { return capture.Runtime.xrGetActionStateFloat(session, getInfo, state); },
+            [&](auto& visitor) { VisitActionState(visitor, *state); });
+    }
+
+    static XrResult XRAPI_CALL GetActionStateVector2f(XrSession session,
+                                                      const XrActionStateGetInfo* getInfo,
+                                                      XrActionStateVector2f* state) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetActionStateVector2f,
+            false,
+            [&] { return capture.Runtime.xrGetActionStateVector2f(session, getInfo, state); },
+            [&](auto& visitor) { VisitActionState(visitor, *state); });
+    }
+
+    static XrResult XRAPI_CALL GetActionStatePose(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStatePose* state) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetActionStatePose,
+            false,
+            [&] { return capture.Runtime.xrGetActionStatePose(session, getInfo, state); },
+            [&](auto& visitor) { visitor.Value(state->isActive); });
+    }
+
+    template <typename TVisitor, typename TState>
+    static void VisitActionState(TVisitor& visitor, TState& state) {
+        visitor.Value(state.currentState);
+        visitor.Value(state.changedSinceLastSync);
+        visitor.Value(state.lastChangeTime);
+        visitor.Value(state.isActive);
+    }
+
+    static XrResult XRAPI_CALL LocateHandJoints(XrHandTrackerEXT handTracker,
+                                                const XrHandJointsLocateInfoEXT* locateInfo,
+                                                XrHandJointLocationsEXT* locations) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::LocateHandJoints,
+            false,
+            [&] { return capture.Runtime.xrLocateHandJointsEXT(handTracker, locateInfo, locations); },
+            [&](auto& visitor) {
+                visitor.Value(locations->isActive);
+                visitor.Array(locations->jointLocations, locations->jointCount);
+                if (auto* velocities = FindOutStruct<XrHandJointVelocitiesEXT>(locations->next, XR_TYPE_HAND_JOINT_VELOCITIES_EXT)) {
+                    visitor.Array(velocities->jointVelocities, velocities->jointCount);
+                }
+            });
+    }
+
+    static XrResult XRAPI_CALL UpdateHandMesh(XrHandTrackerEXT handTracker,
+                                              const XrHandMeshUpdateInfoMSFT* updateInfo,
+                                              XrHandMeshMSFT* handMesh) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::UpdateHandMesh,
+            false,
+            [&] { return capture.Runtime.xrUpdateHandMeshMSFT(handTracker, updateInfo, handMesh); },
+            [&](auto& visitor) {
+                visitor.Value(handMesh->isActive);
+                visitor.Value(handMesh->indexBufferChanged);
+                visitor.Value(handMesh->vertexBufferChanged);
+
+                // Buffers are only recorded when the runtime rewrote them.
+                XrHandMeshIndexBufferMSFT& indexBuffer = handMesh->indexBuffer;
+                visitor.Value(indexBuffer.indexBufferKey);
+                visitor.Value(indexBuffer.indexCountOutput);
+                if (handMesh->indexBufferChanged) {
+                    visitor.Array(indexBuffer.indices, FilledCount(indexBuffer.indexCapacityInput, indexBuffer.indexCountOutput));
+                }
+
+                XrHandMeshVertexBufferMSFT& vertexBuffer = handMesh->vertexBuffer;
+                visitor.Value(vertexBuffer.vertexUpdateTime);
+                visitor.Value(vertexBuffer.vertexCountOutput);
+                if (handMesh->vertexBufferChanged) {
+                    visitor.Array(vertexBuffer.vertices, FilledCount(vertexBuffer.vertexCapacityInput, vertexBuffer.vertexCountOutput));
+                }
+            });
+    }
+
+    // Replayed scenes never reach the runtime. Their handles are the recorded ones and are only used as keys by the application.
+    static XrResult XRAPI_CALL ComputeNewScene(XrSceneObserverMSFT sceneObserver, const XrNewSceneComputeInfoMSFT* computeInfo) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::ComputeNewScene,
+            false,
+            [&] { return capture.Runtime.xrComputeNewSceneMSFT(sceneObserver, computeInfo); },
+            [](auto&) {});
+    }
+
+    static XrResult XRAPI_CALL GetSceneComputeState(XrSceneObserverMSFT sceneObserver, XrSceneComputeStateMSFT* state) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetSceneComputeState,
+            false,
+            [&] { return capture.Runtime.xrGetSceneComputeStateMSFT(sceneObserver, state); },
+            [&](auto& visitor) { visitor.Value(*state); });
+    }
+
+    static XrResult XRAPI_CALL CreateScene(XrSceneObserverMSFT sceneObserver, const XrSceneCreateInfoMSFT* createInfo, XrSceneMSFT* scene) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::CreateScene,
+            false,
+            [&] { return capture.Runtime.xrCreateSceneMSFT(sceneObserver, createInfo, scene); },
+            [&](auto& visitor) { visitor.Value(*scene); });
+    }
+
+    static XrResult XRAPI_CALL DestroyScene(XrSceneMSFT scene) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::DestroyScene, false, [&] { return capture.Runtime.xrDestroySceneMSFT(scene); }, [](auto&) {});
+    }
+
+    static XrResult XRAPI_CALL GetSceneComponents(XrSceneMSFT scene,
+                                                  const XrSceneComponentsGetInfoMSFT* getInfo,
+                                                  XrSceneComponentsMSFT* components) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetSceneComponents,
+            false,
+            [&] { return capture.Runtime.xrGetSceneComponentsMSFT(scene, getInfo, components); },
+            [&](auto& visitor) {
+                visitor.Value(components->componentCountOutput);
+                const uint32_t count = FilledCount(components->componentCapacityInput, components->componentCountOutput);
+                visitor.Array(components->components, count);
+
+                // The extension structures have one element per component.
+                const void* next = components->next;
+                if (auto* objects = FindOutStruct<XrSceneObjectsMSFT>(next, XR_TYPE_SCENE_OBJECTS_MSFT)) {
+                    visitor.Array(objects->sceneObjects, FilledCount(objects->sceneObjectCount, count));
+                }
+                if (auto* planes = FindOutStruct<XrScenePlanesMSFT>(next, XR_TYPE_SCENE_PLANES_MSFT)) {
+                    visitor.Array(planes->scenePlanes, FilledCount(planes->scenePlaneCount, count));
+                }
+                if (auto* meshes = FindOutStruct<XrSceneMeshesMSFT>(next, XR_TYPE_SCENE_MESHES_MSFT)) {
+                    visitor.Array(meshes->sceneMeshes, FilledCount(meshes->sceneMeshCount, count));
+                }
+                if (auto* markers = FindOutStruct<XrSceneMarkersMSFT>(next, XR_TYPE_SCENE_MARKERS_MSFT)) {
+                    visitor.Array(markers->sceneMarkers, FilledCount(markers->sceneMarkerCapacityInput, count));
+                }
+                if (auto* qrCodes = FindOutStruct<XrSceneMarkerQRCodesMSFT>(next, XR_TYPE_SCENE_MARKER_QR_CODES_MSFT)) {
+                    visitor.Array(qrCodes->qrCodes, FilledCount(qrCodes->qrCodeCapacityInput, count));
+                }
+            });
+    }
+
+    static XrResult XRAPI_CALL LocateSceneComponents(XrSceneMSFT scene,
+                                                     const XrSceneComponentsLocateInfoMSFT* locateInfo,
+                                                     XrSceneComponentLocationsMSFT* locations) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::LocateSceneComponents,
+            false,
+            [&] { return capture.Runtime.xrLocateSceneComponentsMSFT(scene, locateInfo, locations); },
+            [&](auto& visitor) { visitor.Array(locations->locations, locations->locationCount); });
+    }
+
+    static XrResult XRAPI_CALL GetSceneMeshBuffers(XrSceneMSFT scene,
+                                                   const XrSceneMeshBuffersGetInfoMSFT* getInfo,
+                                                   XrSceneMeshBuffersMSFT* buffers) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetSceneMeshBuffers,
+            false,
+            [&] { return capture.Runtime.xrGetSceneMeshBuffersMSFT(scene, getInfo, buffers); },
+            [&](auto& visitor) {
+                const void* next = buffers->next;
+                if (auto* vertices = FindOutStruct<XrSceneMeshVertexBufferMSFT>(next, XR_TYPE_SCENE_MESH_VERTEX_BUFFER_MSFT)) {
+                    visitor.Value(vertices->vertexCountOutput);
+                    visitor.Array(vertices->vertices, FilledCount(vertices->vertexCapacityInput, vertices->vertexCountOutput));
+                }
+                if (auto* indices = FindOutStruct<XrSceneMeshIndicesUint32MSFT>(next, XR_TYPE_SCENE_MESH_INDICES_UINT32_MSFT)) {
+                    visitor.Value(indices->indexCountOutput);
+                    visitor.Array(indices->indices, FilledCount(indices->indexCapacityInput, indices->indexCountOutput));
+                }
+                if (auto* indices = FindOutStruct<XrSceneMeshIndicesUint16MSFT>(next, XR_TYPE_SCENE_MESH_INDICES_UINT16_MSFT)) {
+                    visitor.Value(indices->indexCountOutput);
+                    visitor.Array(indices->indices, FilledCount(indices->indexCapacityInput, indices->indexCountOutput));
+                }
+            });
+    }
+
+    static XrResult XRAPI_CALL GetSceneMarkerRawData(
+        XrSceneMSFT scene, const XrUuidMSFT* markerId, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, uint8_t* buffer) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetSceneMarkerRawData,
+            false,
+            [&] { return capture.Runtime.xrGetSceneMarkerRawDataMSFT(scene, markerId, bufferCapacityInput, bufferCountOutput, buffer); },
+            [&](auto& visitor) {
+                visitor.Value(*bufferCountOutput);
+                visitor.Array(buffer, FilledCount(bufferCapacityInput, *bufferCountOutput));
+            });
+    }
+
+    static XrResult XRAPI_CALL GetSceneMarkerDecodedString(
+        XrSceneMSFT scene, const XrUuidMSFT* markerId, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetSceneMarkerDecodedString,
+            false,
+            [&] {
+                return capture.Runtime.xrGetSceneMarkerDecodedStringMSFT(scene, markerId, bufferCapacityInput, bufferCountOutput, buffer);
+            },
+            [&](auto& visitor) {
+                visitor.Value(*bufferCountOutput);
+                visitor.Array(buffer, FilledCount(bufferCapacityInput, *bufferCountOutput));
+            });
+    }
+
+    // A replayed deserialization completes like a replayed scene compute, through the recorded xrGetSceneComputeStateMSFT.
+    static XrResult XRAPI_CALL DeserializeScene(XrSceneObserverMSFT sceneObserver, const XrSceneDeserializeInfoMSFT* deserializeInfo) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::DeserializeScene,
+            false,
+            [&] { return capture.Runtime.xrDeserializeSceneMSFT(sceneObserver, deserializeInfo); },
+            [](auto&) {});
+    }
+
+    static XrResult XRAPI_CALL GetSerializedSceneFragmentData(XrSceneMSFT scene,
+                                                              const XrSerializedSceneFragmentDataGetInfoMSFT* getInfo,
+                                                              uint32_t countInput,
+                                                              uint32_t* readOutput,
+                                                              uint8_t* buffer) {
+        Impl& capture = Active();
+        return capture.Capture(
+            FunctionId::GetSerializedSceneFragmentData,
+            false,
+            [&] { return capture.Runtime.xrGetSerializedSceneFragmentDataMSFT(scene, getInfo, countInput, readOutput, buffer); },
+            [&](auto& visitor) {
+                visitor.Value(*readOutput);
+                visitor.Array(buffer, FilledCount(countInput, *readOutput));
+            });
+    }
+
+    inline static Impl* s_active{nullptr};
+
+    xr::DispatchTable& DispatchTable;
+    const xr::DispatchTable Runtime; // The functions of the runtime, before they were replaced.
+    const InputCaptureInfo Info;
+
+    std::mutex Mutex;
+    size_t RecordCount{0};
+
+    // Recording
+    std::ofstream File;
+    std::vector<uint8_t> Buffer;
+    std::chrono::steady_clock::time_point StartTime;
+
+    // Replay
+    std::vector<uint8_t> FileData;
+    std::map<std::pair<uint16_t, uint16_t>, RecordStream> Streams; // Keyed by function and stream.
+    std::array<std::pair<XrTime, XrTime>, DisplayTimeHistory> DisplayTimes{};
+    size_t NextDisplayTime{0};
+};
+
+#undef INPUT_CAPTURE_LIST_FUNCTIONS
+#undef INPUT_CAPTURE_LIST_LOCATE_SPACES
+
+namespace sample {
+    InputCapture::InputCapture(xr::DispatchTable& dispatchTable, InputCaptureInfo info)
+        : m_impl(std::make_unique<Impl>(dispatchTable, std::move(info))) {
+        m_impl->Install();
+        Trace("Input capture {}: {}",
+              m_impl->Info.Mode == InputCaptureMode::Record ? "recording" : "replaying",
+              m_impl->Info.Path.string());
+    }
+
+    InputCapture::~InputCapture() {
+        m_impl->Uninstall();
+        try {
+            Flush();
+        } catch (const std::exception& ex) {
+            Trace("{}", ex.what());
+        }
+    }
+
+    InputCaptureMode InputCapture::Mode() const {
+        return m_impl->Info.Mode;
+    }
+
+    size_t InputCapture::RecordCount() const {
+        std::lock_guard lock(m_impl->Mutex);
+        return m_impl->RecordCount;
+    }
+
+    void InputCapture::Flush() {
+        std::lock_guard lock(m_impl->Mutex);
+        m_impl->FlushLocked();
+    }
+
+    void InputCapture::SetThreadStream(uint16_t stream) {
+        t_stream = stream;
+    }
+
+    bool InputCapture::IsActive() {
+        return Impl::s_active != nullptr;
+    }
+} // namespace sample
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <XrUtility/XrDispatchTable.h>
+
+namespace sample {
+    enum class InputCaptureMode {
+        Record, // Call the runtime and record the results into the capture file.
+        Replay, // Return the results from the capture file instead of the results of the runtime.
+    };
+
+    struct InputCaptureInfo {
+        InputCaptureMode Mode{InputCaptureMode::Record};
+        std::filesystem::path Path;
+    };
+
+    // Records the results of the input functions of a session into a compact, timestamped binary file, and replays them
+    // later so that the same head, hand, controller and scene input can be profiled again without a device.
+    //
+    // The capture replaces the input functions in the dispatch table while it is alive, so every call made through the table is
+    // captured, and restores them when destroyed. It must be created right after the dispatch table is initialized.
+    // - Head and views: xrWaitFrame, xrLocateViews, xrLocateSpace and xrLocateSpacesKHR.
+    // - Actions: xrSyncActions and xrGetActionState*.
+    // - Hands: xrLocateHandJointsEXT and xrUpdateHandMeshMSFT.
+    // - Scene understanding: compute, create, destroy, deserialize and all queries of scenes, including markers and
+    //   serialized fragments.
+    //
+    // Each function replays its own records in call order, per thread stream. Replay throws if the application runs past the end
+    // of the recording, or queries outputs that do not match the recorded ones, e.g. a different view capacity or velocity chain.
+    // The calls must only depend on captured input, e.g. not on files written by a previous run, see InputCapture::IsActive.
+    // In replay, xrWaitFrame and xrSyncActions still reach the runtime to pace the frame loop. Replayed scenes are not backed
+    // by the runtime at all. All other functions, including the creation of sessions, spaces and trackers, still go to the
+    // runtime, so it must support the same extensions, e.g. a simulated device.
+    class InputCapture {
+    public:
+        InputCapture(xr::DispatchTable& dispatchTable, InputCaptureInfo info);
+        ~InputCapture();
+
+        InputCapture(const InputCapture&) = delete;
+        InputCapture& operator=(const InputCapture&) = delete;
+
+        InputCaptureMode Mode() const;
+
+        // Records written so far, or records left to replay.
+        size_t RecordCount() const;
+
+        // Write the buffered records to the file. Called when the capture is destroyed.
+        void Flush();
+
+        // Calls of the current thread are recorded and replayed in their own stream, e.g. 1 for a render thread,
+        // so that their order relative to other threads does not matter. Threads use stream 0 by default.
+        static void SetThreadStream(uint16_t stream);
+
+        // Streams from this one on are left to the background threads of scenes, e.g. a thread processing the results of
+        // a scene compute. Lower streams are used by the frame loop and the scene updates of XrSceneLib.
+        static constexpr uint16_t FirstBackgroundStream = 0x100;
+
+        // True while an input capture records or replays, e.g. to disable features whose calls depend on local files.
+        static bool IsActive();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+} // namespace sample
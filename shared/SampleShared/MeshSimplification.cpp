@@ -0,0 +1,441 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <XrUtility/XrMath.h>
+#include "MeshSimplification.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t RemovedTriangle = std::numeric_limits<uint32_t>::max();
+
+    XMVECTOR XM_CALLCONV Load(const XrVector3f& v) {
+        return XMVectorSet(v.x, v.y, v.z, 0);
+    }
+
+    // Merge vertices closer than weldDistance using a spatial hash. Returns the representative of each input vertex.
+    std::vector<uint32_t> WeldVertices(const std::vector<XrVector3f>& positions, float weldDistance) {
+        std::vector<uint32_t> remap(positions.size());
+        if (weldDistance <= 0) {
+            std::iota(remap.begin(), remap.end(), 0);
+            return remap;
+        }
+
+        const auto cellOf = [inverseCellSize = 1.0f / weldDistance](float value) {
+            return static_cast<int64_t>(std::floor(value * inverseCellSize));
+        };
+        const auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+            // Interleave the cell coordinates with large primes to spread them over the hash table.
+            return static_cast<uint64_t>(x * 73856093) ^ static_cast<uint64_t>(y * 19349663) ^ static_cast<uint64_t>(z * 83492791);
+        };
+
+        std::unordered_multimap<uint64_t, uint32_t> cells;
+        cells.reserve(positions.size());
+        const float weldDistanceSquared = weldDistance * weldDistance;
+        for (uint32_t i = 0; i < positions.size(); i++) {
+            const XrVector3f& p = positions[i];
+            const int64_t cx = cellOf(p.x), cy = cellOf(p.y), cz = cellOf(p.z);
+
+            std::optional<uint32_t> representative;
+            for (int64_t x = cx - 1; x <= cx + 1 && !representative; x++) {
+                for (int64_t y = cy - 1; y <= cy + 1 && !representative; y++) {
+                    for (int64_t z = cz - 1; z <= cz + 1 && !representative; z++) {
+                        const auto [begin, end] = cells.equal_range(cellKey(x, y, z));
+                        for (auto it = begin; it != end; ++it) {
+                            const XrVector3f& q = positions[it->second];
+                            const float dx = p.x - q.x, dy = p.y - q.y, dz = p.z - q.z;
+                            if (dx * dx + dy * dy + dz * dz <= weldDistanceSquared) {
+                                representative = it->second;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (representative) {
+                remap[i] = representative.value();
+            } else {
+                remap[i] = i;
+                cells.emplace(cellKey(cx, cy, cz), i);
+            }
+        }
+        return remap;
+    }
+
+    // Symmetric 4x4 error quadric of the weighted sum of squared distances to a set of planes, and the area of the surface these
+    // planes were taken from. Constraint planes, e.g. along boundary edges, add to the error but not to the area.
+    struct Quadric {
+        double a2{}, ab{}, ac{}, ad{}, b2{}, bc{}, bd{}, c2{}, cd{}, d2{};
+        double area{};
+
+        static Quadric FromPlane(double a, double b, double c, double d, double weight, double area) {
+            Quadric q;
+            q.a2 = weight * a * a, q.ab = weight * a * b, q.ac = weight * a * c, q.ad = weight * a * d;
+            q.b2 = weight * b * b, q.bc = weight * b * c, q.bd = weight * b * d;
+            q.c2 = weight * c * c, q.cd = weight * c * d;
+            q.d2 = weight * d * d;
+            q.area = area;
+            return q;
+        }
+
+        Quadric& operator+=(const Quadric& o) {
+            a2 += o.a2, ab += o.ab, ac += o.ac, ad += o.ad, b2 += o.b2, bc += o.bc, bd += o.bd, c2 += o.c2, cd += o.cd, d2 += o.d2;
+            area += o.area;
+            return *this;
+        }
+
+        double Evaluate(const XrVector3f& p) const {
+            const double x = p.x, y = p.y, z = p.z;
+            return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x + b2 * y * y + 2 * bc * y * z + 2 * bd * y + c2 * z * z +
+                   2 * cd * z + d2;
+        }
+
+        // The area weighted mean of the squared distances to the surface in square meters, so that it can be compared against a
+        // distance whatever the size of the triangles. The error of the constraint planes is added on top rather than averaged
+        // with the surface, so that they keep their weight relative to the surface.
+        double MeanSquaredDistance(const XrVector3f& p) const {
+            return area > 0 ? std::max(Evaluate(p), 0.0) / area : 0.0;
+        }
+    };
+
+    struct CollapseCandidate {
+        double cost; // Mean squared distance of the kept vertex from the planes of both vertices.
+        uint32_t from; // Vertex removed by the collapse.
+        uint32_t to;   // Vertex kept by the collapse.
+        uint32_t fromVersion;
+        uint32_t toVersion;
+
+        bool operator>(const CollapseCandidate& other) const {
+            return cost > other.cost;
+        }
+    };
+
+    // Quadric error metric decimation using half-edge collapses, so that vertices stay on the original surface.
+    class Decimator {
+    public:
+        Decimator(std::vector<XrVector3f>& positions, std::vector<uint32_t>& indices)
+            : m_positions(positions)
+            , m_indices(indices)
+            , m_quadrics(positions.size())
+            , m_vertexTriangles(positions.size())
+            , m_versions(positions.size(), 0) {
+            const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+            m_liveTriangleCount = triangleCount;
+
+            std::unordered_map<uint64_t, uint32_t> edgeUseCount;
+            for (uint32_t t = 0; t < triangleCount; t++) {
+                const uint32_t* tri = &m_indices[t * 3];
+                for (uint32_t k = 0; k < 3; k++) {
+                    m_vertexTriangles[tri[k]].push_back(t);
+                    edgeUseCount[EdgeKey(tri[k], tri[(k + 1) % 3])]++;
+                }
+
+                const std::optional<XMVECTOR> plane = TrianglePlane(tri[0], tri[1], tri[2]);
+                if (plane) {
+                    const XMVECTOR p0 = Load(m_positions[tri[0]]);
+                    const XMVECTOR cross = XMVector3Cross(Load(m_positions[tri[1]]) - p0, Load(m_positions[tri[2]]) - p0);
+                    const double area = XMVectorGetX(XMVector3Length(cross)) / 2.0;
+                    const XMFLOAT4 p = StorePlane(plane.value());
+                    const Quadric q = Quadric::FromPlane(p.x, p.y, p.z, p.w, area, area);
+                    for (uint32_t k = 0; k < 3; k++) {
+                        m_quadrics[tri[k]] += q;
+                    }
+                }
+            }
+
+            // Constrain boundary edges with a heavily weighted plane perpendicular to the surface, so that holes and the outline of the
+            // scanned region are preserved.
+            constexpr double BoundaryWeight = 1000.0;
+            for (uint32_t t = 0; t < triangleCount; t++) {
+                const uint32_t* tri = &m_indices[t * 3];
+                const std::optional<XMVECTOR> plane = TrianglePlane(tri[0], tri[1], tri[2]);
+                if (!plane) {
+                    continue;
+                }
+                for (uint32_t k = 0; k < 3; k++) {
+                    const uint32_t v0 = tri[k], v1 = tri[(k + 1) % 3];
+                    if (edgeUseCount[EdgeKey(v0, v1)] != 1) {
+                        continue;
+                    }
+                    const XMVECTOR p0 = Load(m_positions[v0]);
+                    const XMVECTOR edge = Load(m_positions[v1]) - p0;
+                    const XMVECTOR normal = XMVector3Normalize(XMVector3Cross(edge, plane.value()));
+                    if (XMVector3Equal(normal, XMVectorZero())) {
+                        continue;
+                    }
+                    const XMFLOAT4 p = StorePlane(XMVectorSetW(normal, -XMVectorGetX(XMVector3Dot(normal, p0))));
+                    const double length = XMVectorGetX(XMVector3Length(edge));
+                    const Quadric q = Quadric::FromPlane(p.x, p.y, p.z, p.w, BoundaryWeight * length * length, 0);
+                    m_quadrics[v0] += q;
+                    m_quadrics[v1] += q;
+                }
+            }
+
+            for (uint32_t v = 0; v < m_positions.size(); v++) {
+                PushCandidates(v);
+            }
+        }
+
+        // Collapse until the triangle budget is met, as long as collapses cost at most maxCost square meters.
+        void Run(uint32_t triangleBudget, double maxCost) {
+            while (m_liveTriangleCount > triangleBudget && !m_candidates.empty()) {
+                const CollapseCandidate candidate = m_candidates.top();
+                m_candidates.pop();
+                if (candidate.cost > maxCost) {
+                    break;
+                }
+                if (candidate.fromVersion != m_versions[candidate.from] || candidate.toVersion != m_versions[candidate.to]) {
+                    continue; // Stale, a newer candidate was pushed after the vertices changed.
+                }
+                if (!CanCollapse(candidate.from, candidate.to)) {
+                    continue;
+                }
+                Collapse(candidate.from, candidate.to);
+            }
+        }
+
+    private:
+        static uint64_t EdgeKey(uint32_t a, uint32_t b) {
+            return a < b ? (uint64_t{a} << 32) | b : (uint64_t{b} << 32) | a;
+        }
+
+        static XMFLOAT4 StorePlane(FXMVECTOR plane) {
+            XMFLOAT4 p;
+            XMStoreFloat4(&p, plane);
+            return p;
+        }
+
+        std::optional<XMVECTOR> TrianglePlane(uint32_t i0, uint32_t i1, uint32_t i2) const {
+            const XMVECTOR p0 = Load(m_positions[i0]);
+            const XMVECTOR normal = XMVector3Cross(Load(m_positions[i1]) - p0, Load(m_positions[i2]) - p0);
+            if (XMVectorGetX(XMVector3LengthSq(normal)) <= 1e-20f) {
+                return {};
+            }
+            const XMVECTOR n = XMVector3Normalize(normal);
+            return XMVectorSetW(n, -XMVectorGetX(XMVector3Dot(n, p0)));
+        }
+
+        void PushCandidates(uint32_t v) {
+            for (uint32_t t : m_vertexTriangles[v]) {
+                const uint32_t* tri = &m_indices[t * 3];
+                for (uint32_t k = 0; k < 3; k++) {
+                    const uint32_t other = tri[k];
+                    if (other == v) {
+                        continue;
+                    }
+                    Quadric q = m_quadrics[v];
+                    q += m_quadrics[other];
+                    const double costToOther = q.MeanSquaredDistance(m_positions[other]);
+                    const double costToThis = q.MeanSquaredDistance(m_positions[v]);
+                    if (costToOther <= costToThis) {
+                        m_candidates.push({costToOther, v, other, m_versions[v], m_versions[other]});
+                    } else {
+                        m_candidates.push({costToThis, other, v, m_versions[other], m_versions[v]});
+                    }
+                }
+            }
+        }
+
+        // Reject collapses that would flip or degenerate a remaining triangle.
+        bool CanCollapse(uint32_t from, uint32_t to) const {
+            const XMVECTOR target = Load(m_positions[to]);
+            for (uint32_t t : m_vertexTriangles[from]) {
+                const uint32_t* tri = &m_indices[t * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to) {
+                    continue; // Removed by the collapse.
+                }
+
+                XMVECTOR before[3], after[3];
+                for (uint32_t k = 0; k < 3; k++) {
+                    before[k] = Load(m_positions[tri[k]]);
+                    after[k] = tri[k] == from ? target : before[k];
+                }
+                const XMVECTOR normalBefore = XMVector3Cross(before[1] - before[0], before[2] - before[0]);
+                const XMVECTOR normalAfter = XMVector3Cross(after[1] - after[0], after[2] - after[0]);
+                const float lengthsSquared = XMVectorGetX(XMVector3LengthSq(normalBefore)) * XMVectorGetX(XMVector3LengthSq(normalAfter));
+                if (lengthsSquared <= 1e-30f) {
+                    return false;
+                }
+                // Allow at most about 60 degrees of rotation of any remaining triangle.
+                const float dot = XMVectorGetX(XMVector3Dot(normalBefore, normalAfter));
+                if (dot <= 0 || dot * dot < 0.25f * lengthsSquared) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void Collapse(uint32_t from, uint32_t to) {
+            std::vector<uint32_t>& toTriangles = m_vertexTriangles[to];
+            for (uint32_t t : m_vertexTriangles[from]) {
+                uint32_t* tri = &m_indices[t * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to) {
+                    // The triangle collapses to an edge. Remove it from the adjacency of its other vertices.
+                    for (uint32_t k = 0; k < 3; k++) {
+                        if (tri[k] != from) {
+                            std::vector<uint32_t>& triangles = m_vertexTriangles[tri[k]];
+                            triangles.erase(std::remove(triangles.begin(), triangles.end(), t), triangles.end());
+                        }
+                    }
+                    tri[0] = tri[1] = tri[2] = RemovedTriangle;
+                    m_liveTriangleCount--;
+                } else {
+                    std::replace(tri, tri + 3, from, to);
+                    toTriangles.push_back(t);
+                }
+            }
+            m_vertexTriangles[from].clear();
+            m_quadrics[to] += m_quadrics[from];
+
+            // Invalidate the candidates of every vertex around the changed triangles and push new ones.
+            m_versions[from]++;
+            m_versions[to]++;
+            for (uint32_t t : toTriangles) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    if (m_indices[t * 3 + k] != to) {
+                        m_versions[m_indices[t * 3 + k]]++;
+                    }
+                }
+            }
+            PushCandidates(to);
+            for (uint32_t t : toTriangles) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    if (m_indices[t * 3 + k] != to) {
+                        PushCandidates(m_indices[t * 3 + k]);
+                    }
+                }
+            }
+        }
+
+        std::vector<XrVector3f>& m_positions;
+        std::vector<uint32_t>& m_indices;
+        std::vector<Quadric> m_quadrics;
+        std::vector<std::vector<uint32_t>> m_vertexTriangles;
+        std::vector<uint32_t> m_versions;
+        std::priority_queue<CollapseCandidate, std::vector<CollapseCandidate>, std::greater<CollapseCandidate>> m_candidates;
+        uint32_t m_liveTriangleCount{0};
+    };
+
+    // Remove unreferenced vertices and removed triangles.
+    void Compact(const std::vector<XrVector3f>& positions, const std::vector<uint32_t>& indices, sample::SimplifiedMesh& mesh) {
+        constexpr uint32_t Unused = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> newIndex(positions.size(), Unused);
+        mesh.Positions.clear();
+        mesh.Indices.clear();
+        mesh.Indices.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+            if (a == RemovedTriangle || a == b || b == c || a == c) {
+                continue;
+            }
+            for (uint32_t v : {a, b, c}) {
+                if (newIndex[v] == Unused) {
+                    newIndex[v] = static_cast<uint32_t>(mesh.Positions.size());
+                    mesh.Positions.push_back(positions[v]);
+                }
+                mesh.Indices.push_back(newIndex[v]);
+            }
+        }
+    }
+
+    // Area weighted vertex normals, using the same winding as the scene understanding meshes.
+    void GenerateNormals(sample::SimplifiedMesh& mesh) {
+        std::vector<XMVECTOR> sums(mesh.Positions.size(), XMVectorZero());
+        for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3) {
+            const uint32_t a = mesh.Indices[i], b = mesh.Indices[i + 1], c = mesh.Indices[i + 2];
+            const XMVECTOR p0 = Load(mesh.Positions[a]);
+            const XMVECTOR normal = XMVector3Cross(Load(mesh.Positions[b]) - p0, Load(mesh.Positions[c]) - p0);
+            sums[a] += normal;
+            sums[b] += normal;
+            sums[c] += normal;
+        }
+
+        mesh.Normals.resize(mesh.Positions.size());
+        for (size_t v = 0; v < sums.size(); v++) {
+            xr::math::StoreXrVector3(&mesh.Normals[v], XMVector3Normalize(sums[v]));
+        }
+    }
+} // namespace
+
+namespace sample {
+    MeshSimplificationOptions GetMeshSimplificationOptions(XrSceneComputeConsistencyMSFT consistency) {
+        MeshSimplificationOptions options;
+        switch (consistency) {
+        case XR_SCENE_COMPUTE_CONSISTENCY_SNAPSHOT_COMPLETE_MSFT:
+            options.TriangleBudget = 50000;
+            options.MaxError = 0.01f;
+            options.GenerateNormals = true;
+            break;
+        case XR_SCENE_COMPUTE_CONSISTENCY_SNAPSHOT_INCOMPLETE_FAST_MSFT:
+            options.TriangleBudget = 10000;
+            options.MaxError = 0.03f;
+            options.GenerateNormals = true;
+            break;
+        case XR_SCENE_COMPUTE_CONSISTENCY_OCCLUSION_OPTIMIZED_MSFT:
+            // Occlusion meshes are only rendered to depth, so normals are not needed.
+            options.TriangleBudget = 5000;
+            options.MaxError = 0.05f;
+            options.GenerateNormals = false;
+            break;
+        default:
+            break;
+        }
+        return options;
+    }
+
+    SimplifiedMesh SimplifyMesh(const std::vector<XrVector3f>& positions,
+                                const std::vector<uint32_t>& indices,
+                                const MeshSimplificationOptions& options) {
+        const std::vector<uint32_t> remap = WeldVertices(positions, options.WeldDistance);
+
+        std::vector<XrVector3f> workingPositions = positions;
+        std::vector<uint32_t> workingIndices;
+        workingIndices.reserve(indices.size() - indices.size() % 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const uint32_t a = remap.at(indices[i]), b = remap.at(indices[i + 1]), c = remap.at(indices[i + 2]);
+            if (a != b && b != c && a != c) {
+                workingIndices.insert(workingIndices.end(), {a, b, c});
+            }
+        }
+
+        if (options.TriangleBudget > 0 && workingIndices.size() / 3 > options.TriangleBudget) {
+            Decimator decimator(workingPositions, workingIndices);
+            decimator.Run(options.TriangleBudget, static_cast<double>(options.MaxError) * options.MaxError);
+        }
+
+        SimplifiedMesh mesh;
+        Compact(workingPositions, workingIndices, mesh);
+        if (options.GenerateNormals) {
+            GenerateNormals(mesh);
+        }
+        return mesh;
+    }
+
+    std::future<SimplifiedMesh> SimplifyMeshAsync(ThreadPool& threadPool,
+                                                  std::vector<XrVector3f> positions,
+                                                  std::vector<uint32_t> indices,
+                                                  MeshSimplificationOptions options) {
+        std::promise<SimplifiedMesh> promise;
+        std::future<SimplifiedMesh> future = promise.get_future();
+        const bool submitted = threadPool.Submit(
+            [promise = std::move(promise), positions = std::move(positions), indices = std::move(indices), options]() mutable {
+                try {
+                    promise.set_value(SimplifyMesh(positions, indices, options));
+                } catch (...) {
+                    promise.set_exception(std::current_exception());
+                }
+            });
+        if (!submitted) {
+            throw std::runtime_error("The thread pool does not accept new tasks");
+        }
+        return future;
+    }
+} // namespace sample
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include <future>
+#include <vector>
+#include "ThreadPool.h"
+
+namespace sample {
+
+    struct MeshSimplificationOptions {
+        // Vertices closer than this distance in meters are merged. Zero disables welding.
+        float WeldDistance{0.005f};
+
+        // The mesh is decimated until it has at most this many triangles. Zero disables decimation.
+        uint32_t TriangleBudget{0};
+
+        // Collapses are not made when the kept vertex is further than this distance in meters from the surface it replaces, as
+        // the area weighted root mean square distance to its planes, even when over the triangle budget. Flat regions cost nothing
+        // to simplify, so they are reduced first while edges between them are preserved.
+        float MaxError{0.02f};
+
+        // Generate smooth per-vertex normals for the simplified mesh.
+        bool GenerateNormals{false};
+    };
+
+    struct SimplifiedMesh {
+        std::vector<XrVector3f> Positions;
+        std::vector<XrVector3f> Normals; // Empty unless MeshSimplificationOptions::GenerateNormals is set.
+        std::vector<uint32_t> Indices;
+    };
+
+    // Default options for meshes computed with the given consistency. Faster consistencies are simplified more aggressively
+    // because they are typically used for quick, coarse visualizations or occlusion.
+    MeshSimplificationOptions GetMeshSimplificationOptions(XrSceneComputeConsistencyMSFT consistency);
+
+    // Weld, decimate and optionally generate normals for a triangle list, e.g. from xr::ReadMeshBuffers.
+    SimplifiedMesh SimplifyMesh(const std::vector<XrVector3f>& positions,
+                                const std::vector<uint32_t>& indices,
+                                const MeshSimplificationOptions& options);
+
+    // Simplify a mesh on the given thread pool.
+    std::future<SimplifiedMesh> SimplifyMeshAsync(ThreadPool& threadPool,
+                                                  std::vector<XrVector3f> positions,
+                                                  std::vector<uint32_t> indices,
+                                                  MeshSimplificationOptions options);
+
+} // namespace sample
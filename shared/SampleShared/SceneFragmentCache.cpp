@@ -0,0 +1,223 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <fstream>
+#include <XrUtility/XrSceneUnderstandingSerialization.hpp>
+#include "FileUtility.h"
+#include "SceneFragmentCache.h"
+
+namespace {
+    constexpr uint32_t IndexMagic = 0x49465353; // "SSFI"
+    constexpr uint32_t IndexVersion = 1;
+    constexpr wchar_t IndexFileName[] = L"fragments.index";
+
+    // Fixed-size record of one fragment in the index file.
+    struct IndexRecord {
+        XrUuidMSFT Id;
+        XrTime UpdateTime;
+        uint64_t Size;
+        uint64_t ContentHash;
+    };
+
+    struct IndexHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t RecordCount;
+        uint32_t RecordSize;
+    };
+
+    // 64-bit FNV-1a
+    uint64_t HashContent(const uint8_t* data, size_t size) noexcept {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Write to a temporary file first so that an interrupted write never leaves a truncated file behind.
+    void WriteFileBytes(const std::filesystem::path& path, const void* data, size_t size) {
+        std::filesystem::path tempPath = path;
+        tempPath += L".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data), size);
+            if (!file) {
+                throw std::runtime_error(fmt::format("Failed to write file: {}", tempPath.string()));
+            }
+        }
+        std::filesystem::rename(tempPath, path);
+    }
+} // namespace
+
+namespace sample {
+    SceneFragmentCache::SceneFragmentCache(std::filesystem::path directory)
+        : m_directory(std::move(directory)) {
+        std::filesystem::create_directories(m_directory);
+        LoadIndex();
+    }
+
+    SceneFragmentCacheStats SceneFragmentCache::Update(XrSceneMSFT scene) {
+        SceneFragmentCacheStats stats;
+        bool indexChanged = false;
+
+        const std::vector<xr::su::SceneFragment> fragments = xr::su::GetSerializedSceneFragments(scene);
+        std::vector<XrUuidMSFT> ids;
+        ids.reserve(fragments.size());
+        for (const xr::su::SceneFragment& fragment : fragments) {
+            const XrUuidMSFT id = static_cast<XrUuidMSFT>(fragment.id);
+            ids.push_back(id);
+            if (IsUpToDate(id, fragment.updateTime)) {
+                stats.UnchangedCount++;
+                continue;
+            }
+
+            // Either the content or the update time of the fragment changed.
+            xr::su::ReadSceneFragmentData(scene, fragment.id, m_scratchBuffer);
+            indexChanged = true;
+            if (StoreFragment(id, fragment.updateTime, m_scratchBuffer.data(), m_scratchBuffer.size())) {
+                stats.WrittenCount++;
+            } else {
+                stats.UnchangedCount++;
+            }
+        }
+
+        stats.RemovedCount = RetainFragments(ids);
+        stats.FragmentCount = static_cast<uint32_t>(m_entries.size());
+        if (indexChanged || stats.RemovedCount > 0) {
+            SaveIndex();
+        }
+        return stats;
+    }
+
+    bool SceneFragmentCache::IsUpToDate(const XrUuidMSFT& id, XrTime updateTime) const {
+        const auto it = m_entries.find(id);
+        return it != m_entries.end() && it->second.UpdateTime == updateTime;
+    }
+
+    bool SceneFragmentCache::StoreFragment(const XrUuidMSFT& id, XrTime updateTime, const uint8_t* data, size_t size) {
+        Entry entry;
+        entry.UpdateTime = updateTime;
+        entry.Size = size;
+        entry.ContentHash = HashContent(data, size);
+
+        auto it = m_entries.find(id);
+        if (it != m_entries.end() && it->second.Size == entry.Size && it->second.ContentHash == entry.ContentHash) {
+            it->second.UpdateTime = updateTime;
+            return false;
+        }
+
+        WriteFileBytes(GetFragmentPath(id), data, size);
+        m_entries[id] = entry;
+        return true;
+    }
+
+    uint32_t SceneFragmentCache::RetainFragments(const std::vector<XrUuidMSFT>& ids) {
+        const std::set<XrUuidMSFT> retained(ids.begin(), ids.end());
+        uint32_t removedCount = 0;
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (retained.count(it->first) == 0) {
+                std::error_code ec;
+                std::filesystem::remove(GetFragmentPath(it->first), ec);
+                it = m_entries.erase(it);
+                removedCount++;
+            } else {
+                ++it;
+            }
+        }
+        return removedCount;
+    }
+
+    void SceneFragmentCache::SaveIndex() const {
+        std::vector<uint8_t> data(sizeof(IndexHeader) + m_entries.size() * sizeof(IndexRecord));
+
+        const IndexHeader header{IndexMagic, IndexVersion, static_cast<uint32_t>(m_entries.size()), sizeof(IndexRecord)};
+        memcpy(data.data(), &header, sizeof(header));
+
+        uint8_t* recordData = data.data() + sizeof(IndexHeader);
+        for (const auto& [id, entry] : m_entries) {
+            const IndexRecord record{id, entry.UpdateTime, entry.Size, entry.ContentHash};
+            memcpy(recordData, &record, sizeof(record));
+            recordData += sizeof(record);
+        }
+
+        WriteFileBytes(m_directory / IndexFileName, data.data(), data.size());
+    }
+
+    std::vector<std::vector<uint8_t>> SceneFragmentCache::LoadFragments() {
+        std::vector<std::vector<uint8_t>> fragments;
+        fragments.reserve(m_entries.size());
+
+        std::vector<XrUuidMSFT> validIds;
+        validIds.reserve(m_entries.size());
+        for (const auto& [id, entry] : m_entries) {
+            const std::filesystem::path path = GetFragmentPath(id);
+            std::error_code ec;
+            if (!std::filesystem::exists(path, ec)) {
+                sample::Trace("Scene fragment cache is missing {}", path.string());
+                continue;
+            }
+
+            std::vector<uint8_t> data = ReadFileBytes(path);
+            if (data.size() != entry.Size || HashContent(data.data(), data.size()) != entry.ContentHash) {
+                sample::Trace("Scene fragment cache has a corrupted fragment {}", path.string());
+                continue;
+            }
+
+            validIds.push_back(id);
+            fragments.push_back(std::move(data));
+        }
+
+        if (RetainFragments(validIds) > 0) {
+            SaveIndex();
+        }
+        return fragments;
+    }
+
+    void SceneFragmentCache::Clear() {
+        RetainFragments({});
+        std::error_code ec;
+        std::filesystem::remove(m_directory / IndexFileName, ec);
+    }
+
+    std::filesystem::path SceneFragmentCache::GetFragmentPath(const XrUuidMSFT& id) const {
+        std::string name;
+        name.reserve(std::size(id.bytes) * 2 + 4);
+        for (uint8_t byte : id.bytes) {
+            name += fmt::format("{:02x}", byte);
+        }
+        name += ".bin";
+        return m_directory / name;
+    }
+
+    void SceneFragmentCache::LoadIndex() {
+        m_entries.clear();
+
+        const std::filesystem::path indexPath = m_directory / IndexFileName;
+        std::error_code ec;
+        if (!std::filesystem::exists(indexPath, ec)) {
+            return;
+        }
+
+        const std::vector<uint8_t> data = ReadFileBytes(indexPath);
+        IndexHeader header{};
+        if (data.size() >= sizeof(header)) {
+            memcpy(&header, data.data(), sizeof(header));
+        }
+        if (header.Magic != IndexMagic || header.Version != IndexVersion || header.RecordSize != sizeof(IndexRecord) ||
+            data.size() != sizeof(header) + uint64_t{header.RecordCount} * sizeof(IndexRecord)) {
+            // An unreadable index makes all fragment files unusable, so start over.
+            sample::Trace("Ignoring invalid scene fragment index {}", indexPath.string());
+            return;
+        }
+
+        const uint8_t* recordData = data.data() + sizeof(header);
+        for (uint32_t i = 0; i < header.RecordCount; i++) {
+            IndexRecord record;
+            memcpy(&record, recordData, sizeof(record));
+            recordData += sizeof(record);
+            m_entries[record.Id] = Entry{record.UpdateTime, record.Size, record.ContentHash};
+        }
+    }
+} // namespace sample
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include <filesystem>
+#include <map>
+#include <vector>
+#include <XrUtility/XrUuid.h>
+
+namespace sample {
+    struct SceneFragmentCacheStats {
+        uint32_t FragmentCount{0};  // Fragments in the cache after the update.
+        uint32_t WrittenCount{0};   // Fragments whose content changed and were written to disk.
+        uint32_t UnchangedCount{0}; // Fragments that were skipped because their update time or content hash did not change.
+        uint32_t RemovedCount{0};   // Fragments that are no longer part of the scene and were deleted.
+    };
+
+    // Persists the serialized fragments of a scene in a directory, so that a previously observed environment can be
+    // deserialized at startup, before the first scene compute completes.
+    // Each fragment is stored in its own file named by the fragment UUID. A compact index file records the update time,
+    // size and content hash of every fragment, so that unchanged fragments are neither read from the runtime nor rewritten.
+    class SceneFragmentCache {
+    public:
+        explicit SceneFragmentCache(std::filesystem::path directory);
+
+        bool Empty() const noexcept {
+            return m_entries.empty();
+        }
+
+        size_t FragmentCount() const noexcept {
+            return m_entries.size();
+        }
+
+        // Store the serialized fragments of a scene computed with XR_SCENE_COMPUTE_FEATURE_SERIALIZE_SCENE_MSFT.
+        // Fragments missing from the scene are removed from the cache.
+        SceneFragmentCacheStats Update(XrSceneMSFT scene);
+
+        // Returns true if the fragment is cached with the given update time, so its data does not need to be read again.
+        bool IsUpToDate(const XrUuidMSFT& id, XrTime updateTime) const;
+
+        // Store the data of one fragment. Returns true if the data was written, or false if the cached content was identical.
+        // The index file is only written by SaveIndex.
+        bool StoreFragment(const XrUuidMSFT& id, XrTime updateTime, const uint8_t* data, size_t size);
+
+        // Remove all cached fragments that are not in the given list. Returns the number of removed fragments.
+        uint32_t RetainFragments(const std::vector<XrUuidMSFT>& ids);
+
+        void SaveIndex() const;
+
+        // Read all cached fragments, e.g. for xr::su::DeserializeScene.
+        // Fragments whose file is missing or does not match the size and hash in the index are dropped from the cache.
+        std::vector<std::vector<uint8_t>> LoadFragments();
+
+        // Delete all cached fragments and the index file.
+        void Clear();
+
+    private:
+        struct Entry {
+            XrTime UpdateTime{0};
+            uint64_t Size{0};
+            uint64_t ContentHash{0};
+        };
+
+        std::filesystem::path GetFragmentPath(const XrUuidMSFT& id) const;
+        void LoadIndex();
+
+        const std::filesystem::path m_directory;
+        std::map<XrUuidMSFT, Entry> m_entries;
+        std::vector<uint8_t> m_scratchBuffer;
+    };
+} // namespace sample
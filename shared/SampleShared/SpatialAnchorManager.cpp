@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <algorithm>
+#include <XrUtility/XrMath.h>
+#include "SpatialAnchorManager.h"
+
+using namespace xr::math;
+
+namespace {
+    XrSpatialAnchorPersistenceNameMSFT ToPersistenceName(std::string_view name) {
+        XrSpatialAnchorPersistenceNameMSFT persistenceName{};
+        if (name.empty() || name.size() >= XR_MAX_SPATIAL_ANCHOR_NAME_SIZE_MSFT) {
+            throw std::invalid_argument(fmt::format("Invalid spatial anchor name: '{}'", name));
+        }
+        std::copy(name.begin(), name.end(), persistenceName.name);
+        return persistenceName;
+    }
+} // namespace
+
+namespace sample {
+    AnchorTrackingState GetAnchorTrackingState(XrSpaceLocationFlags locationFlags) {
+        if (!Pose::IsPoseValid(locationFlags)) {
+            return AnchorTrackingState::Lost;
+        }
+        return Pose::IsPoseTracked(locationFlags) ? AnchorTrackingState::Tracked : AnchorTrackingState::Inferred;
+    }
+
+    uint32_t GetAnchorLocateInterval(const SpatialAnchorOptions& options,
+                                     AnchorTrackingState state,
+                                     float viewerDistance,
+                                     uint32_t staticLocateCount) {
+        if (state != AnchorTrackingState::Tracked) {
+            return 1;
+        }
+
+        uint32_t interval = viewerDistance > options.FarDistance    ? options.FarLocateInterval
+                            : viewerDistance > options.NearDistance ? options.MidLocateInterval
+                                                                    : 1;
+        if (staticLocateCount >= options.StaticLocateCount) {
+            interval *= 2;
+        }
+        return std::clamp(interval, 1u, std::max(options.MaxLocateInterval, 1u));
+    }
+
+    SpatialAnchorManager::SpatialAnchorManager(XrSession session, const xr::EnabledExtensions& extensions, SpatialAnchorOptions options)
+        : m_session(session)
+        , m_options(std::move(options))
+        , m_persistenceSupported(extensions.XR_MSFT_spatial_anchor_persistence_enabled)
+        , m_spaceLocator(session, extensions.IsEnabled("XR_KHR_locate_spaces")) {
+    }
+
+    std::optional<PlacementId> SpatialAnchorManager::Place(XrSpace space, const XrPosef& pose, XrTime time) {
+        // Anchor poses are known in the base space of the last update only, so placements in other spaces always get a new anchor.
+        if (space == m_baseSpace) {
+            std::optional<AnchorId> nearestAnchor;
+            float nearestDistance = m_options.ClusterRadius;
+            for (AnchorId id = 0; id < m_anchors.size(); id++) {
+                const Anchor& anchor = m_anchors[id];
+                if (anchor.InUse && anchor.State == AnchorTrackingState::Tracked) {
+                    const float distance = Length(anchor.Pose.position - pose.position);
+                    if (distance <= nearestDistance) {
+                        nearestDistance = distance;
+                        nearestAnchor = id;
+                    }
+                }
+            }
+
+            if (nearestAnchor) {
+                return PlaceOnAnchor(nearestAnchor.value(), Pose::Multiply(pose, Pose::Invert(m_anchors[nearestAnchor.value()].Pose)));
+            }
+        }
+
+        XrSpatialAnchorCreateInfoMSFT createInfo{XR_TYPE_SPATIAL_ANCHOR_CREATE_INFO_MSFT};
+        createInfo.space = space;
+        createInfo.pose = pose;
+        createInfo.time = time;
+        xr::SpatialAnchorHandle handle;
+        const XrResult result = xrCreateSpatialAnchorMSFT(m_session, &createInfo, handle.Put(xrDestroySpatialAnchorMSFT));
+        if (result == XR_ERROR_CREATE_SPATIAL_ANCHOR_FAILED_MSFT) {
+            return std::nullopt;
+        }
+        CHECK_XRRESULT(result, "xrCreateSpatialAnchorMSFT");
+
+        const AnchorId anchor = AddAnchor(std::move(handle));
+        return PlaceOnAnchor(anchor, Pose::Identity());
+    }
+
+    PlacementId SpatialAnchorManager::PlaceOnAnchor(AnchorId anchor, const XrPosef& poseInAnchor) {
+        if (anchor >= m_anchors.size() || !m_anchors[anchor].InUse) {
+            throw std::out_of_range("Spatial anchor id is out of range");
+        }
+
+        const PlacementId placement = m_nextPlacementId++;
+        m_placements.emplace(placement, Placement{anchor, poseInAnchor});
+        m_anchors[anchor].PlacementCount++;
+        return placement;
+    }
+
+    void SpatialAnchorManager::Remove(PlacementId placement) {
+        const auto it = m_placements.find(placement);
+        if (it == m_placements.end()) {
+            return;
+        }
+
+        Anchor& anchor = m_anchors[it->second.Anchor];
+        if (--anchor.PlacementCount == 0) {
+            ReleaseAnchor(it->second.Anchor);
+        }
+        m_placements.erase(it);
+    }
+
+    const std::vector<AnchorTrackingEvent>& SpatialAnchorManager::Update(XrSpace baseSpace, XrTime time, const XrVector3f& viewerPosition) {
+        m_trackingEvents.clear();
+        m_frameIndex++;
+
+        // The poses of anchors that are not due are kept from earlier frames, which is only valid in the same base space.
+        if (baseSpace != m_baseSpace) {
+            m_baseSpace = baseSpace;
+            for (Anchor& anchor : m_anchors) {
+                anchor.NextLocateFrame = m_frameIndex;
+            }
+        }
+
+        m_dueAnchors.clear();
+        m_dueSpaces.clear();
+        for (AnchorId id = 0; id < m_anchors.size(); id++) {
+            const Anchor& anchor = m_anchors[id];
+            if (anchor.InUse && anchor.NextLocateFrame <= m_frameIndex) {
+                m_dueAnchors.push_back(id);
+                m_dueSpaces.push_back(anchor.Space.Get());
+            }
+        }
+
+        m_locatedAnchorCount = static_cast<uint32_t>(m_dueAnchors.size());
+        m_dueLocations.resize(m_dueAnchors.size());
+        m_spaceLocator.LocateSpaces(baseSpace, time, m_locatedAnchorCount, m_dueSpaces.data(), m_dueLocations.data());
+
+        for (size_t i = 0; i < m_dueAnchors.size(); i++) {
+            Anchor& anchor = m_anchors[m_dueAnchors[i]];
+            const xr::SpaceLocation& location = m_dueLocations[i];
+
+            const AnchorTrackingState previousState = anchor.State;
+            anchor.State = GetAnchorTrackingState(location.LocationFlags);
+            anchor.LocationFlags = location.LocationFlags;
+            if (Pose::IsPoseValid(location.LocationFlags)) {
+                anchor.Pose = location.Pose;
+                if (Length(anchor.Pose.position - anchor.StaticPosition) <= m_options.StaticDistance) {
+                    anchor.StaticLocateCount++;
+                } else {
+                    anchor.StaticPosition = anchor.Pose.position;
+                    anchor.StaticLocateCount = 0;
+                }
+            }
+
+            const float viewerDistance = Length(anchor.Pose.position - viewerPosition);
+            const uint32_t interval = GetAnchorLocateInterval(m_options, anchor.State, viewerDistance, anchor.StaticLocateCount);
+            anchor.NextLocateFrame = m_frameIndex + interval;
+
+            if (anchor.State != previousState) {
+                m_trackingEvents.push_back(AnchorTrackingEvent{m_dueAnchors[i], previousState, anchor.State, time});
+            }
+        }
+
+        return m_trackingEvents;
+    }
+
+    std::optional<XrPosef> SpatialAnchorManager::GetPlacementPose(PlacementId placement) const {
+        const Placement& placed = m_placements.at(placement);
+        const Anchor& anchor = m_anchors[placed.Anchor];
+        if (!Pose::IsPoseValid(anchor.LocationFlags)) {
+            return std::nullopt;
+        }
+        return Pose::Multiply(placed.PoseInAnchor, anchor.Pose);
+    }
+
+    AnchorId SpatialAnchorManager::GetPlacementAnchor(PlacementId placement) const {
+        return m_placements.at(placement).Anchor;
+    }
+
+    AnchorTrackingState SpatialAnchorManager::GetTrackingState(AnchorId anchor) const {
+        return m_anchors.at(anchor).State;
+    }
+
+    void SpatialAnchorManager::PersistAnchor(AnchorId anchor, std::string_view name) {
+        XrSpatialAnchorPersistenceInfoMSFT persistenceInfo{XR_TYPE_SPATIAL_ANCHOR_PERSISTENCE_INFO_MSFT};
+        persistenceInfo.spatialAnchorPersistenceName = ToPersistenceName(name);
+        persistenceInfo.spatialAnchor = m_anchors.at(anchor).Handle.Get();
+        CHECK_XRCMD(xrPersistSpatialAnchorMSFT(StoreConnection(), &persistenceInfo));
+    }
+
+    std::optional<AnchorId> SpatialAnchorManager::LoadPersistedAnchor(std::string_view name) {
+        XrSpatialAnchorFromPersistedAnchorCreateInfoMSFT createInfo{XR_TYPE_SPATIAL_ANCHOR_FROM_PERSISTED_ANCHOR_CREATE_INFO_MSFT};
+        createInfo.spatialAnchorStore = StoreConnection();
+        createInfo.spatialAnchorPersistenceName = ToPersistenceName(name);
+
+        xr::SpatialAnchorHandle handle;
+        const XrResult result = xrCreateSpatialAnchorFromPersistedNameMSFT(m_session, &createInfo, handle.Put(xrDestroySpatialAnchorMSFT));
+        if (result == XR_ERROR_SPATIAL_ANCHOR_NAME_NOT_FOUND_MSFT) {
+            return std::nullopt;
+        }
+        CHECK_XRRESULT(result, "xrCreateSpatialAnchorFromPersistedNameMSFT");
+        return AddAnchor(std::move(handle));
+    }
+
+    std::vector<std::string> SpatialAnchorManager::EnumeratePersistedAnchorNames() {
+        const XrSpatialAnchorStoreConnectionMSFT storeConnection = StoreConnection();
+        uint32_t nameCount = 0;
+        CHECK_XRCMD(xrEnumeratePersistedSpatialAnchorNamesMSFT(storeConnection, 0, &nameCount, nullptr));
+        std::vector<XrSpatialAnchorPersistenceNameMSFT> names(nameCount);
+        CHECK_XRCMD(xrEnumeratePersistedSpatialAnchorNamesMSFT(storeConnection, nameCount, &nameCount, names.data()));
+
+        std::vector<std::string> result;
+        result.reserve(nameCount);
+        for (uint32_t i = 0; i < nameCount; i++) {
+            result.emplace_back(names[i].name);
+        }
+        return result;
+    }
+
+    void SpatialAnchorManager::UnpersistAnchor(std::string_view name) {
+        const XrSpatialAnchorPersistenceNameMSFT persistenceName = ToPersistenceName(name);
+        const XrResult result = xrUnpersistSpatialAnchorMSFT(StoreConnection(), &persistenceName);
+        if (result != XR_ERROR_SPATIAL_ANCHOR_NAME_NOT_FOUND_MSFT) {
+            CHECK_XRRESULT(result, "xrUnpersistSpatialAnchorMSFT");
+        }
+    }
+
+    AnchorId SpatialAnchorManager::AddAnchor(xr::SpatialAnchorHandle handle) {
+        AnchorId id;
+        if (m_freeAnchors.empty()) {
+            id = static_cast<AnchorId>(m_anchors.size());
+            m_anchors.emplace_back();
+        } else {
+            id = m_freeAnchors.back();
+            m_freeAnchors.pop_back();
+        }
+
+        Anchor& anchor = m_anchors[id];
+        anchor = Anchor{};
+        anchor.Handle = std::move(handle);
+
+        XrSpatialAnchorSpaceCreateInfoMSFT spaceCreateInfo{XR_TYPE_SPATIAL_ANCHOR_SPACE_CREATE_INFO_MSFT};
+        spaceCreateInfo.anchor = anchor.Handle.Get();
+        spaceCreateInfo.poseInAnchorSpace = Pose::Identity();
+        CHECK_XRCMD(xrCreateSpatialAnchorSpaceMSFT(m_session, &spaceCreateInfo, anchor.Space.Put(xrDestroySpace)));
+
+        anchor.NextLocateFrame = m_frameIndex + 1;
+        anchor.InUse = true;
+        return id;
+    }
+
+    void SpatialAnchorManager::ReleaseAnchor(AnchorId id) {
+        Anchor& anchor = m_anchors[id];
+        anchor.Space.Reset();
+        anchor.Handle.Reset();
+        anchor.InUse = false;
+        m_freeAnchors.push_back(id);
+    }
+
+    XrSpatialAnchorStoreConnectionMSFT SpatialAnchorManager::StoreConnection() {
+        if (!m_persistenceSupported) {
+            throw std::logic_error("XR_MSFT_spatial_anchor_persistence is not enabled");
+        }
+        if (m_storeConnection.Get() == XR_NULL_HANDLE) {
+            CHECK_XRCMD(
+                xrCreateSpatialAnchorStoreConnectionMSFT(m_session, m_storeConnection.Put(xrDestroySpatialAnchorStoreConnectionMSFT)));
+        }
+        return m_storeConnection.Get();
+    }
+} // namespace sample
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <XrUtility/XrHandle.h>
+#include <XrUtility/XrEnabledExtensions.h>
+#include <XrUtility/XrSpaceLocator.h>
+
+namespace sample {
+    struct SpatialAnchorOptions {
+        // New placements within this distance of a tracked anchor share that anchor instead of creating a new one, in meters.
+        float ClusterRadius{0.5f};
+
+        // Tracked anchors are located every frame within NearDistance of the viewer, every MidLocateInterval frames up to
+        // FarDistance, and every FarLocateInterval frames beyond.
+        float NearDistance{2.0f};
+        float FarDistance{6.0f};
+        uint32_t MidLocateInterval{2};
+        uint32_t FarLocateInterval{8};
+
+        // Anchors that moved less than StaticDistance over StaticLocateCount locates are located half as often, up to MaxLocateInterval.
+        float StaticDistance{0.002f};
+        uint32_t StaticLocateCount{10};
+        uint32_t MaxLocateInterval{16};
+    };
+
+    enum class AnchorTrackingState {
+        NotLocated, // Created but not located yet.
+        Tracked,    // The runtime is actively tracking the anchor.
+        Inferred,   // The pose is valid but not tracked, e.g. the anchor is in an area the device cannot see.
+        Lost,       // The pose is not valid.
+    };
+
+    using AnchorId = uint32_t;
+    using PlacementId = uint32_t;
+
+    struct AnchorTrackingEvent {
+        AnchorId Anchor;
+        AnchorTrackingState Previous;
+        AnchorTrackingState Current;
+        XrTime Time;
+    };
+
+    // The anchor policy has no runtime dependency, so that it can be checked on its own.
+    AnchorTrackingState GetAnchorTrackingState(XrSpaceLocationFlags locationFlags);
+    uint32_t GetAnchorLocateInterval(const SpatialAnchorOptions& options,
+                                     AnchorTrackingState state,
+                                     float viewerDistance,
+                                     uint32_t staticLocateCount);
+
+    // Owns the spatial anchors of a session and the placements attached to them.
+    // - Placements close to an existing tracked anchor share it, with a pose relative to the anchor.
+    //   An anchor is destroyed when its last placement is removed.
+    // - Anchors are located in one batch per frame. Anchors that are far from the viewer or do not move are located less often.
+    //   Anchors that are not tracked are located every frame, so that tracking recovery is reported promptly.
+    // - Anchors can be persisted by name with XR_MSFT_spatial_anchor_persistence, and loaded again in a later session.
+    // Requires XR_MSFT_spatial_anchor. Not thread safe.
+    class SpatialAnchorManager {
+    public:
+        SpatialAnchorManager(XrSession session, const xr::EnabledExtensions& extensions, SpatialAnchorOptions options = {});
+
+        // Place an object at the pose in the given space and time. The pose is relative to the anchor it is attached to.
+        // Returns nothing if the runtime cannot create an anchor there, e.g. because tracking is lost.
+        std::optional<PlacementId> Place(XrSpace space, const XrPosef& pose, XrTime time);
+
+        // Place an object relative to an existing anchor, e.g. one loaded with LoadPersistedAnchor.
+        PlacementId PlaceOnAnchor(AnchorId anchor, const XrPosef& poseInAnchor);
+
+        void Remove(PlacementId placement);
+
+        // Locate the anchors that are due this frame, in the base space. The viewer position is in the base space too.
+        // Returns the tracking state changes of the anchors located in this update.
+        const std::vector<AnchorTrackingEvent>& Update(XrSpace baseSpace, XrTime time, const XrVector3f& viewerPosition);
+
+        // The pose of the placement in the base space of the last update, if its anchor has a valid pose.
+        std::optional<XrPosef> GetPlacementPose(PlacementId placement) const;
+        AnchorId GetPlacementAnchor(PlacementId placement) const;
+        AnchorTrackingState GetTrackingState(AnchorId anchor) const;
+
+        bool IsPersistenceSupported() const {
+            return m_persistenceSupported;
+        }
+
+        // Persist the anchor under the name, replacing an anchor persisted under the same name before.
+        void PersistAnchor(AnchorId anchor, std::string_view name);
+
+        // Create an anchor from a persisted name. Returns nothing if there is no anchor persisted with this name.
+        // The anchor has no placement until PlaceOnAnchor is called, and it is destroyed when its last placement is removed.
+        std::optional<AnchorId> LoadPersistedAnchor(std::string_view name);
+
+        std::vector<std::string> EnumeratePersistedAnchorNames();
+        void UnpersistAnchor(std::string_view name);
+
+        uint32_t AnchorCount() const {
+            return static_cast<uint32_t>(m_anchors.size() - m_freeAnchors.size());
+        }
+
+        // Number of anchors located by the last update.
+        uint32_t LocatedAnchorCount() const {
+            return m_locatedAnchorCount;
+        }
+
+    private:
+        struct Anchor {
+            xr::SpatialAnchorHandle Handle;
+            xr::SpaceHandle Space;
+            XrPosef Pose{xr::math::Pose::Identity()};
+            XrSpaceLocationFlags LocationFlags{0};
+            AnchorTrackingState State{AnchorTrackingState::NotLocated};
+            XrVector3f StaticPosition{0, 0, 0}; // Position at the start of the current run of static locates.
+            uint32_t StaticLocateCount{0};
+            uint64_t NextLocateFrame{0};
+            uint32_t PlacementCount{0};
+            bool InUse{false};
+        };
+
+        struct Placement {
+            AnchorId Anchor;
+            XrPosef PoseInAnchor;
+        };
+
+        AnchorId AddAnchor(xr::SpatialAnchorHandle handle);
+        void ReleaseAnchor(AnchorId anchor);
+        XrSpatialAnchorStoreConnectionMSFT StoreConnection();
+
+        const XrSession m_session;
+        const SpatialAnchorOptions m_options;
+        const bool m_persistenceSupported;
+        xr::SpatialAnchorStoreConnectionHandle m_storeConnection;
+        xr::SpaceLocator m_spaceLocator;
+
+        std::vector<Anchor> m_anchors;
+        std::vector<AnchorId> m_freeAnchors;
+        std::unordered_map<PlacementId, Placement> m_placements;
+        PlacementId m_nextPlacementId{0};
+
+        XrSpace m_baseSpace{XR_NULL_HANDLE};
+        uint64_t m_frameIndex{0};
+        uint32_t m_locatedAnchorCount{0};
+        std::vector<AnchorId> m_dueAnchors;
+        std::vector<XrSpace> m_dueSpaces;
+        std::vector<xr::SpaceLocation> m_dueLocations;
+        std::vector<AnchorTrackingEvent> m_trackingEvents;
+    };
+} // namespace sample
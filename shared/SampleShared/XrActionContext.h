@@ -5,17 +5,30 @@
 
 #include <set>
 #include <list>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "XrUtility/XrString.h"
 #include "XrUtility/XrHandle.h"
+#include "XrUtility/XrPathCache.h"
 
 namespace sample {
     class ActionSet {
     public:
-        ActionSet(XrInstance instance, const char* name, const char* localizedName, uint32_t priority = 0)
-            : m_instance(instance) {
+        struct ActionDescription {
+            XrAction action;
+            std::string actionName;
+            XrActionType actionType;
+            std::vector<XrPath> subactionPaths;
+        };
+
+        ActionSet(std::shared_ptr<xr::PathCache> paths, const char* name, const char* localizedName, uint32_t priority = 0)
+            : m_instance(paths->Instance())
+            , m_paths(std::move(paths)) {
             XrActionSetCreateInfo actionSetCreateInfo{XR_TYPE_ACTION_SET_CREATE_INFO};
             strcpy_s(actionSetCreateInfo.actionSetName, name);
             strcpy_s(actionSetCreateInfo.localizedActionSetName, localizedName);
@@ -27,7 +40,7 @@ namespace sample {
                               const char* localizedName,
                               XrActionType actionType,
                               const std::vector<std::string>& subactionPaths) {
-            std::vector<XrPath> subActionXrPaths = xr::StringsToPaths(m_instance, subactionPaths);
+            std::vector<XrPath> subActionXrPaths = m_paths->Get(subactionPaths);
 
             XrActionCreateInfo actionCreateInfo{XR_TYPE_ACTION_CREATE_INFO};
             actionCreateInfo.actionType = actionType;
@@ -44,10 +57,15 @@ namespace sample {
             CHECK_XRCMD(xrCreateAction(m_actionSet.Get(), &actionCreateInfo, action.Put(xrDestroyAction)));
 
             m_actions.push_back(std::move(action));
+            m_actionDescriptions.push_back({m_actions.back().Get(), actionName, actionType, std::move(subActionXrPaths)});
 
             return m_actions.back().Get();
         }
 
+        const std::vector<ActionDescription>& Actions() const {
+            return m_actionDescriptions;
+        }
+
         bool Active() const {
             return m_active;
         }
@@ -65,12 +83,29 @@ namespace sample {
 
     private:
         const XrInstance m_instance;
+        std::shared_ptr<xr::PathCache> m_paths;
         xr::ActionSetHandle m_actionSet;
         std::vector<xr::ActionHandle> m_actions;
+        std::vector<ActionDescription> m_actionDescriptions;
         bool m_active{true};
         std::set<XrPath> m_declaredSubactionPaths;
     };
 
+    enum class ActionEventType {
+        Pressed,  // A boolean action became true, or a float action reached the threshold of the subscription.
+        Released, // A boolean action became false, or a float action dropped below the threshold, including when it became inactive.
+    };
+
+    struct ActionEvent {
+        XrAction action;
+        XrPath subactionPath;
+        ActionEventType type;
+        float value;
+        XrTime time;
+    };
+
+    using ActionEventHandler = std::function<void(const ActionEvent&)>;
+
     //
     // OpenXR requires one xrSuggestInteractionProfileBindings call for each interaction profile
     // and one xrAttachSessionActionSets for each session.
@@ -78,37 +113,286 @@ namespace sample {
     // ActionContext class collects action and actionset metadata from multiple places in an app
     // and finalize the binding and attach to session together.
     //
+    // After each SyncActions, the states of the actions in use are read once into a cache,
+    // one entry for each declared subaction path, or one for XR_NULL_PATH if the action has none.
+    // An action is in use once it has a subscriber or its state was queried; other actions are never read.
+    // Scenes read the cached states instead of calling xrGetActionState* themselves,
+    // or subscribe to the actions they react to and only run code when the action changed.
+    //
     struct ActionContext {
         struct ActionBinding {
             XrAction action;
             std::string binding;
         };
 
-        explicit ActionContext(XrInstance instance)
-            : m_instance(instance) {
+        // Pass the path cache of the instance to share path conversions with other action contexts.
+        explicit ActionContext(XrInstance instance, std::shared_ptr<xr::PathCache> paths = nullptr)
+            : m_instance(instance)
+            , m_paths(paths ? std::move(paths) : std::make_shared<xr::PathCache>(instance)) {
         }
 
         ActionSet& CreateActionSet(const char* name, const char* localizedName, uint32_t priority = 0) {
-            return m_actionSets.emplace_back(ActionSet{m_instance, name, localizedName, priority});
+            return m_actionSets.emplace_back(ActionSet{m_paths, name, localizedName, priority});
+        }
+
+        // Returns XR_NULL_HANDLE if no action set of this context has an action with the given name.
+        XrAction FindAction(std::string_view actionName) const {
+            for (const ActionSet& actionSet : m_actionSets) {
+                for (const ActionSet::ActionDescription& description : actionSet.Actions()) {
+                    if (description.actionName == actionName) {
+                        return description.action;
+                    }
+                }
+            }
+            return XR_NULL_HANDLE;
         }
 
         void SuggestInteractionProfileBindings(const char* interactionProfile, const std::vector<ActionBinding>& suggestedBindings) {
-            const XrPath profilePath = xr::StringToPath(m_instance, interactionProfile);
+            const XrPath profilePath = m_paths->Get(interactionProfile);
             for (const auto& actionBinding : suggestedBindings) {
                 m_actionBindings[profilePath].emplace_back(actionBinding);
             }
         }
 
+        XrActionStateBoolean GetBooleanState(XrAction action, XrPath subactionPath = XR_NULL_PATH) {
+            XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
+            if (const ActionStateEntry* entry = GetActionState(action, subactionPath)) {
+                state.currentState = entry->value.x != 0.0f;
+                state.changedSinceLastSync = entry->changedSinceLastSync;
+                state.lastChangeTime = entry->lastChangeTime;
+                state.isActive = entry->isActive;
+            }
+            return state;
+        }
+
+        XrActionStateFloat GetFloatState(XrAction action, XrPath subactionPath = XR_NULL_PATH) {
+            XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
+            if (const ActionStateEntry* entry = GetActionState(action, subactionPath)) {
+                state.currentState = entry->value.x;
+                state.changedSinceLastSync = entry->changedSinceLastSync;
+                state.lastChangeTime = entry->lastChangeTime;
+                state.isActive = entry->isActive;
+            }
+            return state;
+        }
+
+        XrActionStateVector2f GetVector2fState(XrAction action, XrPath subactionPath = XR_NULL_PATH) {
+            XrActionStateVector2f state{XR_TYPE_ACTION_STATE_VECTOR2F};
+            if (const ActionStateEntry* entry = GetActionState(action, subactionPath)) {
+                state.currentState = entry->value;
+                state.changedSinceLastSync = entry->changedSinceLastSync;
+                state.lastChangeTime = entry->lastChangeTime;
+                state.isActive = entry->isActive;
+            }
+            return state;
+        }
+
+        XrActionStatePose GetPoseState(XrAction action, XrPath subactionPath = XR_NULL_PATH) {
+            XrActionStatePose state{XR_TYPE_ACTION_STATE_POSE};
+            if (const ActionStateEntry* entry = GetActionState(action, subactionPath)) {
+                state.isActive = entry->isActive;
+            }
+            return state;
+        }
+
+        // Call the handler from SyncActions whenever a boolean or float input action, for any of its subaction paths,
+        // crosses the threshold. Boolean actions have the value 0 or 1.
+        void Subscribe(XrAction action, ActionEventHandler handler, float threshold = 0.5f) {
+            m_subscriptions[action].push_back({std::move(handler), threshold});
+            TrackAction(action);
+        }
+
     private:
+        struct ActionStateEntry {
+            XrAction action;
+            XrPath subactionPath;
+            XrActionType actionType;
+            const ActionSet* actionSet;
+
+            XrVector2f value{}; // Boolean and float actions store their value in x.
+            XrTime lastChangeTime{0};
+            bool changedSinceLastSync{false};
+            bool isActive{false};
+            bool tracked{false}; // The state is read on every sync.
+        };
+
+        struct ActionStateChange {
+            uint32_t entryIndex;
+            float previousValue;
+        };
+
+        struct Subscription {
+            ActionEventHandler handler;
+            float threshold;
+        };
+
+        const ActionStateEntry* GetActionState(XrAction action, XrPath subactionPath) {
+            const auto it = m_actionStateRanges.find(action);
+            if (it == m_actionStateRanges.end()) {
+                return nullptr;
+            }
+            const auto [begin, end] = it->second;
+            for (uint32_t i = begin; i < end; i++) {
+                if (m_actionStates[i].subactionPath == subactionPath) {
+                    if (!m_actionStates[i].tracked) {
+                        TrackAction(action);
+                    }
+                    return &m_actionStates[i];
+                }
+            }
+            return nullptr;
+        }
+
+        // Start reading the states of the action on every sync. They are read right away as well,
+        // so that the first query after a sync returns the state of that sync.
+        void TrackAction(XrAction action) {
+            const auto it = m_actionStateRanges.find(action);
+            if (it == m_actionStateRanges.end()) {
+                return; // The cache is not built yet. InitializeActionStates tracks the subscribed actions.
+            }
+            const auto [begin, end] = it->second;
+            for (uint32_t i = begin; i < end; i++) {
+                ActionStateEntry& entry = m_actionStates[i];
+                if (!entry.tracked) {
+                    entry.tracked = true;
+                    ReadActionState(entry);
+                }
+            }
+        }
+
+        // Action sets cannot change once they are attached to the session, so the cache layout is built once.
+        void InitializeActionStates() {
+            for (const ActionSet& actionSet : m_actionSets) {
+                for (const ActionSet::ActionDescription& description : actionSet.Actions()) {
+                    if (description.actionType == XR_ACTION_TYPE_VIBRATION_OUTPUT) {
+                        continue;
+                    }
+
+                    const bool subscribed = m_subscriptions.find(description.action) != m_subscriptions.end();
+                    const uint32_t begin = static_cast<uint32_t>(m_actionStates.size());
+                    if (description.subactionPaths.empty()) {
+                        m_actionStates.push_back({description.action, XR_NULL_PATH, description.actionType, &actionSet});
+                        m_actionStates.back().tracked = subscribed;
+                    }
+                    for (XrPath subactionPath : description.subactionPaths) {
+                        m_actionStates.push_back({description.action, subactionPath, description.actionType, &actionSet});
+                        m_actionStates.back().tracked = subscribed;
+                    }
+                    m_actionStateRanges[description.action] = {begin, static_cast<uint32_t>(m_actionStates.size())};
+                }
+            }
+            m_actionStatesInitialized = true;
+        }
+
+        // Read the state of the entry as of the last sync.
+        void ReadActionState(ActionStateEntry& entry) const {
+            if (!entry.actionSet->Active()) {
+                // Actions of inactive action sets are not synced and report as inactive.
+                entry.changedSinceLastSync = entry.isActive && entry.value.x != 0.0f;
+                entry.value = {};
+                entry.isActive = false;
+                return;
+            }
+
+            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
+            getInfo.action = entry.action;
+            getInfo.subactionPath = entry.subactionPath;
+            if (entry.actionType == XR_ACTION_TYPE_BOOLEAN_INPUT) {
+                XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
+                CHECK_XRCMD(xrGetActionStateBoolean(m_session, &getInfo, &state));
+                entry.value = {state.currentState ? 1.0f : 0.0f, 0.0f};
+                entry.lastChangeTime = state.lastChangeTime;
+                entry.changedSinceLastSync = state.changedSinceLastSync;
+                entry.isActive = state.isActive;
+            } else if (entry.actionType == XR_ACTION_TYPE_FLOAT_INPUT) {
+                XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
+                CHECK_XRCMD(xrGetActionStateFloat(m_session, &getInfo, &state));
+                entry.value = {state.currentState, 0.0f};
+                entry.lastChangeTime = state.lastChangeTime;
+                entry.changedSinceLastSync = state.changedSinceLastSync;
+                entry.isActive = state.isActive;
+            } else if (entry.actionType == XR_ACTION_TYPE_VECTOR2F_INPUT) {
+                XrActionStateVector2f state{XR_TYPE_ACTION_STATE_VECTOR2F};
+                CHECK_XRCMD(xrGetActionStateVector2f(m_session, &getInfo, &state));
+                entry.value = state.currentState;
+                entry.lastChangeTime = state.lastChangeTime;
+                entry.changedSinceLastSync = state.changedSinceLastSync;
+                entry.isActive = state.isActive;
+            } else if (entry.actionType == XR_ACTION_TYPE_POSE_INPUT) {
+                XrActionStatePose state{XR_TYPE_ACTION_STATE_POSE};
+                CHECK_XRCMD(xrGetActionStatePose(m_session, &getInfo, &state));
+                entry.isActive = state.isActive;
+            }
+        }
+
+        void UpdateActionStates(XrSession session) {
+            m_session = session;
+            if (!m_actionStatesInitialized) {
+                InitializeActionStates();
+            }
+
+            m_actionStateChanges.clear();
+            for (uint32_t i = 0; i < m_actionStates.size(); i++) {
+                ActionStateEntry& entry = m_actionStates[i];
+                if (!entry.tracked) {
+                    continue;
+                }
+
+                const float previousValue = entry.value.x;
+                ReadActionState(entry);
+                if (entry.value.x != previousValue) {
+                    m_actionStateChanges.push_back({i, previousValue});
+                }
+            }
+
+            DispatchActionEvents();
+        }
+
+        // Only the entries that changed in this sync are visited.
+        void DispatchActionEvents() const {
+            if (m_subscriptions.empty()) {
+                return;
+            }
+
+            for (const ActionStateChange& change : m_actionStateChanges) {
+                const ActionStateEntry& entry = m_actionStates[change.entryIndex];
+                if (entry.actionType != XR_ACTION_TYPE_BOOLEAN_INPUT && entry.actionType != XR_ACTION_TYPE_FLOAT_INPUT) {
+                    continue;
+                }
+
+                const auto it = m_subscriptions.find(entry.action);
+                if (it == m_subscriptions.end()) {
+                    continue;
+                }
+
+                for (const Subscription& subscription : it->second) {
+                    const bool wasPressed = change.previousValue >= subscription.threshold;
+                    const bool isPressed = entry.value.x >= subscription.threshold;
+                    if (wasPressed != isPressed) {
+                        const ActionEventType type = isPressed ? ActionEventType::Pressed : ActionEventType::Released;
+                        subscription.handler({entry.action, entry.subactionPath, type, entry.value.x, entry.lastChangeTime});
+                    }
+                }
+            }
+        }
+
         XrInstance m_instance;
+        XrSession m_session{XR_NULL_HANDLE}; // The session of the last sync
+        std::shared_ptr<xr::PathCache> m_paths;
         std::list<ActionSet> m_actionSets;
         std::unordered_map<XrPath /*interaction profile*/, std::vector<ActionBinding>> m_actionBindings;
 
+        bool m_actionStatesInitialized{false};
+        std::vector<ActionStateEntry> m_actionStates;
+        std::unordered_map<XrAction, std::pair<uint32_t, uint32_t>> m_actionStateRanges; // Range of m_actionStates for each action
+        std::vector<ActionStateChange> m_actionStateChanges;
+        std::unordered_map<XrAction, std::vector<Subscription>> m_subscriptions;
+
         friend void AttachActionsToSession(XrInstance instance,
                                            XrSession session,
                                            const std::vector<const ActionContext*>& actionContexts,
                                            const std::vector<std::string>& interactionProfilesFilter);
-        friend void SyncActions(XrSession session, const std::vector<const ActionContext*>& actionContexts);
+        friend void SyncActions(XrSession session, const std::vector<ActionContext*>& actionContexts);
     };
 
     inline void AttachActionsToSession(XrInstance instance,
@@ -132,14 +416,23 @@ namespace sample {
                 if (hasProfileFilter && enabledProfiles.find(profilePath) == enabledProfiles.end()) {
                     continue;    // skip the profile if app didn't ask for it.
                 }
-                for (const auto& [actionPath, binding] : stringBindings) {
-                    allBindings[profilePath].emplace_back(
-                        XrActionSuggestedBinding{actionPath, xr::StringToPath(instance, binding.c_str())});
+                for (const auto& [action, binding] : stringBindings) {
+                    allBindings[profilePath].emplace_back(XrActionSuggestedBinding{action, actionContext->m_paths->Get(binding)});
                 }
             }
         }
 
-        for (const auto& [interactionProfile, suggestedBindings] : allBindings) {
+        // One xrSuggestInteractionProfileBindings call for each profile, without the bindings suggested more than once.
+        for (auto& [interactionProfile, suggestedBindings] : allBindings) {
+            const auto bindingLess = [](const XrActionSuggestedBinding& a, const XrActionSuggestedBinding& b) {
+                return std::tie(a.action, a.binding) < std::tie(b.action, b.binding);
+            };
+            const auto bindingEqual = [](const XrActionSuggestedBinding& a, const XrActionSuggestedBinding& b) {
+                return a.action == b.action && a.binding == b.binding;
+            };
+            std::sort(suggestedBindings.begin(), suggestedBindings.end(), bindingLess);
+            suggestedBindings.erase(std::unique(suggestedBindings.begin(), suggestedBindings.end(), bindingEqual), suggestedBindings.end());
+
             XrInteractionProfileSuggestedBinding bindings{XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
             bindings.interactionProfile = interactionProfile;
             bindings.suggestedBindings = suggestedBindings.data();
@@ -162,7 +455,7 @@ namespace sample {
         }
     }
 
-    inline void SyncActions(XrSession session, const std::vector<const ActionContext*>& actionContexts) {
+    inline void SyncActions(XrSession session, const std::vector<ActionContext*>& actionContexts) {
         std::vector<XrActiveActionSet> activeActionSets;
 
         for (const ActionContext* actionContext : actionContexts) {
@@ -186,6 +479,10 @@ namespace sample {
             syncInfo.activeActionSets = activeActionSets.data();
             CHECK_XRCMD(xrSyncActions(session, &syncInfo));
         }
+
+        for (ActionContext* actionContext : actionContexts) {
+            actionContext->UpdateActionStates(session);
+        }
     }
 
 } // namespace sample
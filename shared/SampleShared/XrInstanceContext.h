@@ -6,6 +6,7 @@
 #include "XrUtility/XrHandle.h"
 #include "XrUtility/XrStruct.h"
 #include "XrUtility/XrString.h"
+#include "XrUtility/XrPathCache.h"
 
 namespace sample {
     struct InstanceContext {
@@ -13,6 +14,7 @@ namespace sample {
         const xr::NameVersion AppInfo;
         const xr::NameVersion EngineInfo;
         const XrInstanceProperties Properties{XR_TYPE_INSTANCE_PROPERTIES};
+        const std::shared_ptr<xr::PathCache> Paths;
         const XrPath LeftHandPath;
         const XrPath RightHandPath;
 
@@ -25,9 +27,10 @@ namespace sample {
             , AppInfo(std::move(appInfo))
             , EngineInfo(std::move(engineInfo))
             , Properties(std::move(instanceProperties))
+            , Paths(std::make_shared<xr::PathCache>(Handle))
             , m_instance(std::move(instance))
-            , LeftHandPath(xr::StringToPath(Handle, "/user/hand/left"))
-            , RightHandPath(xr::StringToPath(Handle, "/user/hand/right")) {
+            , LeftHandPath(Paths->Get("/user/hand/left"))
+            , RightHandPath(Paths->Get("/user/hand/right")) {
         }
 
     private:
@@ -4,8 +4,11 @@
 #pragma once
 
 #include <pbr/PbrResources.h>
+#include <pbr/PbrResidency.h>
+#include <pbr/PbrRenderDeviceD3D11.h>
 #include <XrUtility/XrString.h>
 #include <XrUtility/XrEnabledExtensions.h>
+#include <XrUtility/XrSpaceLocator.h>
 #include <SampleShared/XrInstanceContext.h>
 #include <SampleShared/XrSystemContext.h>
 #include <SampleShared/XrSessionContext.h>
@@ -29,7 +32,9 @@ namespace engine {
             , AppSpace(appSpace)
             , PbrResources(std::move(pbrResources))
             , Device(std::move(device))
-            , DeviceContext(std::move(deviceContext)) {
+            , DeviceContext(std::move(deviceContext))
+            , RenderDevice(std::make_unique<Pbr::D3D11RenderDevice>(Device.get(), DeviceContext.get()))
+            , SpaceLocations(Session.Handle, Extensions.IsEnabled("XR_KHR_locate_spaces")) {
         }
 
         const xr::EnabledExtensions Extensions;
@@ -42,6 +47,16 @@ namespace engine {
         const winrt::com_ptr<ID3D11DeviceContext> DeviceContext;
         const winrt::com_ptr<ID3D11Device> Device;
         Pbr::Resources PbrResources;
+
+        // Objects render through this device rather than the D3D11 context, so that it can be replaced by one that records
+        // the commands, e.g. a Pbr::NullRenderDevice. Pbr resources are still created with the D3D11 device.
+        std::unique_ptr<Pbr::RenderDevice> RenderDevice;
+
+        // Tracks the memory of registered assets and evicts the least-recently-rendered ones when over budget.
+        Pbr::ResidencyManager AssetResidency;
+
+        // Spaces registered here are located against AppSpace together once per frame, before the scenes are updated.
+        xr::SpaceLocator SpaceLocations;
     };
 
 } // namespace engine
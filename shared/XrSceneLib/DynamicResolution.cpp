@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "DynamicResolution.h"
+
+namespace {
+    constexpr float IntegralErrorLimit = 1.0f;
+    constexpr float MinUtilization = 0.01f; // Avoids dividing by zero when a frame takes no measurable time.
+
+    float Seconds(std::chrono::nanoseconds duration) {
+        return std::chrono::duration_cast<std::chrono::duration<float>>(duration).count();
+    }
+} // namespace
+
+engine::DynamicResolutionDecision engine::DecideDynamicResolution(const DynamicResolutionPolicy& policy,
+                                                                  const DynamicResolutionState& state,
+                                                                  const FrameTimings& timings) {
+    DynamicResolutionDecision decision;
+    decision.State = state;
+    decision.GpuTimed = timings.Gpu.has_value();
+
+    const float displayPeriod = Seconds(timings.DisplayPeriod);
+    if (displayPeriod <= 0) {
+        return decision; // The runtime did not predict a display period, e.g. while the session is not visible.
+    }
+
+    DynamicResolutionState& next = decision.State;
+    decision.Utilization = Seconds(timings.Gpu.value_or(timings.CpuRender)) / displayPeriod;
+    const float utilizationError = policy.TargetUtilization - decision.Utilization;
+
+    // With GPU timings, a frame over budget only on the CPU would not get faster at a lower resolution.
+    const float cpuUtilization = Seconds(std::max(timings.CpuUpdate, timings.CpuRender)) / displayPeriod;
+    if (decision.GpuTimed && cpuUtilization > policy.TargetUtilization + policy.Deadband && utilizationError >= -policy.Deadband) {
+        decision.Action = DynamicResolutionAction::CpuBound;
+        next.HeadroomFrames = 0;
+        return decision;
+    }
+
+    if (std::abs(utilizationError) <= policy.Deadband) {
+        next.HeadroomFrames = 0;
+        next.PreviousError = 0;
+        return decision;
+    }
+
+    // The relative scale change that would bring the utilization to the target, given that it grows with the scale squared.
+    const float error = std::sqrt(policy.TargetUtilization / std::max(decision.Utilization, MinUtilization)) - 1;
+    const float integralError = std::clamp(state.IntegralError + error, -IntegralErrorLimit, IntegralErrorLimit);
+    const float derivative = error - state.PreviousError;
+    const float correction = policy.ProportionalGain * error + policy.IntegralGain * integralError + policy.DerivativeGain * derivative;
+    next.PreviousError = error;
+
+    float step = 0;
+    if (utilizationError < 0) {
+        next.HeadroomFrames = 0;
+        step = std::clamp(state.Scale * correction, -policy.MaxDecreasePerFrame, 0.0f);
+    } else if (++next.HeadroomFrames >= policy.IncreaseDelayFrames) {
+        step = std::clamp(state.Scale * correction, 0.0f, policy.MaxIncreasePerFrame);
+    }
+
+    const float maxScale = std::min(policy.MaxScale, 1.0f);
+    next.Scale = std::clamp(state.Scale + step, policy.MinScale, maxScale);
+
+    // Only integrate the error while the scale can still move towards it, so that it does not wind up at the limits.
+    const bool saturated = (error < 0 && next.Scale <= policy.MinScale) || (error > 0 && next.Scale >= maxScale);
+    if (!saturated) {
+        next.IntegralError = integralError;
+    }
+
+    if (next.Scale < state.Scale) {
+        decision.Action = DynamicResolutionAction::Decrease;
+    } else if (next.Scale > state.Scale) {
+        decision.Action = DynamicResolutionAction::Increase;
+    }
+    return decision;
+}
+
+engine::GpuFrameTimer::GpuFrameTimer(ID3D11Device* device) {
+    const CD3D11_QUERY_DESC disjointDesc(D3D11_QUERY_TIMESTAMP_DISJOINT);
+    const CD3D11_QUERY_DESC timestampDesc(D3D11_QUERY_TIMESTAMP);
+    for (FrameQueries& frame : m_frames) {
+        CHECK_HRCMD(device->CreateQuery(&disjointDesc, frame.Disjoint.put()));
+        CHECK_HRCMD(device->CreateQuery(&timestampDesc, frame.Begin.put()));
+        CHECK_HRCMD(device->CreateQuery(&timestampDesc, frame.End.put()));
+    }
+}
+
+void engine::GpuFrameTimer::Begin(ID3D11DeviceContext* context) {
+    FrameQueries& frame = m_frames[m_frameIndex];
+    m_timingFrame = !frame.Pending;
+    if (m_timingFrame) {
+        context->Begin(frame.Disjoint.get());
+        context->End(frame.Begin.get());
+    }
+}
+
+void engine::GpuFrameTimer::End(ID3D11DeviceContext* context) {
+    if (m_timingFrame) {
+        FrameQueries& frame = m_frames[m_frameIndex];
+        context->End(frame.End.get());
+        context->End(frame.Disjoint.get());
+        frame.Pending = true;
+        m_frameIndex = (m_frameIndex + 1) % m_frames.size();
+    }
+}
+
+std::optional<std::chrono::nanoseconds> engine::GpuFrameTimer::ReadLatest(ID3D11DeviceContext* context) {
+    std::optional<std::chrono::nanoseconds> latest;
+
+    // Read the frames in the order they were submitted, and stop at the first one that is still in flight.
+    for (uint32_t i = 0; i < m_frames.size(); i++) {
+        FrameQueries& frame = m_frames[(m_frameIndex + i) % m_frames.size()];
+        if (!frame.Pending) {
+            continue;
+        }
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        if (context->GetData(frame.Disjoint.get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            break;
+        }
+
+        uint64_t begin, end;
+        const bool timestampsReady =
+            context->GetData(frame.Begin.get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK &&
+            context->GetData(frame.End.get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+        if (!timestampsReady) {
+            break;
+        }
+
+        frame.Pending = false;
+        if (!disjoint.Disjoint && disjoint.Frequency > 0 && end >= begin) {
+            // Split the division to avoid overflowing 64 bits for long frames on high frequency timers.
+            constexpr uint64_t NanosecondsPerSecond = 1'000'000'000;
+            const uint64_t ticks = end - begin;
+            latest = std::chrono::nanoseconds(ticks / disjoint.Frequency * NanosecondsPerSecond +
+                                              ticks % disjoint.Frequency * NanosecondsPerSecond / disjoint.Frequency);
+        }
+    }
+    return latest;
+}
+
+engine::DynamicResolutionController::DynamicResolutionController(ID3D11Device* device, DynamicResolutionPolicy policy)
+    : m_policy(std::move(policy))
+    , m_gpuTimer(device) {
+    m_telemetry.LastDecision.State.Scale = std::min(m_policy.MaxScale, 1.0f);
+}
+
+void engine::DynamicResolutionController::SetUpdateTime(std::chrono::nanoseconds updateTime) {
+    m_updateTimeNs = updateTime.count();
+}
+
+void engine::DynamicResolutionController::BeginRender(ID3D11DeviceContext* context) {
+    m_renderStart = FrameTime::clock::now();
+    m_gpuTimer.Begin(context);
+}
+
+void engine::DynamicResolutionController::EndRender(ID3D11DeviceContext* context, const FrameTime& frameTime) {
+    m_gpuTimer.End(context);
+
+    FrameTimings timings;
+    timings.DisplayPeriod = std::chrono::nanoseconds(frameTime.PredictedDisplayPeriod);
+    timings.CpuUpdate = std::chrono::nanoseconds(m_updateTimeNs.load());
+    timings.CpuRender = std::chrono::duration_cast<std::chrono::nanoseconds>(FrameTime::clock::now() - m_renderStart);
+    timings.Gpu = m_gpuTimer.ReadLatest(context);
+
+    // Once the GPU is timed, frames without a new GPU time are skipped rather than decided on the CPU render time.
+    m_gpuTimed |= timings.Gpu.has_value();
+    if (m_gpuTimed && !timings.Gpu) {
+        return;
+    }
+
+    std::scoped_lock lock(m_mutex);
+    DynamicResolutionTelemetry& telemetry = m_telemetry;
+    telemetry.LastDecision = DecideDynamicResolution(m_policy, telemetry.LastDecision.State, timings);
+    telemetry.LastTimings = timings;
+    telemetry.FrameCount++;
+    telemetry.DecreaseCount += telemetry.LastDecision.Action == DynamicResolutionAction::Decrease;
+    telemetry.IncreaseCount += telemetry.LastDecision.Action == DynamicResolutionAction::Increase;
+    telemetry.CpuBoundCount += telemetry.LastDecision.Action == DynamicResolutionAction::CpuBound;
+    telemetry.OverBudgetCount += telemetry.LastDecision.Utilization > 1;
+}
+
+float engine::DynamicResolutionController::Scale() const {
+    std::scoped_lock lock(m_mutex);
+    return m_telemetry.LastDecision.State.Scale;
+}
+
+engine::DynamicResolutionTelemetry engine::DynamicResolutionController::Telemetry() const {
+    std::scoped_lock lock(m_mutex);
+    return m_telemetry;
+}
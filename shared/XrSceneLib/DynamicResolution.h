@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+#include "FrameTime.h"
+
+namespace engine {
+    // Tunes how the viewport scale follows the measured frame time. The GPU time of a frame grows with the rendered pixels,
+    // i.e. with the square of the scale, so the controller aims for the scale at which the frame takes TargetUtilization of
+    // the display period, and corrects it with a PID controller on the relative scale error.
+    struct DynamicResolutionPolicy {
+        float MinScale{0.6f};
+        float MaxScale{1.0f}; // Relative to the swapchain, so it cannot be larger than 1.
+        float TargetUtilization{0.85f};
+
+        // Utilization within this distance of the target leaves the scale unchanged, so that noise does not resize every frame.
+        float Deadband{0.05f};
+
+        float ProportionalGain{0.6f};
+        float IntegralGain{0.05f};
+        float DerivativeGain{0.1f};
+
+        // The scale drops quickly to recover the frame rate, but only grows slowly after a number of frames with headroom.
+        float MaxDecreasePerFrame{0.05f};
+        float MaxIncreasePerFrame{0.01f};
+        uint32_t IncreaseDelayFrames{30};
+    };
+
+    struct FrameTimings {
+        std::chrono::nanoseconds DisplayPeriod{};
+        std::chrono::nanoseconds CpuUpdate{};
+        std::chrono::nanoseconds CpuRender{};
+        std::optional<std::chrono::nanoseconds> Gpu; // Empty when GPU timestamps are not available, e.g. still in flight.
+    };
+
+    struct DynamicResolutionState {
+        float Scale{1};
+        float IntegralError{0};
+        float PreviousError{0};
+        uint32_t HeadroomFrames{0};
+    };
+
+    enum class DynamicResolutionAction {
+        Hold,     // Within the deadband, waiting for more headroom frames, or already at the limit.
+        Decrease, // Over budget.
+        Increase, // Under budget for long enough.
+        CpuBound, // Over budget on the CPU while the GPU is within budget, so a lower resolution would not help.
+    };
+
+    struct DynamicResolutionDecision {
+        DynamicResolutionState State;
+        DynamicResolutionAction Action{DynamicResolutionAction::Hold};
+        float Utilization{0}; // The frame time that resolution affects, relative to the display period.
+        bool GpuTimed{false}; // Whether Utilization is from GPU timestamps rather than the CPU render time.
+    };
+
+    // The control policy, as a pure function of the previous state and the timings of one frame.
+    // Without GPU timings, the CPU render time stands in for the GPU time, since the render thread blocks on a busy GPU.
+    DynamicResolutionDecision DecideDynamicResolution(const DynamicResolutionPolicy& policy,
+                                                      const DynamicResolutionState& state,
+                                                      const FrameTimings& timings);
+
+    // Measures the GPU time of frames with timestamp queries. Results are read a few frames later without stalling.
+    class GpuFrameTimer {
+    public:
+        explicit GpuFrameTimer(ID3D11Device* device);
+
+        void Begin(ID3D11DeviceContext* context);
+        void End(ID3D11DeviceContext* context);
+
+        // The GPU time of the newest frame whose queries completed since the last call, if any.
+        std::optional<std::chrono::nanoseconds> ReadLatest(ID3D11DeviceContext* context);
+
+    private:
+        struct FrameQueries {
+            winrt::com_ptr<ID3D11Query> Disjoint;
+            winrt::com_ptr<ID3D11Query> Begin;
+            winrt::com_ptr<ID3D11Query> End;
+            bool Pending{false};
+        };
+
+        std::array<FrameQueries, 4> m_frames;
+        uint32_t m_frameIndex{0};
+        bool m_timingFrame{false}; // False when all queries are still in flight and the current frame is not measured.
+    };
+
+    struct DynamicResolutionTelemetry {
+        DynamicResolutionDecision LastDecision;
+        FrameTimings LastTimings;
+        uint64_t FrameCount{0};
+        uint64_t DecreaseCount{0};
+        uint64_t IncreaseCount{0};
+        uint64_t CpuBoundCount{0};
+        uint64_t OverBudgetCount{0}; // Frames whose utilization was above 1, i.e. that likely missed the display period.
+    };
+
+    // Adjusts the viewport scale of the primary projection layers within their swapchains once per frame, driven by the CPU
+    // time of the update and render stages and the GPU time of the rendered frames.
+    class DynamicResolutionController {
+    public:
+        DynamicResolutionController(ID3D11Device* device, DynamicResolutionPolicy policy);
+
+        // Called by the update thread with the time it took to update the scenes.
+        void SetUpdateTime(std::chrono::nanoseconds updateTime);
+
+        // Called by the render thread around the rendering of a frame.
+        void BeginRender(ID3D11DeviceContext* context);
+        void EndRender(ID3D11DeviceContext* context, const FrameTime& frameTime);
+
+        // The viewport scale to render the next frame with.
+        float Scale() const;
+
+        DynamicResolutionTelemetry Telemetry() const;
+
+    private:
+        const DynamicResolutionPolicy m_policy;
+        GpuFrameTimer m_gpuTimer;
+        FrameTime::clock::time_point m_renderStart;
+        std::atomic<int64_t> m_updateTimeNs{0};
+        bool m_gpuTimed{false};
+
+        mutable std::mutex m_mutex;
+        DynamicResolutionTelemetry m_telemetry;
+    };
+} // namespace engine
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "Foveation.h"
+
+XrFovf engine::ComputeFoveatedInsetFov(const XrFovf& viewFov,
+                                       float insetFovFraction,
+                                       const std::optional<XrVector3f>& gazeDirectionInView) {
+    // Work with tangents, in which the projection onto the image is linear.
+    const float left = std::tan(viewFov.angleLeft);
+    const float right = std::tan(viewFov.angleRight);
+    const float down = std::tan(viewFov.angleDown);
+    const float up = std::tan(viewFov.angleUp);
+
+    const float fraction = std::clamp(insetFovFraction, 0.0f, 1.0f);
+    const float halfWidth = fraction * (right - left) / 2;
+    const float halfHeight = fraction * (up - down) / 2;
+
+    float centerX = (left + right) / 2;
+    float centerY = (down + up) / 2;
+    if (gazeDirectionInView && gazeDirectionInView->z < -std::numeric_limits<float>::epsilon()) {
+        centerX = gazeDirectionInView->x / -gazeDirectionInView->z;
+        centerY = gazeDirectionInView->y / -gazeDirectionInView->z;
+    }
+    centerX = std::clamp(centerX, left + halfWidth, right - halfWidth);
+    centerY = std::clamp(centerY, down + halfHeight, up - halfHeight);
+
+    XrFovf insetFov;
+    insetFov.angleLeft = std::atan(centerX - halfWidth);
+    insetFov.angleRight = std::atan(centerX + halfWidth);
+    insetFov.angleUp = std::atan(centerY + halfHeight);
+    insetFov.angleDown = std::atan(centerY - halfHeight);
+    return insetFov;
+}
+
+engine::FoveatedImageRects engine::ComputeFoveatedImageRects(const XrRect2Di& viewImageRect,
+                                                             const FoveationConfig& foveation,
+                                                             const XrExtent2Df& viewportSizeScale) {
+    if (foveation.PeripheryScale <= 0 || foveation.InsetFovFraction <= 0 || foveation.PeripheryScale + foveation.InsetFovFraction > 1) {
+        throw std::runtime_error(fmt::format("Foveation periphery scale {} and inset fov fraction {} do not fit in the image",
+                                             foveation.PeripheryScale,
+                                             foveation.InsetFovFraction));
+    }
+
+    const auto scaled = [](int32_t size, float scale) { return static_cast<int32_t>(std::ceil(size * scale)); };
+    const XrExtent2Di& size = viewImageRect.extent;
+
+    FoveatedImageRects rects;
+    rects.Periphery.offset = viewImageRect.offset;
+    rects.Periphery.extent.width = scaled(size.width, foveation.PeripheryScale * std::min(viewportSizeScale.width, 1.0f));
+    rects.Periphery.extent.height = scaled(size.height, foveation.PeripheryScale * std::min(viewportSizeScale.height, 1.0f));
+
+    // The inset has the same pixel density as the swapchain, so its size is its fraction of the fov.
+    const int32_t peripheryWidth = scaled(size.width, foveation.PeripheryScale);
+    rects.Inset.offset = {viewImageRect.offset.x + peripheryWidth, viewImageRect.offset.y};
+    rects.Inset.extent.width = std::min(scaled(size.width, foveation.InsetFovFraction), size.width - peripheryWidth);
+    rects.Inset.extent.height = scaled(size.height, foveation.InsetFovFraction);
+    return rects;
+}
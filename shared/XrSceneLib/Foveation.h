@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+
+namespace engine {
+    // Foveated projection layers render each view twice into separate rects of the same swapchain image: the whole fov at
+    // a lower resolution, and an inset of the fov at the full resolution of the swapchain. The inset is submitted as a
+    // second projection layer on top, so the pixel shading cost outside the inset drops with the square of PeripheryScale.
+    struct FoveationConfig {
+        float InsetFovFraction{0.4f}; // The width and height of the inset, relative to the tangents of the view fov.
+        float PeripheryScale{0.5f};   // The resolution of the whole view, relative to the swapchain.
+
+        // The inset follows the forward direction of this space, e.g. an eye gaze action space, while it can be located.
+        // Otherwise the inset stays at the center of the view fov.
+        XrSpace GazeSpace{XR_NULL_HANDLE};
+    };
+
+    struct FoveatedImageRects {
+        XrRect2Di Periphery;
+        XrRect2Di Inset;
+    };
+
+    // The fov of the inset of a view, centered on the gaze direction in view space (-Z forward) when given and in front of
+    // the view, and moved as little as needed to stay within the view fov.
+    XrFovf ComputeFoveatedInsetFov(const XrFovf& viewFov, float insetFovFraction, const std::optional<XrVector3f>& gazeDirectionInView);
+
+    // The rects for the periphery and the inset of a view, side by side in the image rect of the view. The periphery is
+    // scaled by viewportSizeScale in addition to PeripheryScale. Throws if they do not fit side by side.
+    FoveatedImageRects ComputeFoveatedImageRects(const XrRect2Di& viewImageRect,
+                                                 const FoveationConfig& foveation,
+                                                 const XrExtent2Df& viewportSizeScale = {1, 1});
+} // namespace engine
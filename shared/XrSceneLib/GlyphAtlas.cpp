@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <algorithm>
+#include <pbr/PbrMaterial.h>
+#include "GlyphAtlas.h"
+
+namespace {
+    constexpr DXGI_FORMAT AtlasFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+    constexpr uint32_t SolidSize = 4; // pixels
+} // namespace
+
+engine::GlyphAtlas::GlyphAtlas(Context& context, GlyphAtlasInfo info)
+    : m_info(std::move(info))
+    , m_packer(m_info.Width, m_info.Height) {
+    const winrt::com_ptr<ID3D11Device> device = context.Device;
+
+    D2D1_FACTORY_OPTIONS options{};
+    CHECK_HRCMD(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, winrt::guid_of<ID2D1Factory2>(), &options, m_d2dFactory.put_void()));
+    CHECK_HRCMD(DWriteCreateFactory(
+        DWRITE_FACTORY_TYPE_SHARED, winrt::guid_of<IDWriteFactory2>(), reinterpret_cast<IUnknown**>(m_dwriteFactory.put_void())));
+
+    const winrt::com_ptr<IDXGIDevice> dxgiDevice = device.as<IDXGIDevice>();
+    CHECK_HRCMD(m_d2dFactory->CreateDevice(dxgiDevice.get(), m_d2dDevice.put()));
+    CHECK_HRCMD(m_d2dDevice->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, m_d2dContext.put()));
+
+    //
+    // Find the font face, falling back to the first family of the system if the font is not installed.
+    //
+    winrt::com_ptr<IDWriteFontCollection> fontCollection;
+    CHECK_HRCMD(m_dwriteFactory->GetSystemFontCollection(fontCollection.put()));
+    UINT32 familyIndex = 0;
+    BOOL familyExists = FALSE;
+    CHECK_HRCMD(fontCollection->FindFamilyName(m_info.FontName, &familyIndex, &familyExists));
+    if (!familyExists) {
+        familyIndex = 0;
+    }
+
+    winrt::com_ptr<IDWriteFontFamily> fontFamily;
+    CHECK_HRCMD(fontCollection->GetFontFamily(familyIndex, fontFamily.put()));
+    winrt::com_ptr<IDWriteFont> font;
+    CHECK_HRCMD(
+        fontFamily->GetFirstMatchingFont(DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL, font.put()));
+    CHECK_HRCMD(font->CreateFontFace(m_fontFace.put()));
+
+    if (auto fontFace1 = m_fontFace.try_as<IDWriteFontFace1>(); fontFace1 && fontFace1->HasKerningPairs()) {
+        m_kerningFontFace = std::move(fontFace1);
+    }
+
+    DWRITE_FONT_METRICS fontMetrics;
+    m_fontFace->GetMetrics(&fontMetrics);
+    m_designUnitScale = m_info.FontSize / fontMetrics.designUnitsPerEm;
+
+    m_glyphs.AtlasWidth = m_info.Width;
+    m_glyphs.AtlasHeight = m_info.Height;
+    m_glyphs.Ascent = fontMetrics.ascent * m_designUnitScale;
+    m_glyphs.LineHeight = (fontMetrics.ascent + fontMetrics.descent + fontMetrics.lineGap) * m_designUnitScale;
+
+    //
+    // Create the atlas texture and clear it to transparent, except for a block of opaque pixels for backgrounds.
+    //
+    const auto texDesc = CD3D11_TEXTURE2D_DESC(AtlasFormat,
+                                               m_info.Width,
+                                               m_info.Height,
+                                               1,
+                                               1,
+                                               D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE,
+                                               D3D11_USAGE_DEFAULT,
+                                               0,
+                                               1,
+                                               0,
+                                               0);
+    CHECK_HRCMD(device->CreateTexture2D(&texDesc, nullptr, m_texture.put()));
+
+    const D2D1_BITMAP_PROPERTIES1 bitmapProperties = D2D1::BitmapProperties1(D2D1_BITMAP_OPTIONS_TARGET | D2D1_BITMAP_OPTIONS_CANNOT_DRAW,
+                                                                             D2D1::PixelFormat(AtlasFormat, D2D1_ALPHA_MODE_PREMULTIPLIED));
+    winrt::com_ptr<IDXGISurface> dxgiSurface = m_texture.as<IDXGISurface>();
+    CHECK_HRCMD(m_d2dContext->CreateBitmapFromDxgiSurface(dxgiSurface.get(), &bitmapProperties, m_d2dTargetBitmap.put()));
+
+    m_d2dContext->SetTarget(m_d2dTargetBitmap.get());
+    m_d2dContext->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+    m_d2dContext->SetTransform(D2D1::Matrix3x2F::Identity());
+    CHECK_HRCMD(m_d2dContext->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), m_brush.put()));
+
+    const AtlasRect solidRect = m_packer.Pack(SolidSize, SolidSize).value();
+    m_glyphs.SolidRect = solidRect;
+
+    m_d2dContext->BeginDraw();
+    m_d2dContext->Clear(D2D1::ColorF(0, 0, 0, 0));
+    m_d2dContext->FillRectangle(
+        D2D1::RectF((float)solidRect.X, (float)solidRect.Y, (float)(solidRect.X + SolidSize), (float)(solidRect.Y + SolidSize)),
+        m_brush.get());
+    CHECK_HRCMD(m_d2dContext->EndDraw());
+
+    m_material = Pbr::Material::CreateFlat(context.PbrResources, Pbr::RGBA::White);
+    winrt::com_ptr<ID3D11ShaderResourceView> atlasSrv;
+    CHECK_HRCMD(device->CreateShaderResourceView(m_texture.get(), nullptr, atlasSrv.put()));
+    m_material->SetTexture(Pbr::ShaderSlots::BaseColor, atlasSrv.get());
+    m_material->SetAlphaBlended(true);
+}
+
+bool engine::GlyphAtlas::AddGlyphs(std::u32string_view text) {
+    std::vector<UINT32> newCodepoints;
+    for (char32_t codepoint : text) {
+        if (codepoint != U'\n' && m_glyphIndices.count(codepoint) == 0 &&
+            std::find(newCodepoints.begin(), newCodepoints.end(), codepoint) == newCodepoints.end()) {
+            newCodepoints.push_back(codepoint);
+        }
+    }
+
+    bool allGlyphsFit = true;
+    if (!newCodepoints.empty()) {
+        std::vector<UINT16> glyphIndices(newCodepoints.size());
+        CHECK_HRCMD(m_fontFace->GetGlyphIndices(newCodepoints.data(), (UINT32)newCodepoints.size(), glyphIndices.data()));
+        std::vector<DWRITE_GLYPH_METRICS> designMetrics(newCodepoints.size());
+        CHECK_HRCMD(m_fontFace->GetDesignGlyphMetrics(glyphIndices.data(), (UINT32)glyphIndices.size(), designMetrics.data(), FALSE));
+
+        m_d2dContext->BeginDraw();
+        for (size_t i = 0; i < newCodepoints.size(); i++) {
+            const DWRITE_GLYPH_METRICS& metrics = designMetrics[i];
+            const float advance = metrics.advanceWidth * m_designUnitScale;
+
+            // Black box of the glyph relative to the pen position, y down, with a pixel of room for antialiasing.
+            const float left = std::floor(metrics.leftSideBearing * m_designUnitScale) - 1;
+            const float right = std::ceil(((int32_t)metrics.advanceWidth - metrics.rightSideBearing) * m_designUnitScale) + 1;
+            const float top = std::floor((metrics.topSideBearing - metrics.verticalOriginY) * m_designUnitScale) - 1;
+            const float bottom =
+                std::ceil(((int32_t)metrics.advanceHeight - metrics.bottomSideBearing - metrics.verticalOriginY) * m_designUnitScale) + 1;
+
+            GlyphMetrics glyph;
+            glyph.Advance = advance;
+            glyph.OffsetX = left;
+            glyph.OffsetY = top;
+
+            const bool hasPixels = (int32_t)metrics.advanceWidth - metrics.leftSideBearing - metrics.rightSideBearing > 0;
+            const std::optional<AtlasRect> rect =
+                hasPixels ? m_packer.Pack((uint32_t)(right - left), (uint32_t)(bottom - top)) : std::nullopt;
+            if (hasPixels && !rect) {
+                // Keep the glyph without pixels, so that it still advances the pen and is not rasterized again.
+                allGlyphsFit = false;
+            } else if (rect) {
+                glyph.Rect = rect.value();
+
+                DWRITE_GLYPH_RUN glyphRun{};
+                glyphRun.fontFace = m_fontFace.get();
+                glyphRun.fontEmSize = m_info.FontSize;
+                glyphRun.glyphCount = 1;
+                glyphRun.glyphIndices = &glyphIndices[i];
+                glyphRun.glyphAdvances = &advance;
+
+                const D2D1_RECT_F clip = D2D1::RectF(
+                    (float)rect->X, (float)rect->Y, (float)(rect->X + rect->Width), (float)(rect->Y + rect->Height));
+                m_d2dContext->PushAxisAlignedClip(clip, D2D1_ANTIALIAS_MODE_ALIASED);
+                m_d2dContext->DrawGlyphRun(D2D1::Point2F(rect->X - left, rect->Y - top), &glyphRun, m_brush.get());
+                m_d2dContext->PopAxisAlignedClip();
+            }
+
+            m_glyphs.Glyphs[newCodepoints[i]] = glyph;
+            m_glyphIndices[newCodepoints[i]] = glyphIndices[i];
+        }
+        CHECK_HRCMD(m_d2dContext->EndDraw());
+    }
+
+    // Pair kerning of the adjacent characters, looked up once per pair.
+    if (m_kerningFontFace) {
+        for (size_t i = 0; i + 1 < text.size(); i++) {
+            const uint64_t key = GlyphTable::KerningKey(text[i], text[i + 1]);
+            if (m_glyphs.Kerning.count(key) != 0) {
+                continue;
+            }
+
+            const auto first = m_glyphIndices.find(text[i]);
+            const auto second = m_glyphIndices.find(text[i + 1]);
+            if (first == m_glyphIndices.end() || second == m_glyphIndices.end()) {
+                continue;
+            }
+
+            const UINT16 pair[2] = {first->second, second->second};
+            INT32 adjustments[2]{};
+            CHECK_HRCMD(m_kerningFontFace->GetKerningPairAdjustments(2, pair, adjustments));
+            m_glyphs.Kerning[key] = adjustments[0] * m_designUnitScale;
+        }
+    }
+
+    return allGlyphsFit;
+}
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <dxgi.h>
+#include <d2d1_2.h>
+#include <dwrite_2.h>
+
+#include "pbr/PbrMaterial.h"
+#include "Context.h"
+#include "TextLayout.h"
+
+namespace engine {
+
+    struct GlyphAtlasInfo {
+        const wchar_t* FontName = L"Segoe UI";
+        float FontSize = 18;
+        uint32_t Width = 1024; // pixels
+        uint32_t Height = 1024;
+    };
+
+    // A texture with the glyphs of one font, shared by all text drawn with that font.
+    // Each glyph is rasterized with DirectWrite the first time a text uses it. All text objects of the atlas share one material.
+    class GlyphAtlas {
+    public:
+        GlyphAtlas(Context& context, GlyphAtlasInfo info = {});
+
+        // Rasterize the glyphs of the text that are not in the atlas yet, and look up the kerning of its character pairs.
+        // Returns false if some glyphs did not fit in the atlas.
+        bool AddGlyphs(std::u32string_view text);
+
+        const GlyphTable& Glyphs() const {
+            return m_glyphs;
+        }
+
+        const std::shared_ptr<Pbr::Material>& Material() const {
+            return m_material;
+        }
+
+    private:
+        const GlyphAtlasInfo m_info;
+        float m_designUnitScale{0}; // Pixels per font design unit.
+
+        winrt::com_ptr<ID2D1Factory2> m_d2dFactory;
+        winrt::com_ptr<ID2D1Device1> m_d2dDevice;
+        winrt::com_ptr<ID2D1DeviceContext1> m_d2dContext;
+        winrt::com_ptr<ID2D1Bitmap1> m_d2dTargetBitmap;
+        winrt::com_ptr<ID2D1SolidColorBrush> m_brush;
+        winrt::com_ptr<IDWriteFactory2> m_dwriteFactory;
+        winrt::com_ptr<IDWriteFontFace> m_fontFace;
+        winrt::com_ptr<IDWriteFontFace1> m_kerningFontFace; // Null if the font has no kerning pairs.
+        winrt::com_ptr<ID3D11Texture2D> m_texture;
+        std::shared_ptr<Pbr::Material> m_material;
+
+        AtlasPacker m_packer;
+        GlyphTable m_glyphs;
+        std::unordered_map<char32_t, uint16_t> m_glyphIndices;
+    };
+
+} // namespace engine
@@ -16,8 +16,8 @@ bool Object::IsVisibleForViewIndex(uint32_t viewIndex) const {
     return (m_visibleViewIndexMask.m_mask & (1 << viewIndex)) > 0;
 }
 
-void Object::Update(engine::Context& /*context*/, const FrameTime& frameTime) {
-    Motion.UpdateMotionAndPose(Pose(), frameTime.Elapsed);
+void Object::Update(engine::Context& /*context*/, const FrameTime& /*frameTime*/) {
+    // Motion is integrated for all objects of a scene at once, see engine::MotionSystem.
 }
 
 void Object::Render(Context& context) const {
@@ -37,6 +37,7 @@ namespace engine {
         }
         XrPosef& Pose() {
             m_localTransformDirty = true;
+            Motion.OnPoseChanged();
             return m_pose;
         }
 
@@ -55,6 +56,8 @@ namespace engine {
         virtual void Render(Context& context) const;
 
     private:
+        friend class MotionSystem; // Writes back the poses it integrates.
+
         bool m_isVisible{true};
 
         XrPosef m_pose = xr::math::Pose::Identity();
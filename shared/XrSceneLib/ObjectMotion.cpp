@@ -3,28 +3,113 @@
 
 #include "pch.h"
 #include "ObjectMotion.h"
+#include "Object.h"
 
 using engine::Motion;
+using engine::MotionSystem;
+using engine::Object;
+
+Motion::~Motion() {
+    if (m_system != nullptr) {
+        m_system->Remove(*m_system->m_objects[m_slot]);
+    }
+}
+
+Motion::Motion(const Motion& other)
+    : m_state(other.GetState()) {
+}
+
+Motion& Motion::operator=(const Motion& other) {
+    if (this != &other) {
+        SetState(other.GetState());
+    }
+    return *this;
+}
+
+Motion::State Motion::GetState() const {
+    return m_system != nullptr ? m_system->GetState(m_slot) : m_state;
+}
+
+void Motion::SetState(const State& state) {
+    if (m_system != nullptr) {
+        m_system->SetState(m_slot, state);
+    } else {
+        m_state = state;
+    }
+}
+
+bool Motion::Enabled() const {
+    return GetState().Enabled;
+}
+
+DirectX::XMFLOAT3 Motion::LinearVelocity() const {
+    return GetState().LinearVelocity;
+}
+
+DirectX::XMFLOAT3 Motion::LinearAcceleration() const {
+    return GetState().LinearAcceleration;
+}
+
+DirectX::XMFLOAT3 Motion::AngularVelocity() const {
+    return GetState().AngularVelocity;
+}
+
+DirectX::XMFLOAT3 Motion::AngularAcceleration() const {
+    return GetState().AngularAcceleration;
+}
+
+void Motion::SetEnabled(bool enabled) {
+    State state = GetState();
+    state.Enabled = enabled;
+    SetState(state);
+}
+
+void Motion::SetLinearVelocity(const DirectX::XMFLOAT3& velocity) {
+    State state = GetState();
+    state.LinearVelocity = velocity;
+    SetState(state);
+}
+
+void Motion::SetLinearAcceleration(const DirectX::XMFLOAT3& acceleration) {
+    State state = GetState();
+    state.LinearAcceleration = acceleration;
+    SetState(state);
+}
+
+void Motion::SetAngularVelocity(const DirectX::XMFLOAT3& velocity) {
+    State state = GetState();
+    state.AngularVelocity = velocity;
+    SetState(state);
+}
+
+void Motion::SetAngularAcceleration(const DirectX::XMFLOAT3& acceleration) {
+    State state = GetState();
+    state.AngularAcceleration = acceleration;
+    SetState(state);
+}
 
 void Motion::SetGravity(float gravitationalAcceleration) {
-    LinearAcceleration = {0, -gravitationalAcceleration, 0};
+    SetLinearAcceleration({0, -gravitationalAcceleration, 0});
 }
 
 void Motion::SetRotation(const XrVector3f& axis, float radiansPerSecond) {
-    AngularVelocity = {axis.x * radiansPerSecond, axis.y * radiansPerSecond, axis.z * radiansPerSecond};
+    SetAngularVelocity({axis.x * radiansPerSecond, axis.y * radiansPerSecond, axis.z * radiansPerSecond});
 }
 
 void Motion::SetVelocity(const XrSpaceVelocity& velocity) {
-    LinearVelocity = (velocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) ? xr::math::cast(velocity.linearVelocity)
-                                                                                   : DirectX::XMFLOAT3{0, 0, 0};
-    AngularVelocity = (velocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) ? xr::math::cast(velocity.angularVelocity)
-                                                                                     : DirectX::XMFLOAT3{0, 0, 0};
+    State state = GetState();
+    state.LinearVelocity = (velocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) ? xr::math::cast(velocity.linearVelocity)
+                                                                                         : DirectX::XMFLOAT3{0, 0, 0};
+    state.AngularVelocity = (velocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) ? xr::math::cast(velocity.angularVelocity)
+                                                                                           : DirectX::XMFLOAT3{0, 0, 0};
+    SetState(state);
 }
 
 void Motion::UpdateMotionAndPose(XrPosef& pose, std::chrono::duration<float> durationInSeconds) {
     using namespace DirectX;
 
-    if (!Enabled) {
+    State state = GetState();
+    if (!state.Enabled) {
         return;
     }
 
@@ -32,13 +117,14 @@ void Motion::UpdateMotionAndPose(XrPosef& pose, std::chrono::duration<float> dur
 
     const auto position = xr::math::LoadXrVector3(pose.position);
     const auto orientation = xr::math::LoadXrQuaternion(pose.orientation);
-    const auto linearVelocity = XMLoadFloat3(&LinearVelocity);
-    const auto angularVelocity = XMLoadFloat3(&AngularVelocity);
-    const auto linearAcceleration = XMLoadFloat3(&LinearAcceleration);
-    const auto angularAcceleration = XMLoadFloat3(&AngularAcceleration);
+    const auto linearVelocity = XMLoadFloat3(&state.LinearVelocity);
+    const auto angularVelocity = XMLoadFloat3(&state.AngularVelocity);
+    const auto linearAcceleration = XMLoadFloat3(&state.LinearAcceleration);
+    const auto angularAcceleration = XMLoadFloat3(&state.AngularAcceleration);
 
-    XMStoreFloat3(&LinearVelocity, linearVelocity + XMVectorScale(linearAcceleration, dt));
-    XMStoreFloat3(&AngularVelocity, angularVelocity + XMVectorScale(angularAcceleration, dt));
+    XMStoreFloat3(&state.LinearVelocity, linearVelocity + XMVectorScale(linearAcceleration, dt));
+    XMStoreFloat3(&state.AngularVelocity, angularVelocity + XMVectorScale(angularAcceleration, dt));
+    SetState(state);
 
     xr::math::StoreXrVector3(&pose.position, position + XMVectorScale(linearVelocity, dt));
 
@@ -51,3 +137,274 @@ void Motion::UpdateMotionAndPose(XrPosef& pose, std::chrono::duration<float> dur
                                     XMQuaternionMultiply(XMQuaternionRotationAxis(angularVelocityInWorld, angle * dt), orientation));
     }
 }
+
+MotionSystem::~MotionSystem() {
+    // Hand the motion state back to the objects which outlive the system.
+    while (!m_objects.empty()) {
+        Remove(*m_objects.back());
+    }
+}
+
+void MotionSystem::Add(Object& object) {
+    Motion& motion = object.Motion;
+    if (motion.m_system == this) {
+        return;
+    }
+    if (motion.m_system != nullptr) {
+        motion.m_system->Remove(object);
+    }
+
+    // The unused lanes of the last group are zero and disabled.
+    const auto slot = static_cast<uint32_t>(m_objects.size());
+    if (slot % 4 == 0) {
+        m_lanes.push_back(MotionLanes{});
+    }
+    m_objects.push_back(&object);
+    m_poseChanged.push_back(1);
+
+    SetState(slot, motion.m_state);
+    motion.m_system = this;
+    motion.m_slot = slot;
+}
+
+void MotionSystem::Remove(Object& object) {
+    Motion& motion = object.Motion;
+    if (motion.m_system != this) {
+        return;
+    }
+
+    const uint32_t slot = motion.m_slot;
+    motion.m_state = GetState(slot);
+    motion.m_system = nullptr;
+
+    // Move the last slot into the removed one so that the lanes stay dense.
+    const auto last = static_cast<uint32_t>(m_objects.size() - 1);
+    if (slot != last) {
+        SwapSlots(slot, last);
+    }
+
+    // The unused lanes of the last group are zero and disabled.
+    LaneRows& rows = reinterpret_cast<LaneRows&>(m_lanes[last / 4]);
+    for (auto& row : rows) {
+        row[last % 4] = 0;
+    }
+    m_objects.pop_back();
+    m_poseChanged.pop_back();
+    if (last % 4 == 0) {
+        m_lanes.pop_back();
+    }
+    m_partitionChanged = true;
+}
+
+bool MotionSystem::IsEnabled(uint32_t slot) const {
+    return m_lanes[slot / 4].EnabledMask[slot % 4] != 0;
+}
+
+void MotionSystem::SwapSlots(uint32_t slot, uint32_t otherSlot) {
+    LaneRows& rows = reinterpret_cast<LaneRows&>(m_lanes[slot / 4]);
+    LaneRows& otherRows = reinterpret_cast<LaneRows&>(m_lanes[otherSlot / 4]);
+    for (size_t row = 0; row < std::size(rows); row++) {
+        std::swap(rows[row][slot % 4], otherRows[row][otherSlot % 4]);
+    }
+
+    std::swap(m_objects[slot], m_objects[otherSlot]);
+    std::swap(m_poseChanged[slot], m_poseChanged[otherSlot]);
+    m_objects[slot]->Motion.m_slot = slot;
+    m_objects[otherSlot]->Motion.m_slot = otherSlot;
+}
+
+void MotionSystem::PartitionEnabledSlots() {
+    // Swap disabled slots from the front with enabled slots from the back, so that only the slots which changed are moved.
+    uint32_t front = 0;
+    auto back = static_cast<uint32_t>(m_objects.size());
+    for (;;) {
+        while (front < back && IsEnabled(front)) {
+            front++;
+        }
+        while (front < back && !IsEnabled(back - 1)) {
+            back--;
+        }
+        if (front == back) {
+            break;
+        }
+        SwapSlots(front++, --back);
+    }
+    m_enabledCount = front;
+}
+
+Motion::State MotionSystem::GetState(uint32_t slot) const {
+    const MotionLanes& lanes = m_lanes[slot / 4];
+    const size_t lane = slot % 4;
+
+    Motion::State state;
+    state.Enabled = lanes.EnabledMask[lane] != 0;
+    state.LinearVelocity = {lanes.LinearVelocityX[lane], lanes.LinearVelocityY[lane], lanes.LinearVelocityZ[lane]};
+    state.LinearAcceleration = {lanes.LinearAccelerationX[lane], lanes.LinearAccelerationY[lane], lanes.LinearAccelerationZ[lane]};
+    state.AngularVelocity = {lanes.AngularVelocityX[lane], lanes.AngularVelocityY[lane], lanes.AngularVelocityZ[lane]};
+    state.AngularAcceleration = {lanes.AngularAccelerationX[lane], lanes.AngularAccelerationY[lane], lanes.AngularAccelerationZ[lane]};
+    return state;
+}
+
+void MotionSystem::SetState(uint32_t slot, const Motion::State& state) {
+    MotionLanes& lanes = m_lanes[slot / 4];
+    const size_t lane = slot % 4;
+
+    if ((lanes.EnabledMask[lane] != 0) != state.Enabled) {
+        lanes.EnabledMask[lane] = state.Enabled ? ~0u : 0u;
+        m_partitionChanged = true;
+    }
+    lanes.LinearVelocityX[lane] = state.LinearVelocity.x;
+    lanes.LinearVelocityY[lane] = state.LinearVelocity.y;
+    lanes.LinearVelocityZ[lane] = state.LinearVelocity.z;
+    lanes.LinearAccelerationX[lane] = state.LinearAcceleration.x;
+    lanes.LinearAccelerationY[lane] = state.LinearAcceleration.y;
+    lanes.LinearAccelerationZ[lane] = state.LinearAcceleration.z;
+    lanes.AngularVelocityX[lane] = state.AngularVelocity.x;
+    lanes.AngularVelocityY[lane] = state.AngularVelocity.y;
+    lanes.AngularVelocityZ[lane] = state.AngularVelocity.z;
+    lanes.AngularAccelerationX[lane] = state.AngularAcceleration.x;
+    lanes.AngularAccelerationY[lane] = state.AngularAcceleration.y;
+    lanes.AngularAccelerationZ[lane] = state.AngularAcceleration.z;
+}
+
+void MotionSystem::GatherPose(uint32_t slot) {
+    const XrPosef& pose = m_objects[slot]->m_pose;
+    MotionLanes& lanes = m_lanes[slot / 4];
+    const size_t lane = slot % 4;
+
+    lanes.PositionX[lane] = pose.position.x;
+    lanes.PositionY[lane] = pose.position.y;
+    lanes.PositionZ[lane] = pose.position.z;
+    lanes.OrientationX[lane] = pose.orientation.x;
+    lanes.OrientationY[lane] = pose.orientation.y;
+    lanes.OrientationZ[lane] = pose.orientation.z;
+    lanes.OrientationW[lane] = pose.orientation.w;
+}
+
+void MotionSystem::ScatterPose(uint32_t slot) {
+    Object& object = *m_objects[slot];
+    const MotionLanes& lanes = m_lanes[slot / 4];
+    const size_t lane = slot % 4;
+
+    // Bypasses Object::Pose(), which would make the system gather the pose again.
+    object.m_pose.position = {lanes.PositionX[lane], lanes.PositionY[lane], lanes.PositionZ[lane]};
+    object.m_pose.orientation = {lanes.OrientationX[lane], lanes.OrientationY[lane], lanes.OrientationZ[lane], lanes.OrientationW[lane]};
+    object.m_localTransformDirty = true;
+}
+
+void MotionSystem::Update(std::chrono::duration<float> durationInSeconds) {
+    for (uint32_t slot = 0; slot < m_poseChanged.size(); slot++) {
+        if (m_poseChanged[slot] != 0) {
+            GatherPose(slot);
+            m_poseChanged[slot] = 0;
+        }
+    }
+
+    if (m_partitionChanged.exchange(false)) {
+        PartitionEnabledSlots();
+    }
+
+    Integrate(durationInSeconds.count());
+}
+
+void MotionSystem::Integrate(float dt) {
+    using namespace DirectX;
+
+    m_movingObjectCount = 0;
+    const size_t enabledGroupCount = (m_enabledCount + 3) / 4;
+    for (size_t group = 0; group < enabledGroupCount; group++) {
+        MotionLanes& lanes = m_lanes[group];
+        const XMVECTOR enabled = XMLoadInt4A(lanes.EnabledMask);
+        if (XMVector4EqualInt(enabled, XMVectorZero())) {
+            continue;
+        }
+
+        // Disabled lanes advance by a zero step, which leaves their state unchanged.
+        const XMVECTOR timeStep = XMVectorAndInt(XMVectorReplicate(dt), enabled);
+        const XMVECTOR halfTimeStep = XMVectorAndInt(XMVectorReplicate(dt * 0.5f), enabled);
+
+        const auto load = [](const float* values) { return XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(values)); };
+        const auto store = [](float* values, FXMVECTOR v) { XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(values), v); };
+
+        // Returns the velocity that advances the pose over the step, and updates the velocity to the end of the step.
+        const auto integrateVelocity = [&](float* velocity, const float* acceleration) {
+            const XMVECTOR v0 = load(velocity);
+            const XMVECTOR a = load(acceleration);
+            const XMVECTOR v1 = XMVectorMultiplyAdd(a, timeStep, v0);
+            store(velocity, v1);
+            switch (Integration) {
+            case MotionIntegration::SemiImplicitEuler:
+                return v1;
+            case MotionIntegration::Midpoint:
+                return XMVectorMultiplyAdd(a, halfTimeStep, v0);
+            case MotionIntegration::Euler:
+            default:
+                return v0;
+            }
+        };
+
+        const XMVECTOR px = load(lanes.PositionX);
+        const XMVECTOR py = load(lanes.PositionY);
+        const XMVECTOR pz = load(lanes.PositionZ);
+        const XMVECTOR vx = integrateVelocity(lanes.LinearVelocityX, lanes.LinearAccelerationX);
+        const XMVECTOR vy = integrateVelocity(lanes.LinearVelocityY, lanes.LinearAccelerationY);
+        const XMVECTOR vz = integrateVelocity(lanes.LinearVelocityZ, lanes.LinearAccelerationZ);
+        const XMVECTOR nextPx = XMVectorMultiplyAdd(vx, timeStep, px);
+        const XMVECTOR nextPy = XMVectorMultiplyAdd(vy, timeStep, py);
+        const XMVECTOR nextPz = XMVectorMultiplyAdd(vz, timeStep, pz);
+        store(lanes.PositionX, nextPx);
+        store(lanes.PositionY, nextPy);
+        store(lanes.PositionZ, nextPz);
+
+        // The rotation over the step is exp(w * dt / 2) = [sin(|w| dt / 2) w / |w|, cos(|w| dt / 2)].
+        const XMVECTOR wx = integrateVelocity(lanes.AngularVelocityX, lanes.AngularAccelerationX);
+        const XMVECTOR wy = integrateVelocity(lanes.AngularVelocityY, lanes.AngularAccelerationY);
+        const XMVECTOR wz = integrateVelocity(lanes.AngularVelocityZ, lanes.AngularAccelerationZ);
+        const XMVECTOR speed = XMVectorSqrt(wx * wx + wy * wy + wz * wz);
+        XMVECTOR sinHalfAngle, cosHalfAngle;
+        XMVectorSinCos(&sinHalfAngle, &cosHalfAngle, speed * halfTimeStep);
+        const XMVECTOR axisScale = XMVectorSelect(sinHalfAngle / speed, XMVectorZero(), XMVectorEqual(speed, XMVectorZero()));
+        const XMVECTOR dx = wx * axisScale;
+        const XMVECTOR dy = wy * axisScale;
+        const XMVECTOR dz = wz * axisScale;
+        const XMVECTOR dw = cosHalfAngle;
+
+        // Apply the world space rotation after the current orientation, i.e. q' = d * q.
+        const XMVECTOR qx = load(lanes.OrientationX);
+        const XMVECTOR qy = load(lanes.OrientationY);
+        const XMVECTOR qz = load(lanes.OrientationZ);
+        const XMVECTOR qw = load(lanes.OrientationW);
+        const XMVECTOR rx = dw * qx + qw * dx + dy * qz - dz * qy;
+        const XMVECTOR ry = dw * qy + qw * dy + dz * qx - dx * qz;
+        const XMVECTOR rz = dw * qz + qw * dz + dx * qy - dy * qx;
+        const XMVECTOR rw = dw * qw - dx * qx - dy * qy - dz * qz;
+
+        // Renormalize so that rounding errors do not accumulate over many frames. Orientations which do not rotate are kept
+        // as they are, so that renormalizing does not change them.
+        const XMVECTOR rotating = XMVectorAndInt(enabled, XMVectorNotEqual(speed, XMVectorZero()));
+        const XMVECTOR lengthSq = rx * rx + ry * ry + rz * rz + rw * rw;
+        const XMVECTOR inverseLength =
+            XMVectorSelect(XMVectorReciprocalSqrt(lengthSq), XMVectorZero(), XMVectorEqual(lengthSq, XMVectorZero()));
+        store(lanes.OrientationX, XMVectorSelect(qx, rx * inverseLength, rotating));
+        store(lanes.OrientationY, XMVectorSelect(qy, ry * inverseLength, rotating));
+        store(lanes.OrientationZ, XMVectorSelect(qz, rz * inverseLength, rotating));
+        store(lanes.OrientationW, XMVectorSelect(qw, rw * inverseLength, rotating));
+
+        // Only write back the poses which changed.
+        const XMVECTOR moved =
+            XMVectorOrInt(XMVectorOrInt(XMVectorNotEqual(nextPx, px), XMVectorNotEqual(nextPy, py)), XMVectorNotEqual(nextPz, pz));
+        const XMVECTOR changed = XMVectorOrInt(XMVectorAndInt(enabled, moved), rotating);
+        if (XMVector4EqualInt(changed, XMVectorZero())) {
+            continue;
+        }
+
+        alignas(16) uint32_t changedMask[4];
+        XMStoreInt4A(changedMask, changed);
+        for (size_t lane = 0; lane < 4; lane++) {
+            if (changedMask[lane] != 0) {
+                ScatterPose(static_cast<uint32_t>(group * 4 + lane));
+                m_movingObjectCount++;
+            }
+        }
+    }
+}
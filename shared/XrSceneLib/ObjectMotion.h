@@ -4,17 +4,136 @@
 #pragma once
 
 namespace engine {
+    class Object;
+    class MotionSystem;
 
-    struct Motion {
-        bool Enabled{false};
-        DirectX::XMFLOAT3 LinearVelocity{};
-        DirectX::XMFLOAT3 LinearAcceleration{};
-        DirectX::XMFLOAT3 AngularVelocity{};
-        DirectX::XMFLOAT3 AngularAcceleration{};
+    // The motion of an object. While the object is in a scene the motion state is stored by the MotionSystem of the scene, and
+    // the motion holds the index of its slot there. Otherwise the motion stores its state itself.
+    class Motion {
+    public:
+        Motion() = default;
+        ~Motion();
+
+        // Copies the state only, the copy is not part of a motion system.
+        Motion(const Motion& other);
+        Motion& operator=(const Motion& other);
+
+        bool Enabled() const;
+        void SetEnabled(bool enabled);
+
+        DirectX::XMFLOAT3 LinearVelocity() const;
+        DirectX::XMFLOAT3 LinearAcceleration() const;
+        DirectX::XMFLOAT3 AngularVelocity() const;
+        DirectX::XMFLOAT3 AngularAcceleration() const;
+        void SetLinearVelocity(const DirectX::XMFLOAT3& velocity);
+        void SetLinearAcceleration(const DirectX::XMFLOAT3& acceleration);
+        void SetAngularVelocity(const DirectX::XMFLOAT3& velocity);
+        void SetAngularAcceleration(const DirectX::XMFLOAT3& acceleration);
 
         void SetGravity(float gravitationalAcceleration = 9.8f);
         void SetVelocity(const XrSpaceVelocity& velocity);
         void SetRotation(const XrVector3f& axis, float radiansPerSecond);
         void UpdateMotionAndPose(XrPosef& pose, std::chrono::duration<float> durationInSeconds);
+
+        // Called when the pose of the object is changed other than by the motion system.
+        void OnPoseChanged();
+
+    private:
+        friend class MotionSystem;
+
+        struct State {
+            bool Enabled{false};
+            DirectX::XMFLOAT3 LinearVelocity{};
+            DirectX::XMFLOAT3 LinearAcceleration{};
+            DirectX::XMFLOAT3 AngularVelocity{};
+            DirectX::XMFLOAT3 AngularAcceleration{};
+        };
+
+        State GetState() const;
+        void SetState(const State& state);
+
+        State m_state; // Only used while the motion is not part of a motion system.
+        MotionSystem* m_system{nullptr};
+        uint32_t m_slot{0};
+    };
+
+    enum class MotionIntegration {
+        Euler,             // Advance with the velocities at the start of the step, same as Motion::UpdateMotionAndPose.
+        SemiImplicitEuler, // Update the velocities first, then advance with the new velocities. Keeps orbits and springs stable.
+        Midpoint,          // Second order Runge-Kutta, advance with the velocities at the middle of the step.
+    };
+
+    // Integrates the motion of all enabled objects of a scene in one batch per frame.
+    // The system owns the motion state of the objects added to it, packed into structure-of-arrays lanes of four objects which
+    // are integrated with SIMD across objects. Each object keeps the index of its slot. Slots are moved so that the lanes stay
+    // dense and the enabled objects come first, after objects are removed or enabled. Poses are only read from an object after
+    // something else changed them, and only written back when the motion changed them. Orientations advance by the exponential
+    // map of the angular velocity, which is in world space. Objects whose motion is not enabled are not touched.
+    class MotionSystem {
+    public:
+        MotionIntegration Integration{MotionIntegration::Euler};
+
+        MotionSystem() = default;
+        ~MotionSystem();
+
+        MotionSystem(const MotionSystem&) = delete;
+        MotionSystem& operator=(const MotionSystem&) = delete;
+
+        // Moves the motion state of the object into the system, or out of it.
+        void Add(Object& object);
+        void Remove(Object& object);
+
+        void Update(std::chrono::duration<float> durationInSeconds);
+
+        // Number of objects whose motion is stored by the system.
+        size_t ObjectCount() const noexcept {
+            return m_objects.size();
+        }
+
+        // Number of objects whose pose was changed by the last update.
+        size_t MovingObjectCount() const noexcept {
+            return m_movingObjectCount;
+        }
+
+    private:
+        friend class Motion;
+
+        // Four objects per lane group, one SIMD vector per component.
+        struct alignas(16) MotionLanes {
+            float PositionX[4], PositionY[4], PositionZ[4];
+            float OrientationX[4], OrientationY[4], OrientationZ[4], OrientationW[4];
+            float LinearVelocityX[4], LinearVelocityY[4], LinearVelocityZ[4];
+            float LinearAccelerationX[4], LinearAccelerationY[4], LinearAccelerationZ[4];
+            float AngularVelocityX[4], AngularVelocityY[4], AngularVelocityZ[4];
+            float AngularAccelerationX[4], AngularAccelerationY[4], AngularAccelerationZ[4];
+            uint32_t EnabledMask[4]; // All bits set for enabled objects.
+        };
+
+        // The lanes of a group as rows of four values, one per component, to move the state of a slot as a whole.
+        using LaneRows = uint32_t[sizeof(MotionLanes) / sizeof(uint32_t[4])][4];
+        static_assert(sizeof(MotionLanes) == sizeof(LaneRows));
+
+        Motion::State GetState(uint32_t slot) const;
+        void SetState(uint32_t slot, const Motion::State& state);
+        bool IsEnabled(uint32_t slot) const;
+        void SwapSlots(uint32_t slot, uint32_t otherSlot);
+        void PartitionEnabledSlots();
+        void GatherPose(uint32_t slot);
+        void Integrate(float dt);
+        void ScatterPose(uint32_t slot);
+
+        std::vector<MotionLanes> m_lanes;
+        std::vector<Object*> m_objects;     // By slot.
+        std::vector<uint8_t> m_poseChanged; // By slot, set when the pose of the object changed since it was last gathered.
+        size_t m_enabledCount{0};           // The slots below are enabled, as of the last partition.
+        std::atomic<bool> m_partitionChanged{false};
+        size_t m_movingObjectCount{0};
     };
+
+    inline void Motion::OnPoseChanged() {
+        // Objects are updated concurrently, so each slot has its own byte.
+        if (m_system != nullptr) {
+            m_system->m_poseChanged[m_slot] = 1;
+        }
+    }
 } // namespace engine
@@ -16,24 +16,79 @@ PbrModelObject::PbrModelObject(std::shared_ptr<Pbr::Model> pbrModel, Pbr::Shadin
     , m_fillMode(fillMode) {
 }
 
+PbrModelObject::~PbrModelObject() {
+    DisableResidencyTracking();
+}
+
+void PbrModelObject::EnableResidencyTracking(Pbr::ResidencyManager& residencyManager,
+                                             std::function<std::shared_ptr<Pbr::Model>()> loadModel,
+                                             bool pinned) {
+    DisableResidencyTracking();
+
+    const Pbr::AssetFootprint footprint = m_pbrModel ? m_pbrModel->GetMemoryFootprint() : Pbr::AssetFootprint{};
+    m_residencyAssetId = residencyManager.RegisterAsset(
+        m_pbrModel ? m_pbrModel->Name : "", footprint, [this] { m_pbrModel = nullptr; }, pinned);
+    m_residencyManager = &residencyManager;
+    m_loadModel = std::move(loadModel);
+}
+
+void PbrModelObject::DisableResidencyTracking() {
+    if (m_residencyManager) {
+        m_residencyManager->UnregisterAsset(m_residencyAssetId);
+        m_residencyManager = nullptr;
+        m_residencyAssetId = Pbr::ResidencyManager::InvalidAssetId;
+        m_loadModel = nullptr;
+    }
+}
+
 void PbrModelObject::SetModel(std::shared_ptr<Pbr::Model> model) {
     m_pbrModel = std::move(model);
+    m_baseColorFactor.reset();
+    if (m_residencyManager) {
+        m_residencyManager->UpdateFootprint(m_residencyAssetId, m_pbrModel ? m_pbrModel->GetMemoryFootprint() : Pbr::AssetFootprint{});
+    }
 }
 
 std::shared_ptr<Pbr::Model> PbrModelObject::GetModel() const {
     return m_pbrModel;
 }
 
+void PbrModelObject::Update(engine::Context& context, const FrameTime& frameTime) {
+    Object::Update(context, frameTime);
+    if (!m_residencyManager) {
+        return;
+    }
+
+    // Reload the model in the background once it is rendered after being evicted, rather than on the rendering thread.
+    if (!m_reloadOperation.IsPending() && m_residencyManager->TakeReloadRequest(m_residencyAssetId)) {
+        m_reloadOperation = PbrModelLoadOperation::LoadAsync(m_loadModel);
+    }
+
+    if (std::shared_ptr<Pbr::Model> model = m_reloadOperation.TakeModelWhenReady()) {
+        m_pbrModel = std::move(model);
+        ApplyMaterialOverrides();
+        m_residencyManager->CompleteReload(m_residencyAssetId, m_pbrModel->GetMemoryFootprint());
+    }
+}
+
 void PbrModelObject::Render(Context& context) const {
-    if (!IsVisible() || !m_pbrModel) {
+    if (!IsVisible()) {
+        return;
+    }
+
+    // An evicted model is not drawn until it was reloaded by Update.
+    if (m_residencyManager && !m_residencyManager->MarkRendered(m_residencyAssetId)) {
+        return;
+    }
+
+    if (!m_pbrModel) {
         return;
     }
 
     context.PbrResources.SetShadingMode(m_shadingMode);
     context.PbrResources.SetFillMode(m_fillMode);
-    context.PbrResources.SetModelToWorld(WorldTransform(), context.DeviceContext.get());
-    context.PbrResources.Bind(context.DeviceContext.get());
-    m_pbrModel->Render(context.PbrResources, context.DeviceContext.get());
+    context.PbrResources.SetModelToWorld(WorldTransform(), *context.RenderDevice);
+    m_pbrModel->Render(context.PbrResources, *context.RenderDevice);
 }
 
 void PbrModelObject::SetShadingMode(const Pbr::ShadingMode& shadingMode) {
@@ -45,9 +100,19 @@ void PbrModelObject::SetFillMode(const Pbr::FillMode& fillMode) {
 }
 
 void PbrModelObject::SetBaseColorFactor(const Pbr::RGBAColor color) {
-    for (uint32_t k = 0; k < GetModel()->GetPrimitiveCount(); k++) {
-        auto& material = GetModel()->GetPrimitive(k).GetMaterial();
-        material->Parameters().BaseColorFactor = color;
+    m_baseColorFactor = color;
+    ApplyMaterialOverrides();
+}
+
+void PbrModelObject::ApplyMaterialOverrides() {
+    // While the model is evicted, the overrides are applied once it is reloaded.
+    if (!m_pbrModel || !m_baseColorFactor) {
+        return;
+    }
+
+    for (uint32_t k = 0; k < m_pbrModel->GetPrimitiveCount(); k++) {
+        auto& material = m_pbrModel->GetPrimitive(k).GetMaterial();
+        material->Parameters().BaseColorFactor = *m_baseColorFactor;
     }
 }
 
@@ -60,6 +125,14 @@ using engine::PbrModelLoadOperation;
     }));
 }
 
+/* static */ PbrModelLoadOperation PbrModelLoadOperation::LoadAsync(std::function<std::shared_ptr<Pbr::Model>()> loadModel) {
+    return PbrModelLoadOperation(std::async(std::launch::async, std::move(loadModel)));
+}
+
+bool PbrModelLoadOperation::IsPending() const {
+    return m_loadModelTask.valid();
+}
+
 std::shared_ptr<Pbr::Model> PbrModelLoadOperation::TakeModelWhenReady() {
     if (m_loadModelTask.valid() && m_loadModelTask.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
         return m_loadModelTask.get();
@@ -4,52 +4,78 @@
 #pragma once
 
 #include <future>
+#include <functional>
+#include <optional>
 #include <pbr/PbrModel.h>
 #include <pbr/PbrMaterial.h>
+#include <pbr/PbrResidency.h>
 #include "Scene.h"
 #include "Context.h"
 
 namespace engine {
 
+    // Helper for loading models, e.g. GLB files, in the background.
+    struct PbrModelLoadOperation {
+        PbrModelLoadOperation() = default;
+        PbrModelLoadOperation(PbrModelLoadOperation&&) = default;
+        PbrModelLoadOperation& operator=(PbrModelLoadOperation&&) = default;
+
+        static PbrModelLoadOperation LoadGltfBinaryAsync(Pbr::Resources& pbrResources, std::wstring filename);
+        static PbrModelLoadOperation LoadAsync(std::function<std::shared_ptr<Pbr::Model>()> loadModel);
+
+        // Whether the model is still loading or was not taken yet.
+        bool IsPending() const;
+
+        // Take the model (can only be done once) once it has been loaded.
+        std::shared_ptr<Pbr::Model> TakeModelWhenReady();
+
+        // Dtor ensures outstanding operation is complete before returning.
+        ~PbrModelLoadOperation();
+
+    private:
+        explicit PbrModelLoadOperation(std::future<std::shared_ptr<Pbr::Model>> loadModelTask);
+
+        std::future<std::shared_ptr<Pbr::Model>> m_loadModelTask;
+    };
+
     class PbrModelObject : public Object {
     public:
         PbrModelObject(std::shared_ptr<Pbr::Model> pbrModel = nullptr,
                        Pbr::ShadingMode shadingMode = Pbr::ShadingMode::Regular,
                        Pbr::FillMode fillMode = Pbr::FillMode::Solid);
+        ~PbrModelObject() override;
+
+        // Account the model's memory against the residency budget. When the model is evicted it is released. Once the object
+        // is rendered again, the model is recreated by loadModel on a background thread and the object is not drawn until then.
+        void EnableResidencyTracking(Pbr::ResidencyManager& residencyManager,
+                                     std::function<std::shared_ptr<Pbr::Model>()> loadModel,
+                                     bool pinned = false);
+        void DisableResidencyTracking();
 
         void SetModel(std::shared_ptr<Pbr::Model> model);
         std::shared_ptr<Pbr::Model> GetModel() const;
 
         void SetShadingMode(const Pbr::ShadingMode& shadingMode);
         void SetFillMode(const Pbr::FillMode& fillMode);
+        // Overrides the base color of all materials of the model. The override is kept by the object and reapplied when the model
+        // is reloaded after being evicted, or set while the model is evicted. Setting another model clears it.
         void SetBaseColorFactor(Pbr::RGBAColor color);
 
+        void Update(engine::Context& context, const FrameTime& frameTime) override;
         void Render(Context& context) const override;
 
     private:
-        std::shared_ptr<Pbr::Model> m_pbrModel;
+        void ApplyMaterialOverrides();
+
+        std::shared_ptr<Pbr::Model> m_pbrModel; // Released when evicted by the residency manager.
         Pbr::ShadingMode m_shadingMode;
         Pbr::FillMode m_fillMode;
-    };
-
-    // Helper for loading GLB files in the background. 
-    struct PbrModelLoadOperation {
-        PbrModelLoadOperation() = default;
-        PbrModelLoadOperation(PbrModelLoadOperation&&) = default;
-        PbrModelLoadOperation& operator=(PbrModelLoadOperation&&) = default;
-
-        static PbrModelLoadOperation LoadGltfBinaryAsync(Pbr::Resources& pbrResources, std::wstring filename);
+        std::optional<Pbr::RGBAColor> m_baseColorFactor;
 
-        // Take the model (can only be done once) once it has been loaded.
-        std::shared_ptr<Pbr::Model> TakeModelWhenReady();
-
-        // Dtor ensures outstanding operation is complete before returning.
-        ~PbrModelLoadOperation();
-
-    private:
-        explicit PbrModelLoadOperation(std::future<std::shared_ptr<Pbr::Model>> loadModelTask);
-
-        std::future<std::shared_ptr<Pbr::Model>> m_loadModelTask;
+        Pbr::ResidencyManager* m_residencyManager{nullptr};
+        Pbr::ResidencyManager::AssetId m_residencyAssetId{Pbr::ResidencyManager::InvalidAssetId};
+        std::function<std::shared_ptr<Pbr::Model>()> m_loadModel;
+        PbrModelLoadOperation m_reloadOperation;
     };
 
     std::shared_ptr<PbrModelObject> CreateCube(const Pbr::Resources& pbrResources,
@@ -0,0 +1,299 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <numeric>
+#include "PickingService.h"
+
+using namespace DirectX;
+
+namespace {
+    XMVECTOR XM_CALLCONV ForwardDirection(const XrPosef& pose) {
+        return XMVector3Rotate(g_XMNegIdentityR2, xr::math::LoadXrQuaternion(pose.orientation));
+    }
+
+    // The largest scale of the transform, so that a scaled sphere stays inside the bounds.
+    float XM_CALLCONV MaxScale(FXMMATRIX transform) {
+        const XMVECTOR scales = XMVectorMax(XMVector3LengthSq(transform.r[0]),
+                                            XMVectorMax(XMVector3LengthSq(transform.r[1]), XMVector3LengthSq(transform.r[2])));
+        return std::sqrt(XMVectorGetX(scales));
+    }
+
+    // The angle between the normalized direction and the vector of the given length.
+    float XM_CALLCONV AngleTo(FXMVECTOR direction, FXMVECTOR vector, float length) {
+        const float cosAngle = XMVectorGetX(XMVector3Dot(direction, vector)) / length;
+        return std::acos(std::clamp(cosAngle, -1.0f, 1.0f));
+    }
+} // namespace
+
+engine::PickQuery engine::PickQuery::Ray(const XrPosef& pose, float maxDistance) {
+    PickQuery query;
+    query.Shape = PickShape::Ray;
+    query.Origin = pose.position;
+    xr::math::StoreXrVector3(&query.Direction, ForwardDirection(pose));
+    query.MaxDistance = maxDistance;
+    return query;
+}
+
+engine::PickQuery engine::PickQuery::Cone(const XrPosef& pose, float angleTolerance, float maxDistance) {
+    PickQuery query = Ray(pose, maxDistance);
+    query.Shape = PickShape::Cone;
+    query.AngleTolerance = angleTolerance;
+    return query;
+}
+
+engine::PickQuery engine::PickQuery::Sphere(const XrVector3f& center, float radius) {
+    PickQuery query;
+    query.Shape = PickShape::Sphere;
+    query.Origin = center;
+    query.Radius = radius;
+    return query;
+}
+
+void engine::PickingService::Add(std::shared_ptr<engine::Object> object, float boundingRadius, const XrVector3f& boundingCenter) {
+    const auto [it, added] = m_pickableIndices.emplace(object.get(), m_pickables.size());
+    if (added) {
+        m_pickables.emplace_back();
+    }
+
+    Pickable& pickable = m_pickables[it->second];
+    pickable.Object = std::move(object);
+    pickable.LocalCenter = boundingCenter;
+    pickable.LocalRadius = boundingRadius;
+    m_structureChanged = true;
+}
+
+void engine::PickingService::Remove(const engine::Object* object) {
+    const auto it = m_pickableIndices.find(object);
+    if (it == m_pickableIndices.end()) {
+        return;
+    }
+
+    const size_t index = it->second;
+    m_pickableIndices.erase(it);
+    if (index != m_pickables.size() - 1) {
+        m_pickables[index] = std::move(m_pickables.back());
+        m_pickableIndices[m_pickables[index].Object.get()] = index;
+    }
+    m_pickables.pop_back();
+    m_structureChanged = true;
+}
+
+void engine::PickingService::Clear() {
+    m_pickables.clear();
+    m_pickableIndices.clear();
+    m_structureChanged = true;
+}
+
+void engine::PickingService::Update() {
+    for (size_t i = m_pickables.size(); i-- > 0;) {
+        if (m_pickables[i].Object->State == ObjectState::RemovePending) {
+            Remove(m_pickables[i].Object.get());
+        }
+    }
+
+    // Each world transform is computed once per frame, instead of once per object per query.
+    for (Pickable& pickable : m_pickables) {
+        const XMMATRIX worldTransform = pickable.Object->WorldTransform();
+        XMStoreFloat3(&pickable.Bounds.Center, XMVector3Transform(xr::math::LoadXrVector3(pickable.LocalCenter), worldTransform));
+        pickable.Bounds.Radius = pickable.LocalRadius * MaxScale(worldTransform);
+        pickable.Enabled = pickable.Object->IsVisible();
+    }
+
+    if (m_structureChanged) {
+        Rebuild();
+        m_structureChanged = false;
+    } else {
+        Refit();
+    }
+}
+
+void engine::PickingService::Pick(const PickQuery& query, std::vector<PickHit>& hits) const {
+    hits.clear();
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    const XMVECTOR origin = xr::math::LoadXrVector3(query.Origin);
+    const XMVECTOR direction = XMVector3Normalize(xr::math::LoadXrVector3(query.Direction));
+    if (query.Shape != PickShape::Sphere && XMVector3Equal(direction, XMVectorZero())) {
+        return;
+    }
+
+    uint32_t stack[MaxStackDepth];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = m_nodes[nodeIndex];
+        if (!NodeMayHit(node, query, origin, direction)) {
+            continue;
+        }
+
+        if (node.Count == 0) {
+            stack[stackSize++] = node.RightChild;
+            stack[stackSize++] = nodeIndex + 1;
+            continue;
+        }
+
+        for (uint32_t i = node.First; i < node.First + node.Count; i++) {
+            const Pickable& pickable = m_pickables[m_order[i]];
+            PickHit hit;
+            if (pickable.Enabled && PickObject(pickable, query, origin, direction, hit)) {
+                hits.push_back(hit);
+            }
+        }
+    }
+
+    const auto closer = [&query](const PickHit& a, const PickHit& b) {
+        if (query.Shape == PickShape::Cone && a.Angle != b.Angle) {
+            return a.Angle < b.Angle;
+        }
+        return a.Distance < b.Distance;
+    };
+
+    if (hits.size() > query.MaxHits) {
+        std::partial_sort(hits.begin(), hits.begin() + query.MaxHits, hits.end(), closer);
+        hits.resize(query.MaxHits);
+    } else {
+        std::sort(hits.begin(), hits.end(), closer);
+    }
+}
+
+void engine::PickingService::Pick(const std::vector<PickQuery>& queries, std::vector<std::vector<PickHit>>& hits) const {
+    hits.resize(queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        Pick(queries[i], hits[i]);
+    }
+}
+
+bool engine::PickingService::NodeMayHit(const Node& node, const PickQuery& query, FXMVECTOR origin, FXMVECTOR direction) const {
+    switch (query.Shape) {
+    case PickShape::Ray: {
+        float distance = 0;
+        return node.Bounds.Intersects(origin, direction, distance) && distance <= query.MaxDistance;
+    }
+    case PickShape::Sphere:
+        return node.Bounds.Intersects(BoundingSphere({query.Origin.x, query.Origin.y, query.Origin.z}, query.Radius));
+    case PickShape::Cone: {
+        // Test the sphere around the box. It contains the bounds of all objects below the node, so their angular radius
+        // seen from the origin is never larger than the angular radius of the sphere.
+        const XMVECTOR toCenter = XMLoadFloat3(&node.Bounds.Center) - origin;
+        const float radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&node.Bounds.Extents)));
+        const float distance = XMVectorGetX(XMVector3Length(toCenter));
+        if (distance <= radius) {
+            return true;
+        }
+        return distance - radius <= query.MaxDistance &&
+               AngleTo(direction, toCenter, distance) <= std::asin(radius / distance) + query.AngleTolerance;
+    }
+    }
+    return false;
+}
+
+bool engine::PickingService::PickObject(
+    const Pickable& pickable, const PickQuery& query, FXMVECTOR origin, FXMVECTOR direction, PickHit& hit) const {
+    const BoundingSphere& bounds = pickable.Bounds;
+    const XMVECTOR toCenter = XMLoadFloat3(&bounds.Center) - origin;
+    const float distanceSq = XMVectorGetX(XMVector3LengthSq(toCenter));
+    const float radiusSq = bounds.Radius * bounds.Radius;
+    hit = {pickable.Object.get(), 0, 0};
+
+    switch (query.Shape) {
+    case PickShape::Ray: {
+        if (distanceSq <= radiusSq) {
+            return true; // The ray starts inside the bounds.
+        }
+        const float alongRay = XMVectorGetX(XMVector3Dot(toCenter, direction));
+        const float offAxisSq = distanceSq - alongRay * alongRay;
+        if (alongRay < 0 || offAxisSq > radiusSq) {
+            return false;
+        }
+        hit.Distance = alongRay - std::sqrt(radiusSq - offAxisSq);
+        return hit.Distance <= query.MaxDistance;
+    }
+    case PickShape::Sphere: {
+        const float distance = std::sqrt(distanceSq);
+        hit.Distance = std::max(0.0f, distance - bounds.Radius - query.Radius);
+        return distance <= bounds.Radius + query.Radius;
+    }
+    case PickShape::Cone: {
+        hit.Distance = std::sqrt(distanceSq);
+        if (hit.Distance <= bounds.Radius) {
+            return true; // The cone starts inside the bounds.
+        }
+        hit.Angle = AngleTo(direction, toCenter, hit.Distance);
+        return hit.Distance <= query.MaxDistance && hit.Angle < std::atan2(bounds.Radius, hit.Distance) + query.AngleTolerance;
+    }
+    }
+    return false;
+}
+
+void engine::PickingService::Rebuild() {
+    m_order.resize(m_pickables.size());
+    std::iota(m_order.begin(), m_order.end(), 0);
+
+    m_nodes.clear();
+    if (!m_pickables.empty()) {
+        m_nodes.reserve(2 * m_pickables.size() / MaxLeafObjects + 1);
+        BuildNode(0, static_cast<uint32_t>(m_pickables.size()));
+    }
+}
+
+uint32_t engine::PickingService::BuildNode(uint32_t first, uint32_t count) {
+    const uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    m_nodes[nodeIndex].Bounds = ComputeBounds(first, count);
+
+    if (count <= MaxLeafObjects) {
+        m_nodes[nodeIndex].First = first;
+        m_nodes[nodeIndex].Count = count;
+        return nodeIndex;
+    }
+
+    // Split at the median center along the longest axis of the node.
+    const XMFLOAT3& extents = m_nodes[nodeIndex].Bounds.Extents;
+    const int axis = extents.x >= extents.y && extents.x >= extents.z ? 0 : (extents.y >= extents.z ? 1 : 2);
+    const auto axisValue = [&](uint32_t pickableIndex) {
+        const XMFLOAT3& center = m_pickables[pickableIndex].Bounds.Center;
+        return axis == 0 ? center.x : (axis == 1 ? center.y : center.z);
+    };
+
+    const uint32_t middle = first + count / 2;
+    std::nth_element(m_order.begin() + first, m_order.begin() + middle, m_order.begin() + first + count, [&](uint32_t a, uint32_t b) {
+        return axisValue(a) < axisValue(b);
+    });
+
+    BuildNode(first, middle - first);
+    const uint32_t rightChild = BuildNode(middle, first + count - middle);
+    m_nodes[nodeIndex].RightChild = rightChild; // Not a reference since m_nodes may have been reallocated.
+    return nodeIndex;
+}
+
+void engine::PickingService::Refit() {
+    // Children are stored after their parents, so visiting the nodes backwards updates children first.
+    for (size_t i = m_nodes.size(); i-- > 0;) {
+        Node& node = m_nodes[i];
+        if (node.Count > 0) {
+            node.Bounds = ComputeBounds(node.First, node.Count);
+        } else {
+            BoundingBox::CreateMerged(node.Bounds, m_nodes[i + 1].Bounds, m_nodes[node.RightChild].Bounds);
+        }
+    }
+}
+
+BoundingBox engine::PickingService::ComputeBounds(uint32_t first, uint32_t count) const {
+    XMVECTOR minimum = g_XMFltMax;
+    XMVECTOR maximum = XMVectorNegate(g_XMFltMax);
+    for (uint32_t i = first; i < first + count; i++) {
+        const BoundingSphere& sphere = m_pickables[m_order[i]].Bounds;
+        const XMVECTOR center = XMLoadFloat3(&sphere.Center);
+        const XMVECTOR radius = XMVectorReplicate(sphere.Radius);
+        minimum = XMVectorMin(minimum, center - radius);
+        maximum = XMVectorMax(maximum, center + radius);
+    }
+
+    BoundingBox bounds;
+    BoundingBox::CreateFromPoints(bounds, minimum, maximum);
+    return bounds;
+}
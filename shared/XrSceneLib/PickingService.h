@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <limits>
+#include <unordered_map>
+#include <DirectXCollision.h>
+#include "Object.h"
+
+namespace engine {
+    enum class PickShape {
+        Ray,    // e.g. a controller or hand aim pose
+        Cone,   // e.g. eye gaze, which is not precise enough for a ray
+        Sphere, // e.g. a fingertip for poke
+    };
+
+    struct PickQuery {
+        PickShape Shape{PickShape::Ray};
+        XrVector3f Origin{0, 0, 0};     // The origin of a ray or cone, or the center of a sphere.
+        XrVector3f Direction{0, 0, -1}; // The axis of a ray or cone. Does not need to be normalized.
+        float Radius{0};                // The radius of a sphere.
+        float AngleTolerance{0};        // Widens the angular radius of objects for cones, in radians.
+        float MaxDistance{std::numeric_limits<float>::max()};
+        size_t MaxHits{std::numeric_limits<size_t>::max()};
+
+        // Queries along the forward direction (-Z) of the pose.
+        static PickQuery Ray(const XrPosef& pose, float maxDistance = std::numeric_limits<float>::max());
+        static PickQuery Cone(const XrPosef& pose, float angleTolerance = 0, float maxDistance = std::numeric_limits<float>::max());
+        static PickQuery Sphere(const XrVector3f& center, float radius);
+    };
+
+    struct PickHit {
+        engine::Object* Object;
+        float Distance; // Along the ray to the bounds for rays, to the center of the bounds for cones, or between the bounds for spheres.
+        float Angle;    // Between the cone axis and the center of the bounds, in radians. Zero for other shapes.
+    };
+
+    // Finds the objects hit by rays, cones and spheres, using a bounding volume hierarchy over the bounding spheres of the objects.
+    // Each object is added once with a bounding sphere in its local space. Update() caches the world bounds of all objects once per
+    // frame, and refits the hierarchy, or rebuilds it after objects were added or removed, before querying.
+    // Hits are sorted by distance, or by angle for cones. Hidden objects are ignored, and removed objects are dropped by Update().
+    class PickingService {
+    public:
+        void Add(std::shared_ptr<engine::Object> object, float boundingRadius, const XrVector3f& boundingCenter = {0, 0, 0});
+        void Remove(const engine::Object* object);
+        void Clear();
+
+        void Update();
+
+        void Pick(const PickQuery& query, std::vector<PickHit>& hits) const;
+
+        // Answer each query into the hits of the same index.
+        void Pick(const std::vector<PickQuery>& queries, std::vector<std::vector<PickHit>>& hits) const;
+
+        size_t ObjectCount() const noexcept {
+            return m_pickables.size();
+        }
+
+    private:
+        static constexpr uint32_t MaxLeafObjects = 4;
+        static constexpr uint32_t MaxStackDepth = 64; // Median splits keep the depth at log2 of the object count.
+
+        struct Pickable {
+            std::shared_ptr<engine::Object> Object;
+            XrVector3f LocalCenter;
+            float LocalRadius;
+            DirectX::BoundingSphere Bounds; // In world space, as of the last update.
+            bool Enabled{false};
+        };
+
+        // Nodes are stored depth-first, so the left child of an inner node immediately follows it.
+        struct Node {
+            DirectX::BoundingBox Bounds;
+            uint32_t First{0};
+            uint32_t Count{0}; // Zero for inner nodes.
+            uint32_t RightChild{0};
+        };
+
+        void Rebuild();
+        void Refit();
+        uint32_t BuildNode(uint32_t first, uint32_t count);
+        DirectX::BoundingBox ComputeBounds(uint32_t first, uint32_t count) const;
+        bool NodeMayHit(const Node& node, const PickQuery& query, DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction) const;
+        bool PickObject(const Pickable& pickable,
+                        const PickQuery& query,
+                        DirectX::FXMVECTOR origin,
+                        DirectX::FXMVECTOR direction,
+                        PickHit& hit) const;
+
+        std::vector<Pickable> m_pickables;
+        std::unordered_map<const engine::Object*, size_t> m_pickableIndices;
+        std::vector<uint32_t> m_order; // Pickables ordered by leaf node.
+        std::vector<Node> m_nodes;
+        bool m_structureChanged{false};
+    };
+} // namespace engine
@@ -36,6 +36,8 @@ engine::ProjectionLayer::ProjectionLayer(const sample::SessionContext& sessionCo
 
 void engine::ProjectionLayer::DestroySwapchains() {
     for (auto& viewConfigComponent : m_viewConfigComponents) {
+        viewConfigComponent.second.ColorViews.Clear();
+        viewConfigComponent.second.DepthViews.Clear();
         viewConfigComponent.second.ColorSwapchain = {};
         viewConfigComponent.second.DepthSwapchain = {};
     }
@@ -98,9 +100,34 @@ void engine::ProjectionLayer::PrepareRendering(const Context& context,
                                               ? viewConfigViews[xr::StereoView::Left].recommendedSwapchainSampleCount
                                               : layerCurrentConfig.SwapchainSampleCount;
 
+    const std::optional<FoveationConfig>& foveation = layerCurrentConfig.Foveation;
+    const size_t insetViewCount = foveation ? viewConfigViews.size() : 0;
     viewConfigComponent.Viewports.resize(viewConfigViews.size());
+    viewConfigComponent.InsetViewports.resize(insetViewCount);
+    viewConfigComponent.InsetProjectionViews.resize(insetViewCount);
+    viewConfigComponent.InsetDepthInfo.resize(insetViewCount);
+
+    const auto viewportFromRect = [](const XrRect2Di& rect) {
+        return CD3D11_VIEWPORT(static_cast<float>(rect.offset.x),
+                               static_cast<float>(rect.offset.y),
+                               static_cast<float>(rect.extent.width),
+                               static_cast<float>(rect.extent.height));
+    };
 
     for (uint32_t viewIndex = 0; viewIndex < (uint32_t)viewConfigViews.size(); viewIndex++) {
+        const int32_t doubleWideOffsetX = static_cast<int32_t>(swapchainImageWidth * viewIndex);
+        if (foveation) {
+            // The periphery and the inset are rendered side by side within the image rect of the view.
+            const XrRect2Di viewImageRect{{layerCurrentConfig.DoubleWideMode ? doubleWideOffsetX : 0, 0},
+                                          {static_cast<int32_t>(swapchainImageWidth), static_cast<int32_t>(swapchainImageHeight)}};
+            const FoveatedImageRects rects = ComputeFoveatedImageRects(viewImageRect, *foveation, layerCurrentConfig.ViewportSizeScale);
+            viewConfigComponent.LayerDepthImageRect[viewIndex] = viewConfigComponent.LayerColorImageRect[viewIndex] = rects.Periphery;
+            viewConfigComponent.InsetImageRect[viewIndex] = rects.Inset;
+            viewConfigComponent.Viewports[viewIndex] = viewportFromRect(rects.Periphery);
+            viewConfigComponent.InsetViewports[viewIndex] = viewportFromRect(rects.Inset);
+            continue;
+        }
+
         viewConfigComponent.Viewports[viewIndex] = CD3D11_VIEWPORT(
             layerCurrentConfig.DoubleWideMode ? static_cast<float>(swapchainImageWidth * viewIndex + layerCurrentConfig.ViewportOffset.x)
                                               : static_cast<float>(layerCurrentConfig.ViewportOffset.x),
@@ -108,12 +135,13 @@ void engine::ProjectionLayer::PrepareRendering(const Context& context,
             static_cast<float>(swapchainImageWidth * layerCurrentConfig.ViewportSizeScale.width),
             static_cast<float>(swapchainImageHeight * layerCurrentConfig.ViewportSizeScale.height));
 
-        const int32_t doubleWideOffsetX = static_cast<int32_t>(swapchainImageWidth * viewIndex);
-        viewConfigComponent.LayerDepthImageRect[viewIndex] =
-            viewConfigComponent.LayerColorImageRect[viewIndex] = {layerCurrentConfig.DoubleWideMode ? doubleWideOffsetX : 0,
-                                                                  0,
-                                                                  static_cast<int32_t>(std::ceil(swapchainImageWidth)),
-                                                                  static_cast<int32_t>(std::ceil(swapchainImageHeight))};
+        // Submit only the part of the image that the viewport renders to, so that a smaller ViewportSizeScale lowers the
+        // rendered resolution instead of shrinking the content within the view.
+        viewConfigComponent.LayerDepthImageRect[viewIndex] = viewConfigComponent.LayerColorImageRect[viewIndex] = {
+            layerCurrentConfig.DoubleWideMode ? doubleWideOffsetX : 0,
+            0,
+            static_cast<int32_t>(std::ceil(swapchainImageWidth * std::min(layerCurrentConfig.ViewportSizeScale.width, 1.0f))),
+            static_cast<int32_t>(std::ceil(swapchainImageHeight * std::min(layerCurrentConfig.ViewportSizeScale.height, 1.0f)))};
     }
 
     if (!shouldResetSwapchain) {
@@ -126,6 +154,10 @@ void engine::ProjectionLayer::PrepareRendering(const Context& context,
     const std::optional<XrViewConfigurationType> viewConfigurationForSwapchain =
         context.Extensions.XR_MSFT_secondary_view_configuration_enabled ? std::optional{viewConfigType} : std::nullopt;
 
+    // Release the views of the previous swapchains before their images, as DestroySwapchains does.
+    viewConfigComponent.ColorViews.Clear();
+    viewConfigComponent.DepthViews.Clear();
+
     // Create color swapchain with recommended properties.
     viewConfigComponent.ColorSwapchain =
         sample::dx::CreateSwapchainD3D11(context.Session.Handle,
@@ -150,6 +182,47 @@ void engine::ProjectionLayer::PrepareRendering(const Context& context,
                                          XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
                                          viewConfigurationForSwapchain);
 
+    // Create the render target and depth stencil views of all images up front, since the images are fixed for the lifetime
+    // of the swapchains.
+    const bool multisampled = swapchainSampleCount > 1;
+    std::vector<xr::SwapchainImageViewKey> colorViewKeys, depthViewKeys;
+    for (uint32_t arraySlice = 0; arraySlice < arrayLength; arraySlice++) {
+        colorViewKeys.push_back({arraySlice, layerCurrentConfig.ColorSwapchainFormat});
+        depthViewKeys.push_back({arraySlice, layerCurrentConfig.DepthSwapchainFormat});
+    }
+
+    viewConfigComponent.ColorViews.Reset(
+        (uint32_t)viewConfigComponent.ColorSwapchain.Images.size(),
+        [device = context.Device, images = viewConfigComponent.ColorSwapchain.Images, multisampled](
+            uint32_t imageIndex, const xr::SwapchainImageViewKey& key) {
+            winrt::com_ptr<ID3D11RenderTargetView> renderTargetView;
+            const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(
+                multisampled ? D3D11_RTV_DIMENSION_TEXTURE2DMSARRAY : D3D11_RTV_DIMENSION_TEXTURE2DARRAY,
+                static_cast<DXGI_FORMAT>(key.Format),
+                0 /* mipSlice */,
+                key.ArraySlice,
+                1 /* arraySize */);
+            CHECK_HRCMD(device->CreateRenderTargetView(images.at(imageIndex).texture, &renderTargetViewDesc, renderTargetView.put()));
+            return renderTargetView;
+        },
+        colorViewKeys);
+
+    viewConfigComponent.DepthViews.Reset(
+        (uint32_t)viewConfigComponent.DepthSwapchain.Images.size(),
+        [device = context.Device, images = viewConfigComponent.DepthSwapchain.Images, multisampled](
+            uint32_t imageIndex, const xr::SwapchainImageViewKey& key) {
+            winrt::com_ptr<ID3D11DepthStencilView> depthStencilView;
+            const CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(
+                multisampled ? D3D11_DSV_DIMENSION_TEXTURE2DMSARRAY : D3D11_DSV_DIMENSION_TEXTURE2DARRAY,
+                static_cast<DXGI_FORMAT>(key.Format),
+                0 /* mipSlice */,
+                key.ArraySlice,
+                1 /* arraySize */);
+            CHECK_HRCMD(device->CreateDepthStencilView(images.at(imageIndex).texture, &depthStencilViewDesc, depthStencilView.put()));
+            return depthStencilView;
+        },
+        depthViewKeys);
+
     {
         CD3D11_DEPTH_STENCIL_DESC depthStencilDesc(CD3D11_DEFAULT{});
         depthStencilDesc.StencilEnable = false;
@@ -194,6 +267,17 @@ bool engine::ProjectionLayer::Render(Context& context,
         // Swapchain image timeout, don't submit this multi projection layer
         submitProjectionLayer = false;
     } else {
+        // Foveated layers move their inset with the gaze while it can be located, otherwise it stays at the center of the views.
+        const bool foveated = !viewConfigComponent.InsetViewports.empty();
+        std::optional<XrPosef> gazePose;
+        if (foveated && currentConfig.Foveation->GazeSpace != XR_NULL_HANDLE) {
+            XrSpaceLocation gazeLocation{XR_TYPE_SPACE_LOCATION};
+            CHECK_XRCMD(xrLocateSpace(currentConfig.Foveation->GazeSpace, layerSpace, frameTime.PredictedDisplayTime, &gazeLocation));
+            if (xr::math::Pose::IsPoseValid(gazeLocation)) {
+                gazePose = gazeLocation.pose;
+            }
+        }
+
         const uint32_t viewCount = (uint32_t)views.size();
         for (uint32_t viewIndex = 0; viewIndex < viewCount; viewIndex++) {
             const XrView& projection = views[viewIndex];
@@ -232,44 +316,55 @@ bool engine::ProjectionLayer::Render(Context& context,
                 projectionViews[viewIndex].next = nullptr;
             }
 
+            XrFovf insetFov{};
+            D3D11_VIEWPORT insetViewport{};
+            if (foveated) {
+                std::optional<XrVector3f> gazeDirectionInView;
+                if (gazePose) {
+                    const XMVECTOR gazeForward = XMVector3Rotate(g_XMNegIdentityR2, xr::math::LoadXrQuaternion(gazePose->orientation));
+                    xr::math::StoreXrVector3(&gazeDirectionInView.emplace(),
+                                             XMVector3InverseRotate(gazeForward, xr::math::LoadXrQuaternion(viewPose.orientation)));
+                }
+                insetFov = ComputeFoveatedInsetFov(fov, currentConfig.Foveation->InsetFovFraction, gazeDirectionInView);
+
+                XrCompositionLayerProjectionView& insetView = viewConfigComponent.InsetProjectionViews[viewIndex];
+                insetView = projectionViews[viewIndex];
+                insetView.fov = insetFov;
+                insetView.subImage.imageRect = viewConfigComponent.InsetImageRect[viewIndex];
+
+                insetViewport = viewConfigComponent.InsetViewports[viewIndex];
+                insetViewport.MinDepth = viewport.MinDepth;
+                insetViewport.MaxDepth = viewport.MaxDepth;
+                if (insetView.next) {
+                    XrCompositionLayerDepthInfoKHR& insetDepthInfo = viewConfigComponent.InsetDepthInfo[viewIndex];
+                    insetDepthInfo = depthInfo[viewIndex];
+                    insetDepthInfo.subImage.imageRect = viewConfigComponent.InsetImageRect[viewIndex];
+                    insetView.next = &insetDepthInfo;
+                }
+            }
+
             // Render for this view pose.
             {
-                // Set the Viewport.
-                context.DeviceContext->RSSetViewports(1, &viewport);
-
                 const uint32_t firstArraySliceForColor = projectionViews[viewIndex].subImage.imageArrayIndex;
 
-                // Create a render target view into the appropriate slice of the color texture from this swapchain image.
-                // This is a lightweight operation which can be done for each viewport projection.
-                winrt::com_ptr<ID3D11RenderTargetView> renderTargetView;
-                const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(
-                    currentConfig.SwapchainSampleCount > 1 ? D3D11_RTV_DIMENSION_TEXTURE2DMSARRAY : D3D11_RTV_DIMENSION_TEXTURE2DARRAY,
-                    currentConfig.ColorSwapchainFormat,
-                    0 /* mipSlice */,
-                    firstArraySliceForColor,
-                    1 /* arraySize */);
-                CHECK_HRCMD(context.Device->CreateRenderTargetView(
-                    colorSwapchain.Images[colorSwapchainImageIndex].texture, &renderTargetViewDesc, renderTargetView.put()));
+                // Look up the render target view into the appropriate slice of the color texture from this swapchain image.
+                // The views of all images are created with the swapchain, rather than for each viewport projection.
+                const xr::SwapchainImageViewKey colorViewKey{firstArraySliceForColor, currentConfig.ColorSwapchainFormat};
+                ID3D11RenderTargetView* const renderTargetView =
+                    viewConfigComponent.ColorViews.Get(colorSwapchainImageIndex, colorViewKey).get();
 
                 const uint32_t firstArraySliceForDepth = depthImageArrayIndex;
 
-                // Create a depth stencil view into the slice of the depth stencil texture array for this swapchain image.
-                // This is a lightweight operation which can be done for each viewport projection.
-                winrt::com_ptr<ID3D11DepthStencilView> depthStencilView;
-                CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(
-                    currentConfig.SwapchainSampleCount > 1 ? D3D11_DSV_DIMENSION_TEXTURE2DMSARRAY : D3D11_DSV_DIMENSION_TEXTURE2DARRAY,
-                    currentConfig.DepthSwapchainFormat,
-                    0 /* mipSlice */,
-                    firstArraySliceForDepth,
-                    1 /* arraySize */);
-                CHECK_HRCMD(context.Device->CreateDepthStencilView(
-                    depthSwapchain.Images[depthSwapchainImageIndex].texture, &depthStencilViewDesc, depthStencilView.put()));
+                // Look up the depth stencil view into the slice of the depth stencil texture array for this swapchain image.
+                const xr::SwapchainImageViewKey depthViewKey{firstArraySliceForDepth, currentConfig.DepthSwapchainFormat};
+                ID3D11DepthStencilView* const depthStencilView =
+                    viewConfigComponent.DepthViews.Get(depthSwapchainImageIndex, depthViewKey).get();
 
                 const bool reversedZ = (currentConfig.NearFar.Near > currentConfig.NearFar.Far);
 
                 // Clear and render to the render target.
-                ID3D11RenderTargetView* const renderTargets[] = {renderTargetView.get()};
-                context.DeviceContext->OMSetRenderTargets(1, renderTargets, depthStencilView.get());
+                ID3D11RenderTargetView* const renderTargets[] = {renderTargetView};
+                context.DeviceContext->OMSetRenderTargets(1, renderTargets, depthStencilView);
 
                 // In double wide mode, the first projection clears the whole RTV and DSV.
                 if ((viewIndex == 0) || !currentConfig.DoubleWideMode) {
@@ -277,32 +372,44 @@ bool engine::ProjectionLayer::Render(Context& context,
 
                     const float clearDepthValue = reversedZ ? 0.f : 1.f;
                     context.DeviceContext->ClearDepthStencilView(
-                        depthStencilView.get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, clearDepthValue, 0);
+                        depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, clearDepthValue, 0);
                 }
 
-                const DirectX::XMMATRIX projectionMatrix = xr::math::ComposeProjectionMatrix(fov, currentConfig.NearFar);
-
                 if (reversedZ) {
                     context.DeviceContext->OMSetDepthStencilState(m_reversedZDepthNoStencilTest.get(), 0);
                 } else {
                     context.DeviceContext->OMSetDepthStencilState(nullptr, 0);
                 }
 
+                // The context was used outside of the PBR resources since the last view was rendered.
+                context.PbrResources.InvalidateBoundState();
+
                 // Set state for any objects which use PBR rendering.
                 // PBR library expects traditional view transform (world to view).
                 DirectX::XMMATRIX worldToViewMatrix = xr::math::LoadInvertedXrPose(projectionViews[viewIndex].pose);
 
-
-                context.PbrResources.SetViewProjection(worldToViewMatrix, projectionMatrix);
-                context.PbrResources.Bind(context.DeviceContext.get());
-                context.PbrResources.SetDepthFuncReversed(reversedZ);
-
-                // Render all active scenes.
-                for (const std::unique_ptr<Scene>& scene : activeScenes) {
-                    if (scene->IsActive() && !std::empty(scene->GetObjects())) {
-                        submitProjectionLayer = true;
-                        scene->Render(frameTime, viewIndex);
+                // Foveated layers render the whole fov into the periphery viewport, then the inset fov into the inset viewport. The PBR
+                // resources are bound once per viewport for all objects, which only set their model to world transform.
+                const auto renderViewport = [&](const D3D11_VIEWPORT& regionViewport, const XrFovf& regionFov) {
+                    context.DeviceContext->RSSetViewports(1, &regionViewport);
+
+                    const DirectX::XMMATRIX projectionMatrix = xr::math::ComposeProjectionMatrix(regionFov, currentConfig.NearFar);
+                    context.PbrResources.SetViewProjection(worldToViewMatrix, projectionMatrix);
+                    context.PbrResources.Bind(*context.RenderDevice);
+                    context.PbrResources.SetDepthFuncReversed(reversedZ);
+
+                    // Render all active scenes.
+                    for (const std::unique_ptr<Scene>& scene : activeScenes) {
+                        if (scene->IsActive() && !std::empty(scene->GetObjects())) {
+                            submitProjectionLayer = true;
+                            scene->Render(frameTime, viewIndex);
+                        }
                     }
+                };
+
+                renderViewport(viewport, fov);
+                if (foveated) {
+                    renderViewport(insetViewport, insetFov);
                 }
             }
         }
@@ -333,5 +440,13 @@ void engine::AppendProjectionLayer(CompositionLayers& layers, ProjectionLayer* l
         xr::InsertExtensionStruct(projectionLayer, reprojPlaneOverride.value());
     }
 
+    // The inset of a foveated layer is composed on top of the periphery. The reprojection structs are already chained into the
+    // periphery layer, so the runtime reprojects the inset with its default mode.
+    if (const auto& insetViews = layer->InsetProjectionViews(viewConfig); !insetViews.empty()) {
+        XrCompositionLayerProjection& insetLayer = layers.AddProjectionLayer(layer->Config(viewConfig).LayerFlags);
+        insetLayer.space = layer->LayerSpace(viewConfig);
+        insetLayer.viewCount = (uint32_t)insetViews.size();
+        insetLayer.views = insetViews.data();
+    }
 }
 
@@ -7,9 +7,11 @@
 #include <XrUtility/XrStereoView.h>
 #include <XrUtility/XrHandle.h>
 #include <XrUtility/XrMath.h>
+#include <XrUtility/XrSwapchainViewCache.h>
 #include <SampleShared/DxUtility.h>
 #include "Context.h"
 #include "FrameTime.h"
+#include "Foveation.h"
 
 namespace engine {
 
@@ -30,6 +32,7 @@ namespace engine {
         DirectX::XMFLOAT4 ClearColor = {0, 0, 0, 0}; // Transparent
         std::optional<XrCompositionLayerReprojectionInfoMSFT> ReprojectionConfig;
         std::optional<XrCompositionLayerReprojectionPlaneOverrideMSFT> ReprojectionPlaneOverride;
+        std::optional<FoveationConfig> Foveation; // When set, ViewportSizeScale only scales the periphery and ViewportOffset is ignored
     };
 
     struct Scene;
@@ -53,6 +56,12 @@ namespace engine {
             return m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).ProjectionViews;
         }
 
+        // The views of the inset layer that is submitted on top of the projection views of a foveated layer, otherwise empty.
+        const std::vector<XrCompositionLayerProjectionView>&
+        InsetProjectionViews(std::optional<XrViewConfigurationType> viewConfig = std::nullopt) const {
+            return m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).InsetProjectionViews;
+        }
+
         const XrSpace LayerSpace(std::optional<XrViewConfigurationType> viewConfig = std::nullopt) const {
             return m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).LayerSpace;
         }
@@ -83,8 +92,18 @@ namespace engine {
             XrRect2Di LayerColorImageRect[xr::StereoView::Count];
             XrRect2Di LayerDepthImageRect[xr::StereoView::Count];
 
+            // Only used by foveated layers, and empty otherwise.
+            std::vector<XrCompositionLayerProjectionView> InsetProjectionViews;
+            std::vector<XrCompositionLayerDepthInfoKHR> InsetDepthInfo;
+            std::vector<D3D11_VIEWPORT> InsetViewports;
+            XrRect2Di InsetImageRect[xr::StereoView::Count];
+
             sample::dx::SwapchainD3D11 ColorSwapchain;
             sample::dx::SwapchainD3D11 DepthSwapchain;
+
+            // Declared after the swapchains, so that the views are released before the swapchain images.
+            xr::SwapchainImageViewCache<winrt::com_ptr<ID3D11RenderTargetView>> ColorViews;
+            xr::SwapchainImageViewCache<winrt::com_ptr<ID3D11DepthStencilView>> DepthViews;
         };
         std::unordered_map<XrViewConfigurationType, ViewConfigComponent> m_viewConfigComponents;
         XrViewConfigurationType m_defaultViewConfigurationType;
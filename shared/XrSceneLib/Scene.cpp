@@ -8,27 +8,39 @@ using namespace DirectX;
 
 namespace {
     template <typename T>
-    void AddPendingObjects(std::vector<std::shared_ptr<T>>* objects, std::vector<std::shared_ptr<T>>&& uninitializedObjects) {
+    void AddPendingObjects(std::vector<std::shared_ptr<T>>* objects,
+                           std::vector<std::shared_ptr<T>>&& uninitializedObjects,
+                           engine::MotionSystem& motionSystem) {
         for (auto& object : uninitializedObjects) {
             if (object->State == engine::ObjectState::InitializePending) {
                 object->State = engine::ObjectState::Initialized;
+                motionSystem.Add(*object);
                 objects->push_back(std::move(object));
             }
         }
     }
 
     template <typename T>
-    void RemoveDestroyedObjects(std::vector<std::shared_ptr<T>>* objects) {
-        auto newEnd = std::remove_if(
-            objects->begin(), objects->end(), [](auto&& object) { return object->State == engine::ObjectState::RemovePending; });
+    void RemoveDestroyedObjects(std::vector<std::shared_ptr<T>>* objects, engine::MotionSystem& motionSystem) {
+        auto newEnd = std::remove_if(objects->begin(), objects->end(), [&](auto&& object) {
+            if (object->State != engine::ObjectState::RemovePending) {
+                return false;
+            }
+            motionSystem.Remove(*object);
+            return true;
+        });
 
         objects->erase(newEnd, objects->end());
     }
 
     template <typename T>
-    void UpdateObjects(std::vector<std::shared_ptr<T>> const& objects, engine::Context& context, engine::FrameTime const& frameTime) {
-        for (const auto& object : objects) {
-            object->Update(context, frameTime);
+    void UpdateObjects(std::vector<std::shared_ptr<T>> const& objects,
+                       size_t first,
+                       size_t last,
+                       engine::Context& context,
+                       engine::FrameTime const& frameTime) {
+        for (size_t i = first; i < last; i++) {
+            objects[i]->Update(context, frameTime);
         }
     }
 
@@ -40,31 +52,94 @@ namespace {
             }
         }
     }
+    thread_local engine::SceneChangeList* t_recordedChanges = nullptr;
 } // namespace
 
+engine::SceneChangeList::RecordScope::RecordScope(SceneChangeList& changes)
+    : m_previous(t_recordedChanges) {
+    t_recordedChanges = &changes;
+}
+
+engine::SceneChangeList::RecordScope::~RecordScope() {
+    t_recordedChanges = m_previous;
+}
+
+void engine::SceneChangeList::Append(SceneChangeList&& other) {
+    m_changes.insert(m_changes.end(), std::make_move_iterator(other.m_changes.begin()), std::make_move_iterator(other.m_changes.end()));
+    other.m_changes.clear();
+}
+
+void engine::SceneChangeList::Apply() {
+    assert(t_recordedChanges == nullptr);
+    for (Change& change : m_changes) {
+        switch (change.Type) {
+        case ChangeType::AddObject:
+            change.Scene->AddObject(change.Object);
+            break;
+        case ChangeType::AddQuadLayerObject:
+            change.Scene->AddQuadLayerObject(std::static_pointer_cast<QuadLayerObject>(change.Object));
+            break;
+        case ChangeType::RemoveObject:
+            change.Scene->RemoveObject(change.Object);
+            break;
+        case ChangeType::ReparentObject:
+            change.Scene->ReparentObject(change.Object, std::move(change.Parent));
+            break;
+        }
+    }
+    m_changes.clear();
+}
+
 engine::Scene::Scene(engine::Context& context)
     : m_context(context)
-    , m_actionContext(context.Instance.Handle) {
+    , m_actionContext(context.Instance.Handle, context.Instance.Paths) {
 }
 
 void engine::Scene::Update(const engine::FrameTime& frameTime) {
+    BeginUpdate();
+    UpdateObjects(frameTime, 0, UpdatedObjectCount());
+    EndUpdate(frameTime);
+}
+
+void engine::Scene::BeginUpdate() {
     std::unique_lock lk(m_uninitializedMutex);
     std::vector uninitializedObjects = std::move(m_uninitializedObjects);
     std::vector uninitializedQuadLayerObjects = std::move(m_uninitializedQuadLayerObjects);
     lk.unlock();
 
-    AddPendingObjects(&m_objects, std::move(uninitializedObjects));
-    AddPendingObjects(&m_quadLayerObjects, std::move(uninitializedQuadLayerObjects));
+    AddPendingObjects(&m_objects, std::move(uninitializedObjects), m_motionSystem);
+    AddPendingObjects(&m_quadLayerObjects, std::move(uninitializedQuadLayerObjects), m_motionSystem);
+
+    RemoveDestroyedObjects(&m_objects, m_motionSystem);
+    RemoveDestroyedObjects(&m_quadLayerObjects, m_motionSystem);
+}
 
-    RemoveDestroyedObjects(&m_objects);
-    RemoveDestroyedObjects(&m_quadLayerObjects);
+size_t engine::Scene::UpdatedObjectCount() const {
+    return m_objects.size() + m_quadLayerObjects.size();
+}
 
-    UpdateObjects(m_objects, m_context, frameTime);
-    UpdateObjects(m_quadLayerObjects, m_context, frameTime);
+void engine::Scene::UpdateObjects(const FrameTime& frameTime, size_t first, size_t last) {
+    const size_t objectCount = m_objects.size();
+    ::UpdateObjects(m_objects, std::min(first, objectCount), std::min(last, objectCount), m_context, frameTime);
+    ::UpdateObjects(
+        m_quadLayerObjects, std::max(first, objectCount) - objectCount, std::max(last, objectCount) - objectCount, m_context, frameTime);
+}
+
+void engine::Scene::EndUpdate(const FrameTime& frameTime) {
+    m_motionSystem.Update(frameTime.Elapsed);
 
     OnUpdate(frameTime);
 }
 
+bool engine::Scene::DeferChange(SceneChangeList::ChangeType type, std::shared_ptr<Object> object, std::shared_ptr<Object> parent) {
+    if (t_recordedChanges == nullptr) {
+        return false;
+    }
+
+    t_recordedChanges->m_changes.push_back({type, this, std::move(object), std::move(parent)});
+    return true;
+}
+
 void engine::Scene::BeforeRender(const FrameTime& frameTime) {
     OnBeforeRender(frameTime);
 }
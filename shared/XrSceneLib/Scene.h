@@ -12,6 +12,47 @@
 #include "QuadLayerObject.h"
 
 namespace engine {
+    struct Scene;
+    class SceneUpdateScheduler;
+
+    // Structural changes to scenes that are made while the scenes update, i.e. adding, removing and reparenting objects.
+    // They are recorded per update job and applied after all scenes are updated, in the order of the scenes and of the object
+    // ranges within them, so that concurrent updates see stable object lists and the result does not depend on thread timing.
+    class SceneChangeList {
+    public:
+        // Record the changes made on the current thread into the list, instead of applying them, until destroyed.
+        class RecordScope {
+        public:
+            explicit RecordScope(SceneChangeList& changes);
+            ~RecordScope();
+
+            RecordScope(const RecordScope&) = delete;
+            RecordScope& operator=(const RecordScope&) = delete;
+
+        private:
+            SceneChangeList* m_previous;
+        };
+
+        void Append(SceneChangeList&& other);
+        void Apply();
+
+        bool empty() const noexcept {
+            return m_changes.empty();
+        }
+
+    private:
+        friend struct Scene;
+
+        enum class ChangeType { AddObject, AddQuadLayerObject, RemoveObject, ReparentObject };
+        struct Change {
+            ChangeType Type;
+            engine::Scene* Scene;
+            std::shared_ptr<engine::Object> Object;
+            std::shared_ptr<engine::Object> Parent;
+        };
+
+        std::vector<Change> m_changes;
+    };
 
     struct Scene {
         virtual ~Scene() = default;
@@ -21,6 +62,7 @@ namespace engine {
         Scene(Scene&&) = delete;
         Scene(const Scene&) = delete;
 
+        // Updates the scene on the calling thread. XrApp updates all scenes through engine::SceneUpdateScheduler instead.
         void Update(const FrameTime& frameTime);
         void BeforeRender(const FrameTime& frameTime);
         void Render(const FrameTime& frameTime, uint32_t viewIndex);
@@ -39,6 +81,25 @@ namespace engine {
             SetActive(!IsActive());
         }
 
+        // Scenes update on the update thread in the order they were added by default, because OnUpdate may use the immediate
+        // device context or state shared with other scenes. A scene whose update only touches its own objects and thread-safe
+        // functions can update concurrently with other scenes instead, once the scenes it depends on are updated. The objects
+        // of a concurrent scene are also updated in parallel ranges.
+        void SetConcurrentUpdate(bool concurrent) {
+            m_concurrentUpdate = concurrent;
+        }
+        bool IsConcurrentUpdate() const {
+            return m_concurrentUpdate;
+        }
+
+        // Update this scene after the given scene when both are active.
+        void AddUpdateDependency(const Scene& scene) {
+            m_updateDependencies.push_back(&scene);
+        }
+        const std::vector<const Scene*>& UpdateDependencies() const {
+            return m_updateDependencies;
+        }
+
         void NotifyEvent(const XrEventDataBuffer& eventData) {
             OnEvent(eventData);
         }
@@ -47,18 +108,27 @@ namespace engine {
         template <typename T>
         std::shared_ptr<T> AddObject(const std::shared_ptr<T>& object) {
             object->State = ObjectState::InitializePending;
-            std::lock_guard guard(m_uninitializedMutex);
-            m_uninitializedObjects.push_back(object);
+            if (!DeferChange(SceneChangeList::ChangeType::AddObject, object)) {
+                std::lock_guard guard(m_uninitializedMutex);
+                m_uninitializedObjects.push_back(object);
+            }
             return object;
         }
 
         template <typename T>
         void RemoveObject(const std::shared_ptr<T>& object) {
-            if (object) {
+            if (object && !DeferChange(SceneChangeList::ChangeType::RemoveObject, object)) {
                 object->State = ObjectState::RemovePending;
             }
         }
 
+        // Unlike Object::SetParent, the parent is only changed once all scenes are updated when called during an update.
+        void ReparentObject(const std::shared_ptr<Object>& object, std::shared_ptr<Object> parent) {
+            if (object && !DeferChange(SceneChangeList::ChangeType::ReparentObject, object, parent)) {
+                object->SetParent(std::move(parent));
+            }
+        }
+
         const std::vector<std::shared_ptr<Object>>& GetObjects() const {
             return m_objects;
         }
@@ -68,8 +138,10 @@ namespace engine {
 #pragma region Quad layer objects will be rendered into quad layers, and will not affect projection layers
         std::shared_ptr<QuadLayerObject> AddQuadLayerObject(const std::shared_ptr<QuadLayerObject>& object) {
             object->State = ObjectState::InitializePending;
-            std::lock_guard guard(m_uninitializedMutex);
-            m_uninitializedQuadLayerObjects.push_back(object);
+            if (!DeferChange(SceneChangeList::ChangeType::AddQuadLayerObject, object)) {
+                std::lock_guard guard(m_uninitializedMutex);
+                m_uninitializedQuadLayerObjects.push_back(object);
+            }
             return object;
         }
 
@@ -82,6 +154,11 @@ namespace engine {
             return m_actionContext;
         }
 
+        // Integrates the motion of the objects of the scene after they are updated.
+        engine::MotionSystem& MotionSystem() {
+            return m_motionSystem;
+        }
+
     protected:
         engine::Context& m_context;
 
@@ -95,9 +172,23 @@ namespace engine {
         }
 
     private:
+        friend class SceneUpdateScheduler;
+
+        // The phases of Update. The objects of the scene are indexed after the projection layer objects.
+        void BeginUpdate();
+        size_t UpdatedObjectCount() const;
+        void UpdateObjects(const FrameTime& frameTime, size_t first, size_t last);
+        void EndUpdate(const FrameTime& frameTime);
+
+        // Records the change if the current thread is updating scenes, otherwise returns false.
+        bool DeferChange(SceneChangeList::ChangeType type, std::shared_ptr<Object> object, std::shared_ptr<Object> parent = nullptr);
+
         sample::ActionContext m_actionContext;
+        engine::MotionSystem m_motionSystem;
 
         std::atomic<bool> m_isActive{true};
+        bool m_concurrentUpdate{false};
+        std::vector<const Scene*> m_updateDependencies;
 
         std::vector<std::shared_ptr<Object>> m_objects;
         std::vector<std::shared_ptr<QuadLayerObject>> m_quadLayerObjects;
@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <queue>
+#include <unordered_map>
+#include <SampleShared/InputCapture.h>
+#include "SceneUpdateScheduler.h"
+
+engine::SceneUpdateScheduler::SceneUpdateScheduler(uint32_t threadCount)
+    : m_threadCount(threadCount) {
+    if (threadCount > 0) {
+        m_threadPool = sample::ThreadPool(threadCount);
+    }
+}
+
+void engine::SceneUpdateScheduler::Update(const std::vector<std::unique_ptr<Scene>>& scenes, const FrameTime& frameTime) {
+    BuildJobs(scenes);
+    m_frameTime = &frameTime;
+
+    if (!m_threadPool) {
+        for (size_t jobIndex : m_order) {
+            RunJob(jobIndex);
+        }
+    } else {
+        {
+            std::scoped_lock lock(m_mutex);
+            for (size_t jobIndex = 0; jobIndex < m_jobs.size(); jobIndex++) {
+                if (m_jobs[jobIndex].Concurrent && m_jobs[jobIndex].PendingDependencies == 0) {
+                    SubmitJob(jobIndex);
+                }
+            }
+        }
+
+        for (size_t jobIndex = 0; jobIndex < m_jobs.size(); jobIndex++) {
+            if (!m_jobs[jobIndex].Concurrent) {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_jobCompleted.wait(lock, [&] { return m_jobs[jobIndex].PendingDependencies == 0; });
+                }
+                RunJob(jobIndex);
+            }
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_jobCompleted.wait(lock, [&] { return m_completedJobCount == m_jobs.size(); });
+    }
+
+    m_frameTime = nullptr;
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+
+    // The sync point: apply the changes in the order of the scenes, regardless of the order in which they were updated.
+    for (Job& job : m_jobs) {
+        job.Changes.Apply();
+    }
+}
+
+void engine::SceneUpdateScheduler::BuildJobs(const std::vector<std::unique_ptr<Scene>>& scenes) {
+    m_jobs.clear();
+    m_order.clear();
+    m_completedJobCount = 0;
+
+    std::unordered_map<const Scene*, size_t> jobIndices;
+    for (size_t sceneIndex = 0; sceneIndex < scenes.size(); sceneIndex++) {
+        Scene* scene = scenes[sceneIndex].get();
+        if (scene->IsActive()) {
+            jobIndices.emplace(scene, m_jobs.size());
+            m_jobs.push_back(Job{scene, scene->IsConcurrentUpdate(), static_cast<uint16_t>(FirstInputStream + sceneIndex)});
+        }
+    }
+
+    // Scenes without concurrent update implicitly depend on the previous one, so that they keep their order.
+    constexpr size_t None = std::numeric_limits<size_t>::max();
+    size_t previousSequentialJob = None;
+    for (size_t jobIndex = 0; jobIndex < m_jobs.size(); jobIndex++) {
+        Job& job = m_jobs[jobIndex];
+        const auto addDependency = [&](size_t dependency) {
+            m_jobs[dependency].Dependents.push_back(jobIndex);
+            job.PendingDependencies++;
+        };
+
+        for (const Scene* dependency : job.Scene->UpdateDependencies()) {
+            const auto it = jobIndices.find(dependency);
+            if (it != jobIndices.end() && it->second != jobIndex) {
+                addDependency(it->second); // Inactive scenes are not updated, so they are not waited for.
+            }
+        }
+
+        if (!job.Concurrent) {
+            if (previousSequentialJob != None) {
+                addDependency(previousSequentialJob);
+            }
+            previousSequentialJob = jobIndex;
+        }
+    }
+
+    // Order the jobs topologically, preferring the order of the scenes, which also detects dependency cycles.
+    std::vector<size_t> pendingDependencies(m_jobs.size());
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> readyJobs;
+    for (size_t jobIndex = 0; jobIndex < m_jobs.size(); jobIndex++) {
+        pendingDependencies[jobIndex] = m_jobs[jobIndex].PendingDependencies;
+        if (pendingDependencies[jobIndex] == 0) {
+            readyJobs.push(jobIndex);
+        }
+    }
+
+    while (!readyJobs.empty()) {
+        const size_t jobIndex = readyJobs.top();
+        readyJobs.pop();
+        m_order.push_back(jobIndex);
+        for (size_t dependent : m_jobs[jobIndex].Dependents) {
+            if (--pendingDependencies[dependent] == 0) {
+                readyJobs.push(dependent);
+            }
+        }
+    }
+
+    if (m_order.size() != m_jobs.size()) {
+        throw std::logic_error("The update dependencies of the active scenes form a cycle");
+    }
+}
+
+void engine::SceneUpdateScheduler::SubmitJob(size_t jobIndex) {
+    m_threadPool.Submit([this, jobIndex] { RunJob(jobIndex); });
+}
+
+void engine::SceneUpdateScheduler::RunJob(size_t jobIndex) {
+    Job& job = m_jobs[jobIndex];
+
+    bool failed;
+    {
+        std::scoped_lock lock(m_mutex);
+        failed = m_exception != nullptr;
+    }
+
+    // Once an update failed the remaining jobs are only completed, so that the frame can be abandoned.
+    if (!failed) {
+        try {
+            UpdateScene(job);
+        } catch (...) {
+            std::scoped_lock lock(m_mutex);
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+        }
+    }
+
+    if (job.Concurrent) {
+        sample::InputCapture::SetThreadStream(0);
+    }
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_completedJobCount++;
+        for (size_t dependent : job.Dependents) {
+            if (--m_jobs[dependent].PendingDependencies == 0 && m_jobs[dependent].Concurrent && m_threadPool) {
+                SubmitJob(dependent);
+            }
+        }
+
+        // Notified while locked, since Update may return and the scheduler be destroyed as soon as the lock is released.
+        m_jobCompleted.notify_all();
+    }
+}
+
+void engine::SceneUpdateScheduler::UpdateScene(Job& job) {
+    SceneChangeList::RecordScope recordChanges(job.Changes);
+    if (job.Concurrent) {
+        sample::InputCapture::SetThreadStream(job.InputStream);
+    }
+
+    job.Scene->BeginUpdate();
+
+    const size_t objectCount = job.Scene->UpdatedObjectCount();
+    if (job.Concurrent && m_threadPool && objectCount > ObjectRangeSize) {
+        UpdateObjectRanges(job, objectCount);
+    } else {
+        job.Scene->UpdateObjects(*m_frameTime, 0, objectCount);
+    }
+
+    job.Scene->EndUpdate(*m_frameTime);
+}
+
+void engine::SceneUpdateScheduler::UpdateObjectRanges(Job& job, size_t objectCount) {
+    // Shared with the helper tasks, which may only start after all ranges are done and this function returned.
+    struct Ranges {
+        std::atomic<size_t> NextRange{0};
+        size_t RangeCount{0};
+        std::vector<SceneChangeList> Changes;
+
+        std::mutex Mutex;
+        std::condition_variable RangeCompleted;
+        size_t CompletedRangeCount{0};
+        std::exception_ptr Exception;
+    };
+
+    auto ranges = std::make_shared<Ranges>();
+    ranges->RangeCount = (objectCount + ObjectRangeSize - 1) / ObjectRangeSize;
+    ranges->Changes.resize(ranges->RangeCount);
+
+    // Claims ranges until none are left. Each range records its changes separately since it may run on any thread.
+    const auto updateRanges = [ranges, scene = job.Scene, &frameTime = *m_frameTime, objectCount]() {
+        for (size_t range; (range = ranges->NextRange++) < ranges->RangeCount;) {
+            try {
+                SceneChangeList::RecordScope recordChanges(ranges->Changes[range]);
+                scene->UpdateObjects(frameTime, range * ObjectRangeSize, std::min((range + 1) * ObjectRangeSize, objectCount));
+            } catch (...) {
+                std::scoped_lock lock(ranges->Mutex);
+                if (!ranges->Exception) {
+                    ranges->Exception = std::current_exception();
+                }
+            }
+
+            {
+                std::scoped_lock lock(ranges->Mutex);
+                ranges->CompletedRangeCount++;
+            }
+            ranges->RangeCompleted.notify_all();
+        }
+    };
+
+    const size_t helperCount = std::min<size_t>(ranges->RangeCount - 1, m_threadCount);
+    for (size_t i = 0; i < helperCount; i++) {
+        m_threadPool.Submit([updateRanges, inputStream = job.InputStream] {
+            sample::InputCapture::SetThreadStream(inputStream);
+            updateRanges();
+            sample::InputCapture::SetThreadStream(0);
+        });
+    }
+
+    // The job thread updates ranges as well, so it only waits for the ranges that are already running on other threads.
+    updateRanges();
+    {
+        std::unique_lock lock(ranges->Mutex);
+        ranges->RangeCompleted.wait(lock, [&] { return ranges->CompletedRangeCount == ranges->RangeCount; });
+    }
+
+    if (ranges->Exception) {
+        std::rethrow_exception(ranges->Exception);
+    }
+
+    for (SceneChangeList& changes : ranges->Changes) {
+        job.Changes.Append(std::move(changes));
+    }
+}
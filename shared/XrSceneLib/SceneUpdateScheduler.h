@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <SampleShared/ThreadPool.h>
+#include "Scene.h"
+
+namespace engine {
+    // Updates the active scenes once per frame, see Scene::SetConcurrentUpdate and Scene::AddUpdateDependency.
+    // - Scenes without concurrent update run on the calling thread, in the order of the scenes.
+    // - Concurrent scenes run on the thread pool as soon as their dependencies are updated. Their objects are updated in
+    //   ranges of ObjectRangeSize objects on the thread pool as well.
+    // - Structural changes made by the updates are applied in the order of the scenes once all scenes are updated,
+    //   see SceneChangeList. The changes of the object ranges of a scene are applied in the order of the ranges.
+    // - Each concurrent scene records and replays its input in its own stream of sample::InputCapture, so that a replayed
+    //   capture produces the same updates regardless of the thread count. Its object ranges share that stream.
+    // Without threads, all scenes run on the calling thread in an order that satisfies the dependencies.
+    class SceneUpdateScheduler {
+    public:
+        static constexpr size_t ObjectRangeSize = 256;
+
+        explicit SceneUpdateScheduler(uint32_t threadCount);
+
+        SceneUpdateScheduler(const SceneUpdateScheduler&) = delete;
+        SceneUpdateScheduler& operator=(const SceneUpdateScheduler&) = delete;
+
+        // Throws std::logic_error if the dependencies of the active scenes form a cycle, and rethrows the first exception
+        // of a scene update after all started updates are finished. Changes are not applied when an update failed.
+        void Update(const std::vector<std::unique_ptr<Scene>>& scenes, const FrameTime& frameTime);
+
+    private:
+        // Streams 0 and 1 are used by the update and render threads of XrApp.
+        static constexpr uint16_t FirstInputStream = 2;
+
+        struct Job {
+            engine::Scene* Scene;
+            bool Concurrent;
+            uint16_t InputStream;
+            std::vector<size_t> Dependents;
+            size_t PendingDependencies{0};
+            SceneChangeList Changes;
+        };
+
+        void BuildJobs(const std::vector<std::unique_ptr<Scene>>& scenes);
+        _Requires_lock_held_(m_mutex) void SubmitJob(size_t jobIndex);
+        void RunJob(size_t jobIndex);
+        void UpdateScene(Job& job);
+        void UpdateObjectRanges(Job& job, size_t objectCount);
+
+        const uint32_t m_threadCount;
+
+        std::mutex m_mutex;
+        std::condition_variable m_jobCompleted;
+        std::vector<Job> m_jobs;
+        std::vector<size_t> m_order; // The jobs in an order that satisfies the dependencies.
+        size_t m_completedJobCount{0};
+        std::exception_ptr m_exception;
+        const FrameTime* m_frameTime{nullptr};
+
+        sample::ThreadPool m_threadPool; // Destroyed first, so that the threads are joined before the state they use.
+    };
+} // namespace engine
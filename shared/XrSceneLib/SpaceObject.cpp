@@ -8,18 +8,18 @@ namespace {
 
     class SpaceObject : public engine::Object {
     public:
-        SpaceObject(xr::SpaceHandle space, bool hideWhenPoseInvalid)
+        SpaceObject(engine::Context& context, xr::SpaceHandle space, bool hideWhenPoseInvalid)
             : m_space(std::move(space))
             , m_hideWhenPoseInvalid(hideWhenPoseInvalid) {
             assert(m_space.Get() != XR_NULL_HANDLE);
+            m_location = context.SpaceLocations.Register(m_space.Get());
         }
 
         void Update(engine::Context& context, const engine::FrameTime& frameTime) override {
-            XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
-            CHECK_XRCMD(xrLocateSpace(m_space.Get(), context.AppSpace, frameTime.PredictedDisplayTime, &location));
-            const bool poseValid = xr::math::Pose::IsPoseValid(location);
+            const xr::SpaceLocation location = m_location.Location();
+            const bool poseValid = xr::math::Pose::IsPoseValid(location.LocationFlags);
             if (poseValid) {
-                Pose() = location.pose;
+                Pose() = location.Pose;
             }
             if (m_hideWhenPoseInvalid) {
                 SetVisible(poseValid);
@@ -28,12 +28,13 @@ namespace {
 
     private:
         xr::SpaceHandle m_space;
+        xr::SpaceLocator::Registration m_location; // Released before the space is destroyed.
         const bool m_hideWhenPoseInvalid;
     };
 } // namespace
 
 namespace engine {
-    std::shared_ptr<engine::Object> CreateSpaceObject(xr::SpaceHandle space, bool hideWhenPoseInvalid) {
-        return std::make_shared<SpaceObject>(std::move(space), hideWhenPoseInvalid);
+    std::shared_ptr<engine::Object> CreateSpaceObject(Context& context, xr::SpaceHandle space, bool hideWhenPoseInvalid) {
+        return std::make_shared<SpaceObject>(context, std::move(space), hideWhenPoseInvalid);
     }
 } // namespace engine
@@ -4,7 +4,9 @@
 #pragma once
 
 #include "Object.h"
+#include "Context.h"
 
 namespace engine {
-    std::shared_ptr<engine::Object> CreateSpaceObject(xr::SpaceHandle space, bool hideWhenPoseInvalid = true);
+    // The object follows the space, which is located with the other spaces of the context once per frame.
+    std::shared_ptr<engine::Object> CreateSpaceObject(Context& context, xr::SpaceHandle space, bool hideWhenPoseInvalid = true);
 } // namespace engine
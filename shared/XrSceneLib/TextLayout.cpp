@@ -0,0 +1,171 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include <algorithm>
+#include "TextLayout.h"
+
+engine::AtlasPacker::AtlasPacker(uint32_t width, uint32_t height, uint32_t padding)
+    : m_width(width)
+    , m_height(height)
+    , m_padding(padding) {
+}
+
+std::optional<engine::AtlasRect> engine::AtlasPacker::Pack(uint32_t width, uint32_t height) {
+    const uint32_t paddedWidth = width + m_padding * 2;
+    const uint32_t paddedHeight = height + m_padding * 2;
+    if (paddedWidth > m_width) {
+        return std::nullopt;
+    }
+
+    // Prefer the lowest shelf that fits, so that small glyphs do not waste the space of tall shelves.
+    Shelf* bestShelf = nullptr;
+    for (Shelf& shelf : m_shelves) {
+        if (shelf.Height >= paddedHeight && m_width - shelf.NextX >= paddedWidth &&
+            (bestShelf == nullptr || shelf.Height < bestShelf->Height)) {
+            bestShelf = &shelf;
+        }
+    }
+
+    if (bestShelf == nullptr) {
+        if (m_height - m_nextShelfY < paddedHeight) {
+            return std::nullopt;
+        }
+        bestShelf = &m_shelves.emplace_back(Shelf{m_nextShelfY, paddedHeight, 0});
+        m_nextShelfY += paddedHeight;
+    }
+
+    const AtlasRect rect{bestShelf->NextX + m_padding, bestShelf->Y + m_padding, width, height};
+    bestShelf->NextX += paddedWidth;
+    return rect;
+}
+
+void engine::AtlasPacker::Reset() {
+    m_shelves.clear();
+    m_nextShelfY = 0;
+}
+
+std::u32string engine::DecodeUtf8(std::string_view text) {
+    constexpr char32_t Replacement = 0xFFFD;
+
+    std::u32string codepoints;
+    codepoints.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        const uint8_t lead = static_cast<uint8_t>(text[i]);
+        const uint32_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size()) {
+            codepoints.push_back(Replacement);
+            i++;
+            continue;
+        }
+
+        char32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+        bool valid = true;
+        for (uint32_t k = 1; k < length; k++) {
+            const uint8_t continuation = static_cast<uint8_t>(text[i + k]);
+            valid = valid && (continuation & 0xC0) == 0x80;
+            codepoint = (codepoint << 6) | (continuation & 0x3F);
+        }
+
+        codepoints.push_back(valid ? codepoint : Replacement);
+        i += valid ? length : 1;
+    }
+    return codepoints;
+}
+
+void engine::LayoutText(std::u32string_view text,
+                        const GlyphTable& glyphs,
+                        const TextLayoutOptions& options,
+                        std::vector<GlyphQuad>& quads) {
+    quads.clear();
+    const float atlasWidth = static_cast<float>(glyphs.AtlasWidth);
+    const float atlasHeight = static_cast<float>(glyphs.AtlasHeight);
+    const float right = options.Width - options.Margin;
+    const float bottom = options.Height - options.Margin;
+
+    const auto lineWidth = [&](std::u32string_view line) {
+        float width = 0;
+        for (size_t i = 0; i < line.size(); i++) {
+            if (const GlyphMetrics* glyph = glyphs.FindGlyph(line[i])) {
+                width += glyph->Advance + (i + 1 < line.size() ? glyphs.GetKerning(line[i], line[i + 1]) : 0.0f);
+            }
+        }
+        return width;
+    };
+
+    const size_t lineCount = std::count(text.begin(), text.end(), U'\n') + 1;
+    const float textHeight = lineCount * glyphs.LineHeight;
+    float baseline = options.Margin + glyphs.Ascent;
+    if (options.VerticalAlignment == TextVerticalAlignment::Center) {
+        baseline += (options.Height - options.Margin * 2 - textHeight) / 2;
+    } else if (options.VerticalAlignment == TextVerticalAlignment::Bottom) {
+        baseline += options.Height - options.Margin * 2 - textHeight;
+    }
+
+    while (true) {
+        const size_t lineEnd = text.find(U'\n');
+        const std::u32string_view line = text.substr(0, lineEnd);
+
+        float penX = options.Margin;
+        if (options.Alignment == TextAlignment::Center) {
+            penX += (options.Width - options.Margin * 2 - lineWidth(line)) / 2;
+        } else if (options.Alignment == TextAlignment::Trailing) {
+            penX += options.Width - options.Margin * 2 - lineWidth(line);
+        }
+
+        for (size_t i = 0; i < line.size(); i++) {
+            const GlyphMetrics* glyph = glyphs.FindGlyph(line[i]);
+            if (glyph == nullptr) {
+                continue;
+            }
+
+            if (glyph->Rect.Width > 0 && glyph->Rect.Height > 0) {
+                const float left = penX + glyph->OffsetX;
+                const float top = baseline + glyph->OffsetY;
+                const GlyphQuad quad{left,
+                                     top,
+                                     left + glyph->Rect.Width,
+                                     top + glyph->Rect.Height,
+                                     glyph->Rect.X / atlasWidth,
+                                     glyph->Rect.Y / atlasHeight,
+                                     (glyph->Rect.X + glyph->Rect.Width) / atlasWidth,
+                                     (glyph->Rect.Y + glyph->Rect.Height) / atlasHeight};
+                if (quad.Left >= options.Margin && quad.Top >= options.Margin && quad.Right <= right && quad.Bottom <= bottom) {
+                    quads.push_back(quad);
+                }
+            }
+
+            penX += glyph->Advance;
+            if (i + 1 < line.size()) {
+                penX += glyphs.GetKerning(line[i], line[i + 1]);
+            }
+        }
+
+        if (lineEnd == std::u32string_view::npos) {
+            break;
+        }
+        text.remove_prefix(lineEnd + 1);
+        baseline += glyphs.LineHeight;
+    }
+}
+
+std::pair<size_t, size_t> engine::FindChangedQuads(const std::vector<GlyphQuad>& previous, const std::vector<GlyphQuad>& current) {
+    const size_t commonSize = std::min(previous.size(), current.size());
+
+    size_t begin = 0;
+    while (begin < commonSize && previous[begin] == current[begin]) {
+        begin++;
+    }
+    if (begin == commonSize && previous.size() == current.size()) {
+        return {begin, begin};
+    }
+
+    // Quads past the common size are always new. Within it, trailing quads that did not move are kept.
+    size_t end = current.size();
+    if (previous.size() == current.size()) {
+        while (end > begin && previous[end - 1] == current[end - 1]) {
+            end--;
+        }
+    }
+    return {begin, end};
+}
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Glyph atlas packing and text layout. This part of the text rendering has no graphics or font API dependency.
+namespace engine {
+
+    struct AtlasRect {
+        uint32_t X{0};
+        uint32_t Y{0};
+        uint32_t Width{0};
+        uint32_t Height{0};
+    };
+
+    // Packs rectangles into horizontal shelves of an atlas of fixed size.
+    // Each rectangle goes to the lowest shelf it fits in, or to a new shelf of its height below the existing ones.
+    class AtlasPacker {
+    public:
+        AtlasPacker(uint32_t width, uint32_t height, uint32_t padding = 1);
+
+        // Returns nothing if the atlas is full.
+        std::optional<AtlasRect> Pack(uint32_t width, uint32_t height);
+        void Reset();
+
+    private:
+        struct Shelf {
+            uint32_t Y;
+            uint32_t Height;
+            uint32_t NextX;
+        };
+
+        const uint32_t m_width;
+        const uint32_t m_height;
+        const uint32_t m_padding;
+        std::vector<Shelf> m_shelves;
+        uint32_t m_nextShelfY{0};
+    };
+
+    // Metrics of a glyph rasterized into the atlas, in pixels.
+    struct GlyphMetrics {
+        AtlasRect Rect;      // Pixels of the glyph in the atlas. Empty for glyphs without pixels, e.g. space.
+        float OffsetX{0};    // From the pen position on the baseline to the left of Rect.
+        float OffsetY{0};    // From the pen position on the baseline to the top of Rect, positive down.
+        float Advance{0};    // Distance to the next pen position.
+    };
+
+    // The glyphs available in an atlas, with the kerning of the character pairs laid out so far.
+    struct GlyphTable {
+        uint32_t AtlasWidth{0};
+        uint32_t AtlasHeight{0};
+        float Ascent{0};
+        float LineHeight{0};
+        AtlasRect SolidRect; // Opaque pixels used for backgrounds.
+
+        std::unordered_map<char32_t, GlyphMetrics> Glyphs;
+        std::unordered_map<uint64_t, float> Kerning;
+
+        static uint64_t KerningKey(char32_t first, char32_t second) {
+            return (uint64_t{first} << 32) | second;
+        }
+
+        const GlyphMetrics* FindGlyph(char32_t codepoint) const {
+            const auto it = Glyphs.find(codepoint);
+            return it == Glyphs.end() ? nullptr : &it->second;
+        }
+
+        float GetKerning(char32_t first, char32_t second) const {
+            const auto it = Kerning.find(KerningKey(first, second));
+            return it == Kerning.end() ? 0.0f : it->second;
+        }
+    };
+
+    enum class TextAlignment { Leading, Center, Trailing };
+    enum class TextVerticalAlignment { Top, Center, Bottom };
+
+    struct TextLayoutOptions {
+        float Width{0}; // Size of the text box in pixels.
+        float Height{0};
+        float Margin{0};
+        TextAlignment Alignment{TextAlignment::Center};
+        TextVerticalAlignment VerticalAlignment{TextVerticalAlignment::Center};
+    };
+
+    // A rectangle of the text box, in pixels from the top left of the box, and its atlas texture coordinates.
+    struct GlyphQuad {
+        float Left, Top, Right, Bottom;
+        float U0, V0, U1, V1;
+
+        bool operator==(const GlyphQuad& other) const {
+            return Left == other.Left && Top == other.Top && Right == other.Right && Bottom == other.Bottom && U0 == other.U0 &&
+                   V0 == other.V0 && U1 == other.U1 && V1 == other.V1;
+        }
+        bool operator!=(const GlyphQuad& other) const {
+            return !(*this == other);
+        }
+    };
+
+    // Invalid sequences decode to U+FFFD.
+    std::u32string DecodeUtf8(std::string_view text);
+
+    // Lay out the text one line per '\n', with pair kerning and without shaping.
+    // Lines are not wrapped. Glyphs outside of the margins and glyphs that are not in the table are left out.
+    void LayoutText(std::u32string_view text, const GlyphTable& glyphs, const TextLayoutOptions& options, std::vector<GlyphQuad>& quads);
+
+    // Returns the range [begin, end) of the quads that differ between two layouts, which is empty if they are the same.
+    std::pair<size_t, size_t> FindChangedQuads(const std::vector<GlyphQuad>& previous, const std::vector<GlyphQuad>& current);
+
+} // namespace engine
@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "TextObject.h"
+
+namespace {
+    constexpr uint32_t VerticesPerQuad = 4;
+    constexpr uint32_t IndicesPerQuad = 6;
+    constexpr float GlyphDepthOffset = 0.0005f; // meters in front of the background, to avoid z-fighting.
+
+    void AppendQuadIndices(std::vector<uint32_t>& indices, uint32_t quadIndex) {
+        const uint32_t vbase = quadIndex * VerticesPerQuad;
+        for (uint32_t index : {0, 1, 2, 0, 2, 3}) {
+            indices.push_back(vbase + index);
+        }
+    }
+} // namespace
+
+engine::TextObject::TextObject(Context& context, std::shared_ptr<GlyphAtlas> atlas, TextObjectInfo info)
+    : m_context(context)
+    , m_atlas(std::move(atlas))
+    , m_info(std::move(info))
+    , m_layoutOptions{m_info.PixelWidth,
+                      std::floor(m_info.Size.y * m_info.PixelWidth / m_info.Size.x), // Keep the aspect ratio of the quad
+                      m_info.Margin,
+                      m_info.Alignment,
+                      m_info.VerticalAlignment} {
+    // The background samples the middle of the opaque block of the atlas, so that filtering never reaches the transparent border.
+    const GlyphTable& glyphs = m_atlas->Glyphs();
+    const float solidU = (glyphs.SolidRect.X + glyphs.SolidRect.Width / 2.0f) / glyphs.AtlasWidth;
+    const float solidV = (glyphs.SolidRect.Y + glyphs.SolidRect.Height / 2.0f) / glyphs.AtlasHeight;
+    const GlyphQuad background{0, 0, m_layoutOptions.Width, m_layoutOptions.Height, solidU, solidV, solidU, solidV};
+
+    m_vertices.resize(VerticesPerQuad);
+    WriteQuad(0, background, m_info.Background, 0);
+    AppendQuadIndices(m_indices, 0);
+
+    Pbr::PrimitiveBuilder builder;
+    builder.Vertices = m_vertices;
+    builder.Indices = m_indices;
+
+    auto model = std::make_shared<Pbr::Model>();
+    model->AddPrimitive(Pbr::Primitive(m_context.PbrResources, builder, m_atlas->Material(), true /* updatableBuffers */));
+    SetModel(std::move(model));
+}
+
+void engine::TextObject::SetText(std::string_view text) {
+    if (text == m_text) {
+        return;
+    }
+    m_text = text;
+
+    const std::u32string codepoints = DecodeUtf8(m_text);
+    if (!m_atlas->AddGlyphs(codepoints)) {
+        sample::Trace("Glyph atlas is full, some characters of the text are not drawn");
+    }
+
+    m_previousQuads.swap(m_quads);
+    LayoutText(codepoints, m_atlas->Glyphs(), m_layoutOptions, m_quads);
+
+    const auto [changedBegin, changedEnd] = FindChangedQuads(m_previousQuads, m_quads);
+    const bool quadCountChanged = m_previousQuads.size() != m_quads.size();
+    if (changedBegin == changedEnd && !quadCountChanged) {
+        return;
+    }
+
+    // Rewrite the vertices of the glyphs that changed only. The first quad is the background.
+    m_vertices.resize((m_quads.size() + 1) * VerticesPerQuad);
+    for (size_t i = changedBegin; i < changedEnd; i++) {
+        WriteQuad(i + 1, m_quads[i], m_info.Foreground, GlyphDepthOffset);
+    }
+
+    Pbr::Primitive& primitive = GetModel()->GetPrimitive(0);
+    const uint32_t vertexCount = (uint32_t)m_vertices.size();
+    primitive.UpdateVertices(m_context.Device.get(), m_context.DeviceContext.get(), vertexCount, [&](Pbr::Vertex* vertices) {
+        memcpy(vertices, m_vertices.data(), vertexCount * sizeof(Pbr::Vertex));
+    });
+
+    if (quadCountChanged) {
+        const uint32_t quadCount = (uint32_t)m_quads.size() + 1;
+        if (m_indices.size() < quadCount * IndicesPerQuad) {
+            for (uint32_t quadIndex = (uint32_t)(m_indices.size() / IndicesPerQuad); quadIndex < quadCount; quadIndex++) {
+                AppendQuadIndices(m_indices, quadIndex);
+            }
+        }
+        primitive.UpdateIndices(m_context.Device.get(), m_context.DeviceContext.get(), m_indices.data(), quadCount * IndicesPerQuad);
+    }
+}
+
+void engine::TextObject::WriteQuad(size_t quadIndex, const GlyphQuad& quad, const Pbr::RGBAColor& color, float z) {
+    // Pixels of the text box are y down from the top left, the quad is y up and centered on the object.
+    const auto toMeters = [&](float x, float y) {
+        return DirectX::XMFLOAT3{
+            (x / m_layoutOptions.Width - 0.5f) * m_info.Size.x, (0.5f - y / m_layoutOptions.Height) * m_info.Size.y, z};
+    };
+
+    Pbr::Vertex vertex;
+    vertex.Normal = {0, 0, 1};
+    vertex.Tangent = {1, 0, 0, 0};
+    vertex.Color0 = color;
+    vertex.ModelTransformIndex = Pbr::RootNodeIndex;
+
+    // Same corner order and winding as PrimitiveBuilder::AddQuad.
+    Pbr::Vertex* const vertices = &m_vertices[quadIndex * VerticesPerQuad];
+    vertex.Position = toMeters(quad.Left, quad.Bottom);
+    vertex.TexCoord0 = {quad.U0, quad.V1};
+    vertices[0] = vertex;
+    vertex.Position = toMeters(quad.Left, quad.Top);
+    vertex.TexCoord0 = {quad.U0, quad.V0};
+    vertices[1] = vertex;
+    vertex.Position = toMeters(quad.Right, quad.Top);
+    vertex.TexCoord0 = {quad.U1, quad.V0};
+    vertices[2] = vertex;
+    vertex.Position = toMeters(quad.Right, quad.Bottom);
+    vertex.TexCoord0 = {quad.U1, quad.V1};
+    vertices[3] = vertex;
+}
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "PbrModelObject.h"
+#include "GlyphAtlas.h"
+
+namespace engine {
+
+    struct TextObjectInfo {
+        DirectX::XMFLOAT2 Size{1, 1}; // meters
+        float PixelWidth = 256;       // Width of the text box in font pixels. The height keeps the aspect ratio of Size.
+        float Margin = 0;             // pixels
+        Pbr::RGBAColor Foreground = Pbr::RGBA::White;
+        Pbr::RGBAColor Background = Pbr::RGBA::Transparent;
+        TextAlignment Alignment = TextAlignment::Center;
+        TextVerticalAlignment VerticalAlignment = TextVerticalAlignment::Center;
+    };
+
+    // A quad of text drawn from the glyphs of a shared atlas, one textured quad per glyph.
+    // Changing the text lays it out again on the CPU and rewrites the vertices of the glyphs that moved or changed.
+    // The material of the atlas is shared and never changes.
+    class TextObject : public PbrModelObject {
+    public:
+        TextObject(Context& context, std::shared_ptr<GlyphAtlas> atlas, TextObjectInfo info);
+
+        void SetText(std::string_view text);
+
+        const std::string& Text() const {
+            return m_text;
+        }
+
+    private:
+        void WriteQuad(size_t quadIndex, const GlyphQuad& quad, const Pbr::RGBAColor& color, float z);
+
+        Context& m_context;
+        const std::shared_ptr<GlyphAtlas> m_atlas;
+        const TextObjectInfo m_info;
+        const TextLayoutOptions m_layoutOptions;
+
+        std::string m_text;
+        std::vector<GlyphQuad> m_quads;
+        std::vector<GlyphQuad> m_previousQuads;
+        std::vector<Pbr::Vertex> m_vertices; // The background quad, followed by one quad per glyph.
+        std::vector<uint32_t> m_indices;
+    };
+
+} // namespace engine
@@ -14,6 +14,7 @@
 
 #include "CompositionLayers.h"
 #include "Context.h"
+#include "SceneUpdateScheduler.h"
 #include "XrApp.h"
 
 using namespace DirectX;
@@ -61,6 +62,9 @@ namespace {
             XR_KHR_D3D11_ENABLE_EXTENSION_NAME,
             XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME,
             XR_MSFT_UNBOUNDED_REFERENCE_SPACE_EXTENSION_NAME,
+#ifdef XR_KHR_locate_spaces
+            XR_KHR_LOCATE_SPACES_EXTENSION_NAME,
+#endif
             XR_MSFT_SECONDARY_VIEW_CONFIGURATION_EXTENSION_NAME,
             XR_MSFT_FIRST_PERSON_OBSERVER_EXTENSION_NAME,
 #if UWP
@@ -98,15 +102,21 @@ namespace {
             return m_projectionLayers;
         }
 
+        const engine::DynamicResolutionController* DynamicResolution() const override {
+            return m_dynamicResolution.get();
+        }
+
     private:
 
         const engine::XrAppConfiguration m_appConfiguration;
+        std::unique_ptr<sample::InputCapture> m_inputCapture; // Outlives the context, whose scene handles may be replayed.
 
         std::unique_ptr<engine::Context> m_context;
         xr::SpaceHandle m_viewSpace;
         xr::SpaceHandle m_appSpace;
 
         engine::ProjectionLayers m_projectionLayers;
+        std::unique_ptr<engine::DynamicResolutionController> m_dynamicResolution;
         std::unordered_map<XrViewConfigurationType, xr::ViewConfigurationState> m_viewConfigStates;
 
         std::mutex m_secondaryViewConfigActiveMutex;
@@ -114,6 +124,7 @@ namespace {
 
         std::mutex m_sceneMutex;
         std::vector<std::unique_ptr<engine::Scene>> m_scenes;
+        engine::SceneUpdateScheduler m_sceneUpdates;
 
         std::atomic<XrSessionState> m_sessionState;
         std::atomic<bool> m_sessionRunning{false};
@@ -148,7 +159,8 @@ namespace {
     };
 
     ImplementXrApp::ImplementXrApp(engine::XrAppConfiguration appConfiguration)
-        : m_appConfiguration(std::move(appConfiguration)) {
+        : m_appConfiguration(std::move(appConfiguration))
+        , m_sceneUpdates(m_appConfiguration.SceneUpdateThreadCount) {
 
         // Create an instance using combined extensions of XrSceneLib and the application.
         // The extension context record those supported by the runtime and enabled by the instance.
@@ -165,6 +177,9 @@ namespace {
         xr::EnabledExtensions enabledExtensions = xr::EnabledExtensions(selectedExtensionsCstr, instanceExtensions);
 
         xr::g_dispatchTable.Initialize(instance.Handle, xrGetInstanceProcAddr);
+        if (m_appConfiguration.InputCapture) {
+            m_inputCapture = std::make_unique<sample::InputCapture>(xr::g_dispatchTable, *m_appConfiguration.InputCapture);
+        }
 
         // For example, this sample currently requires D3D11 extension to be supported.
         if (!enabledExtensions.XR_KHR_D3D11_enable_enabled) {
@@ -247,6 +262,12 @@ namespace {
                                                       std::move(pbrResources),
                                                       device,
                                                       deviceContext);
+        m_context->AssetResidency.SetBudget(m_appConfiguration.AssetResidencyBudget);
+
+        if (m_appConfiguration.DynamicResolution) {
+            m_dynamicResolution =
+                std::make_unique<engine::DynamicResolutionController>(m_context->Device.get(), *m_appConfiguration.DynamicResolution);
+        }
 
         m_projectionLayers.Resize(1, Context(), true /*forceReset*/);
     }
@@ -328,7 +349,7 @@ namespace {
     }
 
     void ImplementXrApp::SyncActions(const std::scoped_lock<std::mutex>& proofOfSceneLock) {
-        std::vector<const sample::ActionContext*> actionContexts;
+        std::vector<sample::ActionContext*> actionContexts;
         for (const auto& scene : m_scenes) {
             if (scene->IsActive()) {
                 actionContexts.push_back(&scene->ActionContext());
@@ -344,6 +365,7 @@ namespace {
             m_renderThread = std::thread([this]() {
                 try {
                     ::SetThreadDescription(::GetCurrentThread(), L"Render Thread");
+                    sample::InputCapture::SetThreadStream(1);
 
                     auto scopeGuard = MakeFailureGuard([&] {
                         // Abort frame loop on error and ensure to balance begin/wait frame count, so as to
@@ -491,16 +513,17 @@ namespace {
 
         {
             std::scoped_lock sceneLock(m_sceneMutex);
+            const engine::FrameTime::clock::time_point updateStart = engine::FrameTime::clock::now();
 
             SyncActions(sceneLock);
 
             m_currentFrameTime.Update(frameState, m_sessionState);
-            for (auto& scene : m_scenes) {
-                if (scene->IsActive()) {
-                    scene->Update(m_currentFrameTime);
-                }
-            }
+            Context().SpaceLocations.Locate(Context().AppSpace, m_currentFrameTime.PredictedDisplayTime);
+            m_sceneUpdates.Update(m_scenes, m_currentFrameTime);
 
+            if (m_dynamicResolution) {
+                m_dynamicResolution->SetUpdateTime(engine::FrameTime::clock::now() - updateStart);
+            }
         }
     }
 
@@ -539,6 +562,11 @@ namespace {
         }
 
         m_projectionLayers.ForEachLayerWithLock([this](auto&& layer) {
+            if (m_dynamicResolution) {
+                const float scale = m_dynamicResolution->Scale();
+                layer.Config(PrimaryViewConfigurationType).ViewportSizeScale = {scale, scale};
+            }
+
             for (auto& [viewConfigType, state] : m_viewConfigStates) {
                 if (xr::IsPrimaryViewConfigurationType(viewConfigType) || state.Active) {
                     layer.PrepareRendering(Context(), viewConfigType, state.ViewConfigViews);
@@ -582,6 +610,13 @@ namespace {
         if (renderFrameTime.ShouldRender) {
             std::scoped_lock sceneLock(m_sceneMutex);
 
+            // Timed under the scene lock, since scenes may use the immediate context while they update.
+            if (m_dynamicResolution) {
+                m_dynamicResolution->BeginRender(Context().DeviceContext.get());
+            }
+
+            Context().AssetResidency.BeginFrame(renderFrameTime.FrameIndex);
+
             for (const std::unique_ptr<engine::Scene>& scene : m_scenes) {
                 if (scene->IsActive()) {
                     scene->BeforeRender(m_currentFrameTime);
@@ -604,6 +639,16 @@ namespace {
                     secondaryViewConfigLayerInfo.layers = secondaryViewConfigLayers.LayerData();
                 }
             }
+
+            // Assets not rendered in this frame may be evicted to meet the memory budget.
+            Context().AssetResidency.EndFrame();
+            if (Context().AssetResidency.GetFrameStats().EvictedAssetCount > 0) {
+                Context().PbrResources.TrimSolidColorTextureCache();
+            }
+
+            if (m_dynamicResolution) {
+                m_dynamicResolution->EndRender(Context().DeviceContext.get(), renderFrameTime);
+            }
         }
 
         CHECK_XRCMD(xrEndFrame(Context().Session.Handle, &endFrameInfo));
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <SampleShared/InputCapture.h>
+
 #include "Scene.h"
 #include "Context.h"
+#include "DynamicResolution.h"
 #include "ProjectionLayer.h"
 
 namespace engine {
@@ -23,6 +26,9 @@ namespace engine {
 
         virtual ProjectionLayers& ProjectionLayers() = 0;
 
+        // Null unless XrAppConfiguration::DynamicResolution is set.
+        virtual const DynamicResolutionController* DynamicResolution() const = 0;
+
     };
 
     struct XrAppConfiguration {
@@ -36,6 +42,18 @@ namespace engine {
         bool SingleThreadedD3D11Device{false};
         bool RenderSynchronously{false};
         std::optional<XrHolographicWindowAttachmentMSFT> HolographicWindowAttachment{std::nullopt};
+        Pbr::ResidencyBudget AssetResidencyBudget{}; // Unlimited by default, i.e. assets are never evicted.
+
+        // Threads that update the scenes with concurrent update, see engine::SceneUpdateScheduler.
+        // Zero updates all scenes on the update thread.
+        uint32_t SceneUpdateThreadCount{2};
+
+        // Scale the viewports of the primary projection layers within their swapchains to hold the frame rate under load.
+        // Overrides ProjectionLayerConfig::ViewportSizeScale of the primary view configuration every frame.
+        std::optional<DynamicResolutionPolicy> DynamicResolution{std::nullopt};
+
+        // Record the input of the session into a file, or replay a recorded file instead of the input of the runtime.
+        std::optional<sample::InputCaptureInfo> InputCapture{std::nullopt};
     };
 
     std::unique_ptr<XrApp> CreateXrApp(XrAppConfiguration appConfiguration);
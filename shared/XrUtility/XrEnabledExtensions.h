@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string_view>
 #include <openxr/openxr_reflection.h>
 #include <openxr_preview/openxr_msft_preview.h>
 
@@ -39,6 +40,20 @@ namespace xr {
 #undef SET_EXTENSION_IF_MATCH
         }
 
+        // Look up an extension by name, e.g. for extensions referenced by data files.
+        bool IsEnabled(std::string_view extensionName) const {
+#define RETURN_EXTENSION_IF_MATCH(name, _) \
+    if (extensionName == #name) {          \
+        return name##_enabled;             \
+    }
+
+            XR_LIST_EXTENSIONS(RETURN_EXTENSION_IF_MATCH)
+            XR_LIST_EXTENSIONS_MSFT_PREVIEW(RETURN_EXTENSION_IF_MATCH)
+
+#undef RETURN_EXTENSION_IF_MATCH
+            return false;
+        }
+
         // Example: for extension name `XR_KHR_extension_name`, there will be two fields define for it.
         //  bool   XR_KHR_extension_name_enabled; // it will be true if the extension is enabled by the current xrInstance
         //  uint32 XR_KHR_extension_name_version; // it will be > 0 if the extension is enabled by the current xrInstance.
@@ -35,6 +35,12 @@
 #define XR_KHR_visibility_mask_DEFINED(_, defined, undefined) _(undefined)
 #endif
 
+#ifdef XR_KHR_locate_spaces
+#define XR_KHR_locate_spaces_DEFINED(_, defined, undefined) _(defined)
+#else
+#define XR_KHR_locate_spaces_DEFINED(_, defined, undefined) _(undefined)
+#endif
+
 #ifdef XR_MSFT_controller_model
 #define XR_MSFT_controller_model_DEFINED(_, defined, undefined) _(defined)
 #else
@@ -81,6 +81,7 @@ namespace xr {
     class SpaceHandle : public UniqueXrHandle<XrSpace> {};
     class SwapchainHandle : public UniqueXrHandle<XrSwapchain> {};
     class SpatialAnchorHandle : public UniqueXrHandle<XrSpatialAnchorMSFT> {};
+    class SpatialAnchorStoreConnectionHandle : public UniqueXrHandle<XrSpatialAnchorStoreConnectionMSFT> {};
     class HandTrackerHandle : public UniqueXrHandle<XrHandTrackerEXT> {};
 
 } // namespace xr
@@ -74,6 +74,7 @@
 #define XR_LIST_FUNCTIONS_XR_KHR_D3D11_enable(_) _(xrGetD3D11GraphicsRequirementsKHR)
 #define XR_LIST_FUNCTIONS_XR_KHR_D3D12_enable(_) _(xrGetD3D12GraphicsRequirementsKHR)
 #define XR_LIST_FUNCTIONS_XR_KHR_visibility_mask(_) _(xrGetVisibilityMaskKHR)
+#define XR_LIST_FUNCTIONS_XR_KHR_locate_spaces(_) _(xrLocateSpacesKHR)
 
 #define XR_LIST_FUNCTIONS_XR_MSFT_controller_model(_) \
     _(xrGetControllerModelKeyMSFT)                    \
@@ -189,6 +190,7 @@
     XR_KHR_D3D11_enable_DEFINED(XR_LIST_FUNCTIONS_XR_KHR_D3D11_enable, _, __)                                                       \
     XR_KHR_D3D12_enable_DEFINED(XR_LIST_FUNCTIONS_XR_KHR_D3D12_enable, _, __)                                                       \
     XR_KHR_visibility_mask_DEFINED(XR_LIST_FUNCTIONS_XR_KHR_visibility_mask, _, __)                                                 \
+    XR_KHR_locate_spaces_DEFINED(XR_LIST_FUNCTIONS_XR_KHR_locate_spaces, _, __)                                                     \
     XR_MSFT_controller_model_DEFINED(XR_LIST_FUNCTIONS_XR_MSFT_controller_model, _, __)                                             \
     XR_MSFT_spatial_anchor_DEFINED(XR_LIST_FUNCTIONS_XR_MSFT_spatial_anchor, _, __)                                                 \
     XR_EXT_hand_tracking_DEFINED(XR_LIST_FUNCTIONS_XR_EXT_hand_tracking, _, __)                                                     \
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "XrError.h"
+
+namespace xr {
+
+    // Interns path strings of an XrInstance, so that each unique string is converted by xrStringToPath only once.
+    // The cache can be shared by everything that creates actions or suggests bindings on the same instance.
+    class PathCache {
+    public:
+        explicit PathCache(XrInstance instance)
+            : m_instance(instance) {
+        }
+
+        XrPath Get(std::string_view pathString) {
+            std::string key(pathString);
+            std::lock_guard lock(m_mutex);
+            const auto it = m_paths.find(key);
+            if (it != m_paths.end()) {
+                return it->second;
+            }
+
+            XrPath path = XR_NULL_PATH;
+            CHECK_XRCMD(xrStringToPath(m_instance, key.c_str(), &path));
+            m_paths.emplace(std::move(key), path);
+            return path;
+        }
+
+        std::vector<XrPath> Get(const std::vector<std::string>& pathStrings) {
+            std::vector<XrPath> paths;
+            paths.reserve(pathStrings.size());
+            for (const std::string& pathString : pathStrings) {
+                paths.push_back(Get(pathString));
+            }
+            return paths;
+        }
+
+        XrInstance Instance() const {
+            return m_instance;
+        }
+
+        size_t Size() const {
+            std::lock_guard lock(m_mutex);
+            return m_paths.size();
+        }
+
+    private:
+        const XrInstance m_instance;
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, XrPath> m_paths;
+    };
+
+} // namespace xr
@@ -71,51 +71,61 @@ namespace xr {
         CHECK_XRCMD(xrComputeNewSceneMSFT(sceneObserver, &computeInfo));
     }
 
-    // Reads mesh vertices and 32-bit indices.
+    namespace detail {
+        template <typename TIndex>
+        struct SceneMeshIndices;
+
+        template <>
+        struct SceneMeshIndices<uint32_t> {
+            using Type = XrSceneMeshIndicesUint32MSFT;
+            static constexpr XrStructureType StructureType = XR_TYPE_SCENE_MESH_INDICES_UINT32_MSFT;
+        };
+
+        template <>
+        struct SceneMeshIndices<uint16_t> {
+            using Type = XrSceneMeshIndicesUint16MSFT;
+            static constexpr XrStructureType StructureType = XR_TYPE_SCENE_MESH_INDICES_UINT16_MSFT;
+        };
+    } // namespace detail
+
+    // Reads mesh vertices and 32-bit or 16-bit indices into the given buffers.
+    // The existing capacity of the buffers is used for the first read, so buffers reused across calls are usually filled
+    // with a single call and without reallocation. The buffers only grow when a mesh does not fit.
+    template <typename TIndex>
     inline void
-    ReadMeshBuffers(XrSceneMSFT scene, uint64_t meshBufferId, std::vector<XrVector3f>& vertexBuffer, std::vector<uint32_t>& indexBuffer) {
+    ReadMeshBuffers(XrSceneMSFT scene, uint64_t meshBufferId, std::vector<XrVector3f>& vertexBuffer, std::vector<TIndex>& indexBuffer) {
         XrSceneMeshBuffersGetInfoMSFT meshGetInfo{XR_TYPE_SCENE_MESH_BUFFERS_GET_INFO_MSFT};
         meshGetInfo.meshBufferId = meshBufferId;
 
         XrSceneMeshBuffersMSFT meshBuffers{XR_TYPE_SCENE_MESH_BUFFERS_MSFT};
         XrSceneMeshVertexBufferMSFT vertices{XR_TYPE_SCENE_MESH_VERTEX_BUFFER_MSFT};
-        XrSceneMeshIndicesUint32MSFT indices{XR_TYPE_SCENE_MESH_INDICES_UINT32_MSFT};
+        typename detail::SceneMeshIndices<TIndex>::Type indices{detail::SceneMeshIndices<TIndex>::StructureType};
         xr::InsertExtensionStruct(meshBuffers, vertices);
         xr::InsertExtensionStruct(meshBuffers, indices);
-        CHECK_XRCMD(xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
 
-        vertexBuffer.resize(vertices.vertexCountOutput);
-        indexBuffer.resize(indices.indexCountOutput);
-        vertices.vertexCapacityInput = vertices.vertexCountOutput;
-        indices.indexCapacityInput = indices.indexCountOutput;
-        vertices.vertices = vertexBuffer.data();
-        indices.indices = indexBuffer.data();
-        CHECK_XRCMD(xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
-        vertexBuffer.resize(vertices.vertexCountOutput);
-        indexBuffer.resize(indices.indexCountOutput);
-    }
-
-    // Reads mesh vertices and 16-bit indices.
-    inline void
-    ReadMeshBuffers(XrSceneMSFT scene, uint64_t meshBufferId, std::vector<XrVector3f>& vertexBuffer, std::vector<uint16_t>& indexBuffer) {
-        XrSceneMeshBuffersGetInfoMSFT meshGetInfo{XR_TYPE_SCENE_MESH_BUFFERS_GET_INFO_MSFT};
-        meshGetInfo.meshBufferId = meshBufferId;
+        const auto readBuffers = [&](size_t vertexCapacity, size_t indexCapacity) {
+            vertexBuffer.resize(vertexCapacity);
+            indexBuffer.resize(indexCapacity);
+            vertices.vertexCapacityInput = static_cast<uint32_t>(vertexCapacity);
+            indices.indexCapacityInput = static_cast<uint32_t>(indexCapacity);
+            vertices.vertices = vertexCapacity > 0 ? vertexBuffer.data() : nullptr;
+            indices.indices = indexCapacity > 0 ? indexBuffer.data() : nullptr;
+            return xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers);
+        };
+
+        XrResult result = XR_ERROR_SIZE_INSUFFICIENT;
+        if (vertexBuffer.capacity() > 0 && indexBuffer.capacity() > 0) {
+            result = readBuffers(vertexBuffer.capacity(), indexBuffer.capacity());
+        }
 
-        XrSceneMeshBuffersMSFT meshBuffers{XR_TYPE_SCENE_MESH_BUFFERS_MSFT};
-        XrSceneMeshVertexBufferMSFT vertices{XR_TYPE_SCENE_MESH_VERTEX_BUFFER_MSFT};
-        XrSceneMeshIndicesUint16MSFT indices{XR_TYPE_SCENE_MESH_INDICES_UINT16_MSFT};
-        xr::InsertExtensionStruct(meshBuffers, vertices);
-        xr::InsertExtensionStruct(meshBuffers, indices);
-        CHECK_XRCMD(xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
+        if (result == XR_ERROR_SIZE_INSUFFICIENT) {
+            // Query the required sizes, then read again into large enough buffers.
+            CHECK_XRCMD(readBuffers(0, 0));
+            result = readBuffers(vertices.vertexCountOutput, indices.indexCountOutput);
+        }
+        CHECK_XRRESULT(result, "xrGetSceneMeshBuffersMSFT");
 
         vertexBuffer.resize(vertices.vertexCountOutput);
         indexBuffer.resize(indices.indexCountOutput);
-        vertices.vertexCapacityInput = vertices.vertexCountOutput;
-        indices.indexCapacityInput = indices.indexCountOutput;
-        vertices.vertices = vertexBuffer.data();
-        indices.indices = indexBuffer.data();
-        CHECK_XRCMD(xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
-        vertexBuffer.resize(vertices.vertexCountOutput);
-        indexBuffer.resize(indices.indexCountOutput);
     }
 } // namespace xr
@@ -344,6 +344,202 @@ namespace xr::su {
         CHECK_XRCMD(xrLocateSceneComponentsMSFT(scene, &locateInfo, &componentLocations));
     }
 
+    // Reads scene components into caller-owned vectors, reusing its own scratch buffers for the runtime structures.
+    // The number of components read by previous calls is used as the capacity of the first xrGetSceneComponentsMSFT call,
+    // so the count query is skipped unless the scene has more components than any scene read before.
+    // A reader is not thread-safe. Use one reader per thread.
+    struct SceneComponentReader {
+        void GetObjects(XrSceneMSFT scene, std::vector<SceneObject>& objects, const std::vector<SceneObject::Type>& filterObjectType = {}) {
+            ComponentsGetInfo getInfo(XR_SCENE_COMPONENT_TYPE_OBJECT_MSFT, {}, filterObjectType);
+            XrSceneObjectsMSFT sceneObjects{XR_TYPE_SCENE_OBJECTS_MSFT};
+            const uint32_t count = ReadComponents(
+                scene, getInfo.getInfo, sceneObjects, &XrSceneObjectsMSFT::sceneObjectCount, &XrSceneObjectsMSFT::sceneObjects, m_objects);
+
+            objects.resize(count);
+            for (uint32_t k = 0; k < count; k++) {
+                objects[k].id = m_components[k].id;
+                objects[k].parentId = m_components[k].parentId;
+                objects[k].updateTime = m_components[k].updateTime;
+                objects[k].type = m_objects[k].objectType;
+            }
+        }
+
+        void GetPlanes(XrSceneMSFT scene,
+                       std::vector<ScenePlane>& planes,
+                       std::optional<SceneObject::Id> parentId = {},
+                       const std::vector<SceneObject::Type>& filterObjectType = {},
+                       const std::vector<ScenePlane::Alignment>& filterAlignment = {}) {
+            ComponentsGetInfo getInfo(XR_SCENE_COMPONENT_TYPE_PLANE_MSFT, parentId, filterObjectType, filterAlignment);
+            XrScenePlanesMSFT scenePlanes{XR_TYPE_SCENE_PLANES_MSFT};
+            const uint32_t count = ReadComponents(
+                scene, getInfo.getInfo, scenePlanes, &XrScenePlanesMSFT::scenePlaneCount, &XrScenePlanesMSFT::scenePlanes, m_planes);
+
+            planes.resize(count);
+            for (uint32_t k = 0; k < count; k++) {
+                planes[k].id = m_components[k].id;
+                planes[k].parentId = m_components[k].parentId;
+                planes[k].updateTime = m_components[k].updateTime;
+                planes[k].alignment = m_planes[k].alignment;
+                planes[k].size = m_planes[k].size;
+                planes[k].meshBufferId = m_planes[k].meshBufferId;
+                planes[k].supportsIndicesUint16 = m_planes[k].supportsIndicesUint16;
+            }
+        }
+
+        void GetVisualMeshes(XrSceneMSFT scene,
+                             std::vector<SceneMesh>& meshes,
+                             std::optional<SceneObject::Id> parentId = {},
+                             const std::vector<SceneObject::Type>& filterObjectType = {}) {
+            ReadMeshes(scene, XR_SCENE_COMPONENT_TYPE_VISUAL_MESH_MSFT, meshes, parentId, filterObjectType);
+        }
+
+        void GetColliderMeshes(XrSceneMSFT scene,
+                               std::vector<SceneColliderMesh>& meshes,
+                               std::optional<SceneObject::Id> parentId = {},
+                               const std::vector<SceneObject::Type>& filterObjectType = {}) {
+            ReadMeshes(scene, XR_SCENE_COMPONENT_TYPE_COLLIDER_MESH_MSFT, meshes, parentId, filterObjectType);
+        }
+
+        void GetQRCodes(XrSceneMSFT scene, std::vector<SceneQRCode>& qrCodes) {
+            static const std::vector<XrSceneMarkerTypeMSFT> markerTypes{XR_SCENE_MARKER_TYPE_QR_CODE_MSFT};
+            ComponentsGetInfo getInfo(XR_SCENE_COMPONENT_TYPE_MARKER_MSFT, {}, {});
+            XrSceneMarkerTypeFilterMSFT typesFilter{XR_TYPE_SCENE_MARKER_TYPE_FILTER_MSFT};
+            typesFilter.markerTypeCount = static_cast<uint32_t>(markerTypes.size());
+            typesFilter.markerTypes = markerTypes.data();
+            xr::InsertExtensionStruct(getInfo.getInfo, typesFilter);
+
+            // The QR code structure is chained after the marker structure and uses the same capacity.
+            XrSceneMarkerQRCodesMSFT sceneQRCodes{XR_TYPE_SCENE_MARKER_QR_CODES_MSFT};
+            XrSceneMarkersMSFT sceneMarkers{XR_TYPE_SCENE_MARKERS_MSFT};
+            xr::InsertExtensionStruct(sceneMarkers, sceneQRCodes);
+            const uint32_t count = ReadComponents(
+                scene,
+                getInfo.getInfo,
+                sceneMarkers,
+                &XrSceneMarkersMSFT::sceneMarkerCapacityInput,
+                &XrSceneMarkersMSFT::sceneMarkers,
+                m_markers,
+                [&](uint32_t capacity) {
+                    m_qrCodes.resize(std::max<size_t>(m_qrCodes.size(), capacity));
+                    sceneQRCodes.qrCodeCapacityInput = capacity;
+                    sceneQRCodes.qrCodes = capacity > 0 ? m_qrCodes.data() : nullptr;
+                });
+
+            qrCodes.resize(count);
+            for (uint32_t k = 0; k < count; k++) {
+                SceneQRCode& qrCode = qrCodes[k];
+                qrCode.id = m_components[k].id;
+                qrCode.markerType = m_markers[k].markerType;
+                qrCode.lastSeenTime = m_markers[k].lastSeenTime;
+                qrCode.center = m_markers[k].center;
+                qrCode.size = m_markers[k].size;
+                qrCode.symbolType = m_qrCodes[k].symbolType;
+                qrCode.qrVersion = m_qrCodes[k].version;
+            }
+        }
+
+    private:
+        // Holds the get info structure and the filters chained to it.
+        struct ComponentsGetInfo {
+            ComponentsGetInfo(XrSceneComponentTypeMSFT componentType,
+                              std::optional<SceneObject::Id> parentId,
+                              const std::vector<SceneObject::Type>& filterObjectType,
+                              const std::vector<ScenePlane::Alignment>& filterAlignment = {}) {
+                getInfo.componentType = componentType;
+                if (parentId.has_value()) {
+                    parentFilter.parentId = static_cast<XrUuidMSFT>(parentId.value());
+                    xr::InsertExtensionStruct(getInfo, parentFilter);
+                }
+                if (!filterObjectType.empty()) {
+                    typesFilter.objectTypeCount = static_cast<uint32_t>(filterObjectType.size());
+                    typesFilter.objectTypes = filterObjectType.data();
+                    xr::InsertExtensionStruct(getInfo, typesFilter);
+                }
+                if (!filterAlignment.empty()) {
+                    alignmentFilter.alignmentCount = static_cast<uint32_t>(filterAlignment.size());
+                    alignmentFilter.alignments = filterAlignment.data();
+                    xr::InsertExtensionStruct(getInfo, alignmentFilter);
+                }
+            }
+
+            ComponentsGetInfo(const ComponentsGetInfo&) = delete;
+            ComponentsGetInfo& operator=(const ComponentsGetInfo&) = delete;
+
+            XrSceneComponentsGetInfoMSFT getInfo{XR_TYPE_SCENE_COMPONENTS_GET_INFO_MSFT};
+            XrSceneComponentParentFilterInfoMSFT parentFilter{XR_TYPE_SCENE_COMPONENT_PARENT_FILTER_INFO_MSFT};
+            XrSceneObjectTypesFilterInfoMSFT typesFilter{XR_TYPE_SCENE_OBJECT_TYPES_FILTER_INFO_MSFT};
+            XrScenePlaneAlignmentFilterInfoMSFT alignmentFilter{XR_TYPE_SCENE_PLANE_ALIGNMENT_FILTER_INFO_MSFT};
+        };
+
+        // Reads the components and their type specific structures into the scratch buffers and returns the number of components.
+        // Only the first returned number of elements of the scratch buffers are valid.
+        template <typename TExtension, typename TElement, typename TPrepare = void (*)(uint32_t)>
+        uint32_t ReadComponents(
+            XrSceneMSFT scene,
+            const XrSceneComponentsGetInfoMSFT& getInfo,
+            TExtension& extension,
+            uint32_t TExtension::*capacityMember,
+            TElement* TExtension::*elementsMember,
+            std::vector<TElement>& elements,
+            TPrepare prepareChainedBuffers = [](uint32_t) {}) {
+            XrSceneComponentsMSFT sceneComponents{XR_TYPE_SCENE_COMPONENTS_MSFT};
+            sceneComponents.next = &extension; // Keeps structures already chained to the extension.
+
+            const auto read = [&](uint32_t capacity) {
+                m_components.resize(std::max<size_t>(m_components.size(), capacity));
+                elements.resize(std::max<size_t>(elements.size(), capacity));
+                sceneComponents.componentCapacityInput = capacity;
+                sceneComponents.components = capacity > 0 ? m_components.data() : nullptr;
+                extension.*capacityMember = capacity;
+                extension.*elementsMember = capacity > 0 ? elements.data() : nullptr;
+                prepareChainedBuffers(capacity);
+                return xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents);
+            };
+
+            XrResult result = XR_ERROR_SIZE_INSUFFICIENT;
+            const uint32_t capacityHint = static_cast<uint32_t>(m_components.size());
+            if (capacityHint > 0) {
+                result = read(capacityHint);
+            }
+
+            if (result == XR_ERROR_SIZE_INSUFFICIENT) {
+                // Query the number of components, then read again into large enough buffers.
+                CHECK_XRCMD(read(0));
+                result = read(sceneComponents.componentCountOutput);
+            }
+            CHECK_XRRESULT(result, "xrGetSceneComponentsMSFT");
+            return sceneComponents.componentCountOutput;
+        }
+
+        template <typename TMesh>
+        void ReadMeshes(XrSceneMSFT scene,
+                        XrSceneComponentTypeMSFT componentType,
+                        std::vector<TMesh>& meshes,
+                        std::optional<SceneObject::Id> parentId,
+                        const std::vector<SceneObject::Type>& filterObjectType) {
+            ComponentsGetInfo getInfo(componentType, parentId, filterObjectType);
+            XrSceneMeshesMSFT sceneMeshes{XR_TYPE_SCENE_MESHES_MSFT};
+            const uint32_t count = ReadComponents(
+                scene, getInfo.getInfo, sceneMeshes, &XrSceneMeshesMSFT::sceneMeshCount, &XrSceneMeshesMSFT::sceneMeshes, m_meshes);
+
+            meshes.resize(count);
+            for (uint32_t k = 0; k < count; k++) {
+                meshes[k].id = m_components[k].id;
+                meshes[k].parentId = m_components[k].parentId;
+                meshes[k].updateTime = m_components[k].updateTime;
+                meshes[k].meshBufferId = m_meshes[k].meshBufferId;
+                meshes[k].supportsIndicesUint16 = m_meshes[k].supportsIndicesUint16;
+            }
+        }
+
+        std::vector<XrSceneComponentMSFT> m_components;
+        std::vector<XrSceneObjectMSFT> m_objects;
+        std::vector<XrScenePlaneMSFT> m_planes;
+        std::vector<XrSceneMeshMSFT> m_meshes;
+        std::vector<XrSceneMarkerMSFT> m_markers;
+        std::vector<XrSceneMarkerQRCodeMSFT> m_qrCodes;
+    };
+
     // C++ wrapper for XrSceneMSFT
     struct Scene {
         Scene(XrSceneObserverMSFT sceneObserver)
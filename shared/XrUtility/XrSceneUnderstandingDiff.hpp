@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <XrUtility/XrSceneUnderstanding.hpp>
+
+// Incremental diffing of scene understanding components between two computed scenes.
+namespace xr::su {
+    // Changes of one type of scene component between the previous and the current scene.
+    // Components are reported in the order of the current scene, except for removed components which are in the order of the previous scene.
+    template <typename TComponent>
+    struct SceneComponentDiff {
+        std::vector<TComponent> added;           // Components that were not in the previous scene.
+        std::vector<TComponent> removed;         // Components of the previous scene that are not in the current scene.
+        std::vector<TComponent> geometryUpdated; // Components whose geometry changed and must be read again.
+        std::vector<TComponent> poseUpdated;     // Components updated by the runtime with unchanged geometry.
+        std::vector<TComponent> unchanged;       // Components with the same update time as in the previous scene.
+
+        bool HasChanges() const noexcept {
+            return !added.empty() || !removed.empty() || !geometryUpdated.empty() || !poseUpdated.empty();
+        }
+    };
+
+    // Returns true if the geometry of the two versions of a component differs.
+    // Mesh buffer ids identify the content of a mesh buffer, so an unchanged id means ReadMeshBuffers can be skipped.
+    inline bool HasGeometryChanged(const ScenePlane& previous, const ScenePlane& current) noexcept {
+        return previous.meshBufferId != current.meshBufferId || previous.alignment != current.alignment ||
+               previous.size.width != current.size.width || previous.size.height != current.size.height;
+    }
+
+    inline bool HasGeometryChanged(const SceneMesh& previous, const SceneMesh& current) noexcept {
+        return previous.meshBufferId != current.meshBufferId;
+    }
+
+    inline bool HasGeometryChanged(const SceneColliderMesh& previous, const SceneColliderMesh& current) noexcept {
+        return previous.meshBufferId != current.meshBufferId;
+    }
+
+    inline bool HasGeometryChanged(const SceneObject& previous, const SceneObject& current) noexcept {
+        return previous.type != current.type; // Scene objects have no geometry, but their visuals depend on the type.
+    }
+
+    // Remembers the components of the last processed scene and computes the differences with the next one.
+    // Components are keyed by id, so the same physical surface is tracked across scenes computed by the same scene observer.
+    template <typename TComponent>
+    struct SceneComponentTracker {
+        using Id = typename TComponent::Id;
+
+        // Compute the differences between the last processed components and the given ones, then remember the given ones.
+        SceneComponentDiff<TComponent> Update(const std::vector<TComponent>& components) {
+            SceneComponentDiff<TComponent> diff;
+
+            std::unordered_map<Id, size_t> currentIndices;
+            currentIndices.reserve(components.size());
+            for (size_t i = 0; i < components.size(); i++) {
+                const TComponent& component = components[i];
+                currentIndices.emplace(component.id, i);
+
+                const auto previousIt = m_previousIndices.find(component.id);
+                if (previousIt == m_previousIndices.end()) {
+                    diff.added.push_back(component);
+                    continue;
+                }
+
+                const TComponent& previous = m_previous[previousIt->second];
+                if (HasGeometryChanged(previous, component)) {
+                    diff.geometryUpdated.push_back(component);
+                } else if (previous.updateTime != component.updateTime) {
+                    diff.poseUpdated.push_back(component);
+                } else {
+                    diff.unchanged.push_back(component);
+                }
+            }
+
+            for (const TComponent& previous : m_previous) {
+                if (currentIndices.count(previous.id) == 0) {
+                    diff.removed.push_back(previous);
+                }
+            }
+
+            m_previous = components;
+            m_previousIndices = std::move(currentIndices);
+            return diff;
+        }
+
+        // Find a component of the last processed scene.
+        const TComponent* Find(const Id& id) const {
+            const auto it = m_previousIndices.find(id);
+            return it == m_previousIndices.end() ? nullptr : &m_previous[it->second];
+        }
+
+        const std::vector<TComponent>& Components() const noexcept {
+            return m_previous;
+        }
+
+        // Forget the last processed scene, so that all components are reported as added by the next update.
+        void Reset() {
+            m_previous.clear();
+            m_previousIndices.clear();
+        }
+
+    private:
+        std::vector<TComponent> m_previous;
+        std::unordered_map<Id, size_t> m_previousIndices;
+    };
+} // namespace xr::su
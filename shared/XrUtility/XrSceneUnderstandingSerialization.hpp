@@ -34,15 +34,37 @@ namespace xr::su {
         return result;
     }
 
-    inline std::vector<uint8_t> ReadSceneFragmentData(XrSceneMSFT scene, const SceneFragment::Id& id) {
+    // Read the serialized data of a scene fragment into the given buffer, reusing its capacity.
+    inline void ReadSceneFragmentData(XrSceneMSFT scene, const SceneFragment::Id& id, std::vector<uint8_t>& buffer) {
         uint32_t readOutput = 0;
         XrSerializedSceneFragmentDataGetInfoMSFT getInfo{XR_TYPE_SERIALIZED_SCENE_FRAGMENT_DATA_GET_INFO_MSFT};
         getInfo.sceneFragmentId = static_cast<XrUuidMSFT>(id);
         CHECK_XRCMD(xrGetSerializedSceneFragmentDataMSFT(scene, &getInfo, 0, &readOutput, nullptr));
 
-        std::vector<uint8_t> buffer(readOutput);
+        buffer.resize(readOutput);
         CHECK_XRCMD(xrGetSerializedSceneFragmentDataMSFT(scene, &getInfo, readOutput, &readOutput, buffer.data()));
+        buffer.resize(readOutput);
+    }
+
+    inline std::vector<uint8_t> ReadSceneFragmentData(XrSceneMSFT scene, const SceneFragment::Id& id) {
+        std::vector<uint8_t> buffer;
+        ReadSceneFragmentData(scene, id, buffer);
         return buffer;
     }
 
+    // Start deserializing previously saved scene fragments. The result is retrieved like a computed scene:
+    // wait until the scene observer reports that the scene compute completed, then create a scene.
+    inline void DeserializeScene(XrSceneObserverMSFT sceneObserver, const std::vector<std::vector<uint8_t>>& fragments) {
+        std::vector<XrDeserializeSceneFragmentMSFT> fragmentInfos;
+        fragmentInfos.reserve(fragments.size());
+        for (const std::vector<uint8_t>& fragment : fragments) {
+            fragmentInfos.push_back({static_cast<uint32_t>(fragment.size()), fragment.data()});
+        }
+
+        XrSceneDeserializeInfoMSFT deserializeInfo{XR_TYPE_SCENE_DESERIALIZE_INFO_MSFT};
+        deserializeInfo.fragmentCount = static_cast<uint32_t>(fragmentInfos.size());
+        deserializeInfo.fragments = fragmentInfos.data();
+        CHECK_XRCMD(xrDeserializeSceneMSFT(sceneObserver, &deserializeInfo));
+    }
+
 } // namespace xr::su
@@ -0,0 +1,451 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <DirectXCollision.h>
+#include <XrUtility/XrMath.h>
+#include <XrUtility/XrUuid.h>
+
+// Bounding volume hierarchy over scene understanding planes and meshes for ray and overlap queries on the CPU.
+namespace xr::su {
+    struct SpatialRay {
+        XrVector3f origin;
+        XrVector3f direction; // Does not need to be normalized.
+        float maxDistance{std::numeric_limits<float>::max()};
+    };
+
+    struct SpatialHit {
+        XrUuidMSFT componentId;
+        float distance;
+        XrVector3f position;
+        XrVector3f normal; // Facing towards the ray origin.
+    };
+
+    // Triangles of all components are stored in the space the component poses are given in, usually the app space.
+    // After adding, removing or moving components, Update() must be called before querying. Moving components only refits the
+    // bounds of the hierarchy, while adding or removing components rebuilds it.
+    class SceneSpatialIndex {
+    public:
+        // Add or replace a plane, as a quad of the given size centered on the pose and facing +Z.
+        void AddOrUpdatePlane(const XrUuidMSFT& id, const XrPosef& pose, const XrExtent2Df& size) {
+            const float halfWidth = size.width / 2.0f;
+            const float halfHeight = size.height / 2.0f;
+            const DirectX::XMFLOAT3 v0{-halfWidth, -halfHeight, 0};
+            const DirectX::XMFLOAT3 v1{-halfWidth, halfHeight, 0};
+            const DirectX::XMFLOAT3 v2{halfWidth, halfHeight, 0};
+            const DirectX::XMFLOAT3 v3{halfWidth, -halfHeight, 0};
+            AddOrUpdateComponent(id, pose, {v0, v1, v2, v3, v2, v0});
+        }
+
+        // Add or replace a triangle mesh given in the local space of the pose, e.g. from xr::ReadMeshBuffers.
+        template <typename TIndex>
+        void AddOrUpdateMesh(const XrUuidMSFT& id,
+                             const XrPosef& pose,
+                             const std::vector<XrVector3f>& vertices,
+                             const std::vector<TIndex>& indices) {
+            std::vector<DirectX::XMFLOAT3> localVertices;
+            localVertices.reserve(indices.size() - indices.size() % 3);
+            for (size_t index = 2; index < indices.size(); index += 3) {
+                for (size_t k = index - 2; k <= index; k++) {
+                    const XrVector3f& vertex = vertices.at(indices[k]);
+                    localVertices.emplace_back(vertex.x, vertex.y, vertex.z);
+                }
+            }
+            AddOrUpdateComponent(id, pose, std::move(localVertices));
+        }
+
+        // Move a component. Returns false if the component is not in the index.
+        bool SetPose(const XrUuidMSFT& id, const XrPosef& pose) {
+            Component* component = FindComponent(id);
+            if (component == nullptr) {
+                return false;
+            }
+
+            if (memcmp(&component->pose, &pose, sizeof(XrPosef)) != 0) {
+                component->pose = pose;
+                component->poseChanged = true;
+                m_boundsChanged = true;
+            }
+            return true;
+        }
+
+        // Disabled components stay in the hierarchy but are ignored by queries, e.g. while their pose is not valid.
+        void SetEnabled(const XrUuidMSFT& id, bool enabled) {
+            if (Component* component = FindComponent(id)) {
+                component->enabled = enabled;
+            }
+        }
+
+        void Remove(const XrUuidMSFT& id) {
+            const auto it = m_componentIndices.find(id);
+            if (it == m_componentIndices.end()) {
+                return;
+            }
+
+            const size_t index = it->second;
+            m_componentIndices.erase(it);
+            if (index != m_components.size() - 1) {
+                m_components[index] = std::move(m_components.back());
+                m_componentIndices[m_components[index].id] = index;
+            }
+            m_components.pop_back();
+            m_structureChanged = true;
+        }
+
+        void Clear() {
+            m_components.clear();
+            m_componentIndices.clear();
+            m_structureChanged = true;
+        }
+
+        // Rebuild or refit the hierarchy after components were changed.
+        void Update() {
+            if (m_structureChanged) {
+                Rebuild();
+            } else if (m_boundsChanged) {
+                Refit();
+            }
+            m_structureChanged = false;
+            m_boundsChanged = false;
+        }
+
+        size_t ComponentCount() const noexcept {
+            return m_components.size();
+        }
+
+        size_t TriangleCount() const noexcept {
+            return m_triangles.size();
+        }
+
+        // Find the closest hit along the ray.
+        std::optional<SpatialHit> RaycastClosest(const SpatialRay& ray) const {
+            std::optional<SpatialHit> hit;
+            Raycast(ray, false /*anyHit*/, &hit);
+            return hit;
+        }
+
+        // Return true if anything is hit along the ray. Faster than RaycastClosest because traversal stops at the first hit.
+        bool RaycastAny(const SpatialRay& ray) const {
+            return Raycast(ray, true /*anyHit*/, nullptr);
+        }
+
+        // Find the closest hit for each ray.
+        void RaycastClosest(const std::vector<SpatialRay>& rays, std::vector<std::optional<SpatialHit>>& hits) const {
+            hits.resize(rays.size());
+            for (size_t i = 0; i < rays.size(); i++) {
+                hits[i].reset();
+                Raycast(rays[i], false /*anyHit*/, &hits[i]);
+            }
+        }
+
+        // Collect the ids of enabled components with at least one triangle intersecting the sphere. Each id is reported once.
+        void OverlapSphere(const XrVector3f& center, float radius, std::vector<XrUuidMSFT>& componentIds) const {
+            componentIds.clear();
+            if (m_nodes.empty()) {
+                return;
+            }
+
+            const DirectX::BoundingSphere sphere({center.x, center.y, center.z}, radius);
+            std::vector<bool> reported(m_components.size(), false);
+
+            uint32_t stack[MaxStackDepth];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0) {
+                const Node& node = m_nodes[stack[--stackSize]];
+                if (!node.bounds.Intersects(sphere)) {
+                    continue;
+                }
+
+                if (node.triangleCount == 0) {
+                    stack[stackSize++] = node.rightChild;
+                    stack[stackSize++] = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+                    continue;
+                }
+
+                for (uint32_t i = node.firstTriangle; i < node.firstTriangle + node.triangleCount; i++) {
+                    const Triangle& triangle = m_triangles[m_triangleIndices[i]];
+                    if (reported[triangle.component] || !m_components[triangle.component].enabled) {
+                        continue;
+                    }
+
+                    using namespace DirectX;
+                    if (sphere.Intersects(XMLoadFloat3(&triangle.v0), XMLoadFloat3(&triangle.v1), XMLoadFloat3(&triangle.v2))) {
+                        reported[triangle.component] = true;
+                        componentIds.push_back(m_components[triangle.component].id);
+                    }
+                }
+            }
+        }
+
+    private:
+        static constexpr uint32_t MaxLeafTriangles = 4;
+        static constexpr uint32_t MaxStackDepth = 64; // Median splits keep the depth at log2 of the triangle count.
+
+        struct Component {
+            XrUuidMSFT id;
+            XrPosef pose;
+            std::vector<DirectX::XMFLOAT3> localVertices; // Three vertices per triangle.
+            uint32_t firstTriangle{0};
+            bool enabled{true};
+            bool poseChanged{true};
+        };
+
+        struct Triangle {
+            DirectX::XMFLOAT3 v0, v1, v2;
+            uint32_t component;
+        };
+
+        // Nodes are stored depth-first, so the left child of an inner node immediately follows it.
+        struct Node {
+            DirectX::BoundingBox bounds;
+            uint32_t firstTriangle{0};
+            uint32_t triangleCount{0}; // Zero for inner nodes.
+            uint32_t rightChild{0};
+        };
+
+        void AddOrUpdateComponent(const XrUuidMSFT& id, const XrPosef& pose, std::vector<DirectX::XMFLOAT3> localVertices) {
+            const auto [it, added] = m_componentIndices.emplace(id, m_components.size());
+            if (added) {
+                m_components.emplace_back();
+            }
+
+            Component& component = m_components[it->second];
+            component.id = id;
+            component.pose = pose;
+            component.localVertices = std::move(localVertices);
+            component.poseChanged = true;
+            m_structureChanged = true;
+        }
+
+        Component* FindComponent(const XrUuidMSFT& id) {
+            const auto it = m_componentIndices.find(id);
+            return it == m_componentIndices.end() ? nullptr : &m_components[it->second];
+        }
+
+        void TransformTriangles(Component& component, uint32_t componentIndex) {
+            using namespace DirectX;
+            const XMMATRIX transform = xr::math::LoadXrPose(component.pose);
+            const auto transformVertex = [&](const XMFLOAT3& local, XMFLOAT3& world) {
+                XMStoreFloat3(&world, XMVector3Transform(XMLoadFloat3(&local), transform));
+            };
+
+            const size_t triangleCount = component.localVertices.size() / 3;
+            for (size_t k = 0; k < triangleCount; k++) {
+                Triangle& triangle = m_triangles[component.firstTriangle + k];
+                transformVertex(component.localVertices[k * 3 + 0], triangle.v0);
+                transformVertex(component.localVertices[k * 3 + 1], triangle.v1);
+                transformVertex(component.localVertices[k * 3 + 2], triangle.v2);
+                triangle.component = componentIndex;
+            }
+            component.poseChanged = false;
+        }
+
+        void Rebuild() {
+            size_t triangleCount = 0;
+            for (Component& component : m_components) {
+                component.firstTriangle = static_cast<uint32_t>(triangleCount);
+                triangleCount += component.localVertices.size() / 3;
+            }
+
+            m_triangles.resize(triangleCount);
+            for (uint32_t i = 0; i < m_components.size(); i++) {
+                TransformTriangles(m_components[i], i);
+            }
+
+            m_triangleIndices.resize(triangleCount);
+            std::iota(m_triangleIndices.begin(), m_triangleIndices.end(), 0);
+
+            m_centroids.resize(triangleCount);
+            for (size_t i = 0; i < triangleCount; i++) {
+                using namespace DirectX;
+                const Triangle& triangle = m_triangles[i];
+                XMStoreFloat3(&m_centroids[i],
+                              (XMLoadFloat3(&triangle.v0) + XMLoadFloat3(&triangle.v1) + XMLoadFloat3(&triangle.v2)) / 3.0f);
+            }
+
+            m_nodes.clear();
+            if (triangleCount > 0) {
+                m_nodes.reserve(2 * triangleCount / MaxLeafTriangles + 1);
+                BuildNode(0, static_cast<uint32_t>(triangleCount));
+            }
+        }
+
+        uint32_t BuildNode(uint32_t first, uint32_t count) {
+            const uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+            m_nodes[nodeIndex].bounds = ComputeTriangleBounds(first, count);
+
+            if (count <= MaxLeafTriangles) {
+                m_nodes[nodeIndex].firstTriangle = first;
+                m_nodes[nodeIndex].triangleCount = count;
+                return nodeIndex;
+            }
+
+            // Split at the median centroid along the longest axis of the centroid bounds.
+            DirectX::XMFLOAT3 minCentroid = m_centroids[m_triangleIndices[first]];
+            DirectX::XMFLOAT3 maxCentroid = minCentroid;
+            for (uint32_t i = first; i < first + count; i++) {
+                const DirectX::XMFLOAT3& centroid = m_centroids[m_triangleIndices[i]];
+                minCentroid = {std::min(minCentroid.x, centroid.x), std::min(minCentroid.y, centroid.y), std::min(minCentroid.z, centroid.z)};
+                maxCentroid = {std::max(maxCentroid.x, centroid.x), std::max(maxCentroid.y, centroid.y), std::max(maxCentroid.z, centroid.z)};
+            }
+            const float extents[3] = {maxCentroid.x - minCentroid.x, maxCentroid.y - minCentroid.y, maxCentroid.z - minCentroid.z};
+            const int axis = static_cast<int>(std::max_element(std::begin(extents), std::end(extents)) - std::begin(extents));
+            const auto axisValue = [&](uint32_t triangleIndex) {
+                const DirectX::XMFLOAT3& centroid = m_centroids[triangleIndex];
+                return axis == 0 ? centroid.x : (axis == 1 ? centroid.y : centroid.z);
+            };
+
+            const uint32_t middle = first + count / 2;
+            std::nth_element(m_triangleIndices.begin() + first,
+                             m_triangleIndices.begin() + middle,
+                             m_triangleIndices.begin() + first + count,
+                             [&](uint32_t a, uint32_t b) { return axisValue(a) < axisValue(b); });
+
+            BuildNode(first, middle - first);
+            const uint32_t rightChild = BuildNode(middle, first + count - middle);
+            m_nodes[nodeIndex].rightChild = rightChild; // Not a reference since m_nodes may have been reallocated.
+            return nodeIndex;
+        }
+
+        void Refit() {
+            for (uint32_t i = 0; i < m_components.size(); i++) {
+                if (m_components[i].poseChanged) {
+                    TransformTriangles(m_components[i], i);
+                }
+            }
+
+            // Children are stored after their parents, so visiting the nodes backwards updates children first.
+            for (size_t i = m_nodes.size(); i-- > 0;) {
+                Node& node = m_nodes[i];
+                if (node.triangleCount > 0) {
+                    node.bounds = ComputeTriangleBounds(node.firstTriangle, node.triangleCount);
+                } else {
+                    DirectX::BoundingBox::CreateMerged(node.bounds, m_nodes[i + 1].bounds, m_nodes[node.rightChild].bounds);
+                }
+            }
+        }
+
+        DirectX::BoundingBox ComputeTriangleBounds(uint32_t first, uint32_t count) const {
+            using namespace DirectX;
+            XMVECTOR minimum = g_XMFltMax;
+            XMVECTOR maximum = XMVectorNegate(g_XMFltMax);
+            for (uint32_t i = first; i < first + count; i++) {
+                const Triangle& triangle = m_triangles[m_triangleIndices[i]];
+                for (const XMFLOAT3* vertex : {&triangle.v0, &triangle.v1, &triangle.v2}) {
+                    const XMVECTOR v = XMLoadFloat3(vertex);
+                    minimum = XMVectorMin(minimum, v);
+                    maximum = XMVectorMax(maximum, v);
+                }
+            }
+
+            BoundingBox bounds;
+            BoundingBox::CreateFromPoints(bounds, minimum, maximum);
+            return bounds;
+        }
+
+        bool Raycast(const SpatialRay& ray, bool anyHit, std::optional<SpatialHit>* closestHit) const {
+            using namespace DirectX;
+            if (m_nodes.empty()) {
+                return false;
+            }
+
+            const XMVECTOR origin = xr::math::LoadXrVector3(ray.origin);
+            const XMVECTOR direction = XMVector3Normalize(xr::math::LoadXrVector3(ray.direction));
+            if (XMVector3Equal(direction, XMVectorZero())) {
+                return false;
+            }
+
+            float closestDistance = ray.maxDistance;
+            const Triangle* closestTriangle = nullptr;
+
+            uint32_t stack[MaxStackDepth];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0) {
+                const uint32_t nodeIndex = stack[--stackSize];
+                const Node& node = m_nodes[nodeIndex];
+
+                float boxDistance = 0;
+                if (!node.bounds.Intersects(origin, direction, boxDistance) || boxDistance > closestDistance) {
+                    continue;
+                }
+
+                if (node.triangleCount == 0) {
+                    // Visit the nearer child first so that farther subtrees are more likely to be culled by the closest hit.
+                    uint32_t nearChild = nodeIndex + 1;
+                    uint32_t farChild = node.rightChild;
+                    float nearDistance = 0, farDistance = 0;
+                    const bool nearHit = m_nodes[nearChild].bounds.Intersects(origin, direction, nearDistance);
+                    const bool farHit = m_nodes[farChild].bounds.Intersects(origin, direction, farDistance);
+                    if (nearHit && farHit && farDistance < nearDistance) {
+                        std::swap(nearChild, farChild);
+                    }
+                    if (farHit || nearHit) {
+                        stack[stackSize++] = farChild;
+                        stack[stackSize++] = nearChild;
+                    }
+                    continue;
+                }
+
+                for (uint32_t i = node.firstTriangle; i < node.firstTriangle + node.triangleCount; i++) {
+                    const Triangle& triangle = m_triangles[m_triangleIndices[i]];
+                    if (!m_components[triangle.component].enabled) {
+                        continue;
+                    }
+
+                    float distance = 0;
+                    if (TriangleTests::Intersects(
+                            origin, direction, XMLoadFloat3(&triangle.v0), XMLoadFloat3(&triangle.v1), XMLoadFloat3(&triangle.v2), distance) &&
+                        distance <= closestDistance) {
+                        if (anyHit) {
+                            return true;
+                        }
+                        closestDistance = distance;
+                        closestTriangle = &triangle;
+                    }
+                }
+            }
+
+            if (closestTriangle == nullptr) {
+                return false;
+            }
+
+            if (closestHit != nullptr) {
+                const XMVECTOR v0 = XMLoadFloat3(&closestTriangle->v0);
+                XMVECTOR normal = XMVector3Normalize(
+                    XMVector3Cross(XMLoadFloat3(&closestTriangle->v1) - v0, XMLoadFloat3(&closestTriangle->v2) - v0));
+                if (XMVectorGetX(XMVector3Dot(normal, direction)) > 0) {
+                    normal = -normal;
+                }
+
+                SpatialHit& hit = closestHit->emplace();
+                hit.componentId = m_components[closestTriangle->component].id;
+                hit.distance = closestDistance;
+                xr::math::StoreXrVector3(&hit.position, origin + direction * closestDistance);
+                xr::math::StoreXrVector3(&hit.normal, normal);
+            }
+            return true;
+        }
+
+        std::vector<Component> m_components;
+        std::unordered_map<XrUuidMSFT, size_t> m_componentIndices;
+
+        std::vector<Triangle> m_triangles;            // Grouped by component, see Component::firstTriangle.
+        std::vector<uint32_t> m_triangleIndices;      // Triangles ordered by leaf node.
+        std::vector<DirectX::XMFLOAT3> m_centroids;   // Only used while building.
+        std::vector<Node> m_nodes;
+
+        bool m_structureChanged{false};
+        bool m_boundsChanged{false};
+    };
+} // namespace xr::su
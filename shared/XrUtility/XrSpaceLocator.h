@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "XrError.h"
+#include "XrMath.h"
+
+namespace xr {
+
+    struct SpaceLocation {
+        XrSpaceLocationFlags LocationFlags{0};
+        XrPosef Pose{xr::math::Pose::Identity()};
+        XrSpaceVelocityFlags VelocityFlags{0};
+        XrVector3f LinearVelocity{0, 0, 0};
+        XrVector3f AngularVelocity{0, 0, 0};
+    };
+
+    // Locates many spaces against one base space per frame with a single runtime call.
+    // Uses xrLocateSpacesKHR when XR_KHR_locate_spaces is enabled, and falls back to one xrLocateSpace per space otherwise.
+    //
+    // Spaces are either located directly with LocateSpaces, or registered once and located together by Locate every frame.
+    // Registered results are kept in a flat array in registration order, and read through the registration.
+    // Registration and reading are thread safe. The space of a registration must stay alive until the registration is released.
+    class SpaceLocator {
+    public:
+        using Id = uint32_t;
+
+        // Unregisters its space when destroyed. Must not outlive the locator.
+        class Registration {
+        public:
+            Registration() = default;
+            Registration(Registration&& other) noexcept
+                : m_locator(std::exchange(other.m_locator, nullptr))
+                , m_id(other.m_id) {
+            }
+            Registration& operator=(Registration&& other) noexcept {
+                if (this != &other) {
+                    Reset();
+                    m_locator = std::exchange(other.m_locator, nullptr);
+                    m_id = other.m_id;
+                }
+                return *this;
+            }
+            Registration(const Registration&) = delete;
+            Registration& operator=(const Registration&) = delete;
+
+            ~Registration() {
+                Reset();
+            }
+
+            void Reset() {
+                if (m_locator != nullptr) {
+                    std::exchange(m_locator, nullptr)->Unregister(m_id);
+                }
+            }
+
+            // The location from the last call to Locate, or an invalid location if the space was registered after it.
+            SpaceLocation Location() const {
+                return m_locator != nullptr ? m_locator->GetLocation(m_id) : SpaceLocation{};
+            }
+
+            explicit operator bool() const {
+                return m_locator != nullptr;
+            }
+
+        private:
+            friend class SpaceLocator;
+            Registration(SpaceLocator* locator, Id id)
+                : m_locator(locator)
+                , m_id(id) {
+            }
+
+            SpaceLocator* m_locator{nullptr};
+            Id m_id{0};
+        };
+
+        SpaceLocator(XrSession session, bool locateSpacesExtensionEnabled)
+            : m_session(session)
+            , m_locateSpacesExtensionEnabled(locateSpacesExtensionEnabled) {
+        }
+
+        SpaceLocator(const SpaceLocator&) = delete;
+        SpaceLocator& operator=(const SpaceLocator&) = delete;
+
+        [[nodiscard]] Registration Register(XrSpace space) {
+            std::lock_guard lock(m_mutex);
+            Id id;
+            if (m_freeIds.empty()) {
+                id = static_cast<Id>(m_idToIndex.size());
+                m_idToIndex.push_back(0);
+            } else {
+                id = m_freeIds.back();
+                m_freeIds.pop_back();
+            }
+
+            m_idToIndex[id] = static_cast<uint32_t>(m_spaces.size());
+            m_spaces.push_back(space);
+            m_locations.emplace_back();
+            m_indexToId.push_back(id);
+            return Registration(this, id);
+        }
+
+        // Locates all registered spaces.
+        void Locate(XrSpace baseSpace, XrTime time) {
+            std::lock_guard lock(m_mutex);
+            LocateSpacesLocked(baseSpace, time, static_cast<uint32_t>(m_spaces.size()), m_spaces.data(), m_locations.data());
+        }
+
+        // Locates the given spaces without registering them.
+        void LocateSpaces(XrSpace baseSpace, XrTime time, uint32_t spaceCount, const XrSpace* spaces, SpaceLocation* locations) {
+            std::lock_guard lock(m_mutex);
+            LocateSpacesLocked(baseSpace, time, spaceCount, spaces, locations);
+        }
+
+        size_t Size() const {
+            std::lock_guard lock(m_mutex);
+            return m_spaces.size();
+        }
+
+    private:
+        void LocateSpacesLocked(XrSpace baseSpace, XrTime time, uint32_t spaceCount, const XrSpace* spaces, SpaceLocation* locations) {
+            if (spaceCount == 0) {
+                return;
+            }
+
+#ifdef XR_KHR_locate_spaces
+            if (m_locateSpacesExtensionEnabled) {
+                m_locationData.resize(spaceCount);
+                m_velocityData.resize(spaceCount);
+
+                XrSpacesLocateInfoKHR locateInfo{XR_TYPE_SPACES_LOCATE_INFO_KHR};
+                locateInfo.baseSpace = baseSpace;
+                locateInfo.time = time;
+                locateInfo.spaceCount = spaceCount;
+                locateInfo.spaces = spaces;
+
+                XrSpaceVelocitiesKHR velocities{XR_TYPE_SPACE_VELOCITIES_KHR};
+                velocities.velocityCount = spaceCount;
+                velocities.velocities = m_velocityData.data();
+                XrSpaceLocationsKHR spaceLocations{XR_TYPE_SPACE_LOCATIONS_KHR, &velocities};
+                spaceLocations.locationCount = spaceCount;
+                spaceLocations.locations = m_locationData.data();
+                CHECK_XRCMD(xrLocateSpacesKHR(m_session, &locateInfo, &spaceLocations));
+
+                for (uint32_t i = 0; i < spaceCount; i++) {
+                    locations[i] = {m_locationData[i].locationFlags,
+                                    m_locationData[i].pose,
+                                    m_velocityData[i].velocityFlags,
+                                    m_velocityData[i].linearVelocity,
+                                    m_velocityData[i].angularVelocity};
+                }
+                return;
+            }
+#endif
+
+            for (uint32_t i = 0; i < spaceCount; i++) {
+                XrSpaceVelocity velocity{XR_TYPE_SPACE_VELOCITY};
+                XrSpaceLocation location{XR_TYPE_SPACE_LOCATION, &velocity};
+                CHECK_XRCMD(xrLocateSpace(spaces[i], baseSpace, time, &location));
+                locations[i] = {
+                    location.locationFlags, location.pose, velocity.velocityFlags, velocity.linearVelocity, velocity.angularVelocity};
+            }
+        }
+
+        void Unregister(Id id) {
+            // Keep the arrays dense by moving the last space into the hole.
+            std::lock_guard lock(m_mutex);
+            const uint32_t index = m_idToIndex[id];
+            const uint32_t lastIndex = static_cast<uint32_t>(m_spaces.size() - 1);
+            if (index != lastIndex) {
+                m_spaces[index] = m_spaces[lastIndex];
+                m_locations[index] = m_locations[lastIndex];
+                m_indexToId[index] = m_indexToId[lastIndex];
+                m_idToIndex[m_indexToId[index]] = index;
+            }
+            m_spaces.pop_back();
+            m_locations.pop_back();
+            m_indexToId.pop_back();
+            m_freeIds.push_back(id);
+        }
+
+        SpaceLocation GetLocation(Id id) const {
+            std::lock_guard lock(m_mutex);
+            return m_locations[m_idToIndex[id]];
+        }
+
+        const XrSession m_session;
+        const bool m_locateSpacesExtensionEnabled;
+        mutable std::mutex m_mutex;
+
+        std::vector<XrSpace> m_spaces;
+        std::vector<SpaceLocation> m_locations;
+        std::vector<Id> m_indexToId;
+        std::vector<uint32_t> m_idToIndex;
+        std::vector<Id> m_freeIds;
+
+#ifdef XR_KHR_locate_spaces
+        std::vector<XrSpaceLocationDataKHR> m_locationData;
+        std::vector<XrSpaceVelocityDataKHR> m_velocityData;
+#endif
+    };
+
+} // namespace xr
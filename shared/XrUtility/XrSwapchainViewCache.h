@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace xr {
+
+    struct SwapchainImageViewKey {
+        uint32_t ArraySlice{0};
+        int64_t Format{0}; // The graphics API format of the view, which may differ from a typeless swapchain format.
+
+        bool operator==(const SwapchainImageViewKey& other) const {
+            return ArraySlice == other.ArraySlice && Format == other.Format;
+        }
+    };
+
+    // Caches the views that rendering creates on the images of a swapchain, e.g. render target views, so that they are created
+    // once per image, array slice and format instead of every frame. The graphics API is abstracted by the view type and the
+    // function that creates a view. The cache must be reset whenever the swapchain is recreated, since a new swapchain may
+    // reuse the handle of the old one.
+    template <typename TView>
+    class SwapchainImageViewCache {
+    public:
+        using CreateViewFunction = std::function<TView(uint32_t imageIndex, const SwapchainImageViewKey& key)>;
+
+        // Drops the views of the previous swapchain, and creates the views of the given keys for all images of the new one.
+        void Reset(uint32_t imageCount, CreateViewFunction createView, const std::vector<SwapchainImageViewKey>& keys = {}) {
+            m_images.clear();
+            m_images.resize(imageCount);
+            m_createView = std::move(createView);
+            m_generation++;
+
+            for (uint32_t imageIndex = 0; imageIndex < imageCount; imageIndex++) {
+                for (const SwapchainImageViewKey& key : keys) {
+                    Get(imageIndex, key);
+                }
+            }
+        }
+
+        void Clear() {
+            m_images.clear();
+            m_createView = nullptr;
+            m_generation++;
+        }
+
+        // The view for the image, which is created on first use when it was not among the keys given to Reset.
+        // The returned reference is valid until the next call to Get, Reset or Clear.
+        const TView& Get(uint32_t imageIndex, const SwapchainImageViewKey& key) {
+            std::vector<Entry>& entries = m_images.at(imageIndex);
+            for (const Entry& entry : entries) {
+                if (entry.Key == key) {
+                    return entry.View;
+                }
+            }
+
+            m_createdViewCount++;
+            return entries.emplace_back(Entry{key, m_createView(imageIndex, key)}).View;
+        }
+
+        uint32_t ImageCount() const {
+            return static_cast<uint32_t>(m_images.size());
+        }
+
+        // Incremented whenever the cached views are dropped, so that users can tell that their views were invalidated.
+        uint64_t Generation() const {
+            return m_generation;
+        }
+
+        uint64_t CreatedViewCount() const {
+            return m_createdViewCount;
+        }
+
+    private:
+        struct Entry {
+            SwapchainImageViewKey Key;
+            TView View;
+        };
+
+        // Only a few views are created per image, so a linear search is faster than hashing.
+        std::vector<std::vector<Entry>> m_images;
+        CreateViewFunction m_createView;
+        uint64_t m_generation{0};
+        uint64_t m_createdViewCount{0};
+    };
+} // namespace xr
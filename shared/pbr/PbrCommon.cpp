@@ -2,6 +2,7 @@
 // Copyright (C) Microsoft Corporation.  All Rights Reserved
 // Licensed under the MIT License. See License.txt in the project root for license information.
 #include "pch.h"
+#include <algorithm>
 #include <sstream>
 // Implementation is in the Gltf library so this isn't needed: #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -11,6 +12,45 @@ using namespace DirectX;
 
 #define TRIANGLE_VERTEX_COUNT 3 // #define so it can be used in lambdas without capture
 
+namespace {
+    // Byte size of a single surface. Block compressed formats are rounded up to whole 4x4 blocks.
+    uint64_t GetFormatByteSize(DXGI_FORMAT format, uint32_t width, uint32_t height) {
+        const uint64_t blocks = uint64_t{(width + 3) / 4} * ((height + 3) / 4);
+        switch (format) {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            return blocks * 8;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return blocks * 16;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            return uint64_t{width} * height * 16;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R32G32_FLOAT:
+            return uint64_t{width} * height * 8;
+        case DXGI_FORMAT_R8G8_UNORM:
+        case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_D16_UNORM:
+            return uint64_t{width} * height * 2;
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_A8_UNORM:
+            return uint64_t{width} * height;
+        default:
+            return uint64_t{width} * height * 4; // Most formats used by the samples are 32 bits per pixel.
+        }
+    }
+} // namespace
+
 namespace Pbr {
     namespace Internal {
         void ThrowIfFailed(HRESULT hr) {
@@ -343,5 +383,39 @@ namespace Pbr {
             Pbr::Internal::ThrowIfFailed(device->CreateSamplerState(&samplerDesc, samplerState.put()));
             return samplerState;
         }
+
+        uint64_t GetTextureByteSize(_In_ ID3D11ShaderResourceView* textureView) {
+            winrt::com_ptr<ID3D11Resource> resource;
+            textureView->GetResource(resource.put());
+            const winrt::com_ptr<ID3D11Texture2D> texture2D = resource.try_as<ID3D11Texture2D>();
+            if (!texture2D) {
+                return 0; // Only 2D textures are used by PBR materials.
+            }
+
+            D3D11_TEXTURE2D_DESC desc;
+            texture2D->GetDesc(&desc);
+
+            uint64_t bytes = 0;
+            uint32_t width = desc.Width;
+            uint32_t height = desc.Height;
+            for (uint32_t mip = 0; mip < std::max(desc.MipLevels, 1u); mip++) {
+                bytes += GetFormatByteSize(desc.Format, width, height);
+                width = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+            return bytes * desc.ArraySize * std::max(desc.SampleDesc.Count, 1u);
+        }
     } // namespace Texture
+
+    namespace Internal {
+        uint64_t GetBufferByteSize(_In_opt_ ID3D11Buffer* buffer) {
+            if (buffer == nullptr) {
+                return 0;
+            }
+
+            D3D11_BUFFER_DESC desc;
+            buffer->GetDesc(&desc);
+            return desc.ByteWidth;
+        }
+    } // namespace Internal
 } // namespace Pbr
@@ -103,5 +103,12 @@ namespace Pbr {
                                                                DXGI_FORMAT format);
         winrt::com_ptr<ID3D11SamplerState> CreateSampler(_In_ ID3D11Device* device,
                                                          D3D11_TEXTURE_ADDRESS_MODE addressMode = D3D11_TEXTURE_ADDRESS_CLAMP);
+
+        // Estimate the GPU memory used by the texture resource behind the given view, including all mips and array slices.
+        uint64_t GetTextureByteSize(_In_ ID3D11ShaderResourceView* textureView);
     } // namespace Texture
+
+    namespace Internal {
+        uint64_t GetBufferByteSize(_In_opt_ ID3D11Buffer* buffer);
+    }
 } // namespace Pbr
@@ -8,10 +8,16 @@
 
 using namespace DirectX;
 
+namespace {
+    uint32_t ToBits(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+} // namespace
+
 namespace Pbr {
-    Material::Material(Pbr::Resources const& pbrResources) {
-        const CD3D11_BUFFER_DESC constantBufferDesc(sizeof(ConstantBufferData), D3D11_BIND_CONSTANT_BUFFER);
-        Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.put()));
+    Material::Material(Pbr::Resources const& /*pbrResources*/) {
     }
 
     std::shared_ptr<Material> Material::Clone(Pbr::Resources const& pbrResources) const {
@@ -23,6 +29,10 @@ namespace Pbr {
         clone->m_samplers = m_samplers;
         clone->m_alphaBlended = m_alphaBlended;
         clone->m_doubleSided = m_doubleSided;
+        clone->m_wireframe = m_wireframe;
+        clone->m_bindingsChanged = m_bindingsChanged;
+        clone->m_bindings = m_bindings;
+        clone->m_bindingsGeneration = m_bindingsGeneration;
         return clone;
     }
 
@@ -64,51 +74,98 @@ namespace Pbr {
         if (sampler) {
             m_samplers[slot].copy_from(sampler);
         }
+
+        m_bindingsChanged = true;
     }
 
     void Material::SetDoubleSided(bool doubleSided) {
         m_doubleSided = doubleSided;
+        m_pipelineState = InvalidPipelineStateId;
     }
 
     void Material::SetWireframe(bool wireframeMode) {
         m_wireframe = wireframeMode;
+        m_pipelineState = InvalidPipelineStateId;
     }
 
     void Material::SetAlphaBlended(bool alphaBlended) {
         m_alphaBlended = alphaBlended;
+        m_pipelineState = InvalidPipelineStateId;
     }
 
-    void Material::Bind(_In_ ID3D11DeviceContext* context, const Resources& pbrResources) const {
-        // If the parameters of the constant buffer have changed, update the constant buffer.
-        if (m_parametersChanged) {
-            m_parametersChanged = false;
-            context->UpdateSubresource(m_constantBuffer.get(), 0, nullptr, &m_parameters, 0, 0);
+    void Material::Bind(RenderDevice& device, const Resources& pbrResources) const {
+        // Only build and look up the pipeline state again when the material or the pass changed since the last bind.
+        if (m_pipelineState == InvalidPipelineStateId || m_passGeneration != pbrResources.PassGeneration()) {
+            PipelineStateDesc pipelineStateDesc = pbrResources.GetPassPipelineStateDesc();
+            pipelineStateDesc.AlphaBlended = m_alphaBlended;
+            pipelineStateDesc.DepthWriteDisabled = m_alphaBlended;
+            pipelineStateDesc.DoubleSided = m_doubleSided;
+            if (m_wireframe) {
+                pipelineStateDesc.Fill = FillMode::Wireframe;
+            }
+
+            m_pipelineState = pbrResources.PipelineStates().GetOrCreate(pipelineStateDesc);
+            m_passGeneration = pbrResources.PassGeneration();
         }
-
-        pbrResources.SetBlendState(context, m_alphaBlended);
-        pbrResources.SetDepthStencilState(context, m_alphaBlended);
-        pbrResources.SetRasterizerState(context, m_doubleSided, m_wireframe);
-
-        ID3D11Buffer* psConstantBuffers[] = {m_constantBuffer.get()};
-        context->PSSetConstantBuffers(Pbr::ShaderSlots::ConstantBuffers::Material, 1, psConstantBuffers);
-
-        static_assert(Pbr::ShaderSlots::BaseColor == 0, "BaseColor must be the first slot");
-
-        std::array<ID3D11ShaderResourceView*, TextureCount> textures;
-        std::transform(m_textures.begin(), m_textures.end(), textures.begin(), [](const auto& texture) { return texture.get(); });
-        context->PSSetShaderResources(Pbr::ShaderSlots::BaseColor, (UINT)textures.size(), textures.data());
-
-        std::array<ID3D11SamplerState*, TextureCount> samplers;
-        std::transform(m_samplers.begin(), m_samplers.end(), samplers.begin(), [](const auto& sampler) { return sampler.get(); });
-        context->PSSetSamplers(Pbr::ShaderSlots::BaseColor, (UINT)samplers.size(), samplers.data());
+        pbrResources.BindPipelineState(device, m_pipelineState);
+
+        // Rather than writing to the material table, intern the changed content to share the GPU resources of equal materials.
+        MaterialRegistry& registry = pbrResources.Materials();
+        if (m_bindingsChanged || !m_bindings || m_bindingsGeneration != registry.Generation()) {
+            std::shared_ptr<const MaterialParameterSlot> parameters = registry.InternParameters(GetParameterKey(), &m_parameters);
+
+            std::array<ShaderResourceViewHandle, TextureCount> textures;
+            std::transform(
+                m_textures.begin(), m_textures.end(), textures.begin(), [](const auto& texture) { return ToHandle(texture.get()); });
+            std::array<SamplerHandle, TextureCount> samplers;
+            std::transform(
+                m_samplers.begin(), m_samplers.end(), samplers.begin(), [](const auto& sampler) { return ToHandle(sampler.get()); });
+
+            m_bindings = registry.InternBindings(std::move(parameters), textures, samplers);
+            m_bindingsChanged = false;
+            m_bindingsGeneration = registry.Generation();
+        }
+        pbrResources.BindMaterial(device, m_bindings);
     }
 
     Material::ConstantBufferData& Material::Parameters() {
-        m_parametersChanged = true;
+        m_bindingsChanged = true;
         return m_parameters;
     }
 
     const Material::ConstantBufferData& Material::Parameters() const {
         return m_parameters;
     }
+
+    MaterialParameterKey Material::GetParameterKey() const {
+        const ConstantBufferData& p = m_parameters;
+        return {ToBits(p.BaseColorFactor.x),
+                ToBits(p.BaseColorFactor.y),
+                ToBits(p.BaseColorFactor.z),
+                ToBits(p.BaseColorFactor.w),
+                ToBits(p.MetallicFactor),
+                ToBits(p.RoughnessFactor),
+                ToBits(p.EmissiveFactor.x),
+                ToBits(p.EmissiveFactor.y),
+                ToBits(p.EmissiveFactor.z),
+                ToBits(p.NormalScale),
+                ToBits(p.OcclusionStrength),
+                ToBits(p.AlphaCutoff)};
+    }
+
+    void Material::AppendMemoryFootprint(AssetFootprint& footprint, std::unordered_set<const void*>& countedResources) const {
+        if (countedResources.insert(this).second) {
+            footprint.push_back({this, {sizeof(Material), 0}});
+        }
+
+        // The parameters are shared with equal materials and only take up the material table once the material was bound.
+        if (m_bindings && countedResources.insert(m_bindings->Parameters.get()).second) {
+            footprint.push_back({m_bindings->Parameters.get(), {0, sizeof(ConstantBufferData)}});
+        }
+        for (const winrt::com_ptr<ID3D11ShaderResourceView>& texture : m_textures) {
+            if (texture && countedResources.insert(texture.get()).second) {
+                footprint.push_back({texture.get(), {0, Texture::GetTextureByteSize(texture.get())}});
+            }
+        }
+    }
 } // namespace Pbr
@@ -6,6 +6,7 @@
 #include <vector>
 #include <array>
 #include <map>
+#include <unordered_set>
 #include <memory>
 #include <winrt/base.h>
 #include <d3d11.h>
@@ -13,6 +14,7 @@
 #include <DirectXMath.h>
 #include <DirectXColors.h>
 #include "PbrResources.h"
+#include "PbrResidency.h"
 
 namespace Pbr {
     // A Material contains the metallic roughness parameters and textures.
@@ -21,6 +23,7 @@ namespace Pbr {
 #pragma warning(push)
 #pragma warning(disable:4324)
         // Coefficients used by the shader. Each texture is sampled and multiplied by these coefficients.
+        // The shader reads them from the material table, with the layout of its MaterialParameters struct.
         struct ConstantBufferData {
             // packoffset(c0)
             alignas(16) RGBAColor BaseColorFactor{1, 1, 1, 1};
@@ -37,8 +40,10 @@ namespace Pbr {
 #pragma warning(pop)
 
         static_assert((sizeof(ConstantBufferData) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
+        static_assert(sizeof(ConstantBufferData) == 64, "Must match the size of MaterialParameters in PbrPixelShader.hlsl");
 
-        // Create a uninitialized material. Textures and shader coefficients must be set.
+        // Create a uninitialized material. Textures and shader coefficients must be set. The GPU resources of the parameters are
+        // shared with materials of equal content and created on first bind.
         Material(Pbr::Resources const& pbrResources);
 
         // Create a clone of this material.
@@ -60,26 +65,42 @@ namespace Pbr {
         void SetWireframe(bool wireframeMode);
         void SetAlphaBlended(bool alphaBlended);
 
-        // Bind this material to current context.
-        void Bind(_In_ ID3D11DeviceContext* context, const Resources& pbrResources) const;
+        // Bind this material to the render device.
+        void Bind(RenderDevice& device, const Resources& pbrResources) const;
 
+        // Materials with equal parameters share one element of the material table, so changing the parameters gives this
+        // material its own.
         ConstantBufferData& Parameters();
         const ConstantBufferData& Parameters() const;
 
+        // Append the estimated memory of the material and its textures to footprint. Resources already in countedResources are
+        // skipped and newly appended resources are added to it, so textures shared between materials are only listed once.
+        void AppendMemoryFootprint(AssetFootprint& footprint, std::unordered_set<const void*>& countedResources) const;
+
         std::string Name;
         bool Hidden{false};
 
     private:
-        mutable bool m_parametersChanged{true};
+        MaterialParameterKey GetParameterKey() const;
+
         ConstantBufferData m_parameters;
 
         bool m_alphaBlended{false};
         bool m_doubleSided{false};
-        bool m_wireframe{false};
+        bool m_wireframe{false}; // Wireframe regardless of the fill mode of the PBR resources.
+
+        // Looked up for the pass generation of the PBR resources, and reset when the pipeline state of the material changes.
+        mutable PipelineStateId m_pipelineState{InvalidPipelineStateId};
+        mutable uint32_t m_passGeneration{0};
 
         static constexpr size_t TextureCount = ShaderSlots::LastMaterialSlot + 1;
+        static_assert(TextureCount == MaterialTextureCount, "The material registry must cover all material slots");
         std::array<winrt::com_ptr<ID3D11ShaderResourceView>, TextureCount> m_textures;
         std::array<winrt::com_ptr<ID3D11SamplerState>, TextureCount> m_samplers;
-        winrt::com_ptr<ID3D11Buffer> m_constantBuffer;
+
+        // Interned from the parameters, textures and samplers when they changed since the last bind.
+        mutable bool m_bindingsChanged{true};
+        mutable std::shared_ptr<const MaterialBindings> m_bindings;
+        mutable uint32_t m_bindingsGeneration{0};
     };
 } // namespace Pbr
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include "PbrMaterialParameterTable.h"
+
+namespace Pbr {
+    MaterialParameterTable::MaterialParameterTable(uint32_t elementByteSize)
+        : m_elementByteSize(elementByteSize) {
+    }
+
+    void MaterialParameterTable::Allocate(const void* data, uint32_t* indexOwner) {
+        std::lock_guard guard(m_mutex);
+
+        uint32_t index;
+        if (!m_free.empty()) {
+            index = *m_free.begin();
+            m_free.erase(m_free.begin());
+        } else {
+            index = Size();
+            m_owners.push_back(nullptr);
+            m_data.resize(m_data.size() + m_elementByteSize);
+        }
+
+        memcpy(m_data.data() + static_cast<size_t>(index) * m_elementByteSize, data, m_elementByteSize);
+        m_owners[index] = indexOwner;
+        *indexOwner = index;
+        MarkDirty(index);
+    }
+
+    void MaterialParameterTable::Free(const uint32_t* indexOwner) {
+        std::lock_guard guard(m_mutex);
+
+        const uint32_t index = *indexOwner;
+        if (index >= Size() || m_owners[index] != indexOwner) {
+            throw std::invalid_argument("The element is not owned by the given index");
+        }
+
+        m_owners[index] = nullptr;
+        m_free.insert(index);
+        TrimFreeTail();
+    }
+
+    size_t MaterialParameterTable::Compact() {
+        std::lock_guard guard(m_mutex);
+
+        size_t movedCount = 0;
+        while (!m_free.empty()) {
+            // The tail is trimmed after each change, so the last element is in use and the free elements are below it.
+            const uint32_t from = Size() - 1;
+            const uint32_t to = *m_free.begin();
+            m_free.erase(m_free.begin());
+
+            memcpy(m_data.data() + static_cast<size_t>(to) * m_elementByteSize,
+                   m_data.data() + static_cast<size_t>(from) * m_elementByteSize,
+                   m_elementByteSize);
+            m_owners[to] = m_owners[from];
+            *m_owners[to] = to;
+            m_owners[from] = nullptr;
+            m_free.insert(from);
+            MarkDirty(to);
+            TrimFreeTail();
+            movedCount++;
+        }
+        return movedCount;
+    }
+
+    bool MaterialParameterTable::IsFragmented() const {
+        std::lock_guard guard(m_mutex);
+        return m_free.size() * 2 > Size();
+    }
+
+    void MaterialParameterTable::MarkDirty(uint32_t index) {
+        if (m_dirtyBegin >= m_dirtyEnd) {
+            m_dirtyBegin = index;
+            m_dirtyEnd = index + 1;
+        } else {
+            m_dirtyBegin = std::min(m_dirtyBegin, index);
+            m_dirtyEnd = std::max(m_dirtyEnd, index + 1);
+        }
+    }
+
+    void MaterialParameterTable::TrimFreeTail() {
+        while (!m_owners.empty() && m_owners.back() == nullptr) {
+            m_free.erase(Size() - 1);
+            m_owners.pop_back();
+            m_data.resize(m_data.size() - m_elementByteSize);
+        }
+
+        // Elements beyond the end no longer need to be uploaded.
+        m_dirtyEnd = std::min(m_dirtyEnd, Size());
+    }
+} // namespace Pbr
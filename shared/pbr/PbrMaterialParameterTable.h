@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace Pbr {
+    // The CPU copy of a table of fixed size elements, e.g. the parameters of all materials, which the shaders read from one
+    // structured buffer. It tracks the range of elements that changed since the last upload, so that only that range is copied
+    // to the GPU. Freed elements are reused lowest first, and Compact moves elements into freed ones so the table stays dense.
+    //
+    // Each element has an owner, the index variable of whoever allocated it, which is rewritten when Compact moves the element.
+    // Thread safe, elements can be freed from any thread.
+    class MaterialParameterTable {
+    public:
+        explicit MaterialParameterTable(uint32_t elementByteSize);
+
+        // Copies the element into the table and writes its index to indexOwner, which must stay valid until it is freed.
+        void Allocate(const void* data, uint32_t* indexOwner);
+
+        // Frees the element whose index indexOwner holds.
+        void Free(const uint32_t* indexOwner);
+
+        // Moves the last elements into freed elements until none are left below the end of the table. Returns the number moved.
+        size_t Compact();
+
+        // Whether less than half of the table is in use, so that Compact would shrink it by at least half.
+        bool IsFragmented() const;
+
+        // Calls upload(data, elementCount, dirtyBegin, dirtyEnd) with the whole table and the range of elements which changed since
+        // the last upload, if any did. The table is locked during the call.
+        template <typename TUpload>
+        bool Upload(TUpload&& upload) {
+            std::lock_guard guard(m_mutex);
+            if (m_dirtyBegin >= m_dirtyEnd) {
+                return false;
+            }
+
+            upload(static_cast<const void*>(m_data.data()), Size(), m_dirtyBegin, m_dirtyEnd);
+            m_dirtyBegin = m_dirtyEnd = 0;
+            return true;
+        }
+
+        bool IsDirty() const {
+            std::lock_guard guard(m_mutex);
+            return m_dirtyBegin < m_dirtyEnd;
+        }
+
+        uint32_t ElementByteSize() const {
+            return m_elementByteSize;
+        }
+
+        // The number of elements up to the last element in use.
+        uint32_t ElementCount() const {
+            std::lock_guard guard(m_mutex);
+            return Size();
+        }
+
+        uint32_t LiveElementCount() const {
+            std::lock_guard guard(m_mutex);
+            return Size() - static_cast<uint32_t>(m_free.size());
+        }
+
+    private:
+        uint32_t Size() const {
+            return static_cast<uint32_t>(m_owners.size());
+        }
+
+        void MarkDirty(uint32_t index);
+        void TrimFreeTail();
+
+        const uint32_t m_elementByteSize;
+        mutable std::mutex m_mutex;
+        std::vector<uint8_t> m_data;
+        std::vector<uint32_t*> m_owners; // By element, null for freed elements.
+        std::set<uint32_t> m_free;       // Freed elements below the end of the table.
+        uint32_t m_dirtyBegin{0};
+        uint32_t m_dirtyEnd{0};
+    };
+} // namespace Pbr
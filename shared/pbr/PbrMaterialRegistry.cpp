@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include "PbrMaterialRegistry.h"
+
+namespace Pbr {
+    MaterialRegistry::MaterialRegistry(uint32_t parameterByteSize)
+        : m_parameterByteSize(parameterByteSize)
+        , m_parameterTable(std::make_shared<MaterialParameterTable>(parameterByteSize)) {
+    }
+
+    std::shared_ptr<const MaterialParameterSlot> MaterialRegistry::InternParameters(const MaterialParameterKey& key, const void* data) {
+        return m_parameterSlots.Intern(key, [&] {
+            auto slot = std::make_unique<MaterialParameterSlot>();
+            m_parameterTable->Allocate(data, &slot->Index);
+
+            // The table is replaced on Clear, after which the slots of the old table have nothing to free.
+            std::weak_ptr<MaterialParameterTable> table = m_parameterTable;
+            return std::shared_ptr<const MaterialParameterSlot>(slot.release(), [table](const MaterialParameterSlot* slot) {
+                if (const std::shared_ptr<MaterialParameterTable> lockedTable = table.lock()) {
+                    lockedTable->Free(&slot->Index);
+                }
+                delete slot;
+            });
+        });
+    }
+
+    std::shared_ptr<const MaterialBindings> MaterialRegistry::InternBindings(
+        std::shared_ptr<const MaterialParameterSlot> parameters,
+        const std::array<ShaderResourceViewHandle, MaterialTextureCount>& textures,
+        const std::array<SamplerHandle, MaterialTextureCount>& samplers) {
+        BindingsKey key;
+        key[0] = parameters.get();
+        for (size_t i = 0; i < MaterialTextureCount; i++) {
+            key[1 + i] = textures[i].Object;
+            key[1 + MaterialTextureCount + i] = samplers[i].Object;
+        }
+
+        return m_bindings.Intern(key, [&] {
+            return std::make_shared<const MaterialBindings>(MaterialBindings{std::move(parameters), textures, samplers});
+        });
+    }
+
+    size_t MaterialRegistry::Trim() {
+        return m_bindings.Trim() + m_parameterSlots.Trim();
+    }
+
+    size_t MaterialRegistry::ParameterSlotCount() const {
+        return m_parameterSlots.Size();
+    }
+
+    size_t MaterialRegistry::BindingsCount() const {
+        return m_bindings.Size();
+    }
+
+    void MaterialRegistry::Clear() {
+        m_bindings.Clear();
+        m_parameterSlots.Clear();
+        m_parameterTable = std::make_shared<MaterialParameterTable>(m_parameterByteSize);
+        m_generation++;
+    }
+} // namespace Pbr
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include "PbrMaterialParameterTable.h"
+#include "PbrRenderDevice.h"
+
+namespace Pbr {
+    // Hashes a fixed size array of integers or pointers, e.g. the key of an InternTable.
+    struct ArrayHash {
+        template <typename T, size_t N>
+        size_t operator()(const std::array<T, N>& values) const {
+            uint64_t hash = 14695981039346656037ull; // FNV-1a over the values rather than their bytes.
+            for (const T& value : values) {
+                if constexpr (std::is_pointer_v<T>) {
+                    hash = (hash ^ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value))) * 1099511628211ull;
+                } else {
+                    hash = (hash ^ static_cast<uint64_t>(value)) * 1099511628211ull;
+                }
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    // Hands out one shared, immutable value per distinct key. Values are created on first use by create(), which returns a
+    // shared pointer so that values can release what they hold with a custom deleter. They are released when the last
+    // reference to them goes away, after which the same key creates a new value. Thread safe.
+    template <typename TKey, typename TValue, typename THash = std::hash<TKey>>
+    class InternTable {
+    public:
+        template <typename TCreate>
+        std::shared_ptr<const TValue> Intern(const TKey& key, TCreate&& create) {
+            std::lock_guard guard(m_mutex);
+            std::weak_ptr<const TValue>& entry = m_entries[key];
+            if (std::shared_ptr<const TValue> value = entry.lock()) {
+                return value;
+            }
+
+            std::shared_ptr<const TValue> value = create();
+            entry = value;
+
+            // Remove the entries of released values once the table doubled in size since the last time.
+            if (m_entries.size() >= m_trimThreshold) {
+                TrimLocked();
+                m_trimThreshold = std::max<size_t>(MinTrimThreshold, m_entries.size() * 2);
+            }
+            return value;
+        }
+
+        // Removes the entries of released values. Returns the number removed.
+        size_t Trim() {
+            std::lock_guard guard(m_mutex);
+            return TrimLocked();
+        }
+
+        // The number of entries, including those of released values which were not trimmed yet.
+        size_t Size() const {
+            std::lock_guard guard(m_mutex);
+            return m_entries.size();
+        }
+
+        void Clear() {
+            std::lock_guard guard(m_mutex);
+            m_entries.clear();
+        }
+
+    private:
+        static constexpr size_t MinTrimThreshold = 64;
+
+        size_t TrimLocked() {
+            size_t removedCount = 0;
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                if (it->second.expired()) {
+                    it = m_entries.erase(it);
+                    removedCount++;
+                } else {
+                    ++it;
+                }
+            }
+            return removedCount;
+        }
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<TKey, std::weak_ptr<const TValue>, THash> m_entries;
+        size_t m_trimThreshold{MinTrimThreshold};
+    };
+
+    constexpr size_t MaterialTextureCount = 5; // One per ShaderSlots::PSMaterial.
+
+    // The bit patterns of the material parameters without padding, so that equal parameters hash and compare equal.
+    using MaterialParameterKey = std::array<uint32_t, 12>;
+
+    // The element of the material parameter table holding some parameters, shared by all materials with those parameters.
+    // The element is freed when the last material releases it.
+    struct MaterialParameterSlot {
+        uint32_t Index{0}; // Changes when the table is compacted.
+    };
+
+    // What a material binds to the pixel shader, shared by all materials with the same parameters, textures and samplers.
+    // The flags of a material are part of its pipeline state instead.
+    struct MaterialBindings {
+        std::shared_ptr<const MaterialParameterSlot> Parameters;
+        std::array<ShaderResourceViewHandle, MaterialTextureCount> Textures;
+        std::array<SamplerHandle, MaterialTextureCount> Samplers;
+    };
+
+    // Interns the GPU content of materials, so that materials with equal content share one element of the parameter table and
+    // one set of bindings. A material that changes its parameters interns them again rather than writing to the shared element.
+    class MaterialRegistry {
+    public:
+        explicit MaterialRegistry(uint32_t parameterByteSize);
+
+        std::shared_ptr<const MaterialParameterSlot> InternParameters(const MaterialParameterKey& key, const void* data);
+
+        // Texture and sampler handles are compared by identity, so materials must hold the objects behind them.
+        std::shared_ptr<const MaterialBindings> InternBindings(std::shared_ptr<const MaterialParameterSlot> parameters,
+                                                               const std::array<ShaderResourceViewHandle, MaterialTextureCount>& textures,
+                                                               const std::array<SamplerHandle, MaterialTextureCount>& samplers);
+
+        // The parameters of all interned materials, which the shaders index by MaterialParameterSlot::Index.
+        MaterialParameterTable& ParameterTable() const {
+            return *m_parameterTable;
+        }
+
+        size_t Trim();
+        size_t ParameterSlotCount() const;
+        size_t BindingsCount() const;
+
+        // Changes on each Clear, so that materials can tell that they need to intern their content again.
+        uint32_t Generation() const {
+            return m_generation;
+        }
+
+        // Forgets all interned content, e.g. when the device is lost.
+        void Clear();
+
+    private:
+        using BindingsKey = std::array<const void*, 1 + 2 * MaterialTextureCount>;
+
+        const uint32_t m_parameterByteSize;
+        std::shared_ptr<MaterialParameterTable> m_parameterTable;
+        std::atomic<uint32_t> m_generation{0};
+        InternTable<MaterialParameterKey, MaterialParameterSlot, ArrayHash> m_parameterSlots;
+        InternTable<BindingsKey, MaterialBindings, ArrayHash> m_bindings;
+    };
+} // namespace Pbr
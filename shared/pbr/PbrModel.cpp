@@ -26,18 +26,23 @@ namespace Pbr
 
     void Model::Render(Pbr::Resources const& pbrResources, _In_ ID3D11DeviceContext* context) const
     {
-        UpdateTransforms(pbrResources, context);
+        D3D11RenderDevice device(pbrResources.GetDevice().get(), context);
+        Render(pbrResources, device);
+    }
+
+    void Model::Render(Pbr::Resources const& pbrResources, RenderDevice& device) const
+    {
+        UpdateTransforms(device);
 
-        ID3D11ShaderResourceView* vsShaderResources[] = { m_modelTransformsResourceView.get() };
-        context->VSSetShaderResources(Pbr::ShaderSlots::Transforms, _countof(vsShaderResources), vsShaderResources);
+        const ShaderResourceViewHandle vsShaderResources[] = { m_modelTransformsResourceView.Handle };
+        device.SetShaderResources(ShaderStage::Vertex, Pbr::ShaderSlots::Transforms, _countof(vsShaderResources), vsShaderResources);
 
         for (const Pbr::Primitive& primitive : m_primitives)
         {
             if (primitive.GetMaterial()->Hidden) continue;
 
-            primitive.GetMaterial()->SetWireframe(pbrResources.GetFillMode() == FillMode::Wireframe);
-            primitive.GetMaterial()->Bind(context, pbrResources);
-            primitive.Render(context);
+            primitive.GetMaterial()->Bind(device, pbrResources);
+            primitive.Render(device);
         }
 
         // Expect the caller to reset other state, but the geometry shader is cleared specially.
@@ -53,7 +58,7 @@ namespace Pbr
         }
 
         m_nodes.emplace_back(transform, std::move(name), newNodeIndex, parentIndex);
-        m_modelTransformsStructuredBuffer = nullptr; // Structured buffer will need to be recreated.
+        m_modelTransformsStructuredBuffer = {}; // Structured buffer will need to be recreated.
         return m_nodes.back().Index;
     }
 
@@ -79,6 +84,36 @@ namespace Pbr
         return clone;
     }
 
+    AssetFootprint Model::GetMemoryFootprint() const
+    {
+        AssetFootprint footprint;
+        MemoryFootprint modelFootprint;
+        modelFootprint.CpuBytes = sizeof(Model) + m_nodes.capacity() * sizeof(Node) + m_primitives.capacity() * sizeof(Primitive) +
+                                  m_modelTransforms.capacity() * sizeof(DirectX::XMFLOAT4X4);
+        modelFootprint.GpuBytes = m_modelTransformsStructuredBuffer.Handle ? m_modelTransforms.size() * sizeof(DirectX::XMFLOAT4X4) : 0;
+        footprint.push_back({this, modelFootprint});
+
+        // Clones share the buffers and textures of the primitives they were cloned from, so these are listed by the objects
+        // holding their memory rather than by primitive.
+        std::unordered_set<const void*> countedResources;
+        for (const Primitive& primitive : m_primitives)
+        {
+            for (ID3D11Buffer* buffer : {primitive.m_indexBuffer.get(), primitive.m_vertexBuffer.get()})
+            {
+                if (buffer && countedResources.insert(buffer).second)
+                {
+                    footprint.push_back({buffer, {0, Internal::GetBufferByteSize(buffer)}});
+                }
+            }
+            if (primitive.m_material)
+            {
+                primitive.m_material->AppendMemoryFootprint(footprint, countedResources);
+            }
+        }
+
+        return footprint;
+    }
+
     std::optional<NodeIndex_t> Model::FindFirstNode(std::string_view name, std::optional<NodeIndex_t> const& parentNodeIndex) const {
         // Children are guaranteed to come after their parents, so start looking after the parent index if one is provided.
         const NodeIndex_t startIndex = parentNodeIndex ? parentNodeIndex.value() + 1 : Pbr::RootNodeIndex;
@@ -105,7 +140,7 @@ namespace Pbr
         m_primitives.push_back(std::move(primitive));
     }
 
-    void Model::UpdateTransforms(Pbr::Resources const& pbrResources, _In_ ID3D11DeviceContext* context) const
+    void Model::UpdateTransforms(RenderDevice& device) const
     {
         const uint32_t newTotalModifyCount = std::accumulate(
             m_nodes.begin(),
@@ -114,29 +149,20 @@ namespace Pbr
             [](uint32_t sumChangeCount, const Node& node) { return sumChangeCount + node.m_modifyCount; });
 
         // If none of the node transforms have changed, no need to recompute/update the model transform structured buffer.
-        if (newTotalModifyCount != TotalModifyCount || m_modelTransformsStructuredBuffer == nullptr)
+        if (newTotalModifyCount != TotalModifyCount || !m_modelTransformsStructuredBuffer.Handle)
         {
-            if (m_modelTransformsStructuredBuffer == nullptr) // The structured buffer is reset when a Node is added.
+            if (!m_modelTransformsStructuredBuffer.Handle) // The structured buffer is reset when a Node is added.
             {
                 m_modelTransforms.resize(m_nodes.size());
 
                 // Create/recreate the structured buffer and SRV which holds the node transforms.
-                // Use Usage=D3D11_USAGE_DYNAMIC and CPUAccessFlags=D3D11_CPU_ACCESS_WRITE with Map/Unmap instead?
-                D3D11_BUFFER_DESC desc{};
-                desc.Usage = D3D11_USAGE_DEFAULT;
-                desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-                desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+                BufferDesc desc;
+                desc.Usage = BufferUsage::Structured;
                 desc.StructureByteStride = sizeof(decltype(m_modelTransforms)::value_type);
-                desc.ByteWidth = (UINT)(m_modelTransforms.size() * desc.StructureByteStride);
-                m_modelTransformsStructuredBuffer = nullptr;
-                Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateBuffer(&desc, nullptr, m_modelTransformsStructuredBuffer.put()));
-
-                D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-                srvDesc.Buffer.NumElements = (UINT)m_modelTransforms.size();
-                srvDesc.Buffer.ElementWidth = (UINT)m_modelTransforms.size();
-                m_modelTransformsResourceView = nullptr;
-                Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateShaderResourceView(m_modelTransformsStructuredBuffer.get(), &srvDesc, m_modelTransformsResourceView.put()));
+                desc.ByteSize = (uint32_t)(m_modelTransforms.size() * desc.StructureByteStride);
+                m_modelTransformsStructuredBuffer = device.CreateBuffer(desc);
+                m_modelTransformsResourceView =
+                    device.CreateShaderResourceView(m_modelTransformsStructuredBuffer.Handle, (uint32_t)m_modelTransforms.size());
             }
 
             // Nodes are guaranteed to come after their parents, so each node transform can be multiplied by its parent transform in a single pass.
@@ -149,7 +175,9 @@ namespace Pbr
             }
 
             // Update node transform structured buffer.
-            context->UpdateSubresource(m_modelTransformsStructuredBuffer.get(), 0, nullptr, this->m_modelTransforms.data(), 0, 0);
+            device.UpdateBuffer(m_modelTransformsStructuredBuffer.Handle,
+                                m_modelTransforms.data(),
+                                (uint32_t)(m_modelTransforms.size() * sizeof(decltype(m_modelTransforms)::value_type)));
             TotalModifyCount = newTotalModifyCount;
         }
     }
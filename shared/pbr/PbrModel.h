@@ -13,6 +13,7 @@
 #include "PbrCommon.h"
 #include "PbrResources.h"
 #include "PbrPrimitive.h"
+#include "PbrResidency.h"
 
 namespace Pbr {
     // Node for creating a hierarchy of transforms. These transforms are referenced by vertices in the model's primitives.
@@ -62,6 +63,7 @@ namespace Pbr {
 
         // Render the model.
         void Render(Pbr::Resources const& pbrResources, _In_ ID3D11DeviceContext* context) const;
+        void Render(Pbr::Resources const& pbrResources, RenderDevice& device) const;
 
         // Remove all primitives.
         void Clear();
@@ -89,6 +91,10 @@ namespace Pbr {
             return m_primitives[index];
         }
 
+        // Estimate the memory used by the model's buffers, materials and textures, listed per resource so that resources shared
+        // with other models are accounted once.
+        AssetFootprint GetMemoryFootprint() const;
+
         // Find the first node which matches a given name.
         std::optional<NodeIndex_t> FindFirstNode(std::string_view name, std::optional<NodeIndex_t> const& parentNodeIndex = {}) const;
 
@@ -97,7 +103,7 @@ namespace Pbr {
         DirectX::XMMATRIX GetNodeToModelRootTransform(NodeIndex_t nodeIndex) const;
 
         // Updated the transforms used to render the model. This needs to be called any time a node transform is changed.
-        void UpdateTransforms(Pbr::Resources const& pbrResources, _In_ ID3D11DeviceContext* context) const;
+        void UpdateTransforms(RenderDevice& device) const;
 
     private:
         // A model is made up of one or more Primitives. Each Primitive has a unique material.
@@ -109,9 +115,11 @@ namespace Pbr {
         Node::Collection m_nodes;
 
         // Temporary buffer holds the world transforms, computed from the node's local transforms.
+        // The structured buffer is created on the render device the model is rendered with, so a model must not be rendered
+        // with devices of different backends.
         mutable std::vector<DirectX::XMFLOAT4X4> m_modelTransforms;
-        mutable winrt::com_ptr<ID3D11Buffer> m_modelTransformsStructuredBuffer;
-        mutable winrt::com_ptr<ID3D11ShaderResourceView> m_modelTransformsResourceView;
+        mutable DeviceObject<BufferHandle> m_modelTransformsStructuredBuffer;
+        mutable DeviceObject<ShaderResourceViewHandle> m_modelTransformsResourceView;
 
         mutable uint32_t TotalModifyCount{0};
     };
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+// Built without the precompiled header, so that the null device does not depend on Windows or D3D11.
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include "PbrNullRenderDevice.h"
+
+namespace {
+    uint64_t BindKey(Pbr::RenderCommandType type, Pbr::ShaderStage stage, uint32_t slot) {
+        return (static_cast<uint64_t>(type) << 40) | (static_cast<uint64_t>(stage) << 32) | slot;
+    }
+
+    uint32_t TexelByteSize(Pbr::TextureFormat format) {
+        switch (format) {
+        case Pbr::TextureFormat::R8G8B8A8_UNorm:
+        case Pbr::TextureFormat::R8G8B8A8_UNorm_SRgb:
+        case Pbr::TextureFormat::R32_Float:
+            return 4;
+        }
+        return 0;
+    }
+} // namespace
+
+namespace Pbr {
+    NullRenderDevice::NullRenderDevice(bool recordCommands)
+        : m_recordCommands(recordCommands) {
+    }
+
+    DeviceObject<BufferHandle> NullRenderDevice::CreateBuffer(const BufferDesc& desc, const void* /*initialData*/) {
+        return CreateObject<BufferHandle>("Buffer", desc.ByteSize, desc.Dynamic);
+    }
+
+    DeviceObject<TextureHandle> NullRenderDevice::CreateTexture2D(const TextureDesc& desc,
+                                                                  const void* /*initialData*/,
+                                                                  uint32_t /*rowPitch*/) {
+        return CreateObject<TextureHandle>("Texture2D", desc.Width * desc.Height * TexelByteSize(desc.Format));
+    }
+
+    DeviceObject<ShaderResourceViewHandle> NullRenderDevice::CreateShaderResourceView(TextureHandle texture) {
+        return CreateObject<ShaderResourceViewHandle>(GetCreatedObject(texture.Object).Name + " view", 0);
+    }
+
+    DeviceObject<ShaderResourceViewHandle> NullRenderDevice::CreateShaderResourceView(BufferHandle structuredBuffer,
+                                                                                      uint32_t /*elementCount*/) {
+        return CreateObject<ShaderResourceViewHandle>(GetCreatedObject(structuredBuffer.Object).Name + " view", 0);
+    }
+
+    void NullRenderDevice::UpdateBuffer(BufferHandle buffer, const void* /*data*/, uint32_t byteSize) {
+        if (GetCreatedObject(buffer.Object).Dynamic) {
+            throw std::logic_error("Dynamic buffers must be written with WriteDynamicBuffer");
+        }
+        m_stats.BufferUpdateCount++;
+        m_stats.BufferUpdateBytes += byteSize;
+        Record({RenderCommandType::UpdateBuffer, ShaderStage::Vertex, 0, buffer.Object, byteSize});
+    }
+
+    void NullRenderDevice::WriteDynamicBuffer(BufferHandle buffer, const void* /*data*/, uint32_t byteSize) {
+        if (!GetCreatedObject(buffer.Object).Dynamic) {
+            throw std::logic_error("Only dynamic buffers can be written with WriteDynamicBuffer");
+        }
+        m_stats.BufferUpdateCount++;
+        m_stats.BufferUpdateBytes += byteSize;
+        Record({RenderCommandType::UpdateBuffer, ShaderStage::Vertex, 0, buffer.Object, byteSize});
+    }
+
+    void NullRenderDevice::UpdateBufferRange(BufferHandle buffer, uint32_t /*byteOffset*/, const void* /*data*/, uint32_t byteSize) {
+        if (GetCreatedObject(buffer.Object).Dynamic) {
+            throw std::logic_error("Dynamic buffers must be written with WriteDynamicBuffer");
+        }
+        m_stats.BufferUpdateCount++;
+        m_stats.BufferUpdateBytes += byteSize;
+        Record({RenderCommandType::UpdateBuffer, ShaderStage::Vertex, 0, buffer.Object, byteSize});
+    }
+
+    void NullRenderDevice::SetShaders(VertexShaderHandle vertexShader, PixelShaderHandle pixelShader) {
+        Bind(RenderCommandType::SetVertexShader, ShaderStage::Vertex, 0, vertexShader.Object);
+        Bind(RenderCommandType::SetPixelShader, ShaderStage::Pixel, 0, pixelShader.Object);
+    }
+
+    void NullRenderDevice::SetInputLayout(InputLayoutHandle inputLayout) {
+        Bind(RenderCommandType::SetInputLayout, ShaderStage::Vertex, 0, inputLayout.Object);
+    }
+
+    void NullRenderDevice::SetConstantBuffers(ShaderStage stage, uint32_t startSlot, uint32_t count, const BufferHandle* buffers) {
+        for (uint32_t i = 0; i < count; i++) {
+            Bind(RenderCommandType::SetConstantBuffer, stage, startSlot + i, buffers[i].Object);
+        }
+    }
+
+    void NullRenderDevice::SetShaderResources(ShaderStage stage,
+                                              uint32_t startSlot,
+                                              uint32_t count,
+                                              const ShaderResourceViewHandle* views) {
+        for (uint32_t i = 0; i < count; i++) {
+            Bind(RenderCommandType::SetShaderResource, stage, startSlot + i, views[i].Object);
+        }
+    }
+
+    void NullRenderDevice::SetSamplers(ShaderStage stage, uint32_t startSlot, uint32_t count, const SamplerHandle* samplers) {
+        for (uint32_t i = 0; i < count; i++) {
+            Bind(RenderCommandType::SetSampler, stage, startSlot + i, samplers[i].Object);
+        }
+    }
+
+    void NullRenderDevice::SetBlendState(BlendStateHandle blendState) {
+        Bind(RenderCommandType::SetBlendState, ShaderStage::Pixel, 0, blendState.Object);
+    }
+
+    void NullRenderDevice::SetRasterizerState(RasterizerStateHandle rasterizerState) {
+        Bind(RenderCommandType::SetRasterizerState, ShaderStage::Pixel, 0, rasterizerState.Object);
+    }
+
+    void NullRenderDevice::SetDepthStencilState(DepthStencilStateHandle depthStencilState, uint32_t stencilRef) {
+        Bind(RenderCommandType::SetDepthStencilState, ShaderStage::Pixel, 0, depthStencilState.Object, stencilRef);
+    }
+
+    void NullRenderDevice::SetVertexBuffer(BufferHandle vertexBuffer, uint32_t stride) {
+        Bind(RenderCommandType::SetVertexBuffer, ShaderStage::Vertex, 0, vertexBuffer.Object, stride);
+    }
+
+    void NullRenderDevice::SetIndexBuffer(BufferHandle indexBuffer) {
+        Bind(RenderCommandType::SetIndexBuffer, ShaderStage::Vertex, 0, indexBuffer.Object);
+    }
+
+    void NullRenderDevice::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount) {
+        m_stats.DrawCount++;
+        m_stats.IndexCount += static_cast<uint64_t>(indexCount) * instanceCount;
+        Record({RenderCommandType::DrawIndexedInstanced, ShaderStage::Vertex, 0, nullptr, indexCount});
+    }
+
+    const std::string& NullRenderDevice::ObjectName(const void* object) const {
+        static const std::string NullName = "null";
+        static const std::string UnknownName = "unknown";
+        if (!object) {
+            return NullName;
+        }
+        const NullObject* const nullObject = FindCreatedObject(object);
+        return nullObject ? nullObject->Name : UnknownName;
+    }
+
+    void NullRenderDevice::ResetStats() {
+        m_stats = {};
+        m_commands.clear();
+    }
+
+    void NullRenderDevice::ResetBoundState() {
+        m_boundObjects.clear();
+    }
+
+    void NullRenderDevice::AddObject(const std::shared_ptr<const NullObject>& object) {
+        // A destroyed object's address may be reused by the new one, whose entry then replaces the old one.
+        m_objects[object.get()] = object;
+        m_stats.CreatedObjectCount++;
+
+        if (m_objects.size() >= m_objectPruneThreshold) {
+            for (auto it = m_objects.begin(); it != m_objects.end();) {
+                it = it->second.expired() ? m_objects.erase(it) : std::next(it);
+            }
+            m_objectPruneThreshold = std::max(MinObjectPruneThreshold, m_objects.size() * 2);
+        }
+    }
+
+    const NullRenderDevice::NullObject* NullRenderDevice::FindCreatedObject(const void* object) const {
+        const auto it = m_objects.find(object);
+        if (it == m_objects.end() || it->second.expired()) {
+            return nullptr;
+        }
+        // The entry only lives as long as the object does, so the object can be read through the handle.
+        return static_cast<const NullObject*>(object);
+    }
+
+    const NullRenderDevice::NullObject& NullRenderDevice::GetCreatedObject(const void* object) const {
+        const NullObject* const nullObject = FindCreatedObject(object);
+        if (!nullObject) {
+            throw std::invalid_argument("The object was not created by this null render device");
+        }
+        return *nullObject;
+    }
+
+    void NullRenderDevice::Bind(RenderCommandType type, ShaderStage stage, uint32_t slot, const void* object, uint32_t value) {
+        const auto [it, added] = m_boundObjects.try_emplace(BindKey(type, stage, slot), BoundObject{object, value});
+        const bool redundant = !added && it->second.Object == object && it->second.Value == value;
+        if (redundant) {
+            m_stats.RedundantBindCount++;
+        } else {
+            it->second = {object, value};
+            m_stats.StateChangeCount++;
+        }
+        Record({type, stage, slot, object, value, redundant});
+    }
+
+    void NullRenderDevice::Record(const RenderCommand& command) {
+        if (m_recordCommands) {
+            m_commands.push_back(command);
+        }
+    }
+} // namespace Pbr
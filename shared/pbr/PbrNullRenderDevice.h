@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "PbrRenderDevice.h"
+
+namespace Pbr {
+    struct RenderDeviceStats {
+        uint64_t DrawCount{0};
+        uint64_t IndexCount{0};         // Indices drawn, across all instances.
+        uint64_t StateChangeCount{0};   // Binds that changed what was bound to a slot.
+        uint64_t RedundantBindCount{0}; // Binds of what was already bound to the slot.
+        uint64_t BufferUpdateCount{0};
+        uint64_t BufferUpdateBytes{0};
+        uint64_t CreatedObjectCount{0};
+    };
+
+    enum class RenderCommandType {
+        UpdateBuffer,
+        SetVertexShader,
+        SetPixelShader,
+        SetInputLayout,
+        SetConstantBuffer,
+        SetShaderResource,
+        SetSampler,
+        SetBlendState,
+        SetRasterizerState,
+        SetDepthStencilState,
+        SetVertexBuffer,
+        SetIndexBuffer,
+        DrawIndexedInstanced,
+    };
+
+    // A recorded command. Binds of several slots at once are recorded as one command per slot.
+    struct RenderCommand {
+        RenderCommandType Type;
+        ShaderStage Stage{ShaderStage::Vertex};
+        uint32_t Slot{0};
+        const void* Object{nullptr};
+        uint32_t Value{0}; // The byte size of updates, stride of vertex buffers, stencil reference, or index count of draws.
+        bool Redundant{false};
+    };
+
+    // A render device without a GPU, which records the commands it receives and counts draws and state changes, so that the
+    // CPU side of rendering can be measured and regression-tested. Binds are tracked per slot like D3D11 does, so a bind of
+    // the object that is already bound with the same parameters counts as redundant.
+    //
+    // It only stands in for the D3D11 device when rendering. Pbr::Resources, primitives, materials and glTF models are still
+    // created with an ID3D11Device, e.g. a WARP device, so their vertex and index buffers, textures, samplers, shaders and
+    // fixed function states are D3D11 objects. Only the constant and structured buffers that Resources and Model create
+    // through the render device they are first rendered with belong to the null device.
+    //
+    // Handles of other devices, such as those D3D11 objects, are recorded as they are but never dereferenced. Operations that
+    // need to look at an object, such as creating a view of it or updating it, throw if the null device did not create it.
+    class NullRenderDevice final : public RenderDevice {
+    public:
+        explicit NullRenderDevice(bool recordCommands = true);
+
+        // Stands in for objects that the null device cannot create, such as shaders and fixed function states.
+        template <typename THandle>
+        DeviceObject<THandle> CreatePlaceholder(std::string name) {
+            return CreateObject<THandle>(std::move(name), 0);
+        }
+
+        DeviceObject<BufferHandle> CreateBuffer(const BufferDesc& desc, const void* initialData = nullptr) override;
+        DeviceObject<TextureHandle> CreateTexture2D(const TextureDesc& desc, const void* initialData, uint32_t rowPitch) override;
+        DeviceObject<ShaderResourceViewHandle> CreateShaderResourceView(TextureHandle texture) override;
+        DeviceObject<ShaderResourceViewHandle> CreateShaderResourceView(BufferHandle structuredBuffer, uint32_t elementCount) override;
+
+        void UpdateBuffer(BufferHandle buffer, const void* data, uint32_t byteSize) override;
+        void WriteDynamicBuffer(BufferHandle buffer, const void* data, uint32_t byteSize) override;
+        void UpdateBufferRange(BufferHandle buffer, uint32_t byteOffset, const void* data, uint32_t byteSize) override;
+
+        void SetShaders(VertexShaderHandle vertexShader, PixelShaderHandle pixelShader) override;
+        void SetInputLayout(InputLayoutHandle inputLayout) override;
+        void SetConstantBuffers(ShaderStage stage, uint32_t startSlot, uint32_t count, const BufferHandle* buffers) override;
+        void SetShaderResources(ShaderStage stage, uint32_t startSlot, uint32_t count, const ShaderResourceViewHandle* views) override;
+        void SetSamplers(ShaderStage stage, uint32_t startSlot, uint32_t count, const SamplerHandle* samplers) override;
+        void SetBlendState(BlendStateHandle blendState) override;
+        void SetRasterizerState(RasterizerStateHandle rasterizerState) override;
+        void SetDepthStencilState(DepthStencilStateHandle depthStencilState, uint32_t stencilRef) override;
+        void SetVertexBuffer(BufferHandle vertexBuffer, uint32_t stride) override;
+        void SetIndexBuffer(BufferHandle indexBuffer) override;
+
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount) override;
+
+        const RenderDeviceStats& Stats() const {
+            return m_stats;
+        }
+
+        const std::vector<RenderCommand>& Commands() const {
+            return m_commands;
+        }
+
+        // The name given to an object when it was created, e.g. for printing recorded commands. Objects that this device did not
+        // create, or which were destroyed, are named "unknown".
+        const std::string& ObjectName(const void* object) const;
+
+        // Starts a new measurement, e.g. for each frame. The bound state is kept, like the state of a D3D11 context.
+        void ResetStats();
+
+        // Forgets the bound state, so that the next bind of each slot is counted as a state change.
+        void ResetBoundState();
+
+    private:
+        struct NullObject {
+            std::string Name;
+            uint32_t ByteSize;
+            bool Dynamic;
+        };
+
+        template <typename THandle>
+        DeviceObject<THandle> CreateObject(std::string name, uint32_t byteSize, bool dynamic = false) {
+            auto object = std::make_shared<NullObject>(NullObject{std::move(name), byteSize, dynamic});
+            AddObject(object);
+            return {THandle{object.get()}, std::move(object)};
+        }
+
+        void AddObject(const std::shared_ptr<const NullObject>& object);
+
+        // Returns null if the object was not created by this device or was destroyed.
+        const NullObject* FindCreatedObject(const void* object) const;
+        const NullObject& GetCreatedObject(const void* object) const;
+
+        void Bind(RenderCommandType type, ShaderStage stage, uint32_t slot, const void* object, uint32_t value = 0);
+        void Record(const RenderCommand& command);
+
+        const bool m_recordCommands;
+        RenderDeviceStats m_stats;
+        std::vector<RenderCommand> m_commands;
+
+        // The objects created by this device. Entries of destroyed objects are removed when the map doubled in size.
+        static constexpr size_t MinObjectPruneThreshold = 64;
+        std::unordered_map<const void*, std::weak_ptr<const NullObject>> m_objects;
+        size_t m_objectPruneThreshold{MinObjectPruneThreshold};
+
+        struct BoundObject {
+            const void* Object;
+            uint32_t Value;
+        };
+        std::unordered_map<uint64_t, BoundObject> m_boundObjects; // By command type, shader stage and slot.
+    };
+} // namespace Pbr
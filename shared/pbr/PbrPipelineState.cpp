@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include "PbrPipelineState.h"
+
+namespace Pbr {
+    PipelineStateCache::PipelineStateCache(CreateFunction create)
+        : m_create(std::move(create)) {
+    }
+
+    PipelineStateId PipelineStateCache::GetOrCreate(const PipelineStateDesc& desc) {
+        const auto it = m_ids.find(desc);
+        if (it != m_ids.end()) {
+            return it->second;
+        }
+
+        const PipelineStateId id = static_cast<PipelineStateId>(m_states.size());
+        m_states.emplace_back(desc, m_create(desc));
+        m_ids.emplace(desc, id);
+        return id;
+    }
+
+    const PipelineState& PipelineStateCache::Get(PipelineStateId id) const {
+        if (id >= m_states.size()) {
+            throw std::invalid_argument("Invalid pipeline state ID");
+        }
+        return m_states[id].second;
+    }
+
+    const PipelineStateDesc& PipelineStateCache::GetDesc(PipelineStateId id) const {
+        if (id >= m_states.size()) {
+            throw std::invalid_argument("Invalid pipeline state ID");
+        }
+        return m_states[id].first;
+    }
+
+    void PipelineStateCache::Clear() {
+        m_ids.clear();
+        m_states.clear();
+        m_generation++;
+    }
+} // namespace Pbr
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "PbrRenderDevice.h"
+
+namespace Pbr {
+    enum class ShadingMode : uint32_t {
+        Regular,
+        Highlight,
+    };
+
+    enum class FillMode : uint32_t {
+        Solid,
+        Wireframe,
+    };
+
+    enum class FrontFaceWindingOrder : uint32_t {
+        ClockWise,
+        CounterClockWise,
+    };
+
+    // The layout of the vertex buffers, which selects the input layout of a pipeline state.
+    enum class VertexFormat : uint32_t {
+        Pbr, // Pbr::Vertex
+    };
+
+    // Everything that a pipeline state is created from. Each unique description gets one pipeline state.
+    struct PipelineStateDesc {
+        ShadingMode Shading{ShadingMode::Regular};
+        VertexFormat Vertex{VertexFormat::Pbr};
+        FillMode Fill{FillMode::Solid};
+        FrontFaceWindingOrder WindingOrder{FrontFaceWindingOrder::ClockWise};
+        bool AlphaBlended{false};
+        bool DepthWriteDisabled{false};
+        bool DoubleSided{false};
+        bool ReverseZ{false};
+
+        // Packs every field into a value which is unique per description, with 8 bits for each enum.
+        uint64_t Key() const {
+            return (static_cast<uint64_t>(Shading) << 40) | (static_cast<uint64_t>(Vertex) << 32) | (static_cast<uint64_t>(Fill) << 24) |
+                   (static_cast<uint64_t>(WindingOrder) << 16) | (AlphaBlended ? 1 << 3 : 0) | (DepthWriteDisabled ? 1 << 2 : 0) |
+                   (DoubleSided ? 1 << 1 : 0) | (ReverseZ ? 1 : 0);
+        }
+
+        bool operator==(const PipelineStateDesc& other) const {
+            return Key() == other.Key();
+        }
+
+        bool operator!=(const PipelineStateDesc& other) const {
+            return Key() != other.Key();
+        }
+    };
+
+    struct PipelineStateDescHash {
+        size_t operator()(const PipelineStateDesc& desc) const {
+            return std::hash<uint64_t>{}(desc.Key());
+        }
+    };
+
+    // An immutable block of the shaders and fixed function states that are bound together for a draw.
+    struct PipelineState {
+        VertexShaderHandle VertexShader;
+        PixelShaderHandle PixelShader;
+        InputLayoutHandle InputLayout;
+        BlendStateHandle BlendState;
+        RasterizerStateHandle RasterizerState;
+        DepthStencilStateHandle DepthStencilState;
+        uint32_t StencilRef{0};
+
+        std::shared_ptr<const void> Lifetime; // Keeps the objects behind the handles alive.
+    };
+
+    // A compact reference to a pipeline state of a PipelineStateCache. Equal IDs of the same generation of the cache refer to
+    // the same pipeline state, so binding can be skipped by comparing IDs.
+    using PipelineStateId = uint32_t;
+    constexpr PipelineStateId InvalidPipelineStateId = ~0u;
+
+    // Creates a pipeline state for each unique description on first use and hands out its ID.
+    // Not thread safe, it is expected to be used by the rendering thread.
+    class PipelineStateCache {
+    public:
+        using CreateFunction = std::function<PipelineState(const PipelineStateDesc& desc)>;
+
+        explicit PipelineStateCache(CreateFunction create);
+
+        PipelineStateId GetOrCreate(const PipelineStateDesc& desc);
+
+        const PipelineState& Get(PipelineStateId id) const;
+        const PipelineStateDesc& GetDesc(PipelineStateId id) const;
+
+        size_t Size() const {
+            return m_states.size();
+        }
+
+        // Changes on each Clear, so that holders of IDs can tell that their IDs are no longer valid.
+        uint32_t Generation() const {
+            return m_generation;
+        }
+
+        // Releases all pipeline states, e.g. when the device is lost.
+        void Clear();
+
+    private:
+        const CreateFunction m_create;
+        uint32_t m_generation{0};
+        std::unordered_map<PipelineStateDesc, PipelineStateId, PipelineStateDescHash> m_ids;
+        std::vector<std::pair<PipelineStateDesc, PipelineState>> m_states; // By ID.
+    };
+} // namespace Pbr
@@ -2,6 +2,7 @@
 // Copyright (C) Microsoft Corporation.  All Rights Reserved
 // Licensed under the MIT License. See License.txt in the project root for license information.
 #include "pch.h"
+#include <algorithm>
 #include "PbrCommon.h"
 #include "PbrResources.h"
 #include "PbrPrimitive.h"
@@ -56,6 +57,32 @@ namespace {
         Pbr::Internal::ThrowIfFailed(device->CreateBuffer(&desc, &initData, indexBuffer.put()));
         return indexBuffer;
     }
+
+    // Map a buffer for writing byteSize bytes, replacing it with a large enough dynamic buffer if needed.
+    void* MapForWrite(_In_ ID3D11Device* device,
+                      _In_ ID3D11DeviceContext* context,
+                      winrt::com_ptr<ID3D11Buffer>& buffer,
+                      UINT bindFlags,
+                      UINT byteSize) {
+        D3D11_BUFFER_DESC desc{};
+        if (buffer) {
+            buffer->GetDesc(&desc);
+        }
+
+        if (!buffer || desc.Usage != D3D11_USAGE_DYNAMIC || desc.ByteWidth < byteSize) {
+            desc = {};
+            desc.Usage = D3D11_USAGE_DYNAMIC;
+            desc.ByteWidth = std::max(byteSize, 1u);
+            desc.BindFlags = bindFlags;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            buffer = nullptr;
+            Pbr::Internal::ThrowIfFailed(device->CreateBuffer(&desc, nullptr, buffer.put()));
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        Pbr::Internal::ThrowIfFailed(context->Map(buffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+        return mapped.pData;
+    }
 } // namespace
 
 namespace Pbr {
@@ -86,42 +113,31 @@ namespace Pbr {
     void Primitive::UpdateBuffers(_In_ ID3D11Device* device,
                                   _In_ ID3D11DeviceContext* context,
                                   const Pbr::PrimitiveBuilder& primitiveBuilder) {
-        // Update vertex buffer.
-        {
-            D3D11_BUFFER_DESC vertDesc;
-            m_vertexBuffer->GetDesc(&vertDesc);
-
-            UINT requiredSize = GetPbrVertexByteSize(primitiveBuilder.Vertices.size());
-            if (vertDesc.ByteWidth >= requiredSize) {
-                context->UpdateSubresource(m_vertexBuffer.get(), 0, nullptr, primitiveBuilder.Vertices.data(), requiredSize, requiredSize);
-            } else {
-                m_vertexBuffer = CreateVertexBuffer(device, primitiveBuilder, true);
-            }
-        }
-
-        // Update index buffer.
-        {
-            D3D11_BUFFER_DESC idxDesc;
-            m_indexBuffer->GetDesc(&idxDesc);
+        UpdateVertices(device, context, (uint32_t)primitiveBuilder.Vertices.size(), [&](Pbr::Vertex* vertices) {
+            memcpy(vertices, primitiveBuilder.Vertices.data(), GetPbrVertexByteSize(primitiveBuilder.Vertices.size()));
+        });
+        UpdateIndices(device, context, primitiveBuilder.Indices.data(), (uint32_t)primitiveBuilder.Indices.size());
+    }
 
-            UINT requiredSize = (UINT)(primitiveBuilder.Indices.size() * sizeof(decltype(primitiveBuilder.Indices)::value_type));
-            if (idxDesc.ByteWidth >= requiredSize) {
-                context->UpdateSubresource(m_indexBuffer.get(), 0, nullptr, primitiveBuilder.Indices.data(), requiredSize, requiredSize);
-            } else {
-                m_indexBuffer = CreateIndexBuffer(device, primitiveBuilder, true);
-            }
+    Pbr::Vertex* Primitive::MapVertices(_In_ ID3D11Device* device, _In_ ID3D11DeviceContext* context, uint32_t vertexCount) {
+        return static_cast<Pbr::Vertex*>(
+            MapForWrite(device, context, m_vertexBuffer, D3D11_BIND_VERTEX_BUFFER, GetPbrVertexByteSize(vertexCount)));
+    }
 
-            m_indexCount = (UINT)primitiveBuilder.Indices.size();
-        }
+    void Primitive::UpdateIndices(_In_ ID3D11Device* device,
+                                  _In_ ID3D11DeviceContext* context,
+                                  const uint32_t* indices,
+                                  uint32_t indexCount) {
+        const UINT byteSize = (UINT)(indexCount * sizeof(uint32_t));
+        void* const mapped = MapForWrite(device, context, m_indexBuffer, D3D11_BIND_INDEX_BUFFER, byteSize);
+        memcpy(mapped, indices, byteSize);
+        context->Unmap(m_indexBuffer.get(), 0);
+        m_indexCount = indexCount;
     }
 
-    void Primitive::Render(_In_ ID3D11DeviceContext* context) const {
-        const UINT stride = sizeof(Pbr::Vertex);
-        const UINT offset = 0;
-        ID3D11Buffer* const vertexBuffers[] = {m_vertexBuffer.get()};
-        context->IASetVertexBuffers(0, 1, vertexBuffers, &stride, &offset);
-        context->IASetIndexBuffer(m_indexBuffer.get(), DXGI_FORMAT_R32_UINT, 0);
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        context->DrawIndexedInstanced(m_indexCount, 1, 0, 0, 0);
+    void Primitive::Render(RenderDevice& device) const {
+        device.SetVertexBuffer(ToHandle(m_vertexBuffer.get()), sizeof(Pbr::Vertex));
+        device.SetIndexBuffer(ToHandle(m_indexBuffer.get()));
+        device.DrawIndexedInstanced(m_indexCount, 1);
     }
 } // namespace Pbr
@@ -26,6 +26,27 @@ namespace Pbr {
 
         void UpdateBuffers(_In_ ID3D11Device* device, _In_ ID3D11DeviceContext* context, const Pbr::PrimitiveBuilder& primitiveBuilder);
 
+        // Streaming updates for primitives whose geometry changes every frame.
+        // The buffers are mapped with D3D11_MAP_WRITE_DISCARD, so the driver hands out a new region while the GPU keeps reading
+        // the previous one and the CPU never waits for the GPU. Buffers that are not dynamic or too small are recreated as dynamic.
+        // The callback receives vertexCount vertices to fill. The mapped memory is write-combined, so it must not be read.
+        template <typename TWriteVertices>
+        void UpdateVertices(_In_ ID3D11Device* device,
+                            _In_ ID3D11DeviceContext* context,
+                            uint32_t vertexCount,
+                            TWriteVertices&& writeVertices) {
+            Pbr::Vertex* const vertices = MapVertices(device, context, vertexCount);
+            try {
+                writeVertices(vertices);
+            } catch (...) {
+                context->Unmap(m_vertexBuffer.get(), 0);
+                throw;
+            }
+            context->Unmap(m_vertexBuffer.get(), 0);
+        }
+
+        void UpdateIndices(_In_ ID3D11Device* device, _In_ ID3D11DeviceContext* context, const uint32_t* indices, uint32_t indexCount);
+
         // Get the material for the primitive.
         std::shared_ptr<Material>& GetMaterial() {
             return m_material;
@@ -41,10 +62,12 @@ namespace Pbr {
 
     protected:
         friend struct Model;
-        void Render(_In_ ID3D11DeviceContext* context) const;
+        void Render(RenderDevice& device) const;
         Primitive Clone(Pbr::Resources const& pbrResources) const;
 
     private:
+        Pbr::Vertex* MapVertices(_In_ ID3D11Device* device, _In_ ID3D11DeviceContext* context, uint32_t vertexCount);
+
         UINT m_indexCount;
         winrt::com_ptr<ID3D11Buffer> m_indexBuffer;
         winrt::com_ptr<ID3D11Buffer> m_vertexBuffer;
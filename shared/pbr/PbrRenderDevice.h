@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace Pbr {
+    // Opaque references to the objects of a render device. Each backend decides what they point to, e.g. the D3D11 interfaces
+    // of the D3D11 backend, so a handle must only be passed to the device that it came from.
+    template <typename TTag>
+    struct DeviceHandle {
+        const void* Object{nullptr};
+
+        explicit operator bool() const {
+            return Object != nullptr;
+        }
+
+        bool operator==(const DeviceHandle& other) const {
+            return Object == other.Object;
+        }
+
+        bool operator!=(const DeviceHandle& other) const {
+            return Object != other.Object;
+        }
+    };
+
+    using BufferHandle = DeviceHandle<struct BufferTag>;
+    using TextureHandle = DeviceHandle<struct TextureTag>;
+    using ShaderResourceViewHandle = DeviceHandle<struct ShaderResourceViewTag>;
+    using SamplerHandle = DeviceHandle<struct SamplerTag>;
+    using VertexShaderHandle = DeviceHandle<struct VertexShaderTag>;
+    using PixelShaderHandle = DeviceHandle<struct PixelShaderTag>;
+    using InputLayoutHandle = DeviceHandle<struct InputLayoutTag>;
+    using BlendStateHandle = DeviceHandle<struct BlendStateTag>;
+    using RasterizerStateHandle = DeviceHandle<struct RasterizerStateTag>;
+    using DepthStencilStateHandle = DeviceHandle<struct DepthStencilStateTag>;
+
+    // An object created by a render device, which stays alive as long as any copy of Lifetime does.
+    template <typename THandle>
+    struct DeviceObject {
+        THandle Handle;
+        std::shared_ptr<const void> Lifetime;
+    };
+
+    enum class ShaderStage {
+        Vertex,
+        Pixel,
+    };
+
+    enum class BufferUsage {
+        Vertex,
+        Index, // 32 bit indices.
+        Constant,
+        Structured,
+    };
+
+    struct BufferDesc {
+        uint32_t ByteSize{0};
+        BufferUsage Usage{BufferUsage::Vertex};
+        uint32_t StructureByteStride{0}; // Only for structured buffers.
+        bool Dynamic{false};             // Updated by the CPU every frame rather than occasionally.
+    };
+
+    enum class TextureFormat {
+        R8G8B8A8_UNorm,
+        R8G8B8A8_UNorm_SRgb,
+        R32_Float,
+    };
+
+    struct TextureDesc {
+        uint32_t Width{1};
+        uint32_t Height{1};
+        TextureFormat Format{TextureFormat::R8G8B8A8_UNorm};
+    };
+
+    // The operations that the PBR renderer and the engine need from a graphics API: creating buffers, textures and views,
+    // updating constants, binding state and drawing. Primitives are indexed triangle lists.
+    class RenderDevice {
+    public:
+        virtual ~RenderDevice() = default;
+
+        virtual DeviceObject<BufferHandle> CreateBuffer(const BufferDesc& desc, const void* initialData = nullptr) = 0;
+        virtual DeviceObject<TextureHandle> CreateTexture2D(const TextureDesc& desc, const void* initialData, uint32_t rowPitch) = 0;
+        virtual DeviceObject<ShaderResourceViewHandle> CreateShaderResourceView(TextureHandle texture) = 0;
+        virtual DeviceObject<ShaderResourceViewHandle> CreateShaderResourceView(BufferHandle structuredBuffer, uint32_t elementCount) = 0;
+
+        // Replaces the whole content of a buffer which is not dynamic.
+        virtual void UpdateBuffer(BufferHandle buffer, const void* data, uint32_t byteSize) = 0;
+
+        // Replaces the content of a dynamic buffer, discarding the previous content which the GPU may still be reading.
+        virtual void WriteDynamicBuffer(BufferHandle buffer, const void* data, uint32_t byteSize) = 0;
+
+        // Replaces part of a buffer which is not dynamic and not a constant buffer.
+        virtual void UpdateBufferRange(BufferHandle buffer, uint32_t byteOffset, const void* data, uint32_t byteSize) = 0;
+
+        virtual void SetShaders(VertexShaderHandle vertexShader, PixelShaderHandle pixelShader) = 0;
+        virtual void SetInputLayout(InputLayoutHandle inputLayout) = 0;
+        virtual void SetConstantBuffers(ShaderStage stage, uint32_t startSlot, uint32_t count, const BufferHandle* buffers) = 0;
+        virtual void SetShaderResources(ShaderStage stage, uint32_t startSlot, uint32_t count, const ShaderResourceViewHandle* views) = 0;
+        virtual void SetSamplers(ShaderStage stage, uint32_t startSlot, uint32_t count, const SamplerHandle* samplers) = 0;
+        virtual void SetBlendState(BlendStateHandle blendState) = 0;
+        virtual void SetRasterizerState(RasterizerStateHandle rasterizerState) = 0;
+        virtual void SetDepthStencilState(DepthStencilStateHandle depthStencilState, uint32_t stencilRef) = 0;
+        virtual void SetVertexBuffer(BufferHandle vertexBuffer, uint32_t stride) = 0;
+        virtual void SetIndexBuffer(BufferHandle indexBuffer) = 0;
+
+        virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount) = 0;
+    };
+} // namespace Pbr
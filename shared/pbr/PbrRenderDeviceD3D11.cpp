@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include "PbrCommon.h"
+#include "PbrRenderDeviceD3D11.h"
+
+namespace {
+    constexpr uint32_t MaxBindCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT;
+
+    // Keeps the D3D11 object alive for as long as the returned pointer is shared.
+    template <typename TInterface>
+    std::shared_ptr<const void> KeepAlive(winrt::com_ptr<TInterface> object) {
+        TInterface* const raw = object.get();
+        return std::shared_ptr<const void>(raw, [object = std::move(object)](const void*) {});
+    }
+
+    template <typename TInterface, typename THandle>
+    std::array<TInterface*, MaxBindCount> ToInterfaces(const THandle* handles, uint32_t count) {
+        if (count > MaxBindCount) {
+            throw std::invalid_argument("Too many objects bound at once");
+        }
+
+        std::array<TInterface*, MaxBindCount> interfaces;
+        for (uint32_t i = 0; i < count; i++) {
+            interfaces[i] = static_cast<TInterface*>(const_cast<void*>(handles[i].Object));
+        }
+        return interfaces;
+    }
+
+    template <typename TInterface, typename THandle>
+    TInterface* ToInterface(THandle handle) {
+        return static_cast<TInterface*>(const_cast<void*>(handle.Object));
+    }
+
+    DXGI_FORMAT ToDxgiFormat(Pbr::TextureFormat format) {
+        switch (format) {
+        case Pbr::TextureFormat::R8G8B8A8_UNorm:
+            return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case Pbr::TextureFormat::R8G8B8A8_UNorm_SRgb:
+            return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        case Pbr::TextureFormat::R32_Float:
+            return DXGI_FORMAT_R32_FLOAT;
+        }
+        throw std::invalid_argument("Unknown texture format");
+    }
+} // namespace
+
+namespace Pbr {
+    D3D11RenderDevice::D3D11RenderDevice(_In_ ID3D11Device* device, _In_ ID3D11DeviceContext* context)
+        : m_device(device)
+        , m_context(context) {
+    }
+
+    DeviceObject<BufferHandle> D3D11RenderDevice::CreateBuffer(const BufferDesc& desc, const void* initialData) {
+        D3D11_BUFFER_DESC bufferDesc{};
+        bufferDesc.ByteWidth = desc.ByteSize;
+        bufferDesc.Usage = desc.Dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
+        bufferDesc.CPUAccessFlags = desc.Dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+        switch (desc.Usage) {
+        case BufferUsage::Vertex:
+            bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+            break;
+        case BufferUsage::Index:
+            bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+            break;
+        case BufferUsage::Constant:
+            bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+            break;
+        case BufferUsage::Structured:
+            bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+            bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+            bufferDesc.StructureByteStride = desc.StructureByteStride;
+            break;
+        }
+
+        const D3D11_SUBRESOURCE_DATA data{initialData};
+        winrt::com_ptr<ID3D11Buffer> buffer;
+        Internal::ThrowIfFailed(m_device->CreateBuffer(&bufferDesc, initialData ? &data : nullptr, buffer.put()));
+        return {ToHandle(buffer.get()), KeepAlive(std::move(buffer))};
+    }
+
+    DeviceObject<TextureHandle> D3D11RenderDevice::CreateTexture2D(const TextureDesc& desc, const void* initialData, uint32_t rowPitch) {
+        const CD3D11_TEXTURE2D_DESC textureDesc(ToDxgiFormat(desc.Format), desc.Width, desc.Height, 1 /* arraySize */, 1 /* mipLevels */);
+        const D3D11_SUBRESOURCE_DATA data{initialData, rowPitch};
+        winrt::com_ptr<ID3D11Texture2D> texture;
+        Internal::ThrowIfFailed(m_device->CreateTexture2D(&textureDesc, initialData ? &data : nullptr, texture.put()));
+        return {ToHandle(texture.get()), KeepAlive(std::move(texture))};
+    }
+
+    DeviceObject<ShaderResourceViewHandle> D3D11RenderDevice::CreateShaderResourceView(TextureHandle texture) {
+        winrt::com_ptr<ID3D11ShaderResourceView> view;
+        Internal::ThrowIfFailed(m_device->CreateShaderResourceView(ToInterface<ID3D11Texture2D>(texture), nullptr, view.put()));
+        return {ToHandle(view.get()), KeepAlive(std::move(view))};
+    }
+
+    DeviceObject<ShaderResourceViewHandle> D3D11RenderDevice::CreateShaderResourceView(BufferHandle structuredBuffer,
+                                                                                       uint32_t elementCount) {
+        D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc{};
+        viewDesc.Format = DXGI_FORMAT_UNKNOWN;
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        viewDesc.Buffer.NumElements = elementCount;
+
+        winrt::com_ptr<ID3D11ShaderResourceView> view;
+        Internal::ThrowIfFailed(m_device->CreateShaderResourceView(ToInterface<ID3D11Buffer>(structuredBuffer), &viewDesc, view.put()));
+        return {ToHandle(view.get()), KeepAlive(std::move(view))};
+    }
+
+    void D3D11RenderDevice::UpdateBuffer(BufferHandle buffer, const void* data, uint32_t /*byteSize*/) {
+        m_context->UpdateSubresource(ToInterface<ID3D11Buffer>(buffer), 0, nullptr, data, 0, 0);
+    }
+
+    void D3D11RenderDevice::WriteDynamicBuffer(BufferHandle buffer, const void* data, uint32_t byteSize) {
+        ID3D11Buffer* const d3dBuffer = ToInterface<ID3D11Buffer>(buffer);
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        Internal::ThrowIfFailed(m_context->Map(d3dBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+        memcpy(mapped.pData, data, byteSize);
+        m_context->Unmap(d3dBuffer, 0);
+    }
+
+    void D3D11RenderDevice::UpdateBufferRange(BufferHandle buffer, uint32_t byteOffset, const void* data, uint32_t byteSize) {
+        const D3D11_BOX box{byteOffset, 0, 0, byteOffset + byteSize, 1, 1};
+        m_context->UpdateSubresource(ToInterface<ID3D11Buffer>(buffer), 0, &box, data, 0, 0);
+    }
+
+    void D3D11RenderDevice::SetShaders(VertexShaderHandle vertexShader, PixelShaderHandle pixelShader) {
+        m_context->VSSetShader(ToInterface<ID3D11VertexShader>(vertexShader), nullptr, 0);
+        m_context->PSSetShader(ToInterface<ID3D11PixelShader>(pixelShader), nullptr, 0);
+    }
+
+    void D3D11RenderDevice::SetInputLayout(InputLayoutHandle inputLayout) {
+        m_context->IASetInputLayout(ToInterface<ID3D11InputLayout>(inputLayout));
+    }
+
+    void D3D11RenderDevice::SetConstantBuffers(ShaderStage stage, uint32_t startSlot, uint32_t count, const BufferHandle* buffers) {
+        const auto d3dBuffers = ToInterfaces<ID3D11Buffer>(buffers, count);
+        if (stage == ShaderStage::Vertex) {
+            m_context->VSSetConstantBuffers(startSlot, count, d3dBuffers.data());
+        } else {
+            m_context->PSSetConstantBuffers(startSlot, count, d3dBuffers.data());
+        }
+    }
+
+    void D3D11RenderDevice::SetShaderResources(ShaderStage stage,
+                                               uint32_t startSlot,
+                                               uint32_t count,
+                                               const ShaderResourceViewHandle* views) {
+        const auto d3dViews = ToInterfaces<ID3D11ShaderResourceView>(views, count);
+        if (stage == ShaderStage::Vertex) {
+            m_context->VSSetShaderResources(startSlot, count, d3dViews.data());
+        } else {
+            m_context->PSSetShaderResources(startSlot, count, d3dViews.data());
+        }
+    }
+
+    void D3D11RenderDevice::SetSamplers(ShaderStage stage, uint32_t startSlot, uint32_t count, const SamplerHandle* samplers) {
+        const auto d3dSamplers = ToInterfaces<ID3D11SamplerState>(samplers, count);
+        if (stage == ShaderStage::Vertex) {
+            m_context->VSSetSamplers(startSlot, count, d3dSamplers.data());
+        } else {
+            m_context->PSSetSamplers(startSlot, count, d3dSamplers.data());
+        }
+    }
+
+    void D3D11RenderDevice::SetBlendState(BlendStateHandle blendState) {
+        m_context->OMSetBlendState(ToInterface<ID3D11BlendState>(blendState), nullptr, 0xFFFFFF);
+    }
+
+    void D3D11RenderDevice::SetRasterizerState(RasterizerStateHandle rasterizerState) {
+        m_context->RSSetState(ToInterface<ID3D11RasterizerState>(rasterizerState));
+    }
+
+    void D3D11RenderDevice::SetDepthStencilState(DepthStencilStateHandle depthStencilState, uint32_t stencilRef) {
+        m_context->OMSetDepthStencilState(ToInterface<ID3D11DepthStencilState>(depthStencilState), stencilRef);
+    }
+
+    void D3D11RenderDevice::SetVertexBuffer(BufferHandle vertexBuffer, uint32_t stride) {
+        ID3D11Buffer* const vertexBuffers[] = {ToInterface<ID3D11Buffer>(vertexBuffer)};
+        const UINT offset = 0;
+        m_context->IASetVertexBuffers(0, 1, vertexBuffers, &stride, &offset);
+    }
+
+    void D3D11RenderDevice::SetIndexBuffer(BufferHandle indexBuffer) {
+        m_context->IASetIndexBuffer(ToInterface<ID3D11Buffer>(indexBuffer), DXGI_FORMAT_R32_UINT, 0);
+        m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    }
+
+    void D3D11RenderDevice::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount) {
+        m_context->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+    }
+} // namespace Pbr
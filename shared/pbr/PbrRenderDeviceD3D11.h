@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <winrt/base.h>
+#include <d3d11.h>
+#include "PbrRenderDevice.h"
+
+namespace Pbr {
+    // Handles of the D3D11 backend are the D3D11 interfaces, so objects created directly on the D3D11 device can be used too.
+    inline BufferHandle ToHandle(ID3D11Buffer* buffer) {
+        return {buffer};
+    }
+    inline TextureHandle ToHandle(ID3D11Texture2D* texture) {
+        return {texture};
+    }
+    inline ShaderResourceViewHandle ToHandle(ID3D11ShaderResourceView* view) {
+        return {view};
+    }
+    inline SamplerHandle ToHandle(ID3D11SamplerState* sampler) {
+        return {sampler};
+    }
+    inline VertexShaderHandle ToHandle(ID3D11VertexShader* shader) {
+        return {shader};
+    }
+    inline PixelShaderHandle ToHandle(ID3D11PixelShader* shader) {
+        return {shader};
+    }
+    inline InputLayoutHandle ToHandle(ID3D11InputLayout* inputLayout) {
+        return {inputLayout};
+    }
+    inline BlendStateHandle ToHandle(ID3D11BlendState* blendState) {
+        return {blendState};
+    }
+    inline RasterizerStateHandle ToHandle(ID3D11RasterizerState* rasterizerState) {
+        return {rasterizerState};
+    }
+    inline DepthStencilStateHandle ToHandle(ID3D11DepthStencilState* depthStencilState) {
+        return {depthStencilState};
+    }
+
+    // Forwards each operation to a D3D11 device and immediate or deferred context, which must outlive it.
+    class D3D11RenderDevice final : public RenderDevice {
+    public:
+        D3D11RenderDevice(_In_ ID3D11Device* device, _In_ ID3D11DeviceContext* context);
+
+        DeviceObject<BufferHandle> CreateBuffer(const BufferDesc& desc, const void* initialData = nullptr) override;
+        DeviceObject<TextureHandle> CreateTexture2D(const TextureDesc& desc, const void* initialData, uint32_t rowPitch) override;
+        DeviceObject<ShaderResourceViewHandle> CreateShaderResourceView(TextureHandle texture) override;
+        DeviceObject<ShaderResourceViewHandle> CreateShaderResourceView(BufferHandle structuredBuffer, uint32_t elementCount) override;
+
+        void UpdateBuffer(BufferHandle buffer, const void* data, uint32_t byteSize) override;
+        void WriteDynamicBuffer(BufferHandle buffer, const void* data, uint32_t byteSize) override;
+        void UpdateBufferRange(BufferHandle buffer, uint32_t byteOffset, const void* data, uint32_t byteSize) override;
+
+        void SetShaders(VertexShaderHandle vertexShader, PixelShaderHandle pixelShader) override;
+        void SetInputLayout(InputLayoutHandle inputLayout) override;
+        void SetConstantBuffers(ShaderStage stage, uint32_t startSlot, uint32_t count, const BufferHandle* buffers) override;
+        void SetShaderResources(ShaderStage stage, uint32_t startSlot, uint32_t count, const ShaderResourceViewHandle* views) override;
+        void SetSamplers(ShaderStage stage, uint32_t startSlot, uint32_t count, const SamplerHandle* samplers) override;
+        void SetBlendState(BlendStateHandle blendState) override;
+        void SetRasterizerState(RasterizerStateHandle rasterizerState) override;
+        void SetDepthStencilState(DepthStencilStateHandle depthStencilState, uint32_t stencilRef) override;
+        void SetVertexBuffer(BufferHandle vertexBuffer, uint32_t stride) override;
+        void SetIndexBuffer(BufferHandle indexBuffer) override;
+
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount) override;
+
+        ID3D11Device* Device() const {
+            return m_device;
+        }
+
+        ID3D11DeviceContext* Context() const {
+            return m_context;
+        }
+
+    private:
+        ID3D11Device* const m_device;
+        ID3D11DeviceContext* const m_context;
+    };
+} // namespace Pbr
@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include <algorithm>
+#include "PbrResidency.h"
+
+namespace Pbr {
+    ResidencyManager::ResidencyManager(ResidencyBudget budget)
+        : m_budget(budget) {
+    }
+
+    void ResidencyManager::SetBudget(ResidencyBudget budget) {
+        std::lock_guard guard(m_mutex);
+        m_budget = budget;
+    }
+
+    ResidencyBudget ResidencyManager::GetBudget() const {
+        std::lock_guard guard(m_mutex);
+        return m_budget;
+    }
+
+    ResidencyManager::AssetId
+    ResidencyManager::RegisterAsset(std::string name, AssetFootprint footprint, EvictCallback evict, bool pinned) {
+        std::lock_guard guard(m_mutex);
+        const AssetId id = m_nextAssetId++;
+
+        AddResources(footprint);
+
+        Asset asset;
+        asset.Name = std::move(name);
+        asset.Footprint = std::move(footprint);
+        asset.Evict = std::move(evict);
+        asset.LastRenderedFrame = m_frameIndex; // A new asset is considered in use during the frame it is registered.
+        asset.Pinned = pinned;
+        m_assets.emplace(id, std::move(asset));
+        return id;
+    }
+
+    void ResidencyManager::UnregisterAsset(AssetId id) {
+        std::lock_guard guard(m_mutex);
+        auto it = m_assets.find(id);
+        if (it == m_assets.end()) {
+            return;
+        }
+
+        if (it->second.Resident) {
+            ReleaseResources(it->second.Footprint);
+        }
+        m_assets.erase(it);
+    }
+
+    void ResidencyManager::UpdateFootprint(AssetId id, AssetFootprint footprint) {
+        std::lock_guard guard(m_mutex);
+        if (Asset* asset = FindAsset(id)) {
+            if (asset->Resident) {
+                // Add before releasing so that resources kept by the update are not released in between.
+                AddResources(footprint);
+                ReleaseResources(asset->Footprint);
+            }
+            asset->Footprint = std::move(footprint);
+        }
+    }
+
+    void ResidencyManager::SetPinned(AssetId id, bool pinned) {
+        std::lock_guard guard(m_mutex);
+        if (Asset* asset = FindAsset(id)) {
+            asset->Pinned = pinned;
+        }
+    }
+
+    bool ResidencyManager::MarkRendered(AssetId id) {
+        std::lock_guard guard(m_mutex);
+        Asset* asset = FindAsset(id);
+        if (asset == nullptr) {
+            return false;
+        }
+
+        if (asset->LastRenderedFrame != m_frameIndex) {
+            asset->LastRenderedFrame = m_frameIndex;
+            m_renderedThisFrame++;
+        }
+
+        if (!asset->Resident) {
+            asset->ReloadRequested = true;
+        }
+        return asset->Resident;
+    }
+
+    bool ResidencyManager::IsResident(AssetId id) const {
+        std::lock_guard guard(m_mutex);
+        const Asset* asset = FindAsset(id);
+        return asset != nullptr && asset->Resident;
+    }
+
+    bool ResidencyManager::TakeReloadRequest(AssetId id) {
+        std::lock_guard guard(m_mutex);
+        Asset* asset = FindAsset(id);
+        if (asset == nullptr || asset->Resident || !asset->ReloadRequested) {
+            return false;
+        }
+
+        asset->ReloadRequested = false;
+        return true;
+    }
+
+    void ResidencyManager::CompleteReload(AssetId id, AssetFootprint footprint) {
+        std::lock_guard guard(m_mutex);
+        Asset* asset = FindAsset(id);
+        if (asset == nullptr || asset->Resident) {
+            return;
+        }
+
+        AddResources(footprint);
+        asset->Footprint = std::move(footprint);
+        asset->Resident = true;
+        asset->ReloadRequested = false;
+        m_reloadedThisFrame++;
+    }
+
+    void ResidencyManager::BeginFrame(uint64_t frameIndex) {
+        std::lock_guard guard(m_mutex);
+        m_frameIndex = frameIndex;
+        m_renderedThisFrame = 0;
+        m_reloadedThisFrame = 0;
+    }
+
+    void ResidencyManager::EndFrame() {
+        std::vector<EvictCallback> evictions;
+        ResidencyStats stats;
+
+        {
+            std::lock_guard guard(m_mutex);
+
+            if (IsOverBudget()) {
+                // Collect eviction candidates: resident, not pinned and not used in this frame.
+                std::vector<std::pair<uint64_t /*lastRenderedFrame*/, AssetId>> candidates;
+                for (const auto& [id, asset] : m_assets) {
+                    if (asset.Resident && !asset.Pinned && asset.LastRenderedFrame != m_frameIndex && asset.Evict) {
+                        candidates.emplace_back(asset.LastRenderedFrame, id);
+                    }
+                }
+
+                // Least-recently-rendered first. Ties are broken by registration order to keep eviction deterministic.
+                std::sort(candidates.begin(), candidates.end());
+
+                for (const auto& [lastRenderedFrame, id] : candidates) {
+                    if (!IsOverBudget()) {
+                        break;
+                    }
+
+                    // Resources shared with other resident assets stay accounted until the last of them is evicted.
+                    Asset& asset = m_assets.at(id);
+                    asset.Resident = false;
+                    asset.ReloadRequested = false;
+                    stats.Evicted += ReleaseResources(asset.Footprint);
+                    stats.EvictedAssetCount++;
+                    evictions.push_back(asset.Evict);
+                }
+            }
+
+            stats.FrameIndex = m_frameIndex;
+            stats.RegisteredAssetCount = static_cast<uint32_t>(m_assets.size());
+            stats.ResidentAssetCount = static_cast<uint32_t>(
+                std::count_if(m_assets.begin(), m_assets.end(), [](const auto& entry) { return entry.second.Resident; }));
+            stats.RenderedAssetCount = m_renderedThisFrame;
+            stats.ReloadedAssetCount = m_reloadedThisFrame;
+            stats.Resident = m_resident;
+            stats.OverBudget = IsOverBudget();
+            m_lastFrameStats = stats;
+        }
+
+        for (const EvictCallback& evict : evictions) {
+            evict();
+        }
+    }
+
+    ResidencyStats ResidencyManager::GetFrameStats() const {
+        std::lock_guard guard(m_mutex);
+        return m_lastFrameStats;
+    }
+
+    MemoryFootprint ResidencyManager::GetResidentFootprint() const {
+        std::lock_guard guard(m_mutex);
+        return m_resident;
+    }
+
+    bool ResidencyManager::IsOverBudget() const {
+        return m_resident.CpuBytes > m_budget.CpuBytes || m_resident.GpuBytes > m_budget.GpuBytes;
+    }
+
+    ResidencyManager::Asset* ResidencyManager::FindAsset(AssetId id) {
+        auto it = m_assets.find(id);
+        return it == m_assets.end() ? nullptr : &it->second;
+    }
+
+    const ResidencyManager::Asset* ResidencyManager::FindAsset(AssetId id) const {
+        auto it = m_assets.find(id);
+        return it == m_assets.end() ? nullptr : &it->second;
+    }
+
+    void ResidencyManager::AddResources(const AssetFootprint& footprint) {
+        for (const ResourceFootprint& resource : footprint) {
+            CountedResource& counted = m_resources[resource.Resource];
+            if (counted.ReferenceCount++ == 0) {
+                counted.Footprint = resource.Footprint;
+                m_resident += resource.Footprint;
+            }
+        }
+    }
+
+    MemoryFootprint ResidencyManager::ReleaseResources(const AssetFootprint& footprint) {
+        MemoryFootprint released;
+        for (const ResourceFootprint& resource : footprint) {
+            auto it = m_resources.find(resource.Resource);
+            if (it != m_resources.end() && --it->second.ReferenceCount == 0) {
+                released += it->second.Footprint;
+                m_resident -= it->second.Footprint;
+                m_resources.erase(it);
+            }
+        }
+        return released;
+    }
+} // namespace Pbr
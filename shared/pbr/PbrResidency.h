@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Pbr {
+    // CPU and GPU memory used by an asset.
+    struct MemoryFootprint {
+        uint64_t CpuBytes{0};
+        uint64_t GpuBytes{0};
+
+        MemoryFootprint& operator+=(const MemoryFootprint& other) {
+            CpuBytes += other.CpuBytes;
+            GpuBytes += other.GpuBytes;
+            return *this;
+        }
+
+        MemoryFootprint& operator-=(const MemoryFootprint& other) {
+            CpuBytes -= other.CpuBytes;
+            GpuBytes -= other.GpuBytes;
+            return *this;
+        }
+    };
+
+    // The memory of one resource of an asset. Resources are identified by the object holding their memory, so that resources
+    // shared between assets, e.g. the buffers and textures of cloned models, are accounted once.
+    struct ResourceFootprint {
+        const void* Resource{nullptr};
+        MemoryFootprint Footprint;
+    };
+
+    // The resources used by an asset.
+    using AssetFootprint = std::vector<ResourceFootprint>;
+
+    // Memory budget enforced by the residency manager. Budgets are unlimited by default.
+    struct ResidencyBudget {
+        uint64_t CpuBytes{std::numeric_limits<uint64_t>::max()};
+        uint64_t GpuBytes{std::numeric_limits<uint64_t>::max()};
+    };
+
+    // Residency statistics of the most recently completed frame.
+    struct ResidencyStats {
+        uint64_t FrameIndex{0};
+        uint32_t RegisteredAssetCount{0};
+        uint32_t ResidentAssetCount{0};
+        uint32_t RenderedAssetCount{0};
+        uint32_t EvictedAssetCount{0};  // Number of assets evicted at the end of the frame.
+        uint32_t ReloadedAssetCount{0}; // Number of evicted assets whose reload completed during the frame.
+        MemoryFootprint Resident;       // Memory used by resident assets after budget enforcement.
+        MemoryFootprint Evicted;        // Memory released by evictions at the end of the frame, excluding resources still in use.
+        bool OverBudget{false};         // True if the budget could not be met by evicting assets not used in this frame.
+    };
+
+    // Accounts the memory of registered assets against a budget and evicts the least-recently-rendered assets when over budget.
+    // The manager only owns the policy. Owners of an asset provide a callback to release it to a reload-able state, and reload
+    // it themselves when the manager reports that an evicted asset was rendered again.
+    //
+    // Resources are reference counted across all resident assets. A resource is only accounted while a resident asset uses it,
+    // so evicting an asset only releases the resources no other resident asset uses. Owners must update the footprint of an
+    // asset when they replace its resources.
+    //
+    // All methods are thread-safe. The evict callback is invoked without holding the internal lock, on the thread calling EndFrame.
+    class ResidencyManager {
+    public:
+        using AssetId = uint64_t;
+        static constexpr AssetId InvalidAssetId = 0;
+
+        // Releases the memory of the asset. The owner must be able to reload the asset afterwards.
+        using EvictCallback = std::function<void()>;
+
+        explicit ResidencyManager(ResidencyBudget budget = {});
+
+        ResidencyManager(const ResidencyManager&) = delete;
+        ResidencyManager& operator=(const ResidencyManager&) = delete;
+
+        void SetBudget(ResidencyBudget budget);
+        ResidencyBudget GetBudget() const;
+
+        // Register a resident asset. Pinned assets are accounted but never evicted.
+        AssetId RegisterAsset(std::string name, AssetFootprint footprint, EvictCallback evict, bool pinned = false);
+        void UnregisterAsset(AssetId id);
+
+        // Update the resources of an asset, e.g. after its buffers are resized.
+        void UpdateFootprint(AssetId id, AssetFootprint footprint);
+        void SetPinned(AssetId id, bool pinned);
+
+        // Mark an asset as rendered in the current frame. Returns false if the asset is unknown or evicted, in which case the
+        // owner should skip drawing it. Rendering an evicted asset requests that it is reloaded.
+        bool MarkRendered(AssetId id);
+        bool IsResident(AssetId id) const;
+
+        // Returns true once for each request to reload an evicted asset. The owner then reloads the asset, typically in the
+        // background, and calls CompleteReload when done.
+        bool TakeReloadRequest(AssetId id);
+        void CompleteReload(AssetId id, AssetFootprint footprint);
+
+        // Frame boundaries. EndFrame evicts the least-recently-rendered assets until the resident memory fits the budget.
+        // Assets rendered during the current frame are never evicted.
+        void BeginFrame(uint64_t frameIndex);
+        void EndFrame();
+
+        ResidencyStats GetFrameStats() const;
+        MemoryFootprint GetResidentFootprint() const;
+
+    private:
+        struct Asset {
+            std::string Name;
+            AssetFootprint Footprint;
+            EvictCallback Evict;
+            uint64_t LastRenderedFrame{0};
+            bool Resident{true};
+            bool Pinned{false};
+            bool ReloadRequested{false};
+        };
+
+        struct CountedResource {
+            MemoryFootprint Footprint;
+            uint32_t ReferenceCount{0};
+        };
+
+        bool IsOverBudget() const;
+        Asset* FindAsset(AssetId id);
+        const Asset* FindAsset(AssetId id) const;
+
+        // Add or remove a reference to each resource of an asset. Returns the memory of the resources no longer referenced.
+        void AddResources(const AssetFootprint& footprint);
+        MemoryFootprint ReleaseResources(const AssetFootprint& footprint);
+
+        mutable std::mutex m_mutex;
+        ResidencyBudget m_budget;
+        std::unordered_map<AssetId, Asset> m_assets;
+        std::unordered_map<const void*, CountedResource> m_resources; // The resources of resident assets.
+        AssetId m_nextAssetId{InvalidAssetId + 1};
+        MemoryFootprint m_resident;
+
+        uint64_t m_frameIndex{0};
+        uint32_t m_renderedThisFrame{0};
+        uint32_t m_reloadedThisFrame{0};
+        ResidencyStats m_lastFrameStats;
+    };
+} // namespace Pbr
@@ -27,11 +27,38 @@ namespace {
     struct ModelConstantBuffer {
         alignas(16) DirectX::XMFLOAT4X4 ModelToWorld;
     };
+
+    struct DrawConstantBuffer {
+        alignas(16) uint32_t MaterialIndex{0};
+    };
+
+    constexpr uint32_t InvalidMaterialIndex = ~0u;
+    constexpr uint32_t MinMaterialTableCapacity = 64;
+
+    // The D3D11 objects behind the handles of a pipeline state.
+    struct PipelineStateObjects {
+        winrt::com_ptr<ID3D11VertexShader> VertexShader;
+        winrt::com_ptr<ID3D11PixelShader> PixelShader;
+        winrt::com_ptr<ID3D11InputLayout> InputLayout;
+        winrt::com_ptr<ID3D11BlendState> BlendState;
+        winrt::com_ptr<ID3D11RasterizerState> RasterizerState;
+        winrt::com_ptr<ID3D11DepthStencilState> DepthStencilState;
+    };
 } // namespace
 
 namespace Pbr {
     struct Resources::Impl {
         void Initialize(_In_ ID3D11Device* device) {
+            Resources.Device.copy_from(device);
+
+            // Pipeline states reference the shaders, so they are recreated with them.
+            PipelineStates.Clear();
+            ++PassGeneration;
+            BoundPipelineState = InvalidPipelineStateId;
+            Materials.Clear();
+            BoundMaterial = nullptr;
+            BoundMaterialIndex = InvalidMaterialIndex;
+
             Internal::ThrowIfFailed(device->CreateInputLayout(Pbr::Vertex::s_vertexDesc,
                                                               ARRAYSIZE(Pbr::Vertex::s_vertexDesc),
                                                               g_PbrVertexShader,
@@ -49,61 +76,138 @@ namespace Pbr {
             Internal::ThrowIfFailed(device->CreateVertexShader(
                 g_HighlightVertexShader, sizeof(g_HighlightVertexShader), nullptr, Resources.HighlightVertexShader.put()));
 
-            // Set up the constant buffers.
-            static_assert((sizeof(SceneConstantBuffer) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
-            const CD3D11_BUFFER_DESC pbrConstantBufferDesc(sizeof(SceneConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
-            Internal::ThrowIfFailed(device->CreateBuffer(&pbrConstantBufferDesc, nullptr, Resources.SceneConstantBuffer.put()));
-
-            static_assert((sizeof(ModelConstantBuffer) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
-            const CD3D11_BUFFER_DESC modelConstantBufferDesc(sizeof(ModelConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
-            Internal::ThrowIfFailed(device->CreateBuffer(&modelConstantBufferDesc, nullptr, Resources.ModelConstantBuffer.put()));
+            // The buffers are created on the render device they are first used with.
+            Resources.SceneConstantBuffer = {};
+            Resources.ModelConstantBuffer = {};
+            Resources.DrawConstantBuffer = {};
+            Resources.MaterialTable = {};
+            Resources.MaterialTableView = {};
+            Resources.MaterialTableCapacity = 0;
 
             // Samplers for environment map and BRDF.
             Resources.EnvironmentMapSampler = Texture::CreateSampler(device);
             Resources.BrdfSampler = Texture::CreateSampler(device);
+        }
 
-            CD3D11_BLEND_DESC blendStateDesc(D3D11_DEFAULT);
-            Internal::ThrowIfFailed(device->CreateBlendState(&blendStateDesc, Resources.DefaultBlendState.put()));
-
-            D3D11_RENDER_TARGET_BLEND_DESC rtBlendDesc;
-            rtBlendDesc.BlendEnable = TRUE;
-            rtBlendDesc.SrcBlend = D3D11_BLEND_SRC_ALPHA;
-            rtBlendDesc.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
-            rtBlendDesc.BlendOp = D3D11_BLEND_OP_ADD;
-            rtBlendDesc.SrcBlendAlpha = D3D11_BLEND_ZERO;
-            rtBlendDesc.DestBlendAlpha = D3D11_BLEND_ONE;
-            rtBlendDesc.BlendOpAlpha = D3D11_BLEND_OP_ADD;
-            rtBlendDesc.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
-            for (UINT i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i) {
-                blendStateDesc.RenderTarget[i] = rtBlendDesc;
+        PipelineState CreatePipelineState(const PipelineStateDesc& desc) const {
+            ID3D11Device* const device = Resources.Device.get();
+
+            auto objects = std::make_shared<PipelineStateObjects>();
+            switch (desc.Shading) {
+            case ShadingMode::Regular:
+                objects->VertexShader = Resources.PbrVertexShader;
+                objects->PixelShader = Resources.PbrPixelShader;
+                break;
+            case ShadingMode::Highlight:
+                objects->VertexShader = Resources.HighlightVertexShader;
+                objects->PixelShader = Resources.HighlightPixelShader;
+                break;
+            default:
+                throw std::invalid_argument("Unknown shading mode");
             }
-            Internal::ThrowIfFailed(device->CreateBlendState(&blendStateDesc, Resources.AlphaBlendState.put()));
-
-            for (bool doubleSided : {false, true}) {
-                for (bool wireframe : {false, true}) {
-                    for (bool frontCounterClockwise : {false, true}) {
-                        CD3D11_RASTERIZER_DESC rasterizerDesc(D3D11_DEFAULT);
-                        rasterizerDesc.CullMode = doubleSided ? D3D11_CULL_NONE : D3D11_CULL_BACK;
-                        rasterizerDesc.FillMode = wireframe ? D3D11_FILL_WIREFRAME : D3D11_FILL_SOLID;
-                        rasterizerDesc.FrontCounterClockwise = frontCounterClockwise;
-                        Internal::ThrowIfFailed(device->CreateRasterizerState(
-                            &rasterizerDesc, Resources.RasterizerStates[doubleSided][wireframe][frontCounterClockwise].put()));
-                    }
-                }
+
+            switch (desc.Vertex) {
+            case VertexFormat::Pbr:
+                objects->InputLayout = Resources.InputLayout;
+                break;
+            default:
+                throw std::invalid_argument("Unknown vertex format");
             }
 
-            for (bool reverseZ : {false, true}) {
-                for (bool noWrite : {false, true}) {
-                    CD3D11_DEPTH_STENCIL_DESC depthStencilDesc(CD3D11_DEFAULT{});
-                    depthStencilDesc.DepthFunc = reverseZ ? D3D11_COMPARISON_GREATER : D3D11_COMPARISON_LESS;
-                    depthStencilDesc.DepthWriteMask = noWrite ? D3D11_DEPTH_WRITE_MASK_ZERO : D3D11_DEPTH_WRITE_MASK_ALL;
-                    Internal::ThrowIfFailed(
-                        device->CreateDepthStencilState(&depthStencilDesc, Resources.DepthStencilStates[reverseZ][noWrite].put()));
+            // D3D11 hands out the same state object for identical descriptions, so states are shared between pipeline states.
+            CD3D11_BLEND_DESC blendStateDesc(D3D11_DEFAULT);
+            if (desc.AlphaBlended) {
+                D3D11_RENDER_TARGET_BLEND_DESC rtBlendDesc;
+                rtBlendDesc.BlendEnable = TRUE;
+                rtBlendDesc.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+                rtBlendDesc.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+                rtBlendDesc.BlendOp = D3D11_BLEND_OP_ADD;
+                rtBlendDesc.SrcBlendAlpha = D3D11_BLEND_ZERO;
+                rtBlendDesc.DestBlendAlpha = D3D11_BLEND_ONE;
+                rtBlendDesc.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+                rtBlendDesc.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+                for (UINT i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i) {
+                    blendStateDesc.RenderTarget[i] = rtBlendDesc;
                 }
             }
+            Internal::ThrowIfFailed(device->CreateBlendState(&blendStateDesc, objects->BlendState.put()));
+
+            CD3D11_RASTERIZER_DESC rasterizerDesc(D3D11_DEFAULT);
+            rasterizerDesc.CullMode = desc.DoubleSided ? D3D11_CULL_NONE : D3D11_CULL_BACK;
+            rasterizerDesc.FillMode = desc.Fill == FillMode::Wireframe ? D3D11_FILL_WIREFRAME : D3D11_FILL_SOLID;
+            rasterizerDesc.FrontCounterClockwise = desc.WindingOrder == FrontFaceWindingOrder::CounterClockWise;
+            Internal::ThrowIfFailed(device->CreateRasterizerState(&rasterizerDesc, objects->RasterizerState.put()));
+
+            CD3D11_DEPTH_STENCIL_DESC depthStencilDesc(CD3D11_DEFAULT{});
+            depthStencilDesc.DepthFunc = desc.ReverseZ ? D3D11_COMPARISON_GREATER : D3D11_COMPARISON_LESS;
+            depthStencilDesc.DepthWriteMask = desc.DepthWriteDisabled ? D3D11_DEPTH_WRITE_MASK_ZERO : D3D11_DEPTH_WRITE_MASK_ALL;
+            Internal::ThrowIfFailed(device->CreateDepthStencilState(&depthStencilDesc, objects->DepthStencilState.put()));
+
+            PipelineState state;
+            state.VertexShader = ToHandle(objects->VertexShader.get());
+            state.PixelShader = ToHandle(objects->PixelShader.get());
+            state.InputLayout = ToHandle(objects->InputLayout.get());
+            state.BlendState = ToHandle(objects->BlendState.get());
+            state.RasterizerState = ToHandle(objects->RasterizerState.get());
+            state.DepthStencilState = ToHandle(objects->DepthStencilState.get());
+            state.StencilRef = 1;
+            state.Lifetime = std::move(objects);
+            return state;
+        }
+
+        void CreateConstantBuffers(RenderDevice& device) {
+            if (Resources.SceneConstantBuffer.Handle) {
+                return;
+            }
+
+            static_assert((sizeof(SceneConstantBuffer) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
+            static_assert((sizeof(ModelConstantBuffer) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
+            static_assert((sizeof(DrawConstantBuffer) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
+            BufferDesc desc;
+            desc.Usage = BufferUsage::Constant;
+            desc.ByteSize = sizeof(SceneConstantBuffer);
+            Resources.SceneConstantBuffer = device.CreateBuffer(desc);
+            desc.ByteSize = sizeof(ModelConstantBuffer);
+            Resources.ModelConstantBuffer = device.CreateBuffer(desc);
+
+            // The material index changes with most draws, so the draw constants are written with discard.
+            desc.ByteSize = sizeof(DrawConstantBuffer);
+            desc.Dynamic = true;
+            Resources.DrawConstantBuffer = device.CreateBuffer(desc);
+        }
+
+        // Copies the material parameters which changed since the last upload to the GPU table, recreating the table when it
+        // outgrew its capacity. Returns whether it was recreated, in which case its view needs to be bound again.
+        bool UploadMaterialTable(RenderDevice& device) {
+            MaterialParameterTable& table = Materials.ParameterTable();
+            const uint32_t stride = table.ElementByteSize();
+
+            bool recreated = false;
+            table.Upload([&](const void* data, uint32_t elementCount, uint32_t dirtyBegin, uint32_t dirtyEnd) {
+                if (elementCount > Resources.MaterialTableCapacity) {
+                    const uint32_t capacity = std::max({elementCount, Resources.MaterialTableCapacity * 2, MinMaterialTableCapacity});
+                    BufferDesc desc;
+                    desc.ByteSize = capacity * stride;
+                    desc.Usage = BufferUsage::Structured;
+                    desc.StructureByteStride = stride;
+                    Resources.MaterialTable = device.CreateBuffer(desc);
+                    Resources.MaterialTableView = device.CreateShaderResourceView(Resources.MaterialTable.Handle, capacity);
+                    Resources.MaterialTableCapacity = capacity;
+                    dirtyBegin = 0;
+                    dirtyEnd = elementCount;
+                    recreated = true;
+                }
+
+                device.UpdateBufferRange(Resources.MaterialTable.Handle,
+                                         dirtyBegin * stride,
+                                         static_cast<const uint8_t*>(data) + static_cast<size_t>(dirtyBegin) * stride,
+                                         (dirtyEnd - dirtyBegin) * stride);
+            });
+            return recreated;
         }
 
         struct DeviceResources {
+            winrt::com_ptr<ID3D11Device> Device;
             winrt::com_ptr<ID3D11SamplerState> BrdfSampler;
             winrt::com_ptr<ID3D11SamplerState> EnvironmentMapSampler;
             winrt::com_ptr<ID3D11InputLayout> InputLayout;
@@ -111,20 +215,24 @@ namespace Pbr {
             winrt::com_ptr<ID3D11PixelShader> PbrPixelShader;
             winrt::com_ptr<ID3D11VertexShader> HighlightVertexShader;
             winrt::com_ptr<ID3D11PixelShader> HighlightPixelShader;
-            winrt::com_ptr<ID3D11Buffer> SceneConstantBuffer;
-            winrt::com_ptr<ID3D11Buffer> ModelConstantBuffer;
+            DeviceObject<BufferHandle> SceneConstantBuffer;
+            DeviceObject<BufferHandle> ModelConstantBuffer;
             winrt::com_ptr<ID3D11ShaderResourceView> BrdfLut;
             winrt::com_ptr<ID3D11ShaderResourceView> SpecularEnvironmentMap;
             winrt::com_ptr<ID3D11ShaderResourceView> DiffuseEnvironmentMap;
-            winrt::com_ptr<ID3D11BlendState> AlphaBlendState;
-            winrt::com_ptr<ID3D11BlendState> DefaultBlendState;
-            winrt::com_ptr<ID3D11RasterizerState>
-                RasterizerStates[2][2][2]; // Three dimensions for [DoubleSide][Wireframe][FrontCounterClockWise]
-            winrt::com_ptr<ID3D11DepthStencilState> DepthStencilStates[2][2]; // Two dimensions for [ReverseZ][NoWrite]
             mutable std::map<uint32_t, winrt::com_ptr<ID3D11ShaderResourceView>> SolidColorTextureCache;
+            DeviceObject<BufferHandle> DrawConstantBuffer;
+            DeviceObject<BufferHandle> MaterialTable;
+            DeviceObject<ShaderResourceViewHandle> MaterialTableView;
+            uint32_t MaterialTableCapacity{0}; // In elements.
         };
 
         DeviceResources Resources;
+        PipelineStateCache PipelineStates{[this](const PipelineStateDesc& desc) { return CreatePipelineState(desc); }};
+        PipelineStateId BoundPipelineState = InvalidPipelineStateId;
+        MaterialRegistry Materials{sizeof(Material::ConstantBufferData)};
+        std::shared_ptr<const MaterialBindings> BoundMaterial; // Held so that its address is not reused while it is bound.
+        uint32_t BoundMaterialIndex = InvalidMaterialIndex;     // The content of the draw constant buffer.
         SceneConstantBuffer SceneBuffer;
         ModelConstantBuffer ModelBuffer;
 
@@ -135,6 +243,7 @@ namespace Pbr {
         FillMode Fill = FillMode::Solid;
         FrontFaceWindingOrder WindingOrder = FrontFaceWindingOrder::ClockWise;
         bool ReverseZ = false;
+        uint32_t PassGeneration = 0; // Changes with the pass pipeline state description and when the pipeline states are cleared.
         mutable std::mutex m_cacheMutex;
     };
 
@@ -156,13 +265,17 @@ namespace Pbr {
     }
 
     void Resources::ReleaseDeviceDependentResources() {
+        m_impl->PipelineStates.Clear();
+        ++m_impl->PassGeneration;
+        m_impl->BoundPipelineState = InvalidPipelineStateId;
+        m_impl->Materials.Clear();
+        m_impl->BoundMaterial = nullptr;
+        m_impl->BoundMaterialIndex = InvalidMaterialIndex;
         m_impl->Resources = {};
     }
 
     winrt::com_ptr<ID3D11Device> Resources::GetDevice() const {
-        winrt::com_ptr<ID3D11Device> device;
-        m_impl->Resources.SceneConstantBuffer->GetDevice(device.put());
-        return device;
+        return m_impl->Resources.Device;
     }
 
     void Resources::SetLight(DirectX::XMFLOAT3 direction, RGBColor diffuseColor) {
@@ -182,8 +295,14 @@ namespace Pbr {
     }
 
     void XM_CALLCONV Resources::SetModelToWorld(DirectX::FXMMATRIX modelToWorld, _In_ ID3D11DeviceContext* context) const {
+        D3D11RenderDevice device(GetDevice().get(), context);
+        SetModelToWorld(modelToWorld, device);
+    }
+
+    void XM_CALLCONV Resources::SetModelToWorld(DirectX::FXMMATRIX modelToWorld, RenderDevice& device) const {
         XMStoreFloat4x4(&m_impl->ModelBuffer.ModelToWorld, XMMatrixTranspose(modelToWorld));
-        context->UpdateSubresource(m_impl->Resources.ModelConstantBuffer.get(), 0, nullptr, &m_impl->ModelBuffer, 0, 0);
+        m_impl->CreateConstantBuffers(device);
+        device.UpdateBuffer(m_impl->Resources.ModelConstantBuffer.Handle, &m_impl->ModelBuffer, sizeof(m_impl->ModelBuffer));
     }
 
     void XM_CALLCONV Resources::SetViewProjection(DirectX::FXMMATRIX view, DirectX::CXMMATRIX projection) {
@@ -229,34 +348,72 @@ namespace Pbr {
         return m_impl->Resources.SolidColorTextureCache.emplace(colorKey, texture).first->second;
     }
 
-    void Resources::Bind(_In_ ID3D11DeviceContext* context) const {
-        context->UpdateSubresource(m_impl->Resources.SceneConstantBuffer.get(), 0, nullptr, &m_impl->SceneBuffer, 0, 0);
-
-        if (m_impl->Shading == ShadingMode::Highlight) {
-            context->VSSetShader(m_impl->Resources.HighlightVertexShader.get(), nullptr, 0);
-            context->PSSetShader(m_impl->Resources.HighlightPixelShader.get(), nullptr, 0);
-        } else {
-            context->VSSetShader(m_impl->Resources.PbrVertexShader.get(), nullptr, 0);
-            context->PSSetShader(m_impl->Resources.PbrPixelShader.get(), nullptr, 0);
+    size_t Resources::TrimSolidColorTextureCache() const {
+        std::lock_guard guard(m_impl->m_cacheMutex);
+        auto& cache = m_impl->Resources.SolidColorTextureCache;
+
+        size_t releasedCount = 0;
+        for (auto it = cache.begin(); it != cache.end();) {
+            // The reference count is returned by Release. A count of one means only the cache holds the texture.
+            it->second->AddRef();
+            if (it->second->Release() == 1) {
+                it = cache.erase(it);
+                releasedCount++;
+            } else {
+                ++it;
+            }
         }
+        return releasedCount;
+    }
 
-        ID3D11Buffer* vsBuffers[] = {m_impl->Resources.SceneConstantBuffer.get(), m_impl->Resources.ModelConstantBuffer.get()};
-        context->VSSetConstantBuffers(Pbr::ShaderSlots::ConstantBuffers::Scene, _countof(vsBuffers), vsBuffers);
-        ID3D11Buffer* psBuffers[] = {m_impl->Resources.SceneConstantBuffer.get()};
-        context->PSSetConstantBuffers(Pbr::ShaderSlots::ConstantBuffers::Scene, _countof(psBuffers), psBuffers);
-        context->IASetInputLayout(m_impl->Resources.InputLayout.get());
+    void Resources::Bind(_In_ ID3D11DeviceContext* context) const {
+        D3D11RenderDevice device(GetDevice().get(), context);
+        Bind(device);
+    }
+
+    void Resources::Bind(RenderDevice& device) const {
+        m_impl->CreateConstantBuffers(device);
+        device.UpdateBuffer(m_impl->Resources.SceneConstantBuffer.Handle, &m_impl->SceneBuffer, sizeof(m_impl->SceneBuffer));
+
+        const BufferHandle vsBuffers[] = {m_impl->Resources.SceneConstantBuffer.Handle, m_impl->Resources.ModelConstantBuffer.Handle};
+        device.SetConstantBuffers(ShaderStage::Vertex, Pbr::ShaderSlots::ConstantBuffers::Scene, _countof(vsBuffers), vsBuffers);
+        const BufferHandle psBuffers[] = {m_impl->Resources.SceneConstantBuffer.Handle};
+        device.SetConstantBuffers(ShaderStage::Pixel, Pbr::ShaderSlots::ConstantBuffers::Scene, _countof(psBuffers), psBuffers);
+        const BufferHandle psDrawBuffers[] = {m_impl->Resources.DrawConstantBuffer.Handle};
+        device.SetConstantBuffers(ShaderStage::Pixel, Pbr::ShaderSlots::ConstantBuffers::Draw, _countof(psDrawBuffers), psDrawBuffers);
+
+        // Compacting changes the indices of materials, so the bound material is bound again with its new index.
+        MaterialParameterTable& materialTable = m_impl->Materials.ParameterTable();
+        if (materialTable.IsFragmented() && materialTable.Compact() > 0) {
+            m_impl->BoundMaterial = nullptr;
+            m_impl->BoundMaterialIndex = InvalidMaterialIndex;
+        }
+        m_impl->UploadMaterialTable(device);
 
         static_assert(ShaderSlots::DiffuseTexture == ShaderSlots::SpecularTexture + 1, "Diffuse must follow Specular slot");
         static_assert(ShaderSlots::SpecularTexture == ShaderSlots::Brdf + 1, "Specular must follow BRDF slot");
-        ID3D11ShaderResourceView* shaderResources[] = {
-            m_impl->Resources.BrdfLut.get(), m_impl->Resources.SpecularEnvironmentMap.get(), m_impl->Resources.DiffuseEnvironmentMap.get()};
-        context->PSSetShaderResources(Pbr::ShaderSlots::Brdf, _countof(shaderResources), shaderResources);
-        ID3D11SamplerState* samplers[] = {m_impl->Resources.BrdfSampler.get(), m_impl->Resources.EnvironmentMapSampler.get()};
-        context->PSSetSamplers(ShaderSlots::Brdf, _countof(samplers), samplers);
+        static_assert(ShaderSlots::MaterialParameters == ShaderSlots::DiffuseTexture + 1, "Material table must follow Diffuse slot");
+        const ShaderResourceViewHandle shaderResources[] = {ToHandle(m_impl->Resources.BrdfLut.get()),
+                                                            ToHandle(m_impl->Resources.SpecularEnvironmentMap.get()),
+                                                            ToHandle(m_impl->Resources.DiffuseEnvironmentMap.get()),
+                                                            m_impl->Resources.MaterialTableView.Handle};
+        device.SetShaderResources(ShaderStage::Pixel, Pbr::ShaderSlots::Brdf, _countof(shaderResources), shaderResources);
+        const SamplerHandle samplers[] = {ToHandle(m_impl->Resources.BrdfSampler.get()),
+                                          ToHandle(m_impl->Resources.EnvironmentMapSampler.get())};
+        device.SetSamplers(ShaderStage::Pixel, ShaderSlots::Brdf, _countof(samplers), samplers);
+    }
+
+    void Resources::InvalidateBoundState() const {
+        m_impl->BoundPipelineState = InvalidPipelineStateId;
+        m_impl->BoundMaterial = nullptr;
+        m_impl->BoundMaterialIndex = InvalidMaterialIndex;
     }
 
     void Resources::SetShadingMode(ShadingMode mode) {
-        m_impl->Shading = mode;
+        if (m_impl->Shading != mode) {
+            m_impl->Shading = mode;
+            ++m_impl->PassGeneration;
+        }
     }
 
     ShadingMode Resources::GetShadingMode() const {
@@ -264,7 +421,10 @@ namespace Pbr {
     }
 
     void Resources::SetFillMode(FillMode mode) {
-        m_impl->Fill = mode;
+        if (m_impl->Fill != mode) {
+            m_impl->Fill = mode;
+            ++m_impl->PassGeneration;
+        }
     }
 
     FillMode Resources::GetFillMode() const {
@@ -272,7 +432,10 @@ namespace Pbr {
     }
 
     void Resources::SetFrontFaceWindingOrder(FrontFaceWindingOrder windingOrder) {
-        m_impl->WindingOrder = windingOrder;
+        if (m_impl->WindingOrder != windingOrder) {
+            m_impl->WindingOrder = windingOrder;
+            ++m_impl->PassGeneration;
+        }
     }
 
     FrontFaceWindingOrder Resources::GetFrontFaceWindingOrder() const {
@@ -280,22 +443,77 @@ namespace Pbr {
     }
 
     void Resources::SetDepthFuncReversed(bool reverseZ) {
-        m_impl->ReverseZ = reverseZ;
+        if (m_impl->ReverseZ != reverseZ) {
+            m_impl->ReverseZ = reverseZ;
+            ++m_impl->PassGeneration;
+        }
+    }
+
+    PipelineStateDesc Resources::GetPassPipelineStateDesc() const {
+        PipelineStateDesc desc;
+        desc.Shading = m_impl->Shading;
+        desc.Fill = m_impl->Fill;
+        desc.WindingOrder = m_impl->WindingOrder;
+        desc.ReverseZ = m_impl->ReverseZ;
+        return desc;
     }
 
-    void Resources::SetBlendState(_In_ ID3D11DeviceContext* context, bool enabled) const {
-        context->OMSetBlendState(
-            enabled ? m_impl->Resources.AlphaBlendState.get() : m_impl->Resources.DefaultBlendState.get(), nullptr, 0xFFFFFF);
+    uint32_t Resources::PassGeneration() const {
+        return m_impl->PassGeneration;
     }
 
-    void Resources::SetRasterizerState(_In_ ID3D11DeviceContext* context, bool doubleSided, bool wireframe) const {
-        context->RSSetState(m_impl->Resources
-                                .RasterizerStates[doubleSided ? 1 : 0][wireframe ? 1 : 0]
-                                                 [m_impl->WindingOrder == FrontFaceWindingOrder::CounterClockWise ? 1 : 0]
-                                .get());
+    PipelineStateCache& Resources::PipelineStates() const {
+        return m_impl->PipelineStates;
     }
 
-    void Resources::SetDepthStencilState(_In_ ID3D11DeviceContext* context, bool disableDepthWrite) const {
-        context->OMSetDepthStencilState(m_impl->Resources.DepthStencilStates[m_impl->ReverseZ ? 1 : 0][disableDepthWrite ? 1 : 0].get(), 1);
+    void Resources::BindPipelineState(RenderDevice& device, PipelineStateId id) const {
+        if (id == m_impl->BoundPipelineState) {
+            return;
+        }
+
+        const PipelineState& state = m_impl->PipelineStates.Get(id);
+        device.SetShaders(state.VertexShader, state.PixelShader);
+        device.SetInputLayout(state.InputLayout);
+        device.SetBlendState(state.BlendState);
+        device.SetRasterizerState(state.RasterizerState);
+        device.SetDepthStencilState(state.DepthStencilState, state.StencilRef);
+        m_impl->BoundPipelineState = id;
+    }
+
+    MaterialRegistry& Resources::Materials() const {
+        return m_impl->Materials;
+    }
+
+    void Resources::BindMaterial(RenderDevice& device, const std::shared_ptr<const MaterialBindings>& bindings) const {
+        if (bindings == m_impl->BoundMaterial) {
+            return;
+        }
+
+        // The parameters of newly interned materials must reach the table before they are drawn.
+        if (m_impl->UploadMaterialTable(device)) {
+            const ShaderResourceViewHandle materialTableViews[] = {m_impl->Resources.MaterialTableView.Handle};
+            device.SetShaderResources(ShaderStage::Pixel, Pbr::ShaderSlots::MaterialParameters, 1, materialTableViews);
+        }
+
+        // Instead of binding a constant buffer per material, each draw carries the index of its material in the table.
+        const uint32_t materialIndex = bindings->Parameters->Index;
+        if (materialIndex != m_impl->BoundMaterialIndex) {
+            const DrawConstantBuffer drawConstants{materialIndex};
+            device.WriteDynamicBuffer(m_impl->Resources.DrawConstantBuffer.Handle, &drawConstants, sizeof(drawConstants));
+            m_impl->BoundMaterialIndex = materialIndex;
+        }
+
+        // Materials which only differ in their parameters share their textures and samplers, which then stay bound.
+        static_assert(Pbr::ShaderSlots::BaseColor == 0, "BaseColor must be the first slot");
+        const MaterialBindings* const boundMaterial = m_impl->BoundMaterial.get();
+        const auto& textures = bindings->Textures;
+        if (!boundMaterial || boundMaterial->Textures != textures) {
+            device.SetShaderResources(ShaderStage::Pixel, Pbr::ShaderSlots::BaseColor, (uint32_t)textures.size(), textures.data());
+        }
+        const auto& samplers = bindings->Samplers;
+        if (!boundMaterial || boundMaterial->Samplers != samplers) {
+            device.SetSamplers(ShaderStage::Pixel, Pbr::ShaderSlots::BaseColor, (uint32_t)samplers.size(), samplers.data());
+        }
+        m_impl->BoundMaterial = bindings;
     }
 } // namespace Pbr
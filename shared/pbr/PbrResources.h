@@ -11,6 +11,9 @@
 #include <d3d11_2.h>
 #include <DirectXMath.h>
 #include "PbrCommon.h"
+#include "PbrMaterialRegistry.h"
+#include "PbrPipelineState.h"
+#include "PbrRenderDeviceD3D11.h"
 
 namespace Pbr {
     namespace ShaderSlots {
@@ -37,28 +40,17 @@ namespace Pbr {
             EnvironmentMapSampler = Brdf + 1
         };
 
+        enum MaterialTable {
+            MaterialParameters = DiffuseTexture + 1, // The parameters of all materials, indexed per draw.
+        };
+
         enum ConstantBuffers {
             Scene,    // Used by VS and PS
             Model,    // PS only
-            Material, // PS only
+            Draw,     // PS only, the index of the material in the material table
         };
     } // namespace ShaderSlots
 
-    enum class ShadingMode : uint32_t {
-        Regular,
-        Highlight,
-    };
-
-    enum class FillMode : uint32_t {
-        Solid,
-        Wireframe,
-    };
-
-    enum class FrontFaceWindingOrder : uint32_t {
-        ClockWise,
-        CounterClockWise,
-    };
-
     // Global PBR resources required for rendering a scene.
     struct Resources final {
         explicit Resources(_In_ ID3D11Device* d3dDevice);
@@ -99,11 +91,21 @@ namespace Pbr {
         // number of textures created.
         winrt::com_ptr<ID3D11ShaderResourceView> CreateSolidColorTexture(RGBAColor color) const;
 
-        // Bind the the PBR resources to the current context.
+        // Release cached solid color textures which are no longer referenced by any material. Returns the number released.
+        size_t TrimSolidColorTextureCache() const;
+
+        // Upload the scene constants and bind the PBR resources shared by all materials to the current context, once per pass rather
+        // than per model. The pipeline state is bound by each material.
         void Bind(_In_ ID3D11DeviceContext* context) const;
+        void Bind(RenderDevice& device) const;
+
+        // Forget the pipeline state and material which were bound last, so that the next material binds all of its state. Call it
+        // when other rendering changed the state of the context since then.
+        void InvalidateBoundState() const;
 
         // Set and update the model to world constant buffer value.
         void XM_CALLCONV SetModelToWorld(DirectX::FXMMATRIX modelToWorld, _In_ ID3D11DeviceContext* context) const;
+        void XM_CALLCONV SetModelToWorld(DirectX::FXMMATRIX modelToWorld, RenderDevice& device) const;
 
         // Set or get the shading and fill modes.
         void SetShadingMode(ShadingMode mode);
@@ -116,9 +118,20 @@ namespace Pbr {
         void SetDepthFuncReversed(bool reverseZ);
 
     private:
-        void SetBlendState(_In_ ID3D11DeviceContext* context, bool enabled) const;
-        void SetRasterizerState(_In_ ID3D11DeviceContext* context, bool doubleSided, bool wireframe) const;
-        void SetDepthStencilState(_In_ ID3D11DeviceContext* context, bool disableDepthWrite) const;
+        // The pipeline state of the current shading mode, fill mode, winding order and depth function, to be completed by the
+        // material.
+        PipelineStateDesc GetPassPipelineStateDesc() const;
+        // Changes whenever the pass pipeline state description changes or the pipeline states are recreated.
+        uint32_t PassGeneration() const;
+        PipelineStateCache& PipelineStates() const;
+
+        // Binds the pipeline state unless it is the one that was bound last since the bound state was invalidated.
+        void BindPipelineState(RenderDevice& device, PipelineStateId id) const;
+
+        MaterialRegistry& Materials() const;
+
+        // Binds the material index, textures and samplers of a material unless they are the ones that were bound last.
+        void BindMaterial(RenderDevice& device, const std::shared_ptr<const MaterialBindings>& bindings) const;
 
         friend struct Material;
 
@@ -18,17 +18,29 @@
 
 #include "PbrShared.hlsl"
 
-cbuffer MaterialConstantBuffer : register(b2)
+// Must match the layout of Pbr::Material::ConstantBufferData.
+struct MaterialParameters
 {
-    float4 BaseColorFactor  : packoffset(c0);
-    float MetallicFactor    : packoffset(c1.x);
-    float RoughnessFactor   : packoffset(c1.y);
-    float3 EmissiveFactor   : packoffset(c2);
-    float NormalScale       : packoffset(c3.x);
-    float OcclusionStrength : packoffset(c3.y);
-    float AlphaCutoff       : packoffset(c3.z);
+    float4 BaseColorFactor;
+    float MetallicFactor;
+    float RoughnessFactor;
+    float2 Padding0;
+    float3 EmissiveFactor;
+    float Padding1;
+    float NormalScale;
+    float OcclusionStrength;
+    float AlphaCutoff;
+    float Padding2;
 };
 
+cbuffer DrawConstantBuffer : register(b2)
+{
+    uint MaterialIndex      : packoffset(c0.x);
+};
+
+// The parameters of all materials, of which each draw uses the one at MaterialIndex.
+StructuredBuffer<MaterialParameters> MaterialTable : register(t8);
+
 // The texture registers must match the order of the MaterialTextures enum.
 Texture2D<float4> BaseColorTexture          : register(t0);
 Texture2D<float3> MetallicRoughnessTexture  : register(t1); // Green(y)=Roughness, Blue(z)=Metallic
@@ -92,16 +104,18 @@ float microfacetDistribution(float NdotH, float alphaRoughness)
 
 float4 main(PSInputPbr input) : SV_TARGET
 {
+    const MaterialParameters material = MaterialTable[MaterialIndex];
+
     // Roughness is stored in the 'g' channel, metallic is stored in the 'b' channel.
     // This layout intentionally reserves the 'r' channel for (optional) occlusion map data
     const float3 mrSample = MetallicRoughnessTexture.Sample(MetallicRoughnessSampler, input.TexCoord0);
-    const float4 baseColor = BaseColorTexture.Sample(BaseColorSampler, input.TexCoord0) * input.Color0 * BaseColorFactor;
+    const float4 baseColor = BaseColorTexture.Sample(BaseColorSampler, input.TexCoord0) * input.Color0 * material.BaseColorFactor;
 
     // Discard if below alpha cutoff.
-    clip(baseColor.a - AlphaCutoff);
+    clip(baseColor.a - material.AlphaCutoff);
 
-    const float metallic = saturate(mrSample.b * MetallicFactor);
-    const float perceptualRoughness = clamp(mrSample.g * RoughnessFactor, MinRoughness, 1.0);
+    const float metallic = saturate(mrSample.b * material.MetallicFactor);
+    const float perceptualRoughness = clamp(mrSample.g * material.RoughnessFactor, MinRoughness, 1.0);
 
     // Roughness is authored as perceptual roughness; as is convention,
     // convert to material roughness by squaring the perceptual roughness [2].
@@ -121,7 +135,7 @@ float4 main(PSInputPbr input) : SV_TARGET
 
     // normal at surface point
     float3 n = 2.0 * NormalTexture.Sample(NormalSampler, input.TexCoord0) - 1.0;
-    n = normalize(mul(n * float3(NormalScale, NormalScale, 1.0), input.TBN));
+    n = normalize(mul(n * float3(material.NormalScale, material.NormalScale, 1.0), input.TBN));
 
     const float3 v = normalize(EyePosition - input.PositionWorld);   // Vector from surface point to camera
     const float3 l = normalize(LightDirection);                           // Vector from surface point to light
@@ -149,9 +163,9 @@ float4 main(PSInputPbr input) : SV_TARGET
 
     // Apply optional PBR terms for additional (optional) shading
     const float ao = OcclusionTexture.Sample(OcclusionSampler, input.TexCoord0).r;
-    color = lerp(color, color * ao, OcclusionStrength);
+    color = lerp(color, color * ao, material.OcclusionStrength);
 
-    const float3 emissive = EmissiveTexture.Sample(EmissiveSampler, input.TexCoord0) * EmissiveFactor;
+    const float3 emissive = EmissiveTexture.Sample(EmissiveSampler, input.TexCoord0) * material.EmissiveFactor;
     color += emissive;
 
     return float4(color, baseColor.a);